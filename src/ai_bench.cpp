@@ -0,0 +1,117 @@
+// ============================================================================
+// ai_bench: measure bot search throughput per thread count
+//
+// Usage: ai_bench [max_threads] [lookahead] [beam_width]
+//
+// Builds a fixed set of mid-game positions by letting a one-ply bot play
+// seeded random games, then searches every position to a fixed depth (no
+// time budget) at 1, 2, 4 ... max_threads threads and reports nodes/sec.
+// ============================================================================
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include "aisearch.h"
+
+static const int BENCH_WIDTH = 10;
+static const int BENCH_HEIGHT = 22;
+static const int BENCH_POSITIONS = 24;
+static const int BENCH_PREVIEW = 20;
+
+struct BenchPosition {
+    BitBoard board;
+    int type;
+    std::vector<int> preview;
+};
+
+static std::vector<BenchPosition> buildPositions() {
+    std::vector<BenchPosition> positions;
+    std::minstd_rand rng(20250705);
+    std::uniform_int_distribution<int> pieceDist(0, AI_PIECE_TYPES - 1);
+
+    AISearch player;
+    player.lookahead = 1;
+    player.budgetMs = 0.0;
+    player.threads = 1;
+
+    BitBoard b;
+    b.clear(BENCH_WIDTH, BENCH_HEIGHT);
+    int spawnX = BENCH_WIDTH / 2 - 2;
+
+    while ((int)positions.size() < BENCH_POSITIONS) {
+        // Play a few pieces between samples so positions differ
+        for (int i = 0; i < 7; ++i) {
+            int type = pieceDist(rng);
+            AIPlacement p = player.choose(b, type, spawnX, 0, 0, std::vector<int>());
+            if (!p.valid || AISearch::place(b, type, p.rotation, p.x, p.y) < 0) {
+                b.clear(BENCH_WIDTH, BENCH_HEIGHT);
+            }
+        }
+
+        BenchPosition pos;
+        pos.board = b;
+        pos.type = pieceDist(rng);
+        for (int i = 0; i < BENCH_PREVIEW; ++i) {
+            pos.preview.push_back(pieceDist(rng));
+        }
+        positions.push_back(pos);
+    }
+    return positions;
+}
+
+int main(int argc, char* argv[]) {
+    int cores = (int)std::thread::hardware_concurrency();
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : (cores > 0 ? cores : 1);
+    int lookahead = argc > 2 ? std::atoi(argv[2]) : 4;
+    int beamWidth = argc > 3 ? std::atoi(argv[3]) : 4;
+    if (maxThreads < 1) maxThreads = 1;
+
+    std::vector<BenchPosition> positions = buildPositions();
+
+    std::cout << "Positions: " << positions.size() << ", lookahead " << lookahead
+              << ", beam " << beamWidth << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "nodes"
+              << std::setw(12) << "ms" << std::setw(14) << "nodes/sec"
+              << std::setw(10) << "speedup" << std::endl;
+
+    double baseline = 0.0;
+    std::vector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+
+    for (int threads : counts) {
+        AISearch search;
+        search.lookahead = lookahead;
+        search.beamWidth = beamWidth;
+        search.budgetMs = 0.0;
+        search.threads = threads;
+
+        // Warm up the pool and tables outside the timed region
+        search.choose(positions[0].board, positions[0].type, BENCH_WIDTH / 2 - 2, 0, 0,
+                      positions[0].preview);
+
+        long nodes = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const BenchPosition& pos : positions) {
+            search.choose(pos.board, pos.type, BENCH_WIDTH / 2 - 2, 0, 0, pos.preview);
+            nodes += search.getNodesSearched();
+        }
+        double ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start).count();
+
+        double rate = ms > 0.0 ? nodes / (ms / 1000.0) : 0.0;
+        if (threads == 1) baseline = rate;
+
+        std::cout << std::setw(8) << threads << std::setw(14) << nodes
+                  << std::setw(12) << std::fixed << std::setprecision(1) << ms
+                  << std::setw(14) << std::setprecision(0) << rate
+                  << std::setw(9) << std::setprecision(2)
+                  << (baseline > 0.0 ? rate / baseline : 0.0) << "x" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,422 @@
+// ============================================================================
+// ai_tune: offline evolution of the bot's heuristic weights
+//
+// Usage: ai_tune [options]
+//   --generations N   Generations to run (default 100)
+//   --population N    Candidates per generation (default 16)
+//   --games N         Seeded games per candidate (default 64)
+//   --pieces N        Piece cap per game (default 1000)
+//   --pieceset N      1 = all 14 pieces, 2 = up to triominoes, 3/4 = tetrominoes (default 4)
+//   --lookahead N     Pieces searched per move, current plus previews (default 2)
+//   --beam N          Beam width of the search (default 2)
+//   --threads N       Worker threads, 0 = one per core (default 0)
+//   --checkpoint F    Checkpoint file, resumed from when present (default ai_tune.ckpt)
+//   --log F           CSV log of lines per game per generation (default ai_tune.csv)
+//   --out F           Tuned weights, readable by the game as bot_weights.txt
+//                     (default bot_weights.txt)
+//
+// The optimiser is a separable CMA-ES over the four AIWeights terms. Every
+// candidate of a generation plays the same seeded piece sequences (common
+// random numbers), so differences in lines per game come from the weights
+// and not from luck of the draw. Games are bitboard games played by the
+// bot's own search (breadth-first placements with tucks and spins, then a
+// beam over the previews), at a smaller depth and beam than the game uses
+// and with no time budget so results do not depend on machine load. Each
+// worker thread keeps one search engine, so no locks are taken while a
+// generation plays.
+// ============================================================================
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <memory>
+#include <string>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "aisearch.h"
+#include "threadpool.h"
+
+static const int DIMENSIONS = 4;
+static const int TUNE_WIDTH = 10;
+static const int TUNE_HEIGHT = 22;
+static const uint32_t CHECKPOINT_VERSION = 2;
+
+struct TuneOptions {
+    int generations = 100;
+    int population = 16;
+    int games = 64;
+    int pieces = 1000;
+    int pieceSet = 4;
+    int lookahead = 2;
+    int beamWidth = 2;
+    int threads = 0;
+    std::string checkpointPath = "ai_tune.ckpt";
+    std::string logPath = "ai_tune.csv";
+    std::string outPath = "bot_weights.txt";
+};
+
+/**
+ * Separable CMA-ES state (diagonal covariance). Small enough to write to
+ * the checkpoint as plain numbers.
+ */
+struct TuneState {
+    int generation = 0;
+    double sigma = 0.3;
+    double mean[DIMENSIONS];
+    double diagC[DIMENSIONS];
+    double pathSigma[DIMENSIONS];
+    double pathC[DIMENSIONS];
+    double meanLines = 0.0;   // Lines per game of the mean, last generation
+    uint64_t rngState = 1;
+};
+
+static AIWeights toWeights(const double* v) {
+    // Scores are only compared, so the weights are used as a unit vector
+    double norm = 0.0;
+    for (int i = 0; i < DIMENSIONS; ++i) norm += v[i] * v[i];
+    norm = norm > 0.0 ? std::sqrt(norm) : 1.0;
+
+    AIWeights w;
+    w.aggregateHeight = v[0] / norm;
+    w.completeLines = v[1] / norm;
+    w.holes = v[2] / norm;
+    w.bumpiness = v[3] / norm;
+    return w;
+}
+
+static void fromWeights(const AIWeights& w, double* v) {
+    v[0] = w.aggregateHeight;
+    v[1] = w.completeLines;
+    v[2] = w.holes;
+    v[3] = w.bumpiness;
+}
+
+// ============================================================================
+// Headless games
+// ============================================================================
+
+static int pieceTypeCount(int pieceSet) {
+    // Mirrors the minBlockSize switch in TetrimoneBoard::generateNewPiece()
+    switch (pieceSet) {
+        case 1: return 14;
+        case 2: return 11;
+        default: return 7;
+    }
+}
+
+/**
+ * Play one seeded game with fixed weights.
+ * @param search Engine owned by the calling worker; its weights are replaced
+ * @return Lines cleared before topping out or reaching the piece cap
+ */
+static int playGame(AISearch& search, const AIWeights& w, uint32_t seed, int maxPieces,
+                    int pieceTypes) {
+    std::minstd_rand rng(seed);
+    std::uniform_int_distribution<int> pieceDist(0, pieceTypes - 1);
+    search.weights = w;
+
+    BitBoard b;
+    b.clear(TUNE_WIDTH, TUNE_HEIGHT);
+    int lines = 0;
+
+    // The search sees as many previews as it looks ahead
+    std::vector<int> preview(std::max(search.lookahead - 1, 0));
+    for (int& next : preview) next = pieceDist(rng);
+
+    for (int i = 0; i < maxPieces; ++i) {
+        int type = pieceDist(rng);
+        if (!preview.empty()) {
+            std::swap(type, preview.front());
+            std::rotate(preview.begin(), preview.begin() + 1, preview.end());
+        }
+        AIPlacement p = search.choose(b, type, TUNE_WIDTH / 2 - 2, 0, 0, preview);
+        if (!p.valid) break;
+        int cleared = AISearch::place(b, type, p.rotation, p.x, p.y);
+        if (cleared < 0) break;
+        lines += cleared;
+    }
+    return lines;
+}
+
+// ============================================================================
+// Checkpoints
+// ============================================================================
+
+static bool saveCheckpoint(const std::string& path, const TuneState& state) {
+    // Write beside the target and rename, so a crash never leaves half a file
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open checkpoint for writing: " << tmpPath << std::endl;
+            return false;
+        }
+        file.precision(17);
+        file << "ai_tune " << CHECKPOINT_VERSION << "\n"
+             << state.generation << " " << state.sigma << " " << state.meanLines << " "
+             << state.rngState << "\n";
+        const double* arrays[] = {state.mean, state.diagC, state.pathSigma, state.pathC};
+        for (const double* a : arrays) {
+            for (int i = 0; i < DIMENSIONS; ++i) file << a[i] << " ";
+            file << "\n";
+        }
+        if (!file.good()) return false;
+    }
+    std::remove(path.c_str());
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+static bool loadCheckpoint(const std::string& path, TuneState& state) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    std::string magic;
+    uint32_t version = 0;
+    file >> magic >> version;
+    if (magic != "ai_tune" || version != CHECKPOINT_VERSION) {
+        std::cerr << "Ignoring incompatible checkpoint: " << path << std::endl;
+        return false;
+    }
+
+    TuneState loaded;
+    file >> loaded.generation >> loaded.sigma >> loaded.meanLines >> loaded.rngState;
+    double* arrays[] = {loaded.mean, loaded.diagC, loaded.pathSigma, loaded.pathC};
+    for (double* a : arrays) {
+        for (int i = 0; i < DIMENSIONS; ++i) file >> a[i];
+    }
+    if (!file) {
+        std::cerr << "Ignoring truncated checkpoint: " << path << std::endl;
+        return false;
+    }
+    state = loaded;
+    return true;
+}
+
+// ============================================================================
+// Main loop
+// ============================================================================
+
+static bool parseArgs(int argc, char* argv[], TuneOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            std::cout << "Usage: ai_tune [--generations N] [--population N] [--games N]"
+                         " [--pieces N] [--pieceset 1-4] [--lookahead N] [--beam N] [--threads N]"
+                         " [--checkpoint FILE] [--log FILE] [--out FILE]" << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--generations") opt.generations = std::atoi(value.c_str());
+        else if (arg == "--population") opt.population = std::max(4, std::atoi(value.c_str()));
+        else if (arg == "--games") opt.games = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--pieces") opt.pieces = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--pieceset") opt.pieceSet = std::atoi(value.c_str());
+        else if (arg == "--lookahead") opt.lookahead = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--beam") opt.beamWidth = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--threads") opt.threads = std::atoi(value.c_str());
+        else if (arg == "--checkpoint") opt.checkpointPath = value;
+        else if (arg == "--log") opt.logPath = value;
+        else if (arg == "--out") opt.outPath = value;
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    TuneOptions opt;
+    if (!parseArgs(argc, argv, opt)) {
+        return 1;
+    }
+
+    int threads = opt.threads;
+    if (threads <= 0) {
+        threads = (int)std::thread::hardware_concurrency();
+        if (threads <= 0) threads = 1;
+    }
+    ThreadPool pool(threads);
+
+    // One single-threaded engine per worker; the pool supplies the parallelism
+    std::vector<std::unique_ptr<AISearch>> searches(pool.size());
+    for (auto& search : searches) {
+        search.reset(new AISearch());
+        search->lookahead = opt.lookahead;
+        search->beamWidth = opt.beamWidth;
+        search->budgetMs = 0.0;
+        search->threads = 1;
+    }
+
+    const int n = DIMENSIONS;
+    const int lambda = opt.population;
+    const int candidates = lambda + 1;  // Last slot scores the current mean
+    const int pieceTypes = pieceTypeCount(opt.pieceSet);
+
+    // Recombination weights and learning rates (Hansen's defaults, with the
+    // covariance rates scaled up as for separable CMA-ES)
+    const int mu = lambda / 2;
+    std::vector<double> recomb(mu);
+    for (int i = 0; i < mu; ++i) recomb[i] = std::log(mu + 0.5) - std::log(i + 1.0);
+    double recombSum = std::accumulate(recomb.begin(), recomb.end(), 0.0);
+    double recombSq = 0.0;
+    for (double& r : recomb) {
+        r /= recombSum;
+        recombSq += r * r;
+    }
+    const double mueff = 1.0 / recombSq;
+    const double cSigma = (mueff + 2.0) / (n + mueff + 5.0);
+    const double dSigma = 1.0 + 2.0 * std::max(0.0, std::sqrt((mueff - 1.0) / (n + 1.0)) - 1.0) + cSigma;
+    const double cc = (4.0 + mueff / n) / (n + 4.0 + 2.0 * mueff / n);
+    const double sepScale = (n + 2.0) / 3.0;
+    const double c1 = std::min(1.0, sepScale * 2.0 / ((n + 1.3) * (n + 1.3) + mueff));
+    const double cMu = std::min(1.0 - c1, sepScale * 2.0 * (mueff - 2.0 + 1.0 / mueff) /
+                                              ((n + 2.0) * (n + 2.0) + mueff));
+    const double chiN = std::sqrt((double)n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+
+    TuneState state;
+    fromWeights(AIWeights(), state.mean);
+    for (int i = 0; i < n; ++i) {
+        state.diagC[i] = 1.0;
+        state.pathSigma[i] = 0.0;
+        state.pathC[i] = 0.0;
+    }
+    if (loadCheckpoint(opt.checkpointPath, state)) {
+        std::cout << "Resuming from " << opt.checkpointPath << " at generation "
+                  << state.generation << std::endl;
+    }
+
+    std::ofstream log(opt.logPath, std::ios::app);
+    if (!log.is_open()) {
+        std::cerr << "Failed to open log file: " << opt.logPath << std::endl;
+    } else if (state.generation == 0) {
+        log << "generation,run_seconds,best_lines_per_game,mean_lines_per_game,sigma,"
+               "aggregateHeight,completeLines,holes,bumpiness\n";
+    }
+
+    // Everything the games touch is sized up front
+    std::vector<double> z(lambda * n), y(lambda * n), x(candidates * n);
+    std::vector<AIWeights> weights(candidates);
+    std::vector<int> lines(candidates * opt.games);
+    std::vector<double> fitness(candidates);
+    std::vector<int> order(lambda);
+    std::mt19937_64 rng(state.rngState);
+    std::normal_distribution<double> normal(0.0, 1.0);
+
+    std::cout << "Tuning with " << pool.size() << " threads, " << lambda << " candidates x "
+              << opt.games << " games per generation, lookahead " << opt.lookahead
+              << ", beam " << opt.beamWidth << std::endl;
+    std::cout << std::setw(5) << "gen" << std::setw(10) << "best" << std::setw(10) << "mean"
+              << std::setw(10) << "sigma" << std::setw(12) << "games/sec" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int gen = 0; gen < opt.generations; ++gen) {
+        // Sample the population around the mean
+        for (int k = 0; k < lambda; ++k) {
+            for (int i = 0; i < n; ++i) {
+                z[k * n + i] = normal(rng);
+                y[k * n + i] = std::sqrt(state.diagC[i]) * z[k * n + i];
+                x[k * n + i] = state.mean[i] + state.sigma * y[k * n + i];
+            }
+        }
+        for (int i = 0; i < n; ++i) x[lambda * n + i] = state.mean[i];
+        for (int k = 0; k < candidates; ++k) weights[k] = toWeights(&x[k * n]);
+
+        // Common random numbers: game g uses the same seed for every candidate
+        uint32_t seedBase = (uint32_t)state.generation * 7919u + 1u;
+        auto genStart = std::chrono::steady_clock::now();
+        pool.parallelFor(candidates * opt.games, [&](int task, int worker) {
+            int candidate = task / opt.games;
+            int game = task % opt.games;
+            lines[task] = playGame(*searches[worker], weights[candidate],
+                                   seedBase + (uint32_t)game, opt.pieces, pieceTypes);
+        });
+        double genSeconds = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - genStart).count();
+
+        for (int k = 0; k < candidates; ++k) {
+            long total = 0;
+            for (int g = 0; g < opt.games; ++g) total += lines[k * opt.games + g];
+            fitness[k] = (double)total / opt.games;
+        }
+
+        // Rank, best first
+        for (int k = 0; k < lambda; ++k) order[k] = k;
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return fitness[a] > fitness[b]; });
+
+        state.meanLines = fitness[lambda];
+
+        // Mean update
+        double yw[DIMENSIONS] = {0.0};
+        for (int r = 0; r < mu; ++r) {
+            for (int i = 0; i < n; ++i) yw[i] += recomb[r] * y[order[r] * n + i];
+        }
+        for (int i = 0; i < n; ++i) state.mean[i] += state.sigma * yw[i];
+
+        // Step size path and update
+        double psNorm = 0.0;
+        for (int i = 0; i < n; ++i) {
+            state.pathSigma[i] = (1.0 - cSigma) * state.pathSigma[i] +
+                                 std::sqrt(cSigma * (2.0 - cSigma) * mueff) * yw[i] / std::sqrt(state.diagC[i]);
+            psNorm += state.pathSigma[i] * state.pathSigma[i];
+        }
+        psNorm = std::sqrt(psNorm);
+        state.sigma *= std::exp((cSigma / dSigma) * (psNorm / chiN - 1.0));
+
+        // Covariance path and diagonal update
+        double decay = 1.0 - std::pow(1.0 - cSigma, 2.0 * (state.generation + 1));
+        bool hSigma = psNorm / std::sqrt(decay) < (1.4 + 2.0 / (n + 1.0)) * chiN;
+        for (int i = 0; i < n; ++i) {
+            state.pathC[i] = (1.0 - cc) * state.pathC[i] +
+                             (hSigma ? std::sqrt(cc * (2.0 - cc) * mueff) * yw[i] : 0.0);
+            double rankMu = 0.0;
+            for (int r = 0; r < mu; ++r) {
+                double yi = y[order[r] * n + i];
+                rankMu += recomb[r] * yi * yi;
+            }
+            state.diagC[i] = (1.0 - c1 - cMu) * state.diagC[i] +
+                             c1 * (state.pathC[i] * state.pathC[i] +
+                                   (hSigma ? 0.0 : cc * (2.0 - cc) * state.diagC[i])) +
+                             cMu * rankMu;
+        }
+
+        state.generation++;
+        state.rngState = rng();
+        rng.seed(state.rngState);
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double gamesPerSec = genSeconds > 0.0 ? candidates * opt.games / genSeconds : 0.0;
+        std::cout << std::setw(5) << state.generation << std::fixed << std::setprecision(1)
+                  << std::setw(10) << fitness[order[0]] << std::setw(10) << fitness[lambda]
+                  << std::setw(10) << std::setprecision(4) << state.sigma
+                  << std::setw(12) << std::setprecision(0) << gamesPerSec << std::endl;
+
+        if (log.is_open()) {
+            AIWeights m = weights[lambda];
+            log << state.generation << "," << elapsed << "," << fitness[order[0]] << ","
+                << fitness[lambda] << "," << state.sigma << "," << m.aggregateHeight << ","
+                << m.completeLines << "," << m.holes << "," << m.bumpiness << "\n";
+            log.flush();
+        }
+
+        saveCheckpoint(opt.checkpointPath, state);
+        saveAIWeights(opt.outPath, toWeights(state.mean));
+    }
+
+    // The distribution mean is the answer; single samples are too noisy
+    AIWeights best = toWeights(state.mean);
+    std::cout << std::setprecision(4) << "Mean scored " << state.meanLines << " lines per game: aggregateHeight "
+              << best.aggregateHeight << ", completeLines " << best.completeLines
+              << ", holes " << best.holes << ", bumpiness " << best.bumpiness << std::endl;
+    std::cout << "Weights written to " << opt.outPath << std::endl;
+    return 0;
+}
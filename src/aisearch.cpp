@@ -0,0 +1,516 @@
+// ============================================================================
+// Bot Search Engine: move generation and parallel beam search
+// ============================================================================
+
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include "tetrimoneblock.h"
+#include "aisearch.h"
+#include "threadpool.h"
+
+// Value given to a line of play that tops out
+static const double LOST_GAME = -1e9;
+
+AISearch::PieceMask AISearch::masks[AI_PIECE_TYPES][4];
+uint64_t AISearch::zobristRow[AI_MAX_GRID_HEIGHT][2][256];
+uint64_t AISearch::zobristDepth[64];
+
+AISearch::AISearch() {
+  ensureTables();
+  states.resize(4 * STATE_W * STATE_H);
+  table.reset(new TTSlot[1u << TT_BITS]);
+  for (uint32_t i = 0; i < (1u << TT_BITS); ++i) {
+    table[i].check.store(0, std::memory_order_relaxed);
+    table[i].value.store(0, std::memory_order_relaxed);
+  }
+}
+
+// Out of line so threadpool.h stays out of the header
+AISearch::~AISearch() {}
+
+int AISearch::getThreadCount() const {
+  if (threads > 0) return threads;
+  int cores = (int)std::thread::hardware_concurrency();
+  return cores > 0 ? cores : 1;
+}
+
+void AISearch::ensurePool() {
+  int wanted = getThreadCount();
+  if (!pool || pool->size() != wanted) {
+    pool.reset(new ThreadPool(wanted));
+    workers = std::vector<Worker>(wanted);
+  }
+}
+
+// ============================================================================
+// Tables
+// ============================================================================
+
+void AISearch::ensureTables() {
+  // Function-local static: built once, and thread safe for the tuner's workers
+  static const bool built = (buildTables(), true);
+  (void)built;
+}
+
+void AISearch::buildTables() {
+  for (int type = 0; type < AI_PIECE_TYPES; ++type) {
+    for (int rotation = 0; rotation < 4; ++rotation) {
+      PieceMask& m = masks[type][rotation];
+      m.rows[0] = m.rows[1] = m.rows[2] = m.rows[3] = 0;
+      m.minCol = 4;
+      m.maxCol = -1;
+
+      // Same fallback as TetrimoneBlock::getShape()
+      const auto& rotations = TETRIMONEBLOCK_SHAPES[type];
+      const auto& shape = rotations[rotation < (int)rotations.size() ? rotation : 0];
+      for (int y = 0; y < (int)shape.size() && y < 4; ++y) {
+        for (int x = 0; x < (int)shape[y].size() && x < 4; ++x) {
+          if (shape[y][x] == 1) {
+            m.rows[y] |= (uint8_t)(1u << x);
+            m.minCol = std::min(m.minCol, x);
+            m.maxCol = std::max(m.maxCol, x);
+          }
+        }
+      }
+    }
+  }
+
+  // Zobrist keys: one random key per cell, folded into per-byte tables so
+  // a row hashes with two lookups instead of one XOR per filled cell
+  std::mt19937_64 keys(0x7e7219013eULL);
+  for (int y = 0; y < AI_MAX_GRID_HEIGHT; ++y) {
+    uint64_t cellKey[AI_MAX_GRID_WIDTH];
+    for (int x = 0; x < AI_MAX_GRID_WIDTH; ++x) {
+      cellKey[x] = keys();
+    }
+    for (int half = 0; half < 2; ++half) {
+      for (int bits = 0; bits < 256; ++bits) {
+        uint64_t h = 0;
+        for (int i = 0; i < 8; ++i) {
+          if (bits & (1 << i)) h ^= cellKey[half * 8 + i];
+        }
+        zobristRow[y][half][bits] = h;
+      }
+    }
+  }
+  for (int d = 0; d < 64; ++d) {
+    zobristDepth[d] = keys();
+  }
+}
+
+uint64_t AISearch::hashBoard(const BitBoard& b) {
+  uint64_t h = 0;
+  for (int y = 0; y < b.height; ++y) {
+    uint16_t row = b.rows[y];
+    h ^= zobristRow[y][0][row & 0xFF] ^ zobristRow[y][1][row >> 8];
+  }
+  return h;
+}
+
+bool AISearch::probe(uint64_t key, double& value) const {
+  const TTSlot& slot = table[key & ((1u << TT_BITS) - 1)];
+  uint64_t bits = slot.value.load(std::memory_order_relaxed);
+  uint64_t check = slot.check.load(std::memory_order_relaxed);
+  if ((check ^ bits) != key) return false;
+  std::memcpy(&value, &bits, sizeof(value));
+  return true;
+}
+
+void AISearch::store(uint64_t key, double value) {
+  TTSlot& slot = table[key & ((1u << TT_BITS) - 1)];
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  slot.check.store(key ^ bits, std::memory_order_relaxed);
+  slot.value.store(bits, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Weights files
+// ============================================================================
+
+bool loadAIWeights(const std::string& path, AIWeights& weights) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  std::string name;
+  double value;
+  while (file >> name >> value) {
+    if (name == "aggregateHeight") weights.aggregateHeight = value;
+    else if (name == "completeLines") weights.completeLines = value;
+    else if (name == "holes") weights.holes = value;
+    else if (name == "bumpiness") weights.bumpiness = value;
+  }
+  return true;
+}
+
+bool saveAIWeights(const std::string& path, const AIWeights& weights) {
+  std::ofstream file(path, std::ios::trunc);
+  if (!file.is_open()) {
+    std::cerr << "Failed to open bot weights file for writing: " << path << std::endl;
+    return false;
+  }
+
+  file.precision(9);
+  file << "aggregateHeight " << weights.aggregateHeight << "\n"
+       << "completeLines " << weights.completeLines << "\n"
+       << "holes " << weights.holes << "\n"
+       << "bumpiness " << weights.bumpiness << "\n";
+  return file.good();
+}
+
+// ============================================================================
+// Bitboard helpers
+// ============================================================================
+
+/**
+ * Same rules as TetrimoneBoard::checkCollision(): walls and floor block,
+ * cells above the top of the grid are free.
+ */
+bool AISearch::fits(const BitBoard& b, int type, int rotation, int x, int y) {
+  const PieceMask& m = masks[type][rotation];
+  if (x + m.minCol < 0 || x + m.maxCol >= b.width) {
+    return false;
+  }
+  for (int r = 0; r < 4; ++r) {
+    if (!m.rows[r]) continue;
+    int gy = y + r;
+    if (gy >= b.height) return false;
+    if (gy < 0) continue;
+    uint32_t bits = x >= 0 ? (uint32_t)m.rows[r] << x : (uint32_t)m.rows[r] >> -x;
+    if (b.rows[gy] & bits) return false;
+  }
+  return true;
+}
+
+/**
+ * Lock a piece into the bitboard and remove completed rows.
+ * @return Number of lines cleared, or -1 if the piece locked above the grid
+ */
+int AISearch::place(BitBoard& b, int type, int rotation, int x, int y) {
+  const PieceMask& m = masks[type][rotation];
+  for (int r = 0; r < 4; ++r) {
+    if (!m.rows[r]) continue;
+    int gy = y + r;
+    if (gy < 0) return -1;
+    uint32_t bits = x >= 0 ? (uint32_t)m.rows[r] << x : (uint32_t)m.rows[r] >> -x;
+    b.rows[gy] |= (uint16_t)bits;
+  }
+
+  uint16_t full = b.fullMask();
+  int lines = 0;
+  int dst = b.height - 1;
+  for (int row = b.height - 1; row >= 0; --row) {
+    if (b.rows[row] == full) {
+      lines++;
+      continue;
+    }
+    b.rows[dst--] = b.rows[row];
+  }
+  while (dst >= 0) {
+    b.rows[dst--] = 0;
+  }
+  return lines;
+}
+
+double AISearch::evaluateWith(const AIWeights& weights, const BitBoard& b, int lines) {
+  int heights[AI_MAX_GRID_WIDTH] = {0};
+  uint16_t seen = 0;
+  int holes = 0;
+
+  for (int y = 0; y < b.height; ++y) {
+    uint16_t row = b.rows[y];
+    holes += __builtin_popcount(seen & (uint16_t)~row);
+    uint16_t firstSeen = row & (uint16_t)~seen;
+    while (firstSeen) {
+      int x = __builtin_ctz(firstSeen);
+      heights[x] = b.height - y;
+      firstSeen &= firstSeen - 1;
+    }
+    seen |= row;
+  }
+
+  int aggregateHeight = 0, bumpiness = 0;
+  for (int x = 0; x < b.width; ++x) {
+    aggregateHeight += heights[x];
+    if (x > 0) {
+      bumpiness += std::abs(heights[x] - heights[x - 1]);
+    }
+  }
+
+  return weights.aggregateHeight * aggregateHeight +
+         weights.completeLines * lines +
+         weights.holes * holes +
+         weights.bumpiness * bumpiness;
+}
+
+// ============================================================================
+// Move generation
+// ============================================================================
+
+/**
+ * Breadth-first search over (rotation, x, y) from the piece's current
+ * state using the same moves a player has: left, right, soft drop and
+ * both rotations. Every state that cannot move down is a placement, so
+ * tucks and spins under overhangs are found too.
+ */
+void AISearch::enumeratePlacements(const BitBoard& b, int type, int x, int y, int rotation,
+                                   std::vector<AIPlacement>& out) {
+  ++currentStamp;
+  queue.clear();
+
+  auto visit = [&](int r, int vx, int vy, int parent, Action action) {
+    if (!inStateRange(vx, vy)) return;
+    int idx = stateIndex(r, vx, vy);
+    StateInfo& info = states[idx];
+    if (info.stamp == currentStamp) return;
+    if (!fits(b, type, r, vx, vy)) return;
+    info.stamp = currentStamp;
+    info.parent = parent;
+    info.action = action;
+    queue.push_back(idx);
+  };
+
+  visit(rotation, x, y, -1, ACTION_NONE);
+
+  for (size_t head = 0; head < queue.size(); ++head) {
+    int idx = queue[head];
+    int sy = idx % STATE_H - Y_OFFSET;
+    int rest = idx / STATE_H;
+    int sx = rest % STATE_W - X_OFFSET;
+    int sr = rest / STATE_W;
+    nodesSearched++;
+
+    visit(sr, sx - 1, sy, idx, MOVE_LEFT);
+    visit(sr, sx + 1, sy, idx, MOVE_RIGHT);
+    visit(sr, sx, sy + 1, idx, MOVE_DOWN);
+    visit((sr + 1) & 3, sx, sy, idx, ROTATE_CW);
+    visit((sr + 3) & 3, sx, sy, idx, ROTATE_CCW);
+
+    if (!fits(b, type, sr, sx, sy + 1)) {
+      AIPlacement p;
+      p.x = sx;
+      p.y = sy;
+      p.rotation = sr;
+      p.score = 0.0;
+      p.valid = true;
+      out.push_back(p);
+    }
+  }
+}
+
+/**
+ * Cheaper enumeration for preview pieces: rotate at the spawn point,
+ * slide sideways, then drop straight down.
+ */
+void AISearch::enumerateDrops(const BitBoard& b, int type, std::vector<AIPlacement>& out) {
+  int spawnX = b.width / 2 - 2;
+
+  for (int rotation = 0; rotation < 4; ++rotation) {
+    bool reachable = true;
+    for (int r = 0; r <= rotation; ++r) {
+      if (!fits(b, type, r, spawnX, 0)) {
+        reachable = false;
+        break;
+      }
+    }
+    if (!reachable) break;
+
+    int minX = spawnX, maxX = spawnX;
+    while (fits(b, type, rotation, minX - 1, 0)) minX--;
+    while (fits(b, type, rotation, maxX + 1, 0)) maxX++;
+
+    for (int x = minX; x <= maxX; ++x) {
+      int y = 0;
+      while (fits(b, type, rotation, x, y + 1)) y++;
+      AIPlacement p;
+      p.x = x;
+      p.y = y;
+      p.rotation = rotation;
+      p.score = 0.0;
+      p.valid = true;
+      out.push_back(p);
+    }
+  }
+}
+
+AISearch::Action AISearch::firstActionTowards(const BitBoard& b, int type, int x, int y, int rotation,
+                                              const AIPlacement& goal, bool& onlyDropsLeft) {
+  onlyDropsLeft = false;
+
+  std::vector<AIPlacement> scratch;
+  enumeratePlacements(b, type, x, y, rotation, scratch);
+
+  if (!inStateRange(goal.x, goal.y)) return ACTION_NONE;
+  int idx = stateIndex(goal.rotation, goal.x, goal.y);
+  if (states[idx].stamp != currentStamp) return ACTION_NONE;
+
+  // Walk back to the root; the last action seen is the first to play
+  Action first = ACTION_NONE;
+  onlyDropsLeft = true;
+  while (states[idx].parent >= 0) {
+    first = (Action)states[idx].action;
+    if (first != MOVE_DOWN) onlyDropsLeft = false;
+    idx = states[idx].parent;
+  }
+  return first;
+}
+
+// ============================================================================
+// Search
+// ============================================================================
+
+bool AISearch::timeUp(Worker& w) {
+  if (timed && (w.nodes & 63) == 0 && !outOfTime.load(std::memory_order_relaxed) &&
+      std::chrono::steady_clock::now() > deadline) {
+    outOfTime.store(true, std::memory_order_relaxed);
+  }
+  return outOfTime.load(std::memory_order_relaxed);
+}
+
+/**
+ * Beam search below the root. Every drop of the piece at this ply is
+ * scored statically; only the beamWidth best are searched deeper. The
+ * value returned covers the lines cleared from this ply down, so it
+ * depends only on the board and the ply and can be shared through the
+ * transposition table by every thread.
+ */
+double AISearch::search(Worker& w, const BitBoard& b, int depth, int maxDepth) {
+  if (depth >= maxDepth) {
+    return evaluate(b, 0);
+  }
+
+  uint64_t key = hashBoard(b) ^ zobristDepth[depth] ^ zobristDepth[maxDepth + 32] ^ decisionSalt;
+  double cached;
+  if (probe(key, cached)) {
+    return cached;
+  }
+
+  int type = pieceTypes[depth];
+  std::vector<AIPlacement>& moves = w.moves[depth];
+  std::vector<std::pair<double, int>>& ranked = w.ranked[depth];
+  moves.clear();
+  ranked.clear();
+  enumerateDrops(b, type, moves);
+
+  bool leaf = depth + 1 >= maxDepth;
+  for (int i = 0; i < (int)moves.size(); ++i) {
+    w.nodes++;
+    BitBoard child = b;
+    int cleared = place(child, type, moves[i].rotation, moves[i].x, moves[i].y);
+    if (cleared < 0) continue;
+    ranked.push_back(std::make_pair(evaluate(child, cleared), i));
+  }
+
+  double best = LOST_GAME;
+  if (leaf) {
+    for (const auto& r : ranked) {
+      best = std::max(best, r.first);
+    }
+  } else {
+    int beam = std::min((int)ranked.size(), std::max(beamWidth, 1));
+    std::partial_sort(ranked.begin(), ranked.begin() + beam, ranked.end(),
+                      [](const std::pair<double, int>& a, const std::pair<double, int>& c) {
+                        return a.first > c.first;
+                      });
+    for (int i = 0; i < beam; ++i) {
+      // The lists for deeper plies get reused, so copy the move out first
+      AIPlacement m = moves[ranked[i].second];
+      BitBoard child = b;
+      int cleared = place(child, type, m.rotation, m.x, m.y);
+      double value = weights.completeLines * cleared + search(w, child, depth + 1, maxDepth);
+      best = std::max(best, value);
+      if (timeUp(w)) break;
+    }
+  }
+
+  if (!outOfTime.load(std::memory_order_relaxed)) {
+    store(key, best);
+  }
+  return best;
+}
+
+AIPlacement AISearch::choose(const BitBoard& b, int type, int x, int y, int rotation,
+                             const std::vector<int>& preview) {
+  AIPlacement best;
+  best.valid = false;
+  best.score = -1e18;
+
+  ensurePool();
+
+  pieceTypes.clear();
+  pieceTypes.push_back(type);
+  for (int next : preview) {
+    if ((int)pieceTypes.size() >= lookahead) break;
+    pieceTypes.push_back(next);
+  }
+  int maxDepth = std::min(std::max(lookahead, 1), (int)pieceTypes.size());
+
+  for (Worker& w : workers) {
+    w.nodes = 0;
+    w.moves.resize(maxDepth);
+    w.ranked.resize(maxDepth);
+  }
+
+  timed = budgetMs > 0.0;
+  deadline = std::chrono::steady_clock::now() +
+             std::chrono::microseconds((long long)(budgetMs * 1000.0));
+  outOfTime.store(false);
+  nodesSearched = 0;
+  lastDepth = 0;
+
+  // A new salt per decision retires the previous decision's entries,
+  // whose plies referred to different preview pieces
+  decisionSalt = decisionSalt * 6364136223846793005ULL + 1442695040888963407ULL;
+
+  std::vector<AIPlacement> roots;
+  enumeratePlacements(b, type, x, y, rotation, roots);
+  if (roots.empty()) return best;
+
+  std::vector<double> values(roots.size());
+
+  // Iterative deepening: depth 1 always completes, deeper passes only
+  // replace the answer if they finish inside the budget
+  for (int depth = 1; depth <= maxDepth; ++depth) {
+    pool->parallelFor((int)roots.size(), [&](int task, int worker) {
+      Worker& w = workers[worker];
+      const AIPlacement& root = roots[task];
+      w.nodes++;
+      if (depth > 1 && outOfTime.load(std::memory_order_relaxed)) {
+        values[task] = LOST_GAME;
+        return;
+      }
+      BitBoard child = b;
+      int cleared = place(child, type, root.rotation, root.x, root.y);
+      values[task] = cleared < 0 ? LOST_GAME * 1000.0
+                                 : weights.completeLines * cleared + search(w, child, 1, depth);
+    });
+
+    if (depth > 1 && outOfTime.load()) break;
+
+    AIPlacement iterBest;
+    iterBest.valid = false;
+    for (size_t i = 0; i < roots.size(); ++i) {
+      if (!iterBest.valid || values[i] > iterBest.score) {
+        iterBest = roots[i];
+        iterBest.score = values[i];
+        iterBest.valid = true;
+      }
+    }
+    best = iterBest;
+    lastDepth = depth;
+    if (timed && std::chrono::steady_clock::now() > deadline) break;
+  }
+
+  for (const Worker& w : workers) {
+    nodesSearched += w.nodes;
+  }
+  return best;
+}
@@ -0,0 +1,193 @@
+#ifndef AISEARCH_H
+#define AISEARCH_H
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <cstdint>
+#include <string>
+
+class ThreadPool;
+
+// ============================================================================
+// Bot search engine: bitboards, move generation and parallel beam search
+//
+// Kept free of the board / GUI headers so the offline tools (ai_bench) can
+// link it on its own.
+// ============================================================================
+
+// Must match MAX_GRID_WIDTH / MAX_GRID_HEIGHT in tetrimone_core.h
+const int AI_MAX_GRID_WIDTH = 16;
+const int AI_MAX_GRID_HEIGHT = 30;
+const int AI_PIECE_TYPES = 14;
+
+/**
+ * Heuristic weights used to score a board after a placement.
+ * Defaults are the well known four-feature weights (height, lines,
+ * holes, bumpiness) and play a solid, if unspectacular, game.
+ */
+struct AIWeights {
+    double aggregateHeight = -0.510066;
+    double completeLines = 0.760666;
+    double holes = -0.35663;
+    double bumpiness = -0.184483;
+};
+
+/**
+ * Occupancy-only copy of the playfield. Bit x of rows[y] is set when the
+ * cell (x, y) is filled, so collision against a piece is a handful of ANDs.
+ */
+struct BitBoard {
+    uint16_t rows[AI_MAX_GRID_HEIGHT];
+    int width, height;
+
+    void clear(int w, int h) {
+        width = w;
+        height = h;
+        for (int y = 0; y < AI_MAX_GRID_HEIGHT; ++y) rows[y] = 0;
+    }
+    uint16_t fullMask() const { return (uint16_t)((1u << width) - 1); }
+};
+
+struct AIPlacement {
+    int x, y, rotation;
+    double score;
+    bool valid;
+};
+
+/**
+ * Read / write heuristic weights as "name value" lines.
+ * Unknown names are ignored and missing ones keep their current value.
+ * @return true on success
+ */
+bool loadAIWeights(const std::string& path, AIWeights& weights);
+bool saveAIWeights(const std::string& path, const AIWeights& weights);
+
+class AISearch {
+public:
+    enum Action : uint8_t {
+        ACTION_NONE, MOVE_LEFT, MOVE_RIGHT, MOVE_DOWN, ROTATE_CW, ROTATE_CCW
+    };
+
+    AIWeights weights;
+    int lookahead = 4;        // Pieces searched: current piece plus (lookahead - 1) previews
+    int beamWidth = 4;        // Best-looking placements expanded below the root, per ply
+    double budgetMs = 8.0;    // Search time allowed per decision, <= 0 for no limit
+    int threads = 0;          // Search threads including the caller, 0 = one per core
+
+    AISearch();
+    ~AISearch();
+
+    /**
+     * Pick the best resting place for a piece.
+     *
+     * Every placement reachable from the piece's current state is a root;
+     * roots are shared out across the thread pool and each is scored by a
+     * beam search over the preview pieces. Deepening stops when the budget
+     * runs out, keeping the result of the last completed depth.
+     *
+     * @param b Board to analyse
+     * @param type Piece type
+     * @param x Piece column
+     * @param y Piece row
+     * @param rotation Piece rotation
+     * @param preview Upcoming piece types, next piece first
+     * @return Chosen placement; valid is false when the piece cannot be placed
+     */
+    AIPlacement choose(const BitBoard& b, int type, int x, int y, int rotation,
+                       const std::vector<int>& preview);
+
+    /**
+     * First move to play to get a piece from its current state to goal.
+     * @param onlyDropsLeft Set when the rest of the path is soft drops
+     * @return ACTION_NONE if goal is no longer reachable
+     */
+    Action firstActionTowards(const BitBoard& b, int type, int x, int y, int rotation,
+                              const AIPlacement& goal, bool& onlyDropsLeft);
+
+    long getNodesSearched() const { return nodesSearched; }
+    int getLastDepth() const { return lastDepth; }
+    int getThreadCount() const;
+
+    // Bitboard helpers (static so other tools can reuse them)
+    static bool fits(const BitBoard& b, int type, int rotation, int x, int y);
+    static int place(BitBoard& b, int type, int rotation, int x, int y);
+    double evaluate(const BitBoard& b, int lines) const { return evaluateWith(weights, b, lines); }
+    static double evaluateWith(const AIWeights& w, const BitBoard& b, int lines);
+
+private:
+    struct PieceMask {
+        uint8_t rows[4];
+        int minCol, maxCol;
+    };
+    static PieceMask masks[AI_PIECE_TYPES][4];
+    static uint64_t zobristRow[AI_MAX_GRID_HEIGHT][2][256];
+    static uint64_t zobristDepth[64];
+    static void ensureTables();
+    static void buildTables();
+    static uint64_t hashBoard(const BitBoard& b);
+
+    // Move generation state, stamped per search instead of cleared
+    static const int X_OFFSET = 4, Y_OFFSET = 4;
+    static const int STATE_W = AI_MAX_GRID_WIDTH + 2 * X_OFFSET;
+    static const int STATE_H = AI_MAX_GRID_HEIGHT + 2 * Y_OFFSET;
+    struct StateInfo {
+        uint32_t stamp;
+        int32_t parent;
+        uint8_t action;
+    };
+    std::vector<StateInfo> states;
+    std::vector<int> queue;
+    uint32_t currentStamp = 0;
+
+    static int stateIndex(int rotation, int x, int y) {
+        return (rotation * STATE_W + (x + X_OFFSET)) * STATE_H + (y + Y_OFFSET);
+    }
+    static bool inStateRange(int x, int y) {
+        return x >= -X_OFFSET && x < AI_MAX_GRID_WIDTH + X_OFFSET &&
+               y >= -Y_OFFSET && y < AI_MAX_GRID_HEIGHT + Y_OFFSET;
+    }
+
+    /**
+     * Shared transposition table. Lockless: each slot stores key ^ value
+     * next to the value, so a slot torn by two threads writing at once just
+     * fails the check and reads as a miss.
+     */
+    struct TTSlot {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> value;
+    };
+    static const int TT_BITS = 18;
+    std::unique_ptr<TTSlot[]> table;
+    uint64_t decisionSalt = 0;  // Mixed into every key so old entries never match
+
+    bool probe(uint64_t key, double& value) const;
+    void store(uint64_t key, double value);
+
+    // Per-thread scratch, padded so counters do not share cache lines
+    struct alignas(64) Worker {
+        std::vector<std::vector<AIPlacement>> moves;   // One list per ply
+        std::vector<std::vector<std::pair<double, int>>> ranked;
+        long nodes = 0;
+    };
+    std::vector<Worker> workers;
+    std::unique_ptr<ThreadPool> pool;
+
+    // Per-decision search state
+    std::vector<int> pieceTypes;
+    std::chrono::steady_clock::time_point deadline;
+    bool timed = false;
+    std::atomic<bool> outOfTime{false};
+    long nodesSearched = 0;
+    int lastDepth = 0;
+
+    void ensurePool();
+    void enumeratePlacements(const BitBoard& b, int type, int x, int y, int rotation,
+                             std::vector<AIPlacement>& out);
+    static void enumerateDrops(const BitBoard& b, int type, std::vector<AIPlacement>& out);
+    double search(Worker& w, const BitBoard& b, int depth, int maxDepth);
+    bool timeUp(Worker& w);
+};
+
+#endif // AISEARCH_H
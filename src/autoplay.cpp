@@ -0,0 +1,294 @@
+// ============================================================================
+// Built-in Bot: board glue and demo mode
+// ============================================================================
+
+#ifdef GTK3
+#include "tetrimone_gtk.h"
+#endif
+
+#ifdef QT5
+#include "tetrimone_qt5.h"
+#endif
+
+#ifdef KIOSK
+#include "tetrimone_kiosk.h"
+#include "kiosk_timers.h"
+#endif
+
+#include "autoplay.h"
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+
+// Delay between bot moves, so the demo is watchable
+static const int AUTOPLAY_STEP_MS = 60;
+// Idle time on the splash / game over screen before the demo starts
+static const int DEMO_IDLE_MS = 30000;
+// Pause on a finished demo game before the next one starts
+static const int DEMO_RESTART_MS = 3000;
+
+static_assert(AI_MAX_GRID_WIDTH == MAX_GRID_WIDTH && AI_MAX_GRID_HEIGHT == MAX_GRID_HEIGHT,
+              "aisearch.h grid limits are out of step with tetrimone_core.h");
+
+// Defined in saveloadsettings.cpp
+std::string getConfigDirectory();
+
+AutoPlayer::AutoPlayer() {
+  target.valid = false;
+
+  // Weights written by the offline tuner (make ai-tune), if the player has any
+  std::string weightsPath = getConfigDirectory() +
+#ifdef _WIN32
+                            "\\"
+#else
+                            "/"
+#endif
+                            "bot_weights.txt";
+  if (loadAIWeights(weightsPath, engine.weights)) {
+    std::cout << "Loaded bot weights from " << weightsPath << std::endl;
+  }
+}
+
+void AutoPlayer::reset() {
+  plannedSerial = -1;
+  plannedDuringClear = false;
+  target.valid = false;
+}
+
+void AutoPlayer::loadBitBoard(const TetrimoneBoard& board, BitBoard& out) {
+  out.clear(GRID_WIDTH, GRID_HEIGHT);
+  for (int y = 0; y < GRID_HEIGHT; ++y) {
+    uint16_t bits = 0;
+    for (int x = 0; x < GRID_WIDTH; ++x) {
+      if (board.getGridValue(x, y) != 0) {
+        bits |= (uint16_t)(1u << x);
+      }
+    }
+    out.rows[y] = bits;
+  }
+}
+
+AutoPlayer::Placement AutoPlayer::choosePlacement(const TetrimoneBoard& board) {
+  Placement none;
+  none.valid = false;
+  none.score = 0.0;
+
+  const TetrimoneBlock* piece = board.getCurrentPiece();
+  if (!piece) return none;
+
+  BitBoard b;
+  loadBitBoard(board, b);
+
+  preview.clear();
+  for (const auto& next : board.getNextPieces()) {
+    preview.push_back(next->getType());
+  }
+
+  return engine.choose(b, piece->getType(), piece->getX(), piece->getY(),
+                       piece->getRotation(), preview);
+}
+
+bool AutoPlayer::step(TetrimoneBoard& board) {
+  if (board.isGameOver() || board.isPaused() || board.isSplashScreenActive()) {
+    return false;
+  }
+  const TetrimoneBlock* piece = board.getCurrentPiece();
+  if (!piece) return false;
+
+  // Re-plan on every new piece, and once more if we planned while cleared
+  // rows were still sitting in the grid
+  bool replan = plannedSerial != board.getPieceSerial() ||
+                (plannedDuringClear && !board.isLineClearActive());
+
+  BitBoard b;
+  loadBitBoard(board, b);
+  bool onlyDrops = false;
+  Action action = AISearch::ACTION_NONE;
+
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    if (replan) {
+      target = choosePlacement(board);
+      plannedSerial = board.getPieceSerial();
+      plannedDuringClear = board.isLineClearActive();
+    }
+    if (!target.valid) break;
+
+    action = engine.firstActionTowards(b, piece->getType(), piece->getX(), piece->getY(),
+                                       piece->getRotation(), target, onlyDrops);
+    if (action != AISearch::ACTION_NONE || onlyDrops) break;
+
+    // Gravity carried the piece past the plan; pick again from here
+    replan = true;
+  }
+
+  if (!onlyDrops) {
+    switch (action) {
+      case AISearch::MOVE_LEFT:
+        board.movePiece(-1, 0);
+        return true;
+      case AISearch::MOVE_RIGHT:
+        board.movePiece(1, 0);
+        return true;
+      case AISearch::MOVE_DOWN:
+        board.movePiece(0, 1);
+        return true;
+      case AISearch::ROTATE_CW:
+        board.rotatePiece(true);
+        return true;
+      case AISearch::ROTATE_CCW:
+        board.rotatePiece(false);
+        return true;
+      default:
+        break;
+    }
+  }
+
+  // Only soft drops left (or nothing better to do): finish the piece
+  board.hardDrop();
+  return true;
+}
+
+// ============================================================================
+// Demo / attract mode glue
+// ============================================================================
+
+static void startDemoGame(TetrimoneApp* app) {
+  app->autoPlayActive = true;
+  app->autoPlayer->reset();
+  if (app->board->isSplashScreenActive()) {
+    app->board->dismissSplashScreen();
+  }
+#ifdef GTK3
+  onRestartGame(nullptr, app);
+#endif
+#ifdef QT5
+  startGame(app);
+#endif
+#ifdef KIOSK
+  onRestartGame(app);
+#endif
+}
+
+static void autoPlayTick(TetrimoneApp* app) {
+  TetrimoneBoard* board = app->board;
+  auto now = std::chrono::steady_clock::now();
+
+  if (app->autoPlayActive) {
+    if (board->isGameOver()) {
+      if (app->demoMode) {
+        // Let the idle check start the next game after a short pause
+        app->autoPlayActive = false;
+        app->lastInputTime = now - std::chrono::milliseconds(DEMO_IDLE_MS - DEMO_RESTART_MS);
+      } else {
+        stopAutoPlay(app);
+      }
+      return;
+    }
+    if (app->autoPlayer->step(*board)) {
+      updateDisplay(app);
+      updateLabels(app);
+    }
+    return;
+  }
+
+  if (app->demoMode && (board->isSplashScreenActive() || board->isGameOver())) {
+    auto idleMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - app->lastInputTime).count();
+    if (idleMs >= DEMO_IDLE_MS) {
+      startDemoGame(app);
+    }
+  }
+}
+
+static void ensureAutoPlayTimer(TetrimoneApp* app) {
+  if (!app->autoPlayer) {
+    app->autoPlayer = new AutoPlayer();
+  }
+#if defined(GTK3) || defined(KIOSK)
+  if (app->autoplayTimerId == 0) {
+    app->autoplayTimerId = g_timeout_add(AUTOPLAY_STEP_MS,
+        [](gpointer userData) -> gboolean {
+          TetrimoneApp* app = static_cast<TetrimoneApp*>(userData);
+          autoPlayTick(app);
+          return app->autoplayTimerId != 0;
+        }, app);
+  }
+#endif
+#ifdef QT5
+  if (!app->autoplayTimer) {
+    app->autoplayTimer = new QTimer(app->window);
+    QObject::connect(app->autoplayTimer, &QTimer::timeout, [app]() {
+      autoPlayTick(app);
+    });
+    app->autoplayTimer->start(AUTOPLAY_STEP_MS);
+  }
+#endif
+}
+
+/**
+ * Hand the current game to the bot.
+ */
+void startAutoPlay(TetrimoneApp* app) {
+  ensureAutoPlayTimer(app);
+  app->autoPlayer->reset();
+  app->autoPlayActive = true;
+  std::cout << "Autoplay ON" << std::endl;
+}
+
+/**
+ * Give control back to the player. The timer keeps running in demo mode
+ * so the idle check can start the next demo.
+ */
+void stopAutoPlay(TetrimoneApp* app) {
+  app->autoPlayActive = false;
+  if (app->demoMode) {
+    return;
+  }
+#if defined(GTK3) || defined(KIOSK)
+  if (app->autoplayTimerId > 0) {
+    g_source_remove(app->autoplayTimerId);
+    app->autoplayTimerId = 0;
+  }
+#endif
+#ifdef QT5
+  if (app->autoplayTimer) {
+    app->autoplayTimer->stop();
+    app->autoplayTimer->deleteLater();
+    app->autoplayTimer = nullptr;
+  }
+#endif
+  std::cout << "Autoplay OFF" << std::endl;
+}
+
+bool isAutoPlayActive(TetrimoneApp* app) {
+  return app && app->autoPlayActive;
+}
+
+/**
+ * Attract mode: the bot plays whenever the game has sat idle on the
+ * splash or game over screen for a while.
+ */
+void enableDemoMode(TetrimoneApp* app) {
+  app->demoMode = true;
+  app->lastInputTime = std::chrono::steady_clock::now();
+  ensureAutoPlayTimer(app);
+}
+
+/**
+ * Note player input. In demo mode a key press during a bot game ends the
+ * demo and returns to the splash screen.
+ * @return true if the key was consumed
+ */
+bool autoPlayHandleInput(TetrimoneApp* app) {
+  app->lastInputTime = std::chrono::steady_clock::now();
+
+  if (!app->demoMode || !app->autoPlayActive) {
+    return false;
+  }
+
+  app->autoPlayActive = false;
+  app->board->restart();
+  app->board->setSplashScreenActive(true);
+  updateDisplay(app);
+  updateLabels(app);
+  return true;
+}
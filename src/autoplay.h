@@ -0,0 +1,63 @@
+#ifndef AUTOPLAY_H
+#define AUTOPLAY_H
+
+#include <vector>
+#include "tetrimone_core.h"
+#include "aisearch.h"
+
+// ============================================================================
+// Built-in bot: drives the board using the search engine in aisearch.h
+// ============================================================================
+
+class AutoPlayer {
+public:
+    typedef AISearch::Action Action;
+    typedef AIPlacement Placement;
+
+    AISearch engine;    // Search settings (lookahead, beam, budget, threads) live here
+
+    AutoPlayer();
+
+    /**
+     * Pick the best resting place for the current piece, looking ahead
+     * through the board's preview queue.
+     * @param board Board to analyse (not modified)
+     * @return Chosen placement; valid is false when the piece cannot be placed
+     */
+    Placement choosePlacement(const TetrimoneBoard& board);
+
+    /**
+     * Advance the current piece by one move towards the chosen placement,
+     * using the board's own movePiece / rotatePiece / hardDrop.
+     * @param board Board to drive
+     * @return false if there was nothing to do (paused, game over, splash)
+     */
+    bool step(TetrimoneBoard& board);
+
+    /**
+     * Forget the current plan, e.g. after the player takes over.
+     */
+    void reset();
+
+    long getNodesSearched() const { return engine.getNodesSearched(); }
+    int getLastDepth() const { return engine.getLastDepth(); }
+
+    static void loadBitBoard(const TetrimoneBoard& board, BitBoard& out);
+
+private:
+    std::vector<int> preview;
+
+    // Current plan
+    Placement target;
+    int plannedSerial = -1;
+    bool plannedDuringClear = false;
+};
+
+// Demo / attract mode glue (framework-specific timers live in autoplay.cpp)
+void startAutoPlay(TetrimoneApp* app);
+void stopAutoPlay(TetrimoneApp* app);
+bool isAutoPlayActive(TetrimoneApp* app);
+void enableDemoMode(TetrimoneApp* app);
+bool autoPlayHandleInput(TetrimoneApp* app);
+
+#endif // AUTOPLAY_H
@@ -1,4 +1,11 @@
+#ifdef GTK3
 #include "tetrimone_gtk.h"
+#endif
+
+#ifdef KIOSK
+#include "tetrimone_kiosk.h"
+#endif
+
 #include <iostream>
 #include <string>
 #include "zip.h"
@@ -10,6 +17,7 @@
 #include <direct.h>
 #endif
 
+#ifdef GTK3
 // Update the background toggle handler to handle ZIP mode
 void onBackgroundToggled(GtkCheckMenuItem* menuItem, gpointer userData) {
     TetrimoneApp* app = static_cast<TetrimoneApp*>(userData);
@@ -26,16 +34,19 @@ void onBackgroundToggled(GtkCheckMenuItem* menuItem, gpointer userData) {
     // Redraw the game area
     updateDisplay(app);
 }
+#endif
 
 void drawBackground(cairo_t *cr, TetrimoneBoard *board, int width, int height) {
+  Profiler::Scope scope("drawBackground");
   // Draw solid background color
   cairo_set_source_rgb(cr, 0.1, 0.1, 0.1);
   cairo_rectangle(cr, 0, 0, width, height);
   cairo_fill(cr);
 
-  // Draw background image if enabled
+  // Draw background image if enabled and the effect budget allows it
+  const QualityGovernor::Budget &budget = qualityGovernor.budget();
   if ((board->isUsingBackgroundImage() || board->isUsingBackgroundZip()) &&
-      board->getBackgroundImage() != nullptr) {
+      board->getBackgroundImage() != nullptr && budget.backgroundImage) {
     // Save the current state
     cairo_save(cr);
 
@@ -118,6 +129,7 @@ void drawBackground(cairo_t *cr, TetrimoneBoard *board, int width, int height) {
 
       // Draw the image with normal opacity
       cairo_set_source_surface(cr, board->getBackgroundImage(), 0, 0);
+      cairo_pattern_set_filter(cairo_get_source(cr), budget.backgroundFilter);
       cairo_paint_with_alpha(cr, board->getBackgroundOpacity());
     }
 
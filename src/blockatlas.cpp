@@ -0,0 +1,184 @@
+// ============================================================================
+// Block Sprite Atlas for the Cairo renderer (Framework-Agnostic)
+// ============================================================================
+
+#include "tetrimone_core.h"
+#include "blockatlas.h"
+#include <cmath>
+#include <iostream>
+
+BlockAtlas blockAtlas;
+
+bool BlockAtlas::Key::operator==(const Key &other) const {
+  return blockSize == other.blockSize && paletteHash == other.paletteHash &&
+         heatStep == other.heatStep &&
+         retro == other.retro && simple == other.simple && pixelScale == other.pixelScale;
+}
+
+BlockAtlas::BlockAtlas() : surface(nullptr), valid(false), cellSize(0) {}
+
+BlockAtlas::~BlockAtlas() {
+  if (surface) {
+    cairo_surface_destroy(surface);
+  }
+}
+
+void BlockAtlas::prepare(cairo_t *cr, TetrimoneBoard *board) {
+  Style style;
+  style.palette = &board->getPalette();
+  style.blockSize = BLOCK_SIZE;
+  style.heatLevel = board->getHeatLevel();
+  style.retro = board->retroModeActive;
+  style.simple = board->simpleBlocksActive;
+  prepare(cr, style);
+}
+
+void BlockAtlas::prepare(cairo_t *cr, const Style &style) {
+  // Render at device resolution so a scaled context (Qt) stays sharp
+  double sx = 1.0, sy = 1.0;
+  cairo_user_to_device_distance(cr, &sx, &sy);
+  double pixelScale = std::round(std::fabs(sx) * 100.0) / 100.0;
+  if (pixelScale <= 0.0) pixelScale = 1.0;
+
+  Key wanted;
+  wanted.blockSize = style.blockSize;
+  wanted.paletteHash = style.palette->getColorHash();
+  wanted.heatStep = (int)std::lround(style.heatLevel * HEAT_STEPS);
+  wanted.retro = style.retro;
+  wanted.simple = style.simple;
+  wanted.pixelScale = pixelScale;
+
+  if (valid && surface && key == wanted) {
+    return;
+  }
+  key = wanted;
+  rebuild(*style.palette);
+}
+
+// Fill the cell with a bevelled block: flat face, light top-left, dark bottom-right
+static void drawBevelBlock(cairo_t *cr, double x, double y, double size,
+                           const std::array<double, 3> &color, double bevelAlpha) {
+  cairo_set_source_rgb(cr, color[0], color[1], color[2]);
+  cairo_rectangle(cr, x + 1, y + 1, size - 2, size - 2);
+  cairo_fill(cr);
+
+  cairo_set_source_rgba(cr, 1, 1, 1, bevelAlpha);
+  cairo_move_to(cr, x + 1, y + 1);
+  cairo_line_to(cr, x + size - 1, y + 1);
+  cairo_line_to(cr, x + 1, y + size - 1);
+  cairo_close_path(cr);
+  cairo_fill(cr);
+
+  cairo_set_source_rgba(cr, 0, 0, 0, bevelAlpha);
+  cairo_move_to(cr, x + size - 1, y + 1);
+  cairo_line_to(cr, x + size - 1, y + size - 1);
+  cairo_line_to(cr, x + 1, y + size - 1);
+  cairo_close_path(cr);
+  cairo_fill(cr);
+}
+
+static void drawFlatBlock(cairo_t *cr, double x, double y, double size,
+                          const std::array<double, 3> &color) {
+  cairo_set_source_rgb(cr, color[0], color[1], color[2]);
+  cairo_rectangle(cr, x, y, size, size);
+  cairo_fill(cr);
+}
+
+void BlockAtlas::rebuild(const ThemePalette &palette) {
+  if (surface) {
+    cairo_surface_destroy(surface);
+    surface = nullptr;
+  }
+
+  const int types = palette.size();
+  cellSize = key.blockSize + 2 * PAD;
+  int pixelW = (int)std::ceil(cellSize * types * key.pixelScale);
+  int pixelH = (int)std::ceil(cellSize * ROW_COUNT * key.pixelScale);
+
+  surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, pixelW, pixelH);
+  if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+    std::cerr << "Failed to create block atlas surface" << std::endl;
+    cairo_surface_destroy(surface);
+    surface = nullptr;
+    valid = false;
+    return;
+  }
+  cairo_surface_set_device_scale(surface, key.pixelScale, key.pixelScale);
+
+  const double size = key.blockSize;
+  const bool flat = key.retro || key.simple;
+  const float heat = (float)key.heatStep / HEAT_STEPS;
+
+  cairo_t *cr = cairo_create(surface);
+  cairo_set_line_width(cr, 1.0);
+
+  for (int type = 0; type < types; ++type) {
+    double x = type * cellSize + PAD;
+
+    // Same colour choices the direct drawing code used
+    const std::array<double, 3> &themeColor = palette.themeColor(type);
+    const std::array<double, 3> &liveColor = palette.color(type);
+    std::array<double, 3> heatColor = getHeatModifiedColor(liveColor, heat);
+
+    // Placed blocks
+    double y = ROW_PLACED * cellSize + PAD;
+    if (flat) drawFlatBlock(cr, x, y, size, heatColor);
+    else drawBevelBlock(cr, x, y, size, heatColor, 0.3);
+
+    // Falling piece
+    y = ROW_PIECE * cellSize + PAD;
+    if (flat) drawFlatBlock(cr, x, y, size, liveColor);
+    else drawBevelBlock(cr, x, y, size, liveColor, 0.3);
+
+    // Ghost piece: translucent outline (retro) or outlined translucent face
+    y = ROW_GHOST * cellSize + PAD;
+    cairo_set_source_rgba(cr, themeColor[0], themeColor[1], themeColor[2], 0.3);
+    if (key.retro) {
+      cairo_rectangle(cr, x, y, size, size);
+      cairo_stroke(cr);
+    } else {
+      cairo_rectangle(cr, x + 1, y + 1, size - 2, size - 2);
+      cairo_stroke_preserve(cr);
+      cairo_fill(cr);
+    }
+
+    // Trails are faded per trail when drawn, so they are stored opaque
+    y = ROW_TRAIL * cellSize + PAD;
+    if (key.simple) drawFlatBlock(cr, x, y, size, themeColor);
+    else drawBevelBlock(cr, x, y, size, themeColor, 0.1);
+  }
+
+  cairo_destroy(cr);
+  cairo_surface_flush(surface);
+  valid = true;
+}
+
+void BlockAtlas::draw(cairo_t *cr, Row row, int type, double x, double y) const {
+  if (!surface || !valid) return;
+
+  double srcX = type * cellSize + PAD;
+  double srcY = row * cellSize + PAD;
+  cairo_set_source_surface(cr, surface, x - srcX, y - srcY);
+  cairo_rectangle(cr, x - PAD, y - PAD, cellSize, cellSize);
+  cairo_fill(cr);
+}
+
+void BlockAtlas::drawScaled(cairo_t *cr, Row row, int type, double x, double y,
+                            double scale, double alpha) const {
+  if (!surface || !valid || scale <= 0.0 || alpha <= 0.0) return;
+  if (scale == 1.0 && alpha >= 1.0) {
+    draw(cr, row, type, x, y);
+    return;
+  }
+
+  double srcX = type * cellSize + PAD;
+  double srcY = row * cellSize + PAD;
+  cairo_save(cr);
+  cairo_translate(cr, x, y);
+  cairo_scale(cr, scale, scale);
+  cairo_set_source_surface(cr, surface, -srcX, -srcY);
+  cairo_rectangle(cr, -PAD, -PAD, cellSize, cellSize);
+  cairo_clip(cr);
+  cairo_paint_with_alpha(cr, alpha);
+  cairo_restore(cr);
+}
@@ -0,0 +1,101 @@
+#ifndef BLOCKATLAS_H
+#define BLOCKATLAS_H
+
+#include <cairo/cairo.h>
+#include <cstdint>
+
+class TetrimoneBoard;
+class ThemePalette;
+
+/**
+ * Pre-rendered block sprites for the Cairo renderer.
+ *
+ * Every block type is drawn once per style into a single image surface
+ * (one row per style, one column per block type). Drawing a cell is then
+ * a single blit instead of a fill plus highlight and shadow paths.
+ *
+ * The atlas rebuilds itself from prepare() when anything it was drawn
+ * with changes: the palette's colours (theme or transition step),
+ * BLOCK_SIZE, block style, device scale or the (quantized) heat tint of
+ * placed blocks.
+ */
+class BlockAtlas {
+public:
+    enum Row {
+        ROW_PLACED,   // Locked cells: theme colour with heat tint
+        ROW_PIECE,    // Falling piece: theme colour
+        ROW_GHOST,    // Ghost piece outline
+        ROW_TRAIL,    // Block trails, faded at draw time
+        ROW_COUNT
+    };
+
+    // Everything the sprites are drawn from
+    struct Style {
+        const ThemePalette *palette;
+        int blockSize;
+        float heatLevel;
+        bool retro;
+        bool simple;
+    };
+
+    BlockAtlas();
+    ~BlockAtlas();
+
+    /**
+     * Make sure the sprites match the board's current look.
+     * Cheap when nothing changed; call once per draw function.
+     * @param cr Context that will be drawn to (used for its device scale)
+     * @param board Board supplying theme, heat and style
+     */
+    void prepare(cairo_t *cr, TetrimoneBoard *board);
+
+    /**
+     * Same, from an explicit style instead of the live board, so an atlas
+     * owned by another thread never touches the board or BLOCK_SIZE.
+     */
+    void prepare(cairo_t *cr, const Style &style);
+
+    /**
+     * Blit one block with its top-left corner at (x, y).
+     * @param row Sprite style
+     * @param type Block type (0-13)
+     */
+    void draw(cairo_t *cr, Row row, int type, double x, double y) const;
+
+    /**
+     * Blit one block scaled about its top-left corner and faded.
+     */
+    void drawScaled(cairo_t *cr, Row row, int type, double x, double y,
+                    double scale, double alpha) const;
+
+    /**
+     * Drop the sprites; the next prepare() redraws them.
+     */
+    void invalidate() { valid = false; }
+
+private:
+    struct Key {
+        int blockSize;
+        uint64_t paletteHash;        // Colours, whichever palette they come from
+        int heatStep;
+        bool retro;
+        bool simple;
+        double pixelScale;
+
+        bool operator==(const Key &other) const;
+    };
+
+    static const int PAD = 1;        // Room around each sprite for outlines
+    static const int HEAT_STEPS = 64;
+
+    cairo_surface_t *surface;
+    Key key;
+    bool valid;
+    int cellSize;                    // Sprite cell in user units, including padding
+
+    void rebuild(const ThemePalette &palette);
+};
+
+extern BlockAtlas blockAtlas;
+
+#endif // BLOCKATLAS_H
@@ -0,0 +1,267 @@
+// ============================================================================
+// Board layer render thread for the Cairo renderer (Framework-Agnostic)
+// ============================================================================
+
+#include "tetrimone_core.h"
+#include "boardlayer.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+bool BoardLayerSnapshot::sameGeometry(const BoardLayerSnapshot &other) const {
+  return width == other.width && height == other.height && pixelScale == other.pixelScale &&
+         blockSize == other.blockSize && gridWidth == other.gridWidth &&
+         gridHeight == other.gridHeight;
+}
+
+bool BoardLayerSnapshot::sameAs(const BoardLayerSnapshot &other) const {
+  if (!sameGeometry(other) || cells != other.cells) {
+    return false;
+  }
+  if (palette.getVersion() != other.palette.getVersion() || heatLevel != other.heatLevel ||
+      heatEffects != other.heatEffects || retro != other.retro || simple != other.simple ||
+      showGridLines != other.showGridLines || effectLevel != other.effectLevel) {
+    return false;
+  }
+  if (background != other.background || backgroundOpacity != other.backgroundOpacity) {
+    return false;
+  }
+  // The clock only matters while the effects animate
+  return !heatEffects || timeMs == other.timeMs;
+}
+
+BoardLayerRenderer::BoardLayerRenderer()
+    : running(false), hasPending(false), front(-1), generation(0), hasSubmitted(false) {}
+
+BoardLayerRenderer::~BoardLayerRenderer() {
+  stop();
+  for (Buffer &buffer : buffers) {
+    if (buffer.surface) {
+      cairo_surface_destroy(buffer.surface);
+    }
+  }
+}
+
+void BoardLayerRenderer::start(std::function<void()> callback) {
+  if (worker.joinable()) {
+    return;
+  }
+  frameReady = callback;
+  running = true;
+  worker = std::thread(&BoardLayerRenderer::run, this);
+}
+
+void BoardLayerRenderer::stop() {
+  if (!worker.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    running = false;
+    hasPending = false;
+  }
+  wake.notify_one();
+  worker.join();
+}
+
+void BoardLayerRenderer::submit(const BoardLayerSnapshot &snapshot) {
+  if (!worker.joinable() || (hasSubmitted && submitted.sameAs(snapshot))) {
+    return;
+  }
+  submitted = snapshot;
+  hasSubmitted = true;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending = snapshot;
+    hasPending = true;
+  }
+  wake.notify_one();
+}
+
+void BoardLayerRenderer::discard() {
+  std::lock_guard<std::mutex> lock(mutex);
+  front = -1;
+  hasPending = false;
+  ++generation;
+  hasSubmitted = false;
+}
+
+bool BoardLayerRenderer::paint(cairo_t *cr, const BoardLayerSnapshot &wanted,
+                               std::vector<int> &newCells) {
+  newCells.clear();
+
+  // Held while blitting so the worker cannot swap this buffer out
+  std::lock_guard<std::mutex> lock(mutex);
+  if (front < 0) {
+    return false;
+  }
+  const Buffer &buffer = buffers[front];
+  const BoardLayerSnapshot &layer = buffer.snapshot;
+  if (!buffer.surface || !layer.sameGeometry(wanted) || layer.cells.size() != wanted.cells.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < wanted.cells.size(); ++i) {
+    if (layer.cells[i] == wanted.cells[i]) {
+      continue;
+    }
+    if (layer.cells[i] != 0) {
+      return false;
+    }
+    newCells.push_back((int)i);
+  }
+
+  cairo_save(cr);
+  cairo_set_source_surface(cr, buffer.surface, 0, 0);
+  cairo_paint(cr);
+  cairo_restore(cr);
+  return true;
+}
+
+void BoardLayerRenderer::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    wake.wait(lock, [this] { return !running || hasPending; });
+    if (!running) {
+      break;
+    }
+
+    // Render into whichever buffer is not on screen
+    int back = (front == 0) ? 1 : 0;
+    Buffer &buffer = buffers[back];
+    buffer.snapshot = std::move(pending);
+    buffer.generation = generation;
+    hasPending = false;
+
+    lock.unlock();
+    bool finished = rasterize(buffer);
+    lock.lock();
+
+    // A layer started before discard() is already out of date
+    if (finished && running && buffer.generation == generation) {
+      front = back;
+      if (frameReady) {
+        lock.unlock();
+        frameReady();
+        lock.lock();
+      }
+    }
+  }
+}
+
+// Background image scaled to cover the area, as drawBackground() does
+static void paintBackground(cairo_t *cr, const BoardLayerSnapshot &layer) {
+  cairo_set_source_rgb(cr, 0.1, 0.1, 0.1);
+  cairo_rectangle(cr, 0, 0, layer.width, layer.height);
+  cairo_fill(cr);
+
+  cairo_surface_t *image = layer.background.get();
+  if (!image) {
+    return;
+  }
+  int imgWidth = cairo_image_surface_get_width(image);
+  int imgHeight = cairo_image_surface_get_height(image);
+  if (imgWidth <= 0 || imgHeight <= 0) {
+    return;
+  }
+
+  double scale = std::max(static_cast<double>(layer.width) / imgWidth,
+                          static_cast<double>(layer.height) / imgHeight);
+  cairo_save(cr);
+  cairo_translate(cr, (layer.width - imgWidth * scale) / 2, (layer.height - imgHeight * scale) / 2);
+  cairo_scale(cr, scale, scale);
+  cairo_set_source_surface(cr, image, 0, 0);
+  cairo_pattern_set_filter(cairo_get_source(cr),
+                           QualityGovernor::budgetFor(layer.effectLevel).backgroundFilter);
+  cairo_paint_with_alpha(cr, layer.backgroundOpacity);
+  cairo_restore(cr);
+}
+
+// Same lines as drawGridLines() and drawFailureLine()
+static void paintGrid(cairo_t *cr, const BoardLayerSnapshot &layer) {
+  int size = layer.blockSize;
+  if (layer.showGridLines) {
+    cairo_set_source_rgb(cr, 0.3, 0.3, 0.3);
+    cairo_set_line_width(cr, 1);
+    for (int x = 1; x < layer.gridWidth; ++x) {
+      cairo_move_to(cr, x * size, 0);
+      cairo_line_to(cr, x * size, layer.gridHeight * size);
+    }
+    for (int y = 1; y < layer.gridHeight; ++y) {
+      cairo_move_to(cr, 0, y * size);
+      cairo_line_to(cr, layer.gridWidth * size, y * size);
+    }
+    cairo_stroke(cr);
+  }
+
+  int failureLineY = 2;
+  cairo_set_source_rgb(cr, 1.0, 0.2, 0.2);
+  cairo_set_line_width(cr, 1.0);
+  cairo_move_to(cr, 0, failureLineY * size);
+  cairo_line_to(cr, layer.gridWidth * size, failureLineY * size);
+  cairo_stroke(cr);
+}
+
+bool BoardLayerRenderer::rasterize(Buffer &buffer) {
+  const BoardLayerSnapshot &layer = buffer.snapshot;
+  int pixelW = (int)std::ceil(layer.width * layer.pixelScale);
+  int pixelH = (int)std::ceil(layer.height * layer.pixelScale);
+  if (pixelW <= 0 || pixelH <= 0 || layer.blockSize <= 0) {
+    return false;
+  }
+
+  if (buffer.surface && (cairo_image_surface_get_width(buffer.surface) != pixelW ||
+                         cairo_image_surface_get_height(buffer.surface) != pixelH)) {
+    cairo_surface_destroy(buffer.surface);
+    buffer.surface = nullptr;
+  }
+  if (!buffer.surface) {
+    buffer.surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, pixelW, pixelH);
+    if (cairo_surface_status(buffer.surface) != CAIRO_STATUS_SUCCESS) {
+      std::cerr << "Failed to create board layer surface" << std::endl;
+      cairo_surface_destroy(buffer.surface);
+      buffer.surface = nullptr;
+      return false;
+    }
+  }
+  cairo_surface_set_device_scale(buffer.surface, layer.pixelScale, layer.pixelScale);
+
+  cairo_t *cr = cairo_create(buffer.surface);
+  paintBackground(cr, layer);
+  paintGrid(cr, layer);
+
+  BlockAtlas::Style style;
+  style.palette = &layer.palette;
+  style.blockSize = layer.blockSize;
+  style.heatLevel = layer.heatLevel;
+  style.retro = layer.retro;
+  style.simple = layer.simple;
+  atlas.prepare(cr, style);
+
+  const QualityGovernor::Budget &budget = QualityGovernor::budgetFor(layer.effectLevel);
+  int size = layer.blockSize;
+  for (int y = 0; y < layer.gridHeight; ++y) {
+    for (int x = 0; x < layer.gridWidth; ++x) {
+      int value = layer.cells[y * layer.gridWidth + x];
+      if (value <= 0) {
+        continue;
+      }
+      double drawX = x * size;
+      double drawY = y * size;
+      atlas.draw(cr, BlockAtlas::ROW_PLACED, value - 1, drawX, drawY);
+
+      if (layer.heatEffects) {
+        if (layer.heatLevel > 0.7f) {
+          drawFireyGlow(cr, sprites, size, budget, drawX, drawY, size, layer.heatLevel, layer.timeMs);
+        }
+        if (layer.heatLevel < 0.3f) {
+          drawFreezyEffect(cr, sprites, size, budget, drawX, drawY, size, layer.heatLevel, layer.timeMs);
+        }
+      }
+    }
+  }
+
+  cairo_destroy(cr);
+  cairo_surface_flush(buffer.surface);
+  return true;
+}
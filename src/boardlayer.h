@@ -0,0 +1,147 @@
+#ifndef BOARDLAYER_H
+#define BOARDLAYER_H
+
+#include <cairo/cairo.h>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "palette.h"
+#include "blockatlas.h"
+#include "effectsprites.h"
+#include "qualitygovernor.h"
+
+/**
+ * Everything the board layer is drawn from, copied out of the board on
+ * the main thread so the render thread never reads live game state.
+ */
+struct BoardLayerSnapshot {
+    int width = 0, height = 0;          // Area size in user units
+    double pixelScale = 1.0;
+    int blockSize = 0;
+    int gridWidth = 0, gridHeight = 0;
+    std::vector<int> cells;             // Row-major grid values, 0 = empty
+
+    ThemePalette palette;
+    float heatLevel = 0.5f;
+    bool heatEffects = false;           // Glow or frost drawn over the blocks
+    double timeMs = 0.0;                // Effect animation clock
+    bool retro = false;
+    bool simple = false;
+    bool showGridLines = false;
+    int effectLevel = QualityGovernor::LEVELS - 1;  // Effect budget to draw with
+
+    std::shared_ptr<cairo_surface_t> background;   // Holds a reference; null for none
+    double backgroundOpacity = 1.0;
+
+    /** True if both would rasterize to the same pixels */
+    bool sameAs(const BoardLayerSnapshot &other) const;
+
+    /** True if both have the same surface size */
+    bool sameGeometry(const BoardLayerSnapshot &other) const;
+};
+
+/**
+ * The draw handler's side of the board layer, owned by the app: the
+ * snapshot it refills each frame, so cells are only copied when the
+ * published grid changes, and the cells it patches over a lagging layer.
+ * Reset on restart so nothing carries over from the previous game.
+ */
+struct BoardLayerFrame {
+    BoardLayerSnapshot snapshot;
+    uint32_t cellsSerial = 0;           // Published state the cells came from
+    bool haveCells = false;
+    int gameSerial = 0;                 // Game the snapshot was taken from
+    std::vector<int> newCells;
+
+    void reset() { *this = BoardLayerFrame(); }
+};
+
+/**
+ * Rasterizes the board layer (background, grid lines, failure line and
+ * locked blocks with their heat effects) on a worker thread.
+ *
+ * The draw handler submits a snapshot and paints the newest finished
+ * layer, which the worker renders into one of two image buffers while
+ * the other is on screen. The draw handler never waits for rendering;
+ * when a layer finishes, the frameReady callback (called on the worker
+ * thread) should schedule a repaint on the UI thread.
+ */
+class BoardLayerRenderer {
+public:
+    BoardLayerRenderer();
+    ~BoardLayerRenderer();
+
+    BoardLayerRenderer(const BoardLayerRenderer &) = delete;
+    BoardLayerRenderer &operator=(const BoardLayerRenderer &) = delete;
+
+    /**
+     * Start the worker thread.
+     * @param frameReady Called from the worker after each finished layer
+     */
+    void start(std::function<void()> frameReady);
+
+    /** Stop and join the worker; pending work is dropped */
+    void stop();
+
+    bool isRunning() const { return worker.joinable(); }
+
+    /**
+     * Queue a snapshot for rendering unless it matches the last one.
+     * Replaces a queued snapshot the worker has not picked up yet.
+     */
+    void submit(const BoardLayerSnapshot &snapshot);
+
+    /**
+     * Paint the newest finished layer at the origin.
+     *
+     * The layer may lag the snapshot by a frame. Cells filled since it was
+     * rendered are returned in newCells (grid indices) for the caller to
+     * draw on top; anything that cannot be patched that way (a different
+     * size, or a cell that emptied or changed) makes this fail.
+     * @param wanted Snapshot of the board as it is now
+     * @param newCells Filled with cells missing from the painted layer
+     * @return false if nothing was painted
+     */
+    bool paint(cairo_t *cr, const BoardLayerSnapshot &wanted, std::vector<int> &newCells);
+
+    /**
+     * Forget the finished layer, e.g. after frames were drawn without it,
+     * so a stale layer is never shown after newer content.
+     */
+    void discard();
+
+private:
+    struct Buffer {
+        cairo_surface_t *surface = nullptr;
+        BoardLayerSnapshot snapshot;
+        unsigned int generation = 0;
+    };
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool running;
+    bool hasPending;
+    BoardLayerSnapshot pending;         // Guarded by mutex
+    Buffer buffers[2];
+    int front;                          // Finished buffer, -1 for none; guarded by mutex
+    unsigned int generation;            // Bumped by discard(); guarded by mutex
+
+    // Main thread only
+    BoardLayerSnapshot submitted;
+    bool hasSubmitted;
+
+    // Worker only
+    BlockAtlas atlas;
+    EffectSprites sprites;
+    std::function<void()> frameReady;
+
+    void run();
+    bool rasterize(Buffer &buffer);
+};
+
+#endif // BOARDLAYER_H
@@ -23,6 +23,8 @@ struct CommandLineArgs {
     bool retroMode = false;        // Default disabled
     bool simpleBlocks = false;     // Default disabled
     bool retroMusic = false;       // Default disabled
+    bool practiceMode = false;     // Default disabled
+    bool demoMode = false;         // Default disabled
     bool fullscreen = false;       // Default windowed
     bool help = false;             // Show help
     bool version = false;          // Show version
@@ -30,6 +32,12 @@ struct CommandLineArgs {
     std::string backgroundZip;     // Path to background ZIP
     std::string soundZip;          // Path to sound ZIP
     double backgroundOpacity = -1.0; // -1 means use default
+    int effectQuality = -2;        // -2 means use default, -1 means automatic
+    int targetFps = -1;            // -1 means use default
+    bool showQuality = false;      // Default hidden
+    std::string profileTrace;      // Trace file written at exit
+    bool profileOverlay = false;   // Default hidden
+    std::string recordFrames;      // Game area recording for replay_export
 };
 
 enum class ArgType {
@@ -63,6 +71,14 @@ enum class ArgType {
     RETRO,
     SIMPLE_BLOCKS,
     RETRO_MUSIC,
+    PRACTICE,
+    DEMO,
+    QUALITY,
+    TARGET_FPS,
+    SHOW_QUALITY,
+    PROFILE,
+    PROFILE_OVERLAY,
+    RECORD,
     UNKNOWN
 };
 
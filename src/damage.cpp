@@ -0,0 +1,228 @@
+// ============================================================================
+// Damage tracking for partial game area repaints (Framework-Agnostic)
+// ============================================================================
+
+#ifdef GTK3
+#include "tetrimone_gtk.h"
+#elif defined(KIOSK)
+#include "tetrimone_kiosk.h"
+#else
+#include "tetrimone_qt5.h"
+#endif
+
+#include "damage.h"
+#include <algorithm>
+#include <cmath>
+#include <climits>
+
+extern int BLOCK_SIZE;
+extern int GRID_WIDTH;
+extern int GRID_HEIGHT;
+
+// Antialiasing and bevel room around a block, in pixels
+static const int BLOCK_MARGIN = 2;
+
+// Rows either side of a cleared line that its animation may spill into
+static const int CLEAR_SPILL_ROWS = 2;
+
+static inline uint64_t mix(uint64_t hash, uint64_t value) {
+  hash ^= value;
+  return hash * 1099511628211ULL;
+}
+
+static uint64_t mixShape(uint64_t hash, const TetrimoneBlock &block) {
+  hash = mix(hash, (uint64_t)block.getType());
+  for (const auto &row : block.getShape()) {
+    for (int cell : row) {
+      hash = mix(hash, (uint64_t)cell);
+    }
+    hash = mix(hash, 0xff);
+  }
+  return hash;
+}
+
+bool DamageTracker::isQuiet(TetrimoneBoard *board) {
+  if (board->isSplashScreenActive() || board->isPaused() || board->isGameOver()) {
+    return false;
+  }
+  if (board->isShowingPropagandaMessage() || board->isFireworksActive() ||
+      (board->isTrailsEnabled() && board->isBlockTrailsActive())) {
+    return false;
+  }
+  if (board->isInBackgroundTransition() || board->isInThemeTransition()) {
+    return false;
+  }
+  // The frame graph scrolls
+  if (profiler.isOverlayShown()) {
+    return false;
+  }
+
+  // Heat effects shimmer over every locked block
+  float heatLevel = board->getHeatLevel();
+  return board->retroModeActive || (heatLevel <= 0.7f && heatLevel >= 0.3f);
+}
+
+void DamageTracker::capture(TetrimoneBoard *board, Frame &out) {
+  out.valid = true;
+  out.quiet = isQuiet(board);
+  out.blockSize = BLOCK_SIZE;
+  out.paletteVersion = board->getPalette().getVersion();
+  out.effectLevel = qualityGovernor.getLevel();
+
+  out.rows.resize(GRID_HEIGHT);
+  for (int y = 0; y < GRID_HEIGHT; ++y) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (int x = 0; x < GRID_WIDTH; ++x) {
+      hash = mix(hash, (uint64_t)board->getGridValue(x, y));
+    }
+    out.rows[y] = hash;
+  }
+
+  out.clearFirst = out.clearLast = -1;
+  if (board->isLineClearActive()) {
+    for (int y = 0; y < GRID_HEIGHT; ++y) {
+      if (board->isLineBeingCleared(y)) {
+        if (out.clearFirst < 0) out.clearFirst = y;
+        out.clearLast = y;
+      }
+    }
+  }
+
+  out.piece = out.ghost = Box();
+  out.pieceKey = 0;
+  const TetrimoneBlock *piece = board->getCurrentPiece();
+  if (!piece) {
+    return;
+  }
+
+  // Filled extent of the shape, in cells
+  auto shape = piece->getShape();
+  int minCol = INT_MAX, maxCol = -1, minRow = INT_MAX, maxRow = -1;
+  for (int y = 0; y < (int)shape.size(); ++y) {
+    for (int x = 0; x < (int)shape[y].size(); ++x) {
+      if (shape[y][x] == 1) {
+        minCol = std::min(minCol, x);
+        maxCol = std::max(maxCol, x);
+        minRow = std::min(minRow, y);
+        maxRow = std::max(maxRow, y);
+      }
+    }
+  }
+  if (maxCol < 0) {
+    return;
+  }
+
+  // The piece is drawn somewhere between its interpolated and final cell
+  double drawX, drawY;
+  board->getCurrentPieceInterpolatedPosition(drawX, drawY);
+  double leftX = std::min(drawX, (double)piece->getX());
+  double rightX = std::max(drawX, (double)piece->getX());
+  double topY = std::min(drawY, (double)piece->getY());
+  double bottomY = std::max(drawY, (double)piece->getY());
+
+  out.piece.x0 = (int)std::floor((leftX + minCol) * BLOCK_SIZE) - BLOCK_MARGIN;
+  out.piece.x1 = (int)std::ceil((rightX + maxCol + 1) * BLOCK_SIZE) + BLOCK_MARGIN;
+  out.piece.y0 = (int)std::floor((topY + minRow) * BLOCK_SIZE) - BLOCK_MARGIN;
+  out.piece.y1 = (int)std::ceil((bottomY + maxRow + 1) * BLOCK_SIZE) + BLOCK_MARGIN;
+
+  int ghostY = -1;
+  if (board->isGhostPieceEnabled()) {
+    ghostY = board->getGhostPieceY();
+    out.ghost.x0 = out.piece.x0;
+    out.ghost.x1 = out.piece.x1;
+    out.ghost.y0 = (ghostY + minRow) * BLOCK_SIZE - BLOCK_MARGIN;
+    out.ghost.y1 = (ghostY + maxRow + 1) * BLOCK_SIZE + BLOCK_MARGIN;
+  }
+
+  uint64_t key = mixShape(14695981039346656037ULL, *piece);
+  key = mix(key, (uint64_t)(int64_t)std::lround(drawX * 1000.0));
+  key = mix(key, (uint64_t)(int64_t)std::lround(drawY * 1000.0));
+  key = mix(key, (uint64_t)(int64_t)piece->getX());
+  key = mix(key, (uint64_t)(int64_t)piece->getY());
+  out.pieceKey = mix(key, (uint64_t)(int64_t)ghostY);
+}
+
+void DamageTracker::addBox(const Box &box) {
+  if (!box.empty()) {
+    rects.push_back({box.x0, box.y0, box.x1 - box.x0, box.y1 - box.y0});
+  }
+}
+
+void DamageTracker::addRows(int firstRow, int lastRow, int width, int margin) {
+  int y0 = firstRow * BLOCK_SIZE - margin;
+  int y1 = (lastRow + 1) * BLOCK_SIZE + margin;
+  rects.push_back({0, y0, width, y1 - y0});
+}
+
+bool DamageTracker::collect(TetrimoneBoard *board, int areaWidth) {
+  rects.clear();
+  capture(board, current);
+
+  if (!frame.valid || !frame.quiet || !current.quiet ||
+      frame.blockSize != current.blockSize ||
+      frame.paletteVersion != current.paletteVersion ||
+      frame.effectLevel != current.effectLevel ||
+      frame.rows.size() != current.rows.size()) {
+    return false;
+  }
+
+  if (frame.pieceKey != current.pieceKey) {
+    addBox(frame.piece);
+    addBox(frame.ghost);
+    addBox(current.piece);
+    addBox(current.ghost);
+  }
+
+  // Locked blocks: consecutive changed rows become one band
+  int gridWidth = GRID_WIDTH * BLOCK_SIZE + BLOCK_MARGIN;
+  int firstChanged = -1;
+  for (int y = 0; y <= (int)current.rows.size(); ++y) {
+    bool changed = y < (int)current.rows.size() && frame.rows[y] != current.rows[y];
+    if (changed && firstChanged < 0) {
+      firstChanged = y;
+    } else if (!changed && firstChanged >= 0) {
+      addRows(firstChanged, y - 1, gridWidth, BLOCK_MARGIN);
+      firstChanged = -1;
+    }
+  }
+
+  // Line clear animations move blocks off their row; cover them while
+  // they run and once more to wipe the last frame
+  int spill = CLEAR_SPILL_ROWS * BLOCK_SIZE;
+  if (frame.clearFirst >= 0) {
+    addRows(frame.clearFirst, frame.clearLast, areaWidth, spill);
+  }
+  if (current.clearFirst >= 0) {
+    addRows(current.clearFirst, current.clearLast, areaWidth, spill);
+  }
+
+  return true;
+}
+
+void DamageTracker::painted(TetrimoneBoard *board) {
+  capture(board, frame);
+}
+
+uint64_t DamageTracker::previewSignature(TetrimoneBoard *board) {
+  uint64_t hash = 14695981039346656037ULL;
+  hash = mix(hash, board->isGameOver() ? 1 : 0);
+  hash = mix(hash, (uint64_t)BLOCK_SIZE);
+  hash = mix(hash, board->getPalette().getVersion());
+
+  // The preview shows the first three queued pieces
+  size_t count = std::min(board->getNextPiecesCount(), (size_t)3);
+  for (size_t i = 0; i < count; ++i) {
+    const TetrimoneBlock *next = board->getNextPiece((int)i);
+    hash = next ? mixShape(hash, *next) : mix(hash, 0);
+  }
+  return hash;
+}
+
+bool DamageTracker::previewChanged(TetrimoneBoard *board) const {
+  return !previewValid || previewSignature(board) != previewKey;
+}
+
+void DamageTracker::previewPainted(TetrimoneBoard *board) {
+  previewKey = previewSignature(board);
+  previewValid = true;
+}
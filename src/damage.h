@@ -0,0 +1,81 @@
+#ifndef DAMAGE_H
+#define DAMAGE_H
+
+#include <cstdint>
+#include <vector>
+
+class TetrimoneBoard;
+
+/**
+ * Tracks which parts of the game area are out of date.
+ *
+ * The draw handlers record what they painted: the grid contents row by
+ * row, the bounds of the falling piece and its ghost, and whether any
+ * full-screen effect was running. collect() compares the board against
+ * that record and returns only the rectangles that changed, so a piece
+ * moving one cell repaints a few blocks instead of the whole board.
+ *
+ * Anything that animates across the board (overlays, fireworks, trails,
+ * heat effects, background and theme transitions) forces a full repaint.
+ */
+class DamageTracker {
+public:
+    struct Rect {
+        int x, y, width, height;
+    };
+
+    DamageTracker() {}
+
+    /**
+     * Work out what changed since the game area was last painted.
+     * @param board Board to compare against the painted frame
+     * @param areaWidth Game area width in pixels
+     * @return false if the whole area must be repainted, otherwise the
+     *         damaged rectangles are in getRects() (possibly none)
+     */
+    bool collect(TetrimoneBoard *board, int areaWidth);
+
+    const std::vector<Rect> &getRects() const { return rects; }
+
+    /** Record the board as the game area shows it; call after drawing */
+    void painted(TetrimoneBoard *board);
+
+    /** True if the next-piece preview would look different from the painted one */
+    bool previewChanged(TetrimoneBoard *board) const;
+
+    /** Record the preview as painted; call after drawing it */
+    void previewPainted(TetrimoneBoard *board);
+
+private:
+    // Pixel bounds; empty when width is zero
+    struct Box {
+        int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+        bool empty() const { return x1 <= x0 || y1 <= y0; }
+    };
+
+    struct Frame {
+        bool valid = false;
+        bool quiet = false;           // No full-screen effect was drawn
+        int blockSize = 0;
+        unsigned int paletteVersion = 0;
+        int effectLevel = 0;
+        uint64_t pieceKey = 0;        // Type, shape and position of the falling piece
+        Box piece, ghost;
+        int clearFirst = -1, clearLast = -1;  // Rows of a running line clear
+        std::vector<uint64_t> rows;   // Hash of each grid row
+    };
+
+    Frame frame;
+    Frame current;                    // Scratch for collect()
+    std::vector<Rect> rects;
+    uint64_t previewKey = 0;
+    bool previewValid = false;
+
+    static bool isQuiet(TetrimoneBoard *board);
+    static uint64_t previewSignature(TetrimoneBoard *board);
+    static void capture(TetrimoneBoard *board, Frame &out);
+    void addBox(const Box &box);
+    void addRows(int firstRow, int lastRow, int areaWidth, int margin);
+};
+
+#endif // DAMAGE_H
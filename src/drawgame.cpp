@@ -2,6 +2,9 @@
 #ifdef GTK3
 #include "tetrimone_gtk.h"
 #include <glib.h>
+#elif defined(KIOSK)
+#include "tetrimone_kiosk.h"
+#include "kiosk_timers.h"
 #else
 #include "tetrimone_qt5.h"
 #include <QObject>
@@ -26,7 +29,7 @@
 
 void TetrimoneBoard::getCurrentPieceInterpolatedPosition(double &x, double &y) const {
   if (currentPiece) {
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
     if (smoothMovementTimer > 0 && movementProgress < 1.0) {
 #else
     if (smoothMovementTimer != nullptr && movementProgress < 1.0) {
@@ -62,7 +65,7 @@ void TetrimoneBoard::startSmoothMovement(int newX, int newY) {
 
         if (lastPieceX != newX || lastPieceY != newY) {
 
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
             if (smoothMovementTimer > 0) {
                 g_source_remove(smoothMovementTimer);
             }
@@ -108,7 +111,7 @@ void TetrimoneBoard::updateSmoothMovement() {
   
   if (movementProgress >= 1.0) {
     movementProgress = 1.0;
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
     if (smoothMovementTimer > 0) {
       g_source_remove(smoothMovementTimer);
       smoothMovementTimer = 0;
@@ -137,7 +140,7 @@ void TetrimoneBoard::startLineClearAnimation(const std::vector<int> &clearedLine
     currentAnimationType = animDist(rng);
   }
   
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
   if (lineClearAnimationTimer > 0) {
     g_source_remove(lineClearAnimationTimer);
   }
@@ -182,7 +185,7 @@ void TetrimoneBoard::updateLineClearAnimation() {
   
   if (lineClearProgress >= 1.0) {
     // Animation complete - stop timer first
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
     if (lineClearAnimationTimer > 0) {
       g_source_remove(lineClearAnimationTimer);
       lineClearAnimationTimer = 0;
@@ -215,17 +218,9 @@ void TetrimoneBoard::updateLineClearAnimation() {
       
       // Only remove if line is actually full
       if (lineIsFull) {
-        // Move all rows above this line down by one
-        for (int moveY = lineY; moveY > 0; --moveY) {
-          for (int x = 0; x < GRID_WIDTH; ++x) {
-            grid[moveY][x] = grid[moveY - 1][x];
-          }
-        }
-        
-        // Clear the top row
-        for (int x = 0; x < GRID_WIDTH; ++x) {
-          grid[0][x] = 0;
-        }
+        // Drop all rows above this line by one and recycle it as an
+        // empty top row
+        grid.removeRow(lineY);
         
         // After removing this line, adjust positions of remaining lines
         for (int& otherLineY : sortedLines) {
@@ -243,6 +238,26 @@ void TetrimoneBoard::updateLineClearAnimation() {
   }
 }
 
+void TetrimoneBoard::cancelLineClearAnimation() {
+#if defined(GTK3) || defined(KIOSK)
+  if (lineClearAnimationTimer > 0) {
+    g_source_remove(lineClearAnimationTimer);
+    lineClearAnimationTimer = 0;
+  }
+#else  // QT5
+  if (lineClearAnimationTimer) {
+    lineClearAnimationTimer->stop();
+    lineClearAnimationTimer->deleteLater();
+    lineClearAnimationTimer = nullptr;
+  }
+#endif
+
+  // Drop the animation without touching the grid; callers replace it
+  linesBeingCleared.clear();
+  lineClearActive = false;
+  lineClearProgress = 0.0;
+}
+
 void TetrimoneBoard::startThemeTransition(int targetTheme) {
     // Don't start transition if already transitioning to the same theme
     if (isThemeTransitioning && newThemeIndex == targetTheme) {
@@ -250,7 +265,7 @@ void TetrimoneBoard::startThemeTransition(int targetTheme) {
     }
     
     // Cancel any existing transition
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
     if (themeTransitionTimer > 0) {
         g_source_remove(themeTransitionTimer);
     }
@@ -271,7 +286,7 @@ void TetrimoneBoard::startThemeTransition(int targetTheme) {
     // Set start time for this animation
     themeStartTime = std::chrono::high_resolution_clock::now();
     
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
     themeTransitionTimer = g_timeout_add(16, // ~60 FPS
         [](gpointer userData) -> gboolean {
             TetrimoneBoard* board = static_cast<TetrimoneBoard*>(userData);
@@ -311,7 +326,7 @@ void TetrimoneBoard::updateThemeTransition() {
         currentThemeIndex = newThemeIndex;
         
         // Clean up
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
         if (themeTransitionTimer > 0) {
             g_source_remove(themeTransitionTimer);
             themeTransitionTimer = 0;
@@ -329,7 +344,7 @@ void TetrimoneBoard::updateThemeTransition() {
 }
 
 void TetrimoneBoard::cancelThemeTransition() {
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
     if (themeTransitionTimer > 0) {
         g_source_remove(themeTransitionTimer);
         themeTransitionTimer = 0;
@@ -346,29 +361,13 @@ void TetrimoneBoard::cancelThemeTransition() {
     themeTransitionProgress = 0.0;
 }
 
+const ThemePalette& TetrimoneBoard::getPalette() const {
+    // Cheap when neither the theme nor the transition step changed
+    palette.update(currentThemeIndex, isThemeTransitioning, oldThemeIndex, newThemeIndex,
+                   themeTransitionProgress);
+    return palette;
+}
+
 std::array<double, 3> TetrimoneBoard::getInterpolatedColor(int blockType, double progress) const {
-    if (!isThemeTransitioning) {
-        return TETRIMONEBLOCK_COLOR_THEMES[currentThemeIndex][blockType];
-    }
-    
-    // Get colors from old and new themes
-    auto oldColor = TETRIMONEBLOCK_COLOR_THEMES[oldThemeIndex][blockType];
-    auto newColor = TETRIMONEBLOCK_COLOR_THEMES[newThemeIndex][blockType];
-    
-    // Use a more gentle easing function for the longer transition
-    // Cubic ease-in-out for smoother, more noticeable transitions
-    double t = themeTransitionProgress;
-    if (t < 0.5) {
-        t = 4 * t * t * t; // Ease-in cubic
-    } else {
-        t = 1 - pow(-2 * t + 2, 3) / 2; // Ease-out cubic
-    }
-    
-    // Interpolate between colors
-    std::array<double, 3> interpolatedColor;
-    for (int i = 0; i < 3; i++) {
-        interpolatedColor[i] = oldColor[i] + (newColor[i] - oldColor[i]) * t;
-    }
-    
-    return interpolatedColor;
+    return getPalette().color(blockType);
 }
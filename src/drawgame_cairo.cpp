@@ -9,6 +9,11 @@
 #include <QTimer>
 #endif
 
+#ifdef KIOSK
+#include "tetrimone_kiosk.h"
+#include "kiosk_timers.h"
+#endif
+
 #include "audiomanager.h"
 #include <iostream>
 #include <string>
@@ -19,6 +24,9 @@
 #endif
 #include "highscores.h"
 #include "propaganda_messages.h"
+#include "blockatlas.h"
+#include "effectsprites.h"
+#include "textcache.h"
 #include "zip.h"
 
 // Define M_PI for Windows compatibility
@@ -34,22 +42,18 @@ void drawSplashScreen(cairo_t *cr, TetrimoneBoard *board, TetrimoneApp *app) {
   cairo_fill(cr);
 
   // Draw title
-  cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL,
-                         CAIRO_FONT_WEIGHT_BOLD);
-  cairo_set_font_size(cr, 40 * BLOCK_SIZE / 47);
   cairo_set_source_rgb(cr, 1, 1, 1);
 
   // Center the title
-  cairo_text_extents_t extents;
   const char *title = board->retroModeActive ? 
       "БЛОЧНАЯ РЕВОЛЮЦИЯ" : "TETRIMONE";
-  cairo_text_extents(cr, title, &extents);
+  const TextCache::Entry *text = &textCache.get(cr, title, "Sans", CAIRO_FONT_WEIGHT_BOLD,
+                                                40 * BLOCK_SIZE / 47);
 
-  double x = (GRID_WIDTH * BLOCK_SIZE - extents.width) / 2;
+  double x = (GRID_WIDTH * BLOCK_SIZE - text->extents.width) / 2;
   double y = (GRID_HEIGHT * BLOCK_SIZE) / 3;
 
-  cairo_move_to(cr, x, y);
-  cairo_show_text(cr, title);
+  TextCache::show(cr, *text, x, y);
 
   // Draw colored blocks for decoration
   int blockSize = 30;
@@ -81,30 +85,26 @@ void drawSplashScreen(cairo_t *cr, TetrimoneBoard *board, TetrimoneApp *app) {
   cairo_fill(cr);
 
   // Draw press space message
-  cairo_set_font_size(cr, 20 * BLOCK_SIZE / 47);
   const char *startText = board->retroModeActive ? 
       "Нажмите ПРОБЕЛ для начала" : "Press SPACE to Start";
-  cairo_text_extents(cr, startText, &extents);
+  text = &textCache.get(cr, startText, "Sans", CAIRO_FONT_WEIGHT_BOLD, 20 * BLOCK_SIZE / 47);
 
-  x = (GRID_WIDTH * BLOCK_SIZE - extents.width) / 2;
+  x = (GRID_WIDTH * BLOCK_SIZE - text->extents.width) / 2;
   y = (GRID_HEIGHT * BLOCK_SIZE) * 0.75;
 
-  cairo_move_to(cr, x, y);
-  cairo_show_text(cr, startText);
+  TextCache::show(cr, *text, x, y);
 
   // Draw joystick message if enabled
   if (app->joystickEnabled) {
-    cairo_set_font_size(cr, 16 * BLOCK_SIZE / 47);
     const char *joystickText = board->retroModeActive ? 
         "или Нажмите СТАРТ на контроллере" : 
         "or Press START on Controller";
-    cairo_text_extents(cr, joystickText, &extents);
+    text = &textCache.get(cr, joystickText, "Sans", CAIRO_FONT_WEIGHT_BOLD, 16 * BLOCK_SIZE / 47);
 
-    x = (GRID_WIDTH * BLOCK_SIZE - extents.width) / 2;
+    x = (GRID_WIDTH * BLOCK_SIZE - text->extents.width) / 2;
     y += 30;
 
-    cairo_move_to(cr, x, y);
-    cairo_show_text(cr, joystickText);
+    TextCache::show(cr, *text, x, y);
   }
 }
 
@@ -412,130 +412,6 @@ LineClearAnimValues getLineClearAnimationValues(int animationType, double progre
   }
 }
 
-void drawGameOver(cairo_t *cr, TetrimoneBoard *board) {
-  if (board->isGameOver()) {
-    cairo_set_source_rgba(cr, 0, 0, 0, 0.7);
-    cairo_rectangle(cr, 0, 0, GRID_WIDTH * BLOCK_SIZE,
-                    GRID_HEIGHT * BLOCK_SIZE);
-    cairo_fill(cr);
-    cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL,
-                           CAIRO_FONT_WEIGHT_BOLD);
-    cairo_set_font_size(cr, 30);
-    cairo_set_source_rgb(cr, 1, 0, 0);
-    
-    // Center the text
-    cairo_text_extents_t extents;
-    const char *text = board->retroModeActive ? "ИНФОРМАЦИЯ ЗАПРЕЩЕНА" : "GAME OVER";
-    cairo_text_extents(cr, text, &extents);
-    double x = (GRID_WIDTH * BLOCK_SIZE - extents.width) / 2;
-    double y = (GRID_HEIGHT * BLOCK_SIZE) / 2;
-    cairo_move_to(cr, x, y);
-    cairo_show_text(cr, text);
-    
-    // Show different restart message in retro mode
-    cairo_set_font_size(cr, 16);
-    const char *restartText = board->retroModeActive ? 
-                              "ОЖИДАЙТЕ ДОПРОСА. НЕ ДВИГАЙТЕСЬ..." : 
-                              "Press R to restart";
-    cairo_text_extents(cr, restartText, &extents);
-    x = (GRID_WIDTH * BLOCK_SIZE - extents.width) / 2;
-    y += 40;
-    cairo_move_to(cr, x, y);
-    cairo_show_text(cr, restartText);
-    
-    // Add a second line with translation for non-Russian speakers
-    if (board->retroModeActive) {
-        cairo_set_font_size(cr, 12);
-        const char *translationText = "(AWAIT INTERROGATION. DO NOT MOVE...)";
-        cairo_text_extents(cr, translationText, &extents);
-        x = (GRID_WIDTH * BLOCK_SIZE - extents.width) / 2;
-        y += 25;
-        cairo_move_to(cr, x, y);
-        cairo_show_text(cr, translationText);
-    }
-  }
-}
-
-void drawFireworks(cairo_t *cr, TetrimoneBoard *board, TetrimoneApp *app) {
-  if (board->isFireworksActive()) {
-    const auto& particles = app->board->getFireworkParticles();
-    
-    for (const auto& particle : particles) {
-        // Set particle color with alpha based on life
-        double alpha = particle.life;
-        cairo_set_source_rgba(cr, particle.color[0], particle.color[1], particle.color[2], alpha);
-        
-        // Draw particle as a glowing circle
-        cairo_arc(cr, particle.x, particle.y, particle.size * particle.life, 0, 2 * M_PI);
-        cairo_fill(cr);
-        
-        // Add glow effect
-        cairo_set_source_rgba(cr, particle.color[0], particle.color[1], particle.color[2], alpha * 0.3);
-        cairo_arc(cr, particle.x, particle.y, particle.size * particle.life * 2, 0, 2 * M_PI);
-        cairo_fill(cr);
-        
-        // Add bright center
-        cairo_set_source_rgba(cr, 1.0, 1.0, 1.0, alpha * 0.8);
-        cairo_arc(cr, particle.x, particle.y, particle.size * particle.life * 0.3, 0, 2 * M_PI);
-        cairo_fill(cr);
-    }
-  }
-}
-
-void drawBlockTrails(cairo_t *cr, TetrimoneBoard *board) {
-  if (board->isTrailsEnabled() && board->isBlockTrailsActive()) {
-    const auto& trails = board->getBlockTrails();
-    
-    for (const auto& trail : trails) {
-        // Set color with alpha for fading effect
-        auto color = trail.color;
-        cairo_set_source_rgba(cr, color[0], color[1], color[2], trail.alpha);
-        
-        // Draw each block of the trail piece
-        for (size_t y = 0; y < trail.shape.size(); ++y) {
-            for (size_t x = 0; x < trail.shape[y].size(); ++x) {
-                if (trail.shape[y][x] == 1) {
-                    double drawX = (trail.x + x) * BLOCK_SIZE;
-                    double drawY = (trail.y + y) * BLOCK_SIZE;
-                    
-                    // Only draw if within the visible grid
-                    if (drawY >= -BLOCK_SIZE) {
-                        if (board->simpleBlocksActive) {
-                            // Simple trail blocks
-                            cairo_rectangle(cr, drawX, drawY, BLOCK_SIZE, BLOCK_SIZE);
-                            cairo_fill(cr);
-                        } else {
-                            // 3D trail blocks with reduced effect
-                            cairo_rectangle(cr, drawX + 1, drawY + 1, BLOCK_SIZE - 2, BLOCK_SIZE - 2);
-                            cairo_fill(cr);
-                            
-                            // Subtle highlight for 3D effect
-                            cairo_set_source_rgba(cr, 1, 1, 1, 0.1 * trail.alpha);
-                            cairo_move_to(cr, drawX + 1, drawY + 1);
-                            cairo_line_to(cr, drawX + BLOCK_SIZE - 1, drawY + 1);
-                            cairo_line_to(cr, drawX + 1, drawY + BLOCK_SIZE - 1);
-                            cairo_close_path(cr);
-                            cairo_fill(cr);
-                            
-                            // Subtle shadow for 3D effect
-                            cairo_set_source_rgba(cr, 0, 0, 0, 0.1 * trail.alpha);
-                            cairo_move_to(cr, drawX + BLOCK_SIZE - 1, drawY + 1);
-                            cairo_line_to(cr, drawX + BLOCK_SIZE - 1, drawY + BLOCK_SIZE - 1);
-                            cairo_line_to(cr, drawX + 1, drawY + BLOCK_SIZE - 1);
-                            cairo_close_path(cr);
-                            cairo_fill(cr);
-                            
-                            // Reset color for next block
-                            cairo_set_source_rgba(cr, color[0], color[1], color[2], trail.alpha);
-                        }
-                    }
-                }
-            }
-        }
-    }
-  }
-}
-
 void drawFailureLine(cairo_t *cr) {
   int failureLineY = 2;
   cairo_set_source_rgb(cr, 1.0, 0.2, 0.2);
@@ -545,373 +421,250 @@ void drawFailureLine(cairo_t *cr) {
   cairo_stroke(cr);
 }
 
-void drawPropagandaMessage(cairo_t *cr, TetrimoneBoard *board) {
-  if (board->retroModeActive && board->showPropagandaMessage) {
-    // Semi-transparent background for message
-    cairo_set_source_rgba(cr, 0.8, 0.0, 0.0, 0.8);
-    
-    // Calculate message position - center of screen
-    double msgX = (GRID_WIDTH * BLOCK_SIZE) / 2;
-    double msgY = (GRID_HEIGHT * BLOCK_SIZE) / 2;
+// ============================================================================
+// Propaganda message panel: laid out and rendered once per message, then
+// drawn as one scaled image while it pulses
+// ============================================================================
+
+struct PropagandaLayout {
+    double fontSize;
+    std::string formatted;              // Message with an optional line break
+    std::string firstLine, secondLine;  // secondLine is empty for one line
+    cairo_text_extents_t extents;       // Extents of the formatted message
+    int padding;
+    double boxWidth, boxHeight;
+};
+
+struct PropagandaPanel {
+    std::string message;
+    bool retro = false;
+    double screenWidth = 0.0;
+    double pixelScale = 0.0;
+    cairo_surface_t *surface = nullptr;
+    double width = 0.0, height = 0.0;   // User units
+};
+
+static PropagandaPanel propagandaPanel;
+
+// Largest propagandaMessageScale; the panel is rasterized at this size
+static const double PROPAGANDA_MAX_SCALE = 1.2;
+
+static PropagandaLayout layoutPropagandaMessage(cairo_t *cr, const std::string &message,
+                                                bool retro, double screenWidth) {
+    PropagandaLayout layout;
     
     // Calculate font size based on screen width
-    double screenWidth = GRID_WIDTH * BLOCK_SIZE;
     double baseFontSize = screenWidth / 25.0;
-    double fontSize = std::max(14.0, std::min(26.0, baseFontSize));
+    layout.fontSize = std::max(14.0, std::min(26.0, baseFontSize));
     
-    // Set font size
     cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
-    cairo_set_font_size(cr, fontSize);
+    cairo_set_font_size(cr, layout.fontSize);
     
-    // Get original message
-    std::string originalMessage = board->currentPropagandaMessage;
-    std::string formattedMessage = originalMessage;
-    
-    // Check if message is too long
-    cairo_text_extents_t extents;
-    cairo_text_extents(cr, originalMessage.c_str(), &extents);
+    layout.formatted = message;
     
     // If message is too wide for the screen, add a line break
+    cairo_text_extents_t extents;
+    cairo_text_extents(cr, message.c_str(), &extents);
     if (extents.width > screenWidth - 40) {
-        int halfLength = originalMessage.length() / 2;
-        size_t spacePos = originalMessage.rfind(' ', halfLength);
+        int halfLength = message.length() / 2;
+        size_t spacePos = message.rfind(' ', halfLength);
         if (spacePos != std::string::npos) {
-            formattedMessage = originalMessage.substr(0, spacePos) + 
-                              "\n" + 
-                              originalMessage.substr(spacePos + 1);
+            layout.formatted = message.substr(0, spacePos) + "\n" + message.substr(spacePos + 1);
         }
     }
     
-    // Get extents of the potentially reformatted message
-    cairo_text_extents_t newExtents;
-    cairo_text_extents(cr, formattedMessage.c_str(), &newExtents);
-    
     // Make sure the message fits the screen even after reformatting
-    if (newExtents.width > screenWidth - 40) {
-        fontSize = std::max(12.0, fontSize * (screenWidth - 40) / newExtents.width);
-        cairo_set_font_size(cr, fontSize);
-        cairo_text_extents(cr, formattedMessage.c_str(), &newExtents);
+    cairo_text_extents(cr, layout.formatted.c_str(), &layout.extents);
+    if (layout.extents.width > screenWidth - 40) {
+        layout.fontSize = std::max(12.0, layout.fontSize * (screenWidth - 40) / layout.extents.width);
+        cairo_set_font_size(cr, layout.fontSize);
+        cairo_text_extents(cr, layout.formatted.c_str(), &layout.extents);
     }
     
-    // Calculate background box size
-    int msgPadding = 20;
-    double boxHeight = newExtents.height + msgPadding*2;
-    if (formattedMessage.find('\n') != std::string::npos) {
-        boxHeight = newExtents.height * 2.5 + msgPadding*2;
+    size_t newline = layout.formatted.find('\n');
+    layout.firstLine = layout.formatted.substr(0, newline);
+    if (newline != std::string::npos) {
+        layout.secondLine = layout.formatted.substr(newline + 1);
     }
     
-    // Draw message background
-    cairo_rectangle(cr, msgX - newExtents.width/2 - msgPadding,
-                    msgY - boxHeight/2,
-                    newExtents.width + msgPadding*2,
-                    boxHeight);
-    cairo_fill(cr);
-    
-    // Draw white border
-    cairo_set_source_rgb(cr, 1.0, 1.0, 1.0);
-    cairo_set_line_width(cr, 2.0);
-    cairo_rectangle(cr, msgX - newExtents.width/2 - msgPadding,
-                    msgY - boxHeight/2,
-                    newExtents.width + msgPadding*2,
-                    boxHeight);
-    cairo_stroke(cr);
-    
-    // Draw text in white
-    cairo_set_source_rgb(cr, 1.0, 1.0, 1.0);
-    
-    if (formattedMessage.find('\n') != std::string::npos) {
-        std::string firstLine = formattedMessage.substr(0, formattedMessage.find('\n'));
-        std::string secondLine = formattedMessage.substr(formattedMessage.find('\n') + 1);
-        
-        cairo_text_extents_t firstLineExtents;
-        cairo_text_extents(cr, firstLine.c_str(), &firstLineExtents);
-        
-        cairo_move_to(cr, msgX - firstLineExtents.width/2, msgY - fontSize/2);
-        cairo_show_text(cr, firstLine.c_str());
+    // Calculate background box size
+    layout.padding = retro ? 20 : 25;
+    layout.boxWidth = layout.extents.width + layout.padding * 2;
+    layout.boxHeight = layout.extents.height + layout.padding * 2;
+    if (!layout.secondLine.empty()) {
+        layout.boxHeight = layout.extents.height * 2.5 + layout.padding * 2;
+    }
+    return layout;
+}
+
+// Draw the message lines centred on (msgX, msgY) in the current source colour
+static void drawPropagandaText(cairo_t *cr, const PropagandaLayout &layout,
+                               double msgX, double msgY, double offset) {
+    if (!layout.secondLine.empty()) {
+        cairo_text_extents_t lineExtents;
+        cairo_text_extents(cr, layout.firstLine.c_str(), &lineExtents);
+        cairo_move_to(cr, msgX - lineExtents.width/2 + offset, msgY - layout.fontSize/2 + offset);
+        cairo_show_text(cr, layout.firstLine.c_str());
         
-        cairo_text_extents_t secondLineExtents;
-        cairo_text_extents(cr, secondLine.c_str(), &secondLineExtents);
-        cairo_move_to(cr, msgX - secondLineExtents.width/2, msgY + fontSize);
-        cairo_show_text(cr, secondLine.c_str());
+        cairo_text_extents(cr, layout.secondLine.c_str(), &lineExtents);
+        cairo_move_to(cr, msgX - lineExtents.width/2 + offset, msgY + layout.fontSize + offset);
+        cairo_show_text(cr, layout.secondLine.c_str());
     } else {
-        cairo_move_to(cr, msgX - newExtents.width/2, msgY + newExtents.height/2);
-        cairo_show_text(cr, formattedMessage.c_str());
-    }
-  }
-  else if (board->patrioticModeActive && board->showPropagandaMessage) {
-    // Patriotic blue background
-    cairo_set_source_rgba(cr, 0.0, 0.2, 0.7, 0.85);
-    
-    double msgX = (GRID_WIDTH * BLOCK_SIZE) / 2;
-    double msgY = (GRID_HEIGHT * BLOCK_SIZE) / 2;
-    double screenWidth = GRID_WIDTH * BLOCK_SIZE;
-    double baseFontSize = screenWidth / 25.0;
-    double fontSize = std::max(14.0, std::min(26.0, baseFontSize));
-    
-    cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
-    cairo_set_font_size(cr, fontSize);
-    
-    std::string originalMessage = board->currentPropagandaMessage;
-    std::string formattedMessage = originalMessage;
-    
-    cairo_text_extents_t extents;
-    cairo_text_extents(cr, originalMessage.c_str(), &extents);
-    
-    if (extents.width > screenWidth - 40) {
-        int halfLength = originalMessage.length() / 2;
-        size_t spacePos = originalMessage.rfind(' ', halfLength);
-        if (spacePos != std::string::npos) {
-            formattedMessage = originalMessage.substr(0, spacePos) + 
-                              "\n" + 
-                              originalMessage.substr(spacePos + 1);
-        }
-    }
-    
-    cairo_text_extents_t newExtents;
-    cairo_text_extents(cr, formattedMessage.c_str(), &newExtents);
-    
-    if (newExtents.width > screenWidth - 40) {
-        fontSize = std::max(12.0, fontSize * (screenWidth - 40) / newExtents.width);
-        cairo_set_font_size(cr, fontSize);
-        cairo_text_extents(cr, formattedMessage.c_str(), &newExtents);
+        cairo_move_to(cr, msgX - layout.extents.width/2 + offset,
+                      msgY + layout.extents.height/2 + offset);
+        cairo_show_text(cr, layout.formatted.c_str());
     }
-    
-    int msgPadding = 25;
-    double boxHeight = newExtents.height + msgPadding*2;
-    if (formattedMessage.find('\n') != std::string::npos) {
-        boxHeight = newExtents.height * 2.5 + msgPadding*2;
-    }
-    
-    double cornerRadius = 8.0;
-    double boxX = msgX - newExtents.width/2 - msgPadding;
-    double boxY = msgY - boxHeight/2;
-    double boxWidth = newExtents.width + msgPadding*2;
-    
-    // Draw rounded rectangle
+}
+
+static void roundedBoxPath(cairo_t *cr, double boxX, double boxY, double boxWidth,
+                           double boxHeight, double cornerRadius) {
     cairo_new_sub_path(cr);
     cairo_arc(cr, boxX + cornerRadius, boxY + cornerRadius, cornerRadius, M_PI, 3 * M_PI / 2);
     cairo_arc(cr, boxX + boxWidth - cornerRadius, boxY + cornerRadius, cornerRadius, 3 * M_PI / 2, 0);
     cairo_arc(cr, boxX + boxWidth - cornerRadius, boxY + boxHeight - cornerRadius, cornerRadius, 0, M_PI / 2);
     cairo_arc(cr, boxX + cornerRadius, boxY + boxHeight - cornerRadius, cornerRadius, M_PI / 2, M_PI);
     cairo_close_path(cr);
+}
+
+// Draw the whole panel (box, border, text) centred on (msgX, msgY)
+static void paintPropagandaPanel(cairo_t *cr, const PropagandaLayout &layout, bool retro,
+                                 double msgX, double msgY) {
+    cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    cairo_set_font_size(cr, layout.fontSize);
+    
+    double boxX = msgX - layout.boxWidth/2;
+    double boxY = msgY - layout.boxHeight/2;
+    
+    if (retro) {
+        // Semi-transparent red background with a white border
+        cairo_set_source_rgba(cr, 0.8, 0.0, 0.0, 0.8);
+        cairo_rectangle(cr, boxX, boxY, layout.boxWidth, layout.boxHeight);
+        cairo_fill(cr);
+        
+        cairo_set_source_rgb(cr, 1.0, 1.0, 1.0);
+        cairo_set_line_width(cr, 2.0);
+        cairo_rectangle(cr, boxX, boxY, layout.boxWidth, layout.boxHeight);
+        cairo_stroke(cr);
+        
+        // Draw text in white
+        cairo_set_source_rgb(cr, 1.0, 1.0, 1.0);
+        drawPropagandaText(cr, layout, msgX, msgY, 0);
+        return;
+    }
+    
+    // Patriotic blue rounded box with red and white borders
+    double cornerRadius = 8.0;
+    cairo_set_source_rgba(cr, 0.0, 0.2, 0.7, 0.85);
+    roundedBoxPath(cr, boxX, boxY, layout.boxWidth, layout.boxHeight, cornerRadius);
     cairo_fill(cr);
     
-    // Draw patriotic border
     cairo_set_line_width(cr, 3.0);
     cairo_set_source_rgb(cr, 0.8, 0.0, 0.0);
-    cairo_new_sub_path(cr);
-    cairo_arc(cr, boxX + cornerRadius, boxY + cornerRadius, cornerRadius, M_PI, 3 * M_PI / 2);
-    cairo_arc(cr, boxX + boxWidth - cornerRadius, boxY + cornerRadius, cornerRadius, 3 * M_PI / 2, 0);
-    cairo_arc(cr, boxX + boxWidth - cornerRadius, boxY + boxHeight - cornerRadius, cornerRadius, 0, M_PI / 2);
-    cairo_arc(cr, boxX + cornerRadius, boxY + boxHeight - cornerRadius, cornerRadius, M_PI / 2, M_PI);
-    cairo_close_path(cr);
+    roundedBoxPath(cr, boxX, boxY, layout.boxWidth, layout.boxHeight, cornerRadius);
     cairo_stroke(cr);
     
     cairo_set_source_rgb(cr, 1.0, 1.0, 1.0);
     cairo_set_line_width(cr, 1.5);
-    cairo_new_sub_path(cr);
-    cairo_arc(cr, boxX + cornerRadius, boxY + cornerRadius, cornerRadius, M_PI, 3 * M_PI / 2);
-    cairo_arc(cr, boxX + boxWidth - cornerRadius, boxY + cornerRadius, cornerRadius, 3 * M_PI / 2, 0);
-    cairo_arc(cr, boxX + boxWidth - cornerRadius, boxY + boxHeight - cornerRadius, cornerRadius, 0, M_PI / 2);
-    cairo_arc(cr, boxX + cornerRadius, boxY + boxHeight - cornerRadius, cornerRadius, M_PI / 2, M_PI);
-    cairo_close_path(cr);
+    roundedBoxPath(cr, boxX, boxY, layout.boxWidth, layout.boxHeight, cornerRadius);
     cairo_stroke(cr);
     
     // Draw text with shadow
     cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.3);
-    
-    if (formattedMessage.find('\n') != std::string::npos) {
-        std::string firstLine = formattedMessage.substr(0, formattedMessage.find('\n'));
-        std::string secondLine = formattedMessage.substr(formattedMessage.find('\n') + 1);
-        
-        cairo_text_extents_t firstLineExtents;
-        cairo_text_extents(cr, firstLine.c_str(), &firstLineExtents);
-        
-        cairo_move_to(cr, msgX - firstLineExtents.width/2 + 1, msgY - fontSize/2 + 1);
-        cairo_show_text(cr, firstLine.c_str());
-        
-        cairo_text_extents_t secondLineExtents;
-        cairo_text_extents(cr, secondLine.c_str(), &secondLineExtents);
-        cairo_move_to(cr, msgX - secondLineExtents.width/2 + 1, msgY + fontSize + 1);
-        cairo_show_text(cr, secondLine.c_str());
-    } else {
-        cairo_move_to(cr, msgX - newExtents.width/2 + 1, msgY + newExtents.height/2 + 1);
-        cairo_show_text(cr, formattedMessage.c_str());
-    }
-    
-    // Draw main text
+    drawPropagandaText(cr, layout, msgX, msgY, 1);
     cairo_set_source_rgb(cr, 1.0, 1.0, 1.0);
-    
-    if (formattedMessage.find('\n') != std::string::npos) {
-        std::string firstLine = formattedMessage.substr(0, formattedMessage.find('\n'));
-        std::string secondLine = formattedMessage.substr(formattedMessage.find('\n') + 1);
-        
-        cairo_text_extents_t firstLineExtents;
-        cairo_text_extents(cr, firstLine.c_str(), &firstLineExtents);
-        
-        cairo_move_to(cr, msgX - firstLineExtents.width/2, msgY - fontSize/2);
-        cairo_show_text(cr, firstLine.c_str());
-        
-        cairo_text_extents_t secondLineExtents;
-        cairo_text_extents(cr, secondLine.c_str(), &secondLineExtents);
-        cairo_move_to(cr, msgX - secondLineExtents.width/2, msgY + fontSize);
-        cairo_show_text(cr, secondLine.c_str());
-    } else {
-        cairo_move_to(cr, msgX - newExtents.width/2, msgY + newExtents.height/2);
-        cairo_show_text(cr, formattedMessage.c_str());
-    }
-  }
+    drawPropagandaText(cr, layout, msgX, msgY, 0);
 }
 
-void drawCurrentPiece(cairo_t *cr, TetrimoneBoard *board) {
-  if (!board->isGameOver() && !board->isPaused() && !board->isSplashScreenActive()) {
-    const TetrimoneBlock* piecePtr = board->getCurrentPiece();
-    if (!piecePtr) return;  // Safety check
-    
-    const TetrimoneBlock &piece = *piecePtr;
-    auto shape = piece.getShape();
-    auto color = board->isInThemeTransition() ? 
-    board->getInterpolatedColor(piece.getType(), board->getThemeTransitionProgress()) :
-    piece.getColor();
+// Re-render the cached panel if the message, style, width or device scale changed
+static void updatePropagandaPanel(cairo_t *target, const std::string &message, bool retro,
+                                  double screenWidth) {
+    double sx = 1.0, sy = 1.0;
+    cairo_user_to_device_distance(target, &sx, &sy);
+    double pixelScale = std::round(std::fabs(sx) * 100.0) / 100.0;
+    if (pixelScale <= 0.0) pixelScale = 1.0;
+    
+    PropagandaPanel &panel = propagandaPanel;
+    if (panel.surface && panel.message == message && panel.retro == retro &&
+        panel.screenWidth == screenWidth && panel.pixelScale == pixelScale) {
+        return;
+    }
     
-    double pieceX, pieceY;
-    board->getCurrentPieceInterpolatedPosition(pieceX, pieceY);
-
-    cairo_set_source_rgb(cr, color[0], color[1], color[2]);
-
-    for (size_t y = 0; y < shape.size(); ++y) {
-      for (size_t x = 0; x < shape[y].size(); ++x) {
-        if (shape[y][x] == 1) {
-          double drawX = (pieceX + x) * BLOCK_SIZE;
-          double drawY = (pieceY + y) * BLOCK_SIZE;
-
-          if (drawY >= -BLOCK_SIZE) {
-            if (board->retroModeActive || board->simpleBlocksActive) {
-              cairo_rectangle(cr, drawX, drawY, BLOCK_SIZE, BLOCK_SIZE);
-              cairo_fill(cr);
-            } else {
-              cairo_rectangle(cr, drawX + 1, drawY + 1, BLOCK_SIZE - 2, BLOCK_SIZE - 2);
-              cairo_fill(cr);
-
-              // Draw highlight (3D effect)
-              cairo_set_source_rgba(cr, 1, 1, 1, 0.3);
-              cairo_move_to(cr, drawX + 1, drawY + 1);
-              cairo_line_to(cr, drawX + BLOCK_SIZE - 1, drawY + 1);
-              cairo_line_to(cr, drawX + 1, drawY + BLOCK_SIZE - 1);
-              cairo_close_path(cr);
-              cairo_fill(cr);
-
-              // Draw shadow (3D effect)
-              cairo_set_source_rgba(cr, 0, 0, 0, 0.3);
-              cairo_move_to(cr, drawX + BLOCK_SIZE - 1, drawY + 1);
-              cairo_line_to(cr, drawX + BLOCK_SIZE - 1, drawY + BLOCK_SIZE - 1);
-              cairo_line_to(cr, drawX + 1, drawY + BLOCK_SIZE - 1);
-              cairo_close_path(cr);
-              cairo_fill(cr);
-
-              // Reset color for next block
-              cairo_set_source_rgb(cr, color[0], color[1], color[2]);
-            }
-          }
-        }
-      }
+    if (panel.surface) {
+        cairo_surface_destroy(panel.surface);
+        panel.surface = nullptr;
     }
-  }
-}
-
-void drawGhostPiece(cairo_t *cr, TetrimoneBoard *board) {
-  if (!board->isGameOver() && !board->isPaused() && 
-      !board->isSplashScreenActive() && board->isGhostPieceEnabled()) {
-    
-    const TetrimoneBlock* piecePtr = board->getCurrentPiece();
-    if (!piecePtr) return;  // Safety check
-    
-    const TetrimoneBlock &piece = *piecePtr;
-    auto shape = piece.getShape();
-    auto color = piece.getColor();
-    
-    double currentPieceX, currentPieceY;
-    board->getCurrentPieceInterpolatedPosition(currentPieceX, currentPieceY);
-    int ghostY = board->getGhostPieceY();
-
-    if (ghostY > (int)currentPieceY) {
-      cairo_set_source_rgba(cr, color[0], color[1], color[2], 0.3);
-
-      for (size_t y = 0; y < shape.size(); ++y) {
-        for (size_t x = 0; x < shape[y].size(); ++x) {
-          if (shape[y][x] == 1) {
-            double drawX = (currentPieceX + x) * BLOCK_SIZE;
-            double drawY = (ghostY + y) * BLOCK_SIZE;
-
-            if (drawY >= 0) {
-              if (board->retroModeActive) {
-                cairo_rectangle(cr, drawX, drawY, BLOCK_SIZE, BLOCK_SIZE);
-                cairo_stroke(cr);
-              } else {
-                cairo_rectangle(cr, drawX + 1, drawY + 1, BLOCK_SIZE - 2, BLOCK_SIZE - 2);
-                cairo_stroke_preserve(cr);
-                cairo_fill(cr);
-              }
-            }
-          }
-        }
-      }
+    panel.message = message;
+    panel.retro = retro;
+    panel.screenWidth = screenWidth;
+    panel.pixelScale = pixelScale;
+    
+    // Lay out against a scratch context so the target's font state is untouched
+    cairo_surface_t *scratch = cairo_image_surface_create(CAIRO_FORMAT_A8, 1, 1);
+    cairo_t *measure = cairo_create(scratch);
+    PropagandaLayout layout = layoutPropagandaMessage(measure, message, retro, screenWidth);
+    cairo_destroy(measure);
+    cairo_surface_destroy(scratch);
+    
+    // Room for the border strokes around the box
+    const double margin = 3.0;
+    panel.width = layout.boxWidth + margin * 2;
+    panel.height = layout.boxHeight + margin * 2;
+    
+    // Rasterize at the largest pulse so scaling only ever shrinks the image
+    double rasterScale = pixelScale * PROPAGANDA_MAX_SCALE;
+    panel.surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                               (int)std::ceil(panel.width * rasterScale),
+                                               (int)std::ceil(panel.height * rasterScale));
+    if (cairo_surface_status(panel.surface) != CAIRO_STATUS_SUCCESS) {
+        std::cerr << "Failed to create propaganda message surface" << std::endl;
+        cairo_surface_destroy(panel.surface);
+        panel.surface = nullptr;
+        return;
     }
-  }
-}
-
-void drawPauseMenu(cairo_t *cr, TetrimoneBoard *board) {
-  if (board->isPaused() && !board->isGameOver()) {
-    cairo_set_source_rgba(cr, 0, 0, 0, 0.7);
-    cairo_rectangle(cr, 0, 0, GRID_WIDTH * BLOCK_SIZE,
-                    GRID_HEIGHT * BLOCK_SIZE);
-    cairo_fill(cr);
-
-    cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL,
-                          CAIRO_FONT_WEIGHT_BOLD);
-    cairo_set_font_size(cr, 30);
-    cairo_set_source_rgb(cr, 1, 1, 1);
-
-    cairo_text_extents_t extents;
-    const char *text = board->retroModeActive ? "ПРИОСТАНОВЛЕНО ПО ПРИКАЗУ ПАРТИИ" : "PAUSED";
-    cairo_text_extents(cr, text, &extents);
-
-    double x = (GRID_WIDTH * BLOCK_SIZE - extents.width) / 2;
-    double y = (GRID_HEIGHT * BLOCK_SIZE) / 4;
-
-    cairo_move_to(cr, x, y);
-    cairo_show_text(cr, text);
-
-    const int numOptions = 3;
-    const char *menuOptions[numOptions];
+    cairo_surface_set_device_scale(panel.surface, rasterScale, rasterScale);
     
-    if (board->retroModeActive) {
-        menuOptions[0] = "Продолжить Трудовой Подвиг (P)";
-        menuOptions[1] = "Новая Пятилетка (N)";
-        menuOptions[2] = "Дезертировать с Поля Боя (Q)";
-    } else {
-        menuOptions[0] = "Continue (P)";
-        menuOptions[1] = "New Game (N)";
-        menuOptions[2] = "Quit (Q)";
-    }
-
-    cairo_set_font_size(cr, 20);
-    y = (GRID_HEIGHT * BLOCK_SIZE) / 2;
-
-    for (int i = 0; i < numOptions; i++) {
-        cairo_text_extents(cr, menuOptions[i], &extents);
-        x = (GRID_WIDTH * BLOCK_SIZE - extents.width) / 2;
-
-        cairo_move_to(cr, x, y);
-        cairo_show_text(cr, menuOptions[i]);
+    cairo_t *cr = cairo_create(panel.surface);
+    paintPropagandaPanel(cr, layout, retro, panel.width / 2, panel.height / 2);
+    cairo_destroy(cr);
+    cairo_surface_flush(panel.surface);
+}
 
-        y += 40;
-    }
-  }
+void drawPropagandaMessage(cairo_t *cr, TetrimoneBoard *board) {
+  Profiler::Scope scope("drawPropagandaMessage");
+  bool retro = board->retroModeActive;
+  if (!board->showPropagandaMessage || !(retro || board->patrioticModeActive)) return;
+  
+  double screenWidth = GRID_WIDTH * BLOCK_SIZE;
+  updatePropagandaPanel(cr, board->currentPropagandaMessage, retro, screenWidth);
+  const PropagandaPanel &panel = propagandaPanel;
+  if (!panel.surface) return;
+  
+  // Message position - center of screen
+  double msgX = (GRID_WIDTH * BLOCK_SIZE) / 2;
+  double msgY = (GRID_HEIGHT * BLOCK_SIZE) / 2;
+  
+  // Pulse by scaling the cached image, but never past the board edges
+  double scale = std::max(0.1, std::min(board->propagandaMessageScale, PROPAGANDA_MAX_SCALE));
+  scale = std::min(scale, screenWidth / panel.width);
+  
+  cairo_save(cr);
+  cairo_translate(cr, msgX, msgY);
+  cairo_scale(cr, scale, scale);
+  cairo_set_source_surface(cr, panel.surface, -panel.width / 2, -panel.height / 2);
+  cairo_paint(cr);
+  cairo_restore(cr);
 }
 
 void drawFireyGlow(cairo_t* cr, double x, double y, double size, float heatLevel, double time) {
+   drawFireyGlow(cr, effectSprites, BLOCK_SIZE, qualityGovernor.budget(), x, y, size, heatLevel,
+                 time);
+}
+
+void drawFireyGlow(cairo_t* cr, EffectSprites &sprites, int blockSize,
+                   const QualityGovernor::Budget &budget, double x, double y,
+                   double size, float heatLevel, double time) {
    if (heatLevel <= 0.7f) return;
+   Profiler::Tally tally("drawFireyGlow");
    
    // Calculate glow intensity based on heat level
    float glowIntensity = (heatLevel - 0.7f) / 0.3f; // 0.0 to 1.0 range
@@ -921,85 +674,40 @@ void drawFireyGlow(cairo_t* cr, double x, double y, double size, float heatLevel
    double pulseTime = fmod(time * pulseSpeed, 2000.0) / 2000.0; // 2-second base cycle
    double pulse = 0.5 + 0.5 * sin(pulseTime * 2 * M_PI); // 0.0 to 1.0 pulse
    
-   // Combine intensity with pulse for final glow strength
-   double finalGlowStrength = glowIntensity * (0.6 + 0.4 * pulse);
+   sprites.prepare(cr, blockSize);
+   int step = std::max(0, std::min(EffectSprites::GLOW_STEPS - 1,
+       (int)lround(glowIntensity * (EffectSprites::GLOW_STEPS - 1))));
+   double scale = size / blockSize;
    
-   // Save the current state
-   cairo_save(cr);
-   
-   // Create multiple glow layers for depth (more layers at higher heat)
-   int numLayers = 3 + (int)(glowIntensity * 2); // 3-5 layers based on heat
-   for (int layer = 0; layer < numLayers; layer++) {
-       double layerSize = size + (layer + 1) * 6 * finalGlowStrength;
-       double layerAlpha = finalGlowStrength * (0.5 - layer * 0.08);
-       
-       if (layerAlpha <= 0) continue;
-       
-       // Prevent division by zero for radius
-       double radius = layerSize / 2;
-       if (radius <= 0) radius = 1.0;
-       
-       // Create radial gradient for each glow layer
-       cairo_pattern_t* gradient = cairo_pattern_create_radial(
-           x + size/2, y + size/2, 0,
-           x + size/2, y + size/2, radius
-       );
-       
-       // Color shifts based on heat intensity
-       float redIntensity = 1.0f;
-       float greenIntensity = 0.3f + glowIntensity * 0.4f;
-       float blueIntensity = glowIntensity > 0.8f ? 0.2f : 0.0f; // Add blue for extreme heat
-       
-       // Inner glow color (varies with intensity)
-       cairo_pattern_add_color_stop_rgba(gradient, 0.0, 
-           redIntensity, greenIntensity, blueIntensity, layerAlpha);
-       
-       // Outer glow color (red fading to transparent)
-       cairo_pattern_add_color_stop_rgba(gradient, 1.0, 
-           1.0, 0.0, 0.0, 0.0);
-       
-       cairo_set_source(cr, gradient);
-       
-       // Draw the glow circle
-       cairo_arc(cr, x + size/2, y + size/2, radius, 0, 2 * M_PI);
-       cairo_fill(cr);
-       
-       cairo_pattern_destroy(gradient);
+   // The halo is baked at full strength; the pulse fades it like it did each layer
+   if (budget.glowHalo) {
+       EffectSprites::blit(cr, sprites.glowHalo(step), x, y, scale, 0.6 + 0.4 * pulse);
    }
    
    // Add flickering fire particles for extra effect at high heat
-   if (heatLevel > 0.85f) {
-       cairo_set_source_rgba(cr, 1.0, 0.8, 0.0, 0.4 * pulse * glowIntensity);
-       
-       // More particles at higher heat
-       int numParticles = 6 + (int)(glowIntensity * 4);
-       if (numParticles <= 0) numParticles = 1; // Prevent division by zero
+   if (heatLevel > 0.85f && budget.fireRing) {
+       // The ring repeats every particle spacing, so only that arc needs phases
+       double spacing = 2 * M_PI / EffectSprites::fireParticleCount(step);
+       double angle = fmod(pulseTime * 4 * M_PI, spacing);
+       int phase = std::min(EffectSprites::RING_PHASES - 1,
+           (int)(angle / spacing * EffectSprites::RING_PHASES));
        
-       for (int i = 0; i < numParticles; i++) {
-           double angle = (i / (double)numParticles) * 2 * M_PI + pulseTime * 4 * M_PI;
-           
-           // Ensure rand() % doesn't get 0
-           int randRange = 5;
-           if (randRange <= 0) randRange = 1;
-           
-           double radius = size/2 + 5 + (rand() % randRange) * glowIntensity;
-           double particleX = x + size/2 + cos(angle) * radius;
-           double particleY = y + size/2 + sin(angle) * radius;
-           
-           double particleRadius = 1 + glowIntensity * 2;
-           if (particleRadius <= 0) particleRadius = 1.0;
-           
-           cairo_arc(cr, particleX, particleY, particleRadius, 0, 2 * M_PI);
-           cairo_fill(cr);
-       }
+       EffectSprites::blit(cr, sprites.fireRing(step, phase), x, y, scale,
+           0.4 * pulse * glowIntensity);
    }
-   
-   cairo_restore(cr);
 }
 
 // New function for drawing freezy effect
 void drawFreezyEffect(cairo_t* cr, double x, double y, double size, float heatLevel, double time) {
+   drawFreezyEffect(cr, effectSprites, BLOCK_SIZE, qualityGovernor.budget(), x, y, size,
+                    heatLevel, time);
+}
+
+void drawFreezyEffect(cairo_t* cr, EffectSprites &sprites, int blockSize,
+                      const QualityGovernor::Budget &budget, double x, double y,
+                      double size, float heatLevel, double time) {
    if (heatLevel >= 0.3f) return;
+   Profiler::Tally tally("drawFreezyEffect");
    
    // Calculate freeze intensity (higher when colder)
    float freezeIntensity = (0.3f - heatLevel) / 0.3f; // 0.0 to 1.0 range
@@ -1009,99 +717,39 @@ void drawFreezyEffect(cairo_t* cr, double x, double y, double size, float heatLe
    double shimmerTime = fmod(time * shimmerSpeed, 3000.0) / 3000.0; // 3-second base cycle
    double shimmer = 0.3 + 0.2 * sin(shimmerTime * 2 * M_PI);
    
-   cairo_save(cr);
-   
    // Draw ice crystal overlay (more opaque when colder)
    double iceOpacity = 0.15 + 0.25 * freezeIntensity;
    cairo_set_source_rgba(cr, 0.7, 0.9, 1.0, iceOpacity * shimmer);
    cairo_rectangle(cr, x, y, size, size);
    cairo_fill(cr);
    
-   // Create multiple layers of sparkly stars
-   for (int layer = 0; layer < 3; layer++) {
+   sprites.prepare(cr, blockSize);
+   int step = std::max(0, std::min(EffectSprites::FROST_STEPS - 1,
+       (int)lround(freezeIntensity * (EffectSprites::FROST_STEPS - 1))));
+   int variant = EffectSprites::frostVariant(x, y, size, blockSize);
+   double scale = size / blockSize;
+   
+   // Star layers are pre-drawn per cell layout; each layer only fades in and out
+   int layers = std::min(budget.frostLayers, (int)EffectSprites::FROST_LAYERS);
+   for (int layer = 0; layer < layers; layer++) {
        // Different timing for each layer creates depth
        double layerTime = shimmerTime + (layer * 0.3);
        double layerShimmer = 0.4 + 0.6 * sin(layerTime * 2 * M_PI);
        
        // Star brightness varies by layer and freeze intensity
        double starAlpha = (0.3 + 0.7 * freezeIntensity) * layerShimmer * (1.0 - layer * 0.2);
-       cairo_set_source_rgba(cr, 1.0, 1.0, 1.0, starAlpha);
-       
-       // Number of stars increases with freeze intensity
-       int numStars = 2 + layer + (int)(freezeIntensity * 4);
-       
-       for (int i = 0; i < numStars; i++) {
-           // Use deterministic positioning based on block coordinates and layer
-           int seed = (int)(x + y * 100 + layer * 1000 + i * 137);
-           srand(seed); // Temporary seed for consistent positioning
-           
-           // Fix: Ensure we don't get division by zero or negative modulo
-           int maxX = (int)(size - 8);
-           int maxY = (int)(size - 8);
-           if (maxX <= 0) maxX = 1;
-           if (maxY <= 0) maxY = 1;
-           
-           double starX = x + 4 + (rand() % maxX);
-           double starY = y + 4 + (rand() % maxY);
-           
-           // Star size varies with intensity and layer
-           double starSize = 1.5 + freezeIntensity * 2 + layer * 0.5;
-           
-           // Draw 4-pointed star
-           double armLength = starSize + layerShimmer * 0.5;
-           
-           // Horizontal arm
-           cairo_move_to(cr, starX - armLength, starY);
-           cairo_line_to(cr, starX + armLength, starY);
-           
-           // Vertical arm
-           cairo_move_to(cr, starX, starY - armLength);
-           cairo_line_to(cr, starX, starY + armLength);
-           
-           cairo_set_line_width(cr, 0.8 + layer * 0.2);
-           cairo_stroke(cr);
-           
-           // Add diagonal arms for bigger stars at higher freeze intensity
-           if (freezeIntensity > 0.5f && layer == 0) {
-               double diagLength = armLength * 0.7;
-               
-               // Diagonal arms
-               cairo_move_to(cr, starX - diagLength, starY - diagLength);
-               cairo_line_to(cr, starX + diagLength, starY + diagLength);
-               cairo_move_to(cr, starX - diagLength, starY + diagLength);
-               cairo_line_to(cr, starX + diagLength, starY - diagLength);
-               
-               cairo_set_line_width(cr, 0.6);
-               cairo_stroke(cr);
-           }
-       }
+       EffectSprites::blit(cr, sprites.frostStars(step, variant, layer), x, y, scale, starAlpha);
    }
    
    // Add floating sparkle particles around the block for extreme cold
-   if (heatLevel < 0.1f) {
-       cairo_set_source_rgba(cr, 0.9, 0.95, 1.0, 0.4 * shimmer);
+   if (heatLevel < 0.1f && budget.coldSparkles) {
+       double spacing = 2 * M_PI / 6;
+       double angle = fmod(shimmerTime * M_PI, spacing);
+       int phase = std::min(EffectSprites::RING_PHASES - 1,
+           (int)(angle / spacing * EffectSprites::RING_PHASES));
        
-       // Draw small sparkle points floating around the block
-       for (int i = 0; i < 6; i++) {
-           double angle = (i / 6.0) * 2 * M_PI + shimmerTime * M_PI;
-           double distance = size/2 + 4 + sin(shimmerTime * 4 + i) * 2;
-           double sparkleX = x + size/2 + cos(angle) * distance;
-           double sparkleY = y + size/2 + sin(angle) * distance;
-           
-           // Draw tiny 4-pointed stars
-           double tinySize = 1.0 + sin(shimmerTime * 3 + i * 2) * 0.5;
-           
-           cairo_move_to(cr, sparkleX - tinySize, sparkleY);
-           cairo_line_to(cr, sparkleX + tinySize, sparkleY);
-           cairo_move_to(cr, sparkleX, sparkleY - tinySize);
-           cairo_line_to(cr, sparkleX, sparkleY + tinySize);
-           
-           cairo_set_line_width(cr, 0.5);
-           cairo_stroke(cr);
-       }
+       EffectSprites::blit(cr, sprites.coldSparkles(phase), x, y, scale, 0.4 * shimmer);
    }
-   
-   cairo_restore(cr);
 }
 
 void TetrimoneBoard::cleanupBackgroundImages() {
@@ -1214,7 +862,7 @@ cairo_surface_t* cairo_image_surface_create_from_memory(const void* data, size_t
 }
 #endif  // GTK3
 
-#ifdef QT5
+#if defined(QT5) || defined(KIOSK)
 extern "C" {
     #include <jpeglib.h>
 }
@@ -1346,7 +994,7 @@ cairo_surface_t* cairo_image_surface_create_from_memory(const void* data, size_t
     cairo_surface_mark_dirty(surface);
     return surface;
 }
-#endif  // QT5
+#endif  // QT5 || KIOSK
 
 bool TetrimoneBoard::loadBackgroundImage(const std::string& imagePath) {
     // Clean up previous image if it exists
@@ -1476,7 +1124,7 @@ void TetrimoneBoard::startBackgroundTransition() {
     }
     
     // If already transitioning, cancel the current transition
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
     if (isTransitioning && transitionTimerId > 0) {
         g_source_remove(transitionTimerId);
         transitionTimerId = 0;
@@ -1520,7 +1168,7 @@ void TetrimoneBoard::startBackgroundTransition() {
     // We'll call selectRandomBackground() when we're fully faded out
     
     // Start the transition timer - update 20 times per second
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
     transitionTimerId = g_timeout_add(50, 
         [](gpointer data) -> gboolean {
             TetrimoneBoard* board = static_cast<TetrimoneBoard*>(data);
@@ -1571,7 +1219,7 @@ void TetrimoneBoard::updateBackgroundTransition() {
         }
         
         // Clean up the timer
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
         if (transitionTimerId > 0) {
             g_source_remove(transitionTimerId);
             transitionTimerId = 0;
@@ -1587,7 +1235,7 @@ void TetrimoneBoard::updateBackgroundTransition() {
 }
 
 void TetrimoneBoard::cancelBackgroundTransition() {
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
     if (isTransitioning && transitionTimerId > 0) {
         g_source_remove(transitionTimerId);
         transitionTimerId = 0;
@@ -10,6 +10,8 @@
 void drawGridBlocks(cairo_t *cr, TetrimoneBoard *board) {
     if (!board) return;
     
+    const ThemePalette& palette = board->getPalette();
+    
     for (int y = 0; y < GRID_HEIGHT; y++) {
         for (int x = 0; x < GRID_WIDTH; x++) {
             int gridValue = board->getGridValue(x, y);
@@ -22,7 +24,7 @@ void drawGridBlocks(cairo_t *cr, TetrimoneBoard *board) {
             int py = y * BLOCK_SIZE;
             
             // Get block color with theme interpolation support
-            std::array<double, 3> color = board->getInterpolatedColor(gridValue, 0.0);
+            const std::array<double, 3>& color = palette.color(gridValue - 1);
             
             if (isClearing) {
                 // Draw line clear animation - blocks fade out and scale
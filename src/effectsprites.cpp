@@ -0,0 +1,317 @@
+// ============================================================================
+// Heat Effect Sprite Cache for the Cairo renderer (Framework-Agnostic)
+// ============================================================================
+
+#include "tetrimone_core.h"
+#include "effectsprites.h"
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+EffectSprites effectSprites;
+
+// Distance the effects reach past the block edge, in user units
+static const int GLOW_MARGIN = 16;     // Outer layer reaches 15px past the edge
+static const int RING_MARGIN = 14;     // Particle orbit plus jitter and radius
+static const int SPARKLE_MARGIN = 8;
+
+EffectSprites::EffectSprites() : blockSize(0), pixelScale(0.0), fireworkPattern(nullptr) {}
+
+EffectSprites::~EffectSprites() {
+  clear();
+  if (fireworkPattern) {
+    cairo_pattern_destroy(fireworkPattern);
+  }
+}
+
+void EffectSprites::clear() {
+  std::vector<Sprite> *lists[] = {&halos, &fireRings, &frost, &sparkles};
+  for (std::vector<Sprite> *list : lists) {
+    for (Sprite &sprite : *list) {
+      if (sprite.surface) cairo_surface_destroy(sprite.surface);
+    }
+    list->clear();
+  }
+}
+
+void EffectSprites::prepare(cairo_t *cr) {
+  prepare(cr, BLOCK_SIZE);
+}
+
+void EffectSprites::prepare(cairo_t *cr, int size) {
+  double sx = 1.0, sy = 1.0;
+  cairo_user_to_device_distance(cr, &sx, &sy);
+  double scale = std::round(std::fabs(sx) * 100.0) / 100.0;
+  if (scale <= 0.0) scale = 1.0;
+
+  if (blockSize == size && pixelScale == scale && !halos.empty()) {
+    return;
+  }
+
+  clear();
+  blockSize = size;
+  pixelScale = scale;
+  halos.resize(GLOW_STEPS);
+  fireRings.resize(GLOW_STEPS * RING_PHASES);
+  frost.resize(FROST_STEPS * FROST_VARIANTS * FROST_LAYERS);
+  sparkles.resize(RING_PHASES);
+}
+
+EffectSprites::Sprite EffectSprites::createSprite(int margin, cairo_t **cr) const {
+  Sprite sprite;
+  int extent = blockSize + 2 * margin;
+  int pixels = (int)std::ceil(extent * pixelScale);
+
+  sprite.surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, pixels, pixels);
+  if (cairo_surface_status(sprite.surface) != CAIRO_STATUS_SUCCESS) {
+    std::cerr << "Failed to create effect sprite surface" << std::endl;
+    cairo_surface_destroy(sprite.surface);
+    sprite.surface = nullptr;
+    *cr = nullptr;
+    return sprite;
+  }
+  cairo_surface_set_device_scale(sprite.surface, pixelScale, pixelScale);
+  sprite.originX = margin;
+  sprite.originY = margin;
+
+  // Callers draw relative to the block's top-left corner
+  *cr = cairo_create(sprite.surface);
+  cairo_translate(*cr, margin, margin);
+  return sprite;
+}
+
+void EffectSprites::finishSprite(Sprite &sprite, cairo_t *cr) {
+  if (!cr) return;
+  cairo_destroy(cr);
+  cairo_surface_flush(sprite.surface);
+}
+
+// Small integer hash for the baked particle jitter
+static unsigned int effectHash(unsigned int a, unsigned int b) {
+  unsigned int h = a * 0x9E3779B1u ^ (b + 0x7F4A7C15u + (a << 6) + (a >> 2));
+  h ^= h >> 15;
+  h *= 0x2C1B3C6Du;
+  h ^= h >> 12;
+  return h;
+}
+
+// ============================================================================
+// Hot: glow halo and fire particles
+// ============================================================================
+
+const EffectSprites::Sprite &EffectSprites::glowHalo(int step) {
+  Sprite &sprite = halos[step];
+  if (sprite.surface) return sprite;
+
+  cairo_t *cr = nullptr;
+  sprite = createSprite(GLOW_MARGIN, &cr);
+  if (!cr) return sprite;
+
+  // Baked at full pulse; the pulse only scales layer alpha, applied at draw time
+  const double size = blockSize;
+  const double glowIntensity = (double)step / (GLOW_STEPS - 1);
+  const double strength = glowIntensity;
+  const double centerX = size / 2;
+  const double centerY = size / 2;
+  const int numLayers = 3 + (int)(glowIntensity * 2);
+
+  for (int layer = 0; layer < numLayers; layer++) {
+    double layerSize = size + (layer + 1) * 6 * strength;
+    double layerAlpha = strength * (0.5 - layer * 0.08);
+
+    cairo_pattern_t *gradient = cairo_pattern_create_radial(
+        centerX, centerY, 0, centerX, centerY, layerSize / 2);
+
+    double red = 1.0;
+    double green = 0.3 + glowIntensity * 0.4;
+    double blue = glowIntensity > 0.8 ? 0.2 : 0.0;
+
+    cairo_pattern_add_color_stop_rgba(gradient, 0, red, green, blue, layerAlpha);
+    cairo_pattern_add_color_stop_rgba(gradient, 1, 1.0, 0.0, 0.0, 0);
+
+    cairo_set_source(cr, gradient);
+    cairo_arc(cr, centerX, centerY, layerSize / 2, 0, 2 * M_PI);
+    cairo_fill(cr);
+    cairo_pattern_destroy(gradient);
+  }
+
+  finishSprite(sprite, cr);
+  return sprite;
+}
+
+int EffectSprites::fireParticleCount(int step) {
+  return 6 + (int)((double)step / (GLOW_STEPS - 1) * 4);
+}
+
+const EffectSprites::Sprite &EffectSprites::fireRing(int step, int phase) {
+  Sprite &sprite = fireRings[step * RING_PHASES + phase];
+  if (sprite.surface) return sprite;
+
+  cairo_t *cr = nullptr;
+  sprite = createSprite(RING_MARGIN, &cr);
+  if (!cr) return sprite;
+
+  const double size = blockSize;
+  const double glowIntensity = (double)step / (GLOW_STEPS - 1);
+  const int numParticles = fireParticleCount(step);
+  const double phaseAngle = (2 * M_PI / numParticles) * phase / RING_PHASES;
+
+  // Opaque-alpha particles; pulse and intensity fade applied at draw time
+  cairo_set_source_rgba(cr, 1.0, 0.8, 0.0, 1.0);
+  for (int i = 0; i < numParticles; i++) {
+    double angle = (double)i / numParticles * 2 * M_PI + phaseAngle;
+    double jitter = (effectHash(step * RING_PHASES + phase, i) % 5) * glowIntensity;
+    double radius = size / 2 + 5 + jitter;
+
+    double particleX = size / 2 + cos(angle) * radius;
+    double particleY = size / 2 + sin(angle) * radius;
+
+    cairo_arc(cr, particleX, particleY, 1 + glowIntensity * 2, 0, 2 * M_PI);
+    cairo_fill(cr);
+  }
+
+  finishSprite(sprite, cr);
+  return sprite;
+}
+
+// ============================================================================
+// Cold: frost stars and orbiting sparkles
+// ============================================================================
+
+// One four-pointed star
+static void strokeStar(cairo_t *cr, double x, double y, double arm) {
+  cairo_move_to(cr, x - arm, y);
+  cairo_line_to(cr, x + arm, y);
+  cairo_move_to(cr, x, y - arm);
+  cairo_line_to(cr, x, y + arm);
+  cairo_stroke(cr);
+}
+
+int EffectSprites::frostVariant(double x, double y, double size, int cellSize) {
+  int column = (int)std::floor((x + size / 2) / cellSize);
+  int row = (int)std::floor((y + size / 2) / cellSize);
+  return effectHash(column, row) % FROST_VARIANTS;
+}
+
+const EffectSprites::Sprite &EffectSprites::frostStars(int step, int variant, int layer) {
+  Sprite &sprite = frost[(step * FROST_VARIANTS + variant) * FROST_LAYERS + layer];
+  if (sprite.surface) return sprite;
+
+  // Stars stay inside the block; one pixel of margin covers the line caps
+  cairo_t *cr = nullptr;
+  sprite = createSprite(1, &cr);
+  if (!cr) return sprite;
+
+  const double size = blockSize;
+  const double freezeIntensity = (double)step / (FROST_STEPS - 1);
+  const int numStars = 2 + layer + (int)(freezeIntensity * 4);
+  const double starSize = 1.5 + freezeIntensity * 2 + layer * 0.5;
+  const double armLength = starSize + 0.2;  // Mid shimmer
+  const bool diagonals = freezeIntensity > 0.5 && layer == 0;
+
+  // Local generator: the layout is fixed per variant and libc's rand() is left alone
+  std::minstd_rand rng(1 + variant * 131 + layer * 1000);
+  int maxOffset = std::max(1, (int)size - 8);
+
+  cairo_set_source_rgba(cr, 1.0, 1.0, 1.0, 1.0);
+  for (int i = 0; i < numStars; i++) {
+    double starX = 4 + (int)(rng() % maxOffset);
+    double starY = 4 + (int)(rng() % maxOffset);
+
+    cairo_set_line_width(cr, 0.8 + layer * 0.2);
+    strokeStar(cr, starX, starY, armLength);
+
+    // Diagonal arms for bigger stars at higher freeze intensity
+    if (diagonals) {
+      double diag = armLength * 0.7;
+      cairo_move_to(cr, starX - diag, starY - diag);
+      cairo_line_to(cr, starX + diag, starY + diag);
+      cairo_move_to(cr, starX - diag, starY + diag);
+      cairo_line_to(cr, starX + diag, starY - diag);
+      cairo_set_line_width(cr, 0.6);
+      cairo_stroke(cr);
+    }
+  }
+
+  finishSprite(sprite, cr);
+  return sprite;
+}
+
+const EffectSprites::Sprite &EffectSprites::coldSparkles(int phase) {
+  Sprite &sprite = sparkles[phase];
+  if (sprite.surface) return sprite;
+
+  cairo_t *cr = nullptr;
+  sprite = createSprite(SPARKLE_MARGIN, &cr);
+  if (!cr) return sprite;
+
+  const double size = blockSize;
+  const int numSparkles = 6;
+  const double phaseAngle = (2 * M_PI / numSparkles) * phase / RING_PHASES;
+  const double distance = size / 2 + 4;
+  const double tinySize = 1.0;
+
+  cairo_set_source_rgba(cr, 0.9, 0.95, 1.0, 1.0);
+  cairo_set_line_width(cr, 0.5);
+  for (int i = 0; i < numSparkles; i++) {
+    double angle = (i / (double)numSparkles) * 2 * M_PI + phaseAngle;
+    double sparkleX = size / 2 + cos(angle) * distance;
+    double sparkleY = size / 2 + sin(angle) * distance;
+    strokeStar(cr, sparkleX, sparkleY, tinySize);
+  }
+
+  finishSprite(sprite, cr);
+  return sprite;
+}
+
+// ============================================================================
+// Fireworks
+// ============================================================================
+
+cairo_pattern_t *EffectSprites::fireworkMask() {
+  if (fireworkPattern) return fireworkPattern;
+
+  const int extent = FIREWORK_CORE * 4;
+  const double center = extent / 2.0;
+  cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_A8, extent, extent);
+  if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+    std::cerr << "Failed to create firework mask surface" << std::endl;
+    cairo_surface_destroy(surface);
+    return nullptr;
+  }
+
+  cairo_t *cr = cairo_create(surface);
+  cairo_set_source_rgba(cr, 0, 0, 0, 0.3);
+  cairo_arc(cr, center, center, FIREWORK_CORE * 2, 0, 2 * M_PI);
+  cairo_fill(cr);
+  cairo_set_source_rgba(cr, 0, 0, 0, 1.0);
+  cairo_arc(cr, center, center, FIREWORK_CORE, 0, 2 * M_PI);
+  cairo_fill(cr);
+  cairo_destroy(cr);
+  cairo_surface_flush(surface);
+
+  fireworkPattern = cairo_pattern_create_for_surface(surface);
+  cairo_pattern_set_filter(fireworkPattern, CAIRO_FILTER_BILINEAR);
+  cairo_surface_destroy(surface);
+  return fireworkPattern;
+}
+
+void EffectSprites::blit(cairo_t *cr, const Sprite &sprite, double x, double y,
+                         double scale, double alpha) {
+  if (!sprite.surface || scale <= 0.0 || alpha <= 0.0) return;
+
+  // OVER is bounded by the source, so the paint only touches the sprite's area
+  if (scale == 1.0) {
+    cairo_set_source_surface(cr, sprite.surface, x - sprite.originX, y - sprite.originY);
+    cairo_paint_with_alpha(cr, std::min(alpha, 1.0));
+    return;
+  }
+
+  cairo_save(cr);
+  cairo_translate(cr, x, y);
+  cairo_scale(cr, scale, scale);
+  cairo_set_source_surface(cr, sprite.surface, -sprite.originX, -sprite.originY);
+  cairo_paint_with_alpha(cr, std::min(alpha, 1.0));
+  cairo_restore(cr);
+}
@@ -0,0 +1,97 @@
+#ifndef EFFECTSPRITES_H
+#define EFFECTSPRITES_H
+
+#include <cairo/cairo.h>
+#include <vector>
+
+/**
+ * Cached sprites for the heat effects drawn over locked blocks.
+ *
+ * The hot glow halo, the fire particle ring, the frost star layers and
+ * the cold sparkle ring are each rendered once per quantized intensity
+ * (and rotation phase or frost variant) and then blitted, so a frame only
+ * modulates alpha and picks a phase instead of building gradients and
+ * star paths for every block.
+ *
+ * Sprites are built lazily and all dropped when BLOCK_SIZE or the
+ * context's device scale changes.
+ */
+class EffectSprites {
+public:
+    static const int GLOW_STEPS = 16;      // Glow intensity levels
+    static const int RING_PHASES = 8;      // Rotation steps between symmetric ring positions
+    static const int FROST_STEPS = 8;      // Freeze intensity levels
+    static const int FROST_VARIANTS = 16;  // Star layouts, picked by block coordinate
+    static const int FROST_LAYERS = 3;
+    static const int FIREWORK_CORE = 8;    // Core radius of the firework mask, in mask pixels
+    static const int ANIMATION_STEP_MS = 33;  // Clock step for layers cached with the effects
+
+    struct Sprite {
+        cairo_surface_t *surface = nullptr;
+        double originX = 0.0, originY = 0.0;  // Block top-left inside the sprite
+    };
+
+    EffectSprites();
+    ~EffectSprites();
+
+    /**
+     * Drop the cache if BLOCK_SIZE or the device scale changed.
+     * @param cr Context that will be drawn to
+     */
+    void prepare(cairo_t *cr);
+
+    /**
+     * Same, for an explicit block size (used off the main thread, where
+     * BLOCK_SIZE may change underneath).
+     */
+    void prepare(cairo_t *cr, int size);
+
+    const Sprite &glowHalo(int step);
+    const Sprite &fireRing(int step, int phase);
+    const Sprite &frostStars(int step, int variant, int layer);
+    const Sprite &coldSparkles(int phase);
+
+    /**
+     * Alpha mask of one firework particle: a solid core of FIREWORK_CORE
+     * pixels inside a faint glow twice as wide, centred in the surface.
+     * Position and size it with cairo_pattern_set_matrix(), tint it with
+     * the source colour and draw it with cairo_mask().
+     */
+    cairo_pattern_t *fireworkMask();
+
+    /** Particles in the fire ring for a glow step */
+    static int fireParticleCount(int step);
+
+    /**
+     * Frost layout for the block drawn at (x, y), stable per grid cell.
+     * @param size Drawn block size
+     * @param cellSize Grid cell size (BLOCK_SIZE)
+     */
+    static int frostVariant(double x, double y, double size, int cellSize);
+
+    /**
+     * Blit a sprite for the block whose top-left corner is (x, y).
+     * @param scale Block size relative to BLOCK_SIZE (line clear animations)
+     * @param alpha Overall opacity
+     */
+    static void blit(cairo_t *cr, const Sprite &sprite, double x, double y,
+                     double scale, double alpha);
+
+private:
+    int blockSize;
+    double pixelScale;
+
+    std::vector<Sprite> halos;
+    std::vector<Sprite> fireRings;
+    std::vector<Sprite> frost;
+    std::vector<Sprite> sparkles;
+    cairo_pattern_t *fireworkPattern;   // Independent of BLOCK_SIZE, kept across clear()
+
+    void clear();
+    Sprite createSprite(int margin, cairo_t **cr) const;
+    static void finishSprite(Sprite &sprite, cairo_t *cr);
+};
+
+extern EffectSprites effectSprites;
+
+#endif // EFFECTSPRITES_H
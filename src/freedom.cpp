@@ -22,6 +22,10 @@
 #include <gtk/gtk.h>
 #endif
 
+#ifdef KIOSK
+#include "tetrimone_kiosk.h"
+#endif
+
 #include "highscores.h"
 #include "freedom_messages.h"
 
@@ -166,3 +170,13 @@ void showPatrioticPerformanceDialog(TetrimoneApp* app) {
 }
 
 #endif  // QT5
+
+#ifdef KIOSK
+
+void showPatrioticPerformanceDialog(TetrimoneApp* app) {
+    // No dialogs on a kiosk; the message is drawn over the board instead
+    extern const std::vector<std::string> AMERICAN_PROPAGANDA_MESSAGES;
+    showKioskMessage(app, AMERICAN_PROPAGANDA_MESSAGES, "🇺🇸 YOUR BLOCKS HAVE ADVANCED FREEDOM! 🦅");
+}
+
+#endif  // KIOSK
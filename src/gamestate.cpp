@@ -0,0 +1,282 @@
+// ============================================================================
+// Game State Snapshots: undo, rollback and save/resume (Framework-Agnostic)
+// ============================================================================
+
+#ifdef GTK3
+#include "tetrimone_gtk.h"
+#endif
+
+#ifdef QT5
+#include "tetrimone_qt5.h"
+#endif
+
+#ifdef KIOSK
+#include "tetrimone_kiosk.h"
+#endif
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<GameSnapshot>::value,
+              "GameSnapshot must stay trivially copyable");
+
+// Defined in saveloadsettings.cpp
+std::string getConfigDirectory();
+
+static const char SAVE_STATE_MAGIC[4] = {'T', 'M', 'S', 'S'};
+static const uint32_t SAVE_STATE_VERSION = 1;
+
+/**
+ * Capture the gameplay state into a snapshot.
+ * Rows still playing their clear animation are left out so the snapshot
+ * always holds the settled board.
+ *
+ * @param out Snapshot to fill
+ */
+void TetrimoneBoard::saveSnapshot(GameSnapshot& out) const {
+  std::memset(out.occupancy, 0, sizeof(out.occupancy));
+  std::memset(out.cells, 0, sizeof(out.cells));
+
+  int dst = GRID_HEIGHT - 1;
+  for (int y = GRID_HEIGHT - 1; y >= 0; --y) {
+    if (lineClearActive && isLineBeingCleared(y)) {
+      continue;
+    }
+
+    const std::vector<int>& row = grid[y];
+    uint16_t bits = 0;
+    uint64_t packed = 0;
+    for (int x = 0; x < GRID_WIDTH; ++x) {
+      if (row[x] != 0) {
+        bits |= (uint16_t)(1u << x);
+        packed |= (uint64_t)(row[x] & 0xF) << (x * 4);
+      }
+    }
+    out.occupancy[dst] = bits;
+    out.cells[dst] = packed;
+    --dst;
+  }
+
+  out.pieceRng = pieceRng;
+  out.score = score;
+  out.level = level;
+  out.linesCleared = linesCleared;
+  out.consecutiveClears = consecutiveClears;
+  out.maxConsecutiveClears = maxConsecutiveClears;
+  out.lastClearCount = lastClearCount;
+  out.heatLevel = heatLevel;
+  out.gridWidth = (int8_t)GRID_WIDTH;
+  out.gridHeight = (int8_t)GRID_HEIGHT;
+
+  const TetrimoneBlock& piece = getCurrentPieceRef();
+  out.pieceType = (int8_t)piece.getType();
+  out.pieceRotation = (int8_t)piece.getRotation();
+  out.pieceX = (int8_t)piece.getX();
+  out.pieceY = (int8_t)piece.getY();
+
+  out.queueLength = (int8_t)std::min((int)nextPieces.size(), (int)GameSnapshot::QUEUE_LENGTH);
+  for (int i = 0; i < out.queueLength; ++i) {
+    out.nextTypes[i] = (int8_t)nextPieces[i]->getType();
+  }
+
+  out.gameOver = gameOver;
+  out.sequenceActive = sequenceActive;
+}
+
+/**
+ * Put the board back into a previously captured state.
+ * Any running line clear animation is dropped; cosmetic state is left alone.
+ *
+ * @param state Snapshot to restore
+ * @return true on success, false if the snapshot was taken on a different grid size
+ */
+bool TetrimoneBoard::restoreSnapshot(const GameSnapshot& state) {
+  if (state.gridWidth != GRID_WIDTH || state.gridHeight != GRID_HEIGHT) {
+    std::cerr << "Snapshot is for a " << (int)state.gridWidth << "x" << (int)state.gridHeight
+              << " grid, current grid is " << GRID_WIDTH << "x" << GRID_HEIGHT << std::endl;
+    return false;
+  }
+
+  cancelLineClearAnimation();
+
+  for (int y = 0; y < GRID_HEIGHT; ++y) {
+    std::vector<int>& row = grid[y];
+    for (int x = 0; x < GRID_WIDTH; ++x) {
+      row[x] = state.getCell(x, y);
+    }
+  }
+
+  // Reuse the existing piece objects so restoring does not allocate
+  if (!currentPiece) {
+    currentPiece = std::make_unique<TetrimoneBlock>(state.pieceType);
+  } else {
+    *currentPiece = TetrimoneBlock(state.pieceType);
+  }
+  currentPiece->setRotation(state.pieceRotation);
+  currentPiece->setPosition(state.pieceX, state.pieceY);
+  pieceSerial++;
+
+  while ((int)nextPieces.size() > state.queueLength) {
+    nextPieces.pop_back();
+  }
+  for (int i = 0; i < state.queueLength; ++i) {
+    if (i < (int)nextPieces.size() && nextPieces[i]) {
+      *nextPieces[i] = TetrimoneBlock(state.nextTypes[i]);
+    } else if (i < (int)nextPieces.size()) {
+      nextPieces[i] = std::make_unique<TetrimoneBlock>(state.nextTypes[i]);
+    } else {
+      nextPieces.push_back(std::make_unique<TetrimoneBlock>(state.nextTypes[i]));
+    }
+  }
+
+  pieceRng = state.pieceRng;
+  score = state.score;
+  level = state.level;
+  linesCleared = state.linesCleared;
+  consecutiveClears = state.consecutiveClears;
+  maxConsecutiveClears = state.maxConsecutiveClears;
+  lastClearCount = state.lastClearCount;
+  heatLevel = state.heatLevel;
+  gameOver = state.gameOver;
+  sequenceActive = state.sequenceActive;
+
+  // A game taken back from game over can end, and score, again
+  if (!gameOver) {
+    highScoreAlreadyProcessed = false;
+  }
+
+  // Snap the smooth movement to the restored position
+  lastPieceX = state.pieceX;
+  lastPieceY = state.pieceY;
+  movementProgress = 1.0;
+
+  return true;
+}
+
+// ============================================================================
+// Practice Mode Undo
+// ============================================================================
+
+void TetrimoneBoard::setPracticeMode(bool enabled) {
+  practiceMode = enabled;
+  undoHistory.clear();
+  if (practiceMode) {
+    recordUndoPoint();
+  }
+}
+
+/**
+ * Remember the current state as an undo point. Called whenever a new
+ * piece spawns while practice mode is on.
+ */
+void TetrimoneBoard::recordUndoPoint() {
+  if (!practiceMode) return;
+
+  undoHistory.emplace_back();
+  saveSnapshot(undoHistory.back());
+
+  if ((int)undoHistory.size() > MAX_UNDO_STEPS) {
+    undoHistory.pop_front();
+  }
+}
+
+/**
+ * Take back the last placed piece, returning to the moment it spawned.
+ *
+ * @return true if a piece was taken back
+ */
+bool TetrimoneBoard::undoLastPiece() {
+  if (!canUndo()) return false;
+
+  // The newest entry is the piece currently falling
+  undoHistory.pop_back();
+  return restoreSnapshot(undoHistory.back());
+}
+
+// ============================================================================
+// Save / Resume
+// ============================================================================
+
+/**
+ * Get the full path to the quick save file
+ * @return Path to the save state file
+ */
+std::string TetrimoneBoard::getSaveStatePath() {
+  return getConfigDirectory() +
+#ifdef _WIN32
+         "\\"
+#else
+         "/"
+#endif
+         "tetrimone_savestate.bin";
+}
+
+/**
+ * Write the current game to disk.
+ *
+ * @param path File to write
+ * @return true if the state was saved
+ */
+bool TetrimoneBoard::saveGameState(const std::string& path) const {
+  GameSnapshot state;
+  saveSnapshot(state);
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    std::cerr << "Failed to open save state file for writing: " << path << std::endl;
+    return false;
+  }
+
+  uint32_t size = sizeof(GameSnapshot);
+  file.write(SAVE_STATE_MAGIC, sizeof(SAVE_STATE_MAGIC));
+  file.write(reinterpret_cast<const char*>(&SAVE_STATE_VERSION), sizeof(SAVE_STATE_VERSION));
+  file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  file.write(reinterpret_cast<const char*>(&state), sizeof(state));
+
+  return file.good();
+}
+
+/**
+ * Resume a game previously written by saveGameState().
+ * Files from another build (different layout) or grid size are rejected.
+ *
+ * @param path File to read
+ * @return true if the state was restored
+ */
+bool TetrimoneBoard::loadGameState(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "No save state found at: " << path << std::endl;
+    return false;
+  }
+
+  char magic[4];
+  uint32_t version = 0, size = 0;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&version), sizeof(version));
+  file.read(reinterpret_cast<char*>(&size), sizeof(size));
+
+  if (!file || std::memcmp(magic, SAVE_STATE_MAGIC, sizeof(magic)) != 0 ||
+      version != SAVE_STATE_VERSION || size != sizeof(GameSnapshot)) {
+    std::cerr << "Save state file is not compatible with this build: " << path << std::endl;
+    return false;
+  }
+
+  GameSnapshot state;
+  file.read(reinterpret_cast<char*>(&state), sizeof(state));
+  if (!file) {
+    std::cerr << "Save state file is truncated: " << path << std::endl;
+    return false;
+  }
+
+  if (!restoreSnapshot(state)) {
+    return false;
+  }
+
+  undoHistory.clear();
+  recordUndoPoint();
+  return true;
+}
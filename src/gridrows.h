@@ -0,0 +1,71 @@
+#ifndef GRIDROWS_H
+#define GRIDROWS_H
+
+#include <vector>
+#include <algorithm>
+
+/**
+ * Row storage for the playfield.
+ *
+ * Rows live in a fixed pool and are addressed through a table of row
+ * indices, so grid[y][x] keeps working while removing a cleared line or
+ * pushing junk in from the bottom only rotates the index table instead of
+ * copying every cell above (or below) the affected row.
+ */
+class GridRows {
+private:
+    std::vector<std::vector<int>> rows;  // Physical row storage, never reordered
+    std::vector<int> order;              // Logical row y -> index into rows
+
+public:
+    GridRows() {}
+    GridRows(int height, int width) { resize(height, width); }
+
+    void resize(int height, int width) {
+        rows.assign(height, std::vector<int>(width, 0));
+        order.resize(height);
+        for (int y = 0; y < height; ++y) {
+            order[y] = y;
+        }
+    }
+
+    int height() const { return (int)order.size(); }
+
+    std::vector<int>& operator[](int y) { return rows[order[y]]; }
+    const std::vector<int>& operator[](int y) const { return rows[order[y]]; }
+
+    /**
+     * Empty every cell.
+     */
+    void clear() {
+        for (auto& row : rows) {
+            std::fill(row.begin(), row.end(), 0);
+        }
+    }
+
+    /**
+     * Remove logical row y; rows 0..y-1 drop down by one and the recycled
+     * row reappears empty at the top.
+     * @param y Row to remove
+     */
+    void removeRow(int y) {
+        int recycled = order[y];
+        std::copy_backward(order.begin(), order.begin() + y, order.begin() + y + 1);
+        order[0] = recycled;
+        std::fill(rows[recycled].begin(), rows[recycled].end(), 0);
+    }
+
+    /**
+     * Scroll rows [0, activeHeight) up by numRows. The rows that fall off
+     * the top wrap around to the bottom numRows slots and are left with
+     * their old contents, ready for the caller to refill.
+     * @param numRows Number of rows to scroll
+     * @param activeHeight Number of rows currently in play
+     */
+    void scrollUp(int numRows, int activeHeight) {
+        if (numRows <= 0 || numRows >= activeHeight) return;
+        std::rotate(order.begin(), order.begin() + numRows, order.begin() + activeHeight);
+    }
+};
+
+#endif // GRIDROWS_H
@@ -8,140 +8,15 @@
 #include <fstream>
 #include <algorithm>
 #include "gtk3_dialog_helpers.h"
+#include "blockatlas.h"
+#include "boardlayer.h"
+#include <cmath>
 #ifdef _WIN32
 #include <windows.h>
 #include <commdlg.h>
 #include <direct.h>
 #endif
 
-void drawPlacedBlocks(cairo_t *cr, TetrimoneBoard *board, TetrimoneApp *app) {
-  for (int y = 0; y < GRID_HEIGHT; ++y) {
-    for (int x = 0; x < GRID_WIDTH; ++x) {
-      int value = board->getGridValue(x, y);
-      if (value > 0) {
-        // Check if this line is being cleared
-        double alpha = 1.0;
-        double scale = 1.0;
-        double offsetX = 0.0;
-        double offsetY = 0.0;
-        
-        if (board->isLineClearActive() && board->isLineBeingCleared(y)) {
-          // Get animation progress (0.0 to 1.0)
-          double progress = board->getLineClearProgress();
-          
-          if (board->retroModeActive) {
-            // Soviet-era computer animation: Simple scan line effect
-            if (progress < 0.3) {
-              // Horizontal scan line sweep from left to right
-              double scanProgress = progress / 0.3;
-              int scanX = (int)(scanProgress * GRID_WIDTH);
-              
-              // Only affect blocks that have been "scanned"
-              if (x <= scanX) {
-                alpha = 0.3 + 0.4 * sin(progress * 20.0); // Subtle flicker
-              } else {
-                alpha = 1.0; // Normal until scanned
-              }
-              scale = 1.0;
-            } else if (progress < 0.7) {
-              // All blocks flash in unison (like old CRT monitors)
-              double flashProgress = (progress - 0.3) / 0.4;
-              alpha = 1.0 - flashProgress * 0.7;
-              
-              // Simulate old monitor "collapse" effect - vertical compression
-              scale = 1.0;
-              offsetY = flashProgress * BLOCK_SIZE * 0.3; // Slight downward compression
-            } else {
-              // Final "wipe" effect - blocks disappear in chunks
-              double wipeProgress = (progress - 0.7) / 0.3;
-              
-              // Divide line into segments that disappear sequentially
-              int segment = x / 3; // 3-block segments
-              double segmentDelay = segment * 0.2;
-              
-              if (wipeProgress > segmentDelay) {
-                alpha = 0.0; // Instant disappear once segment is reached
-                scale = 0.0;
-              } else {
-                alpha = 1.0 - wipeProgress * 0.5;
-                scale = 1.0;
-              }
-            }
-          } else {
-            // Modern animations - 10 different types selected randomly
-            int animationType = board->getCurrentAnimationType();
-            LineClearAnimValues animValues = getLineClearAnimationValues(animationType, progress, x, y);
-            alpha = animValues.alpha;
-            scale = animValues.scale;
-            offsetX = animValues.offsetX;
-            offsetY = animValues.offsetY;
-          }
-        }
-
-        // Get color from tetrimoneblock colors
-        auto baseColor = board->isInThemeTransition() ? 
-        board->getInterpolatedColor(value - 1, board->getThemeTransitionProgress()) :
-        TETRIMONEBLOCK_COLOR_THEMES[currentThemeIndex][value - 1];
-        auto color = getHeatModifiedColor(baseColor, board->getHeatLevel());
-
-        cairo_set_source_rgba(cr, color[0], color[1], color[2], alpha);
-
-        // Calculate position with animation offsets
-        double drawX = x * BLOCK_SIZE + offsetX + (BLOCK_SIZE * (1.0 - scale)) / 2;
-        double drawY = y * BLOCK_SIZE + offsetY + (BLOCK_SIZE * (1.0 - scale)) / 2;
-        double drawSize = BLOCK_SIZE * scale;
-
-        if (board->retroModeActive || board->simpleBlocksActive) {
-          // Simple blocks
-          cairo_rectangle(cr, drawX, drawY, drawSize, drawSize);
-          cairo_fill(cr);
-        } else {
-          // 3D blocks with scaling
-          cairo_rectangle(cr, drawX + 1, drawY + 1, drawSize - 2, drawSize - 2);
-          cairo_fill(cr);
-
-          // Draw highlight (3D effect)
-          cairo_set_source_rgba(cr, 1, 1, 1, 0.3 * alpha);
-          cairo_move_to(cr, drawX + 1, drawY + 1);
-          cairo_line_to(cr, drawX + drawSize - 1, drawY + 1);
-          cairo_line_to(cr, drawX + 1, drawY + drawSize - 1);
-          cairo_close_path(cr);
-          cairo_fill(cr);
-
-          // Draw shadow (3D effect)
-          cairo_set_source_rgba(cr, 0, 0, 0, 0.3 * alpha);
-          cairo_move_to(cr, drawX + drawSize - 1, drawY + 1);
-          cairo_line_to(cr, drawX + drawSize - 1, drawY + drawSize - 1);
-          cairo_line_to(cr, drawX + 1, drawY + drawSize - 1);
-          cairo_close_path(cr);
-          cairo_fill(cr);
-        }
-        
-        if (!board->retroModeActive) { // Only apply effects in modern mode
-          float heatLevel = board->getHeatLevel();
-          
-          // Get current time for animation
-          auto now = std::chrono::high_resolution_clock::now();
-          auto timeMs = std::chrono::duration<double, std::milli>(
-              now.time_since_epoch()).count();
-          
-          // Draw fiery glow effect when hot
-          if (heatLevel > 0.7f) {
-            drawFireyGlow(cr, drawX, drawY, drawSize, heatLevel, timeMs);
-            updateDisplay(app);
-          }
-          
-          // Draw freezy effect when cold
-          if (heatLevel < 0.3f) {
-            drawFreezyEffect(cr, drawX, drawY, drawSize, heatLevel, timeMs);
-            updateDisplay(app);
-          }
-        }   
-      }
-    }
-  }
-}
-
 void onBackgroundZipDialog(GtkMenuItem* menuItem, gpointer userData) {
     TetrimoneApp* app = static_cast<TetrimoneApp*>(userData);
     
@@ -210,55 +85,174 @@ void onBackgroundOpacityDialog(GtkMenuItem *menuItem, gpointer userData) {
   );
 }
 
-void OnDrawGameAreaCairo(cairo_t *cr, TetrimoneApp *app, int width, int height) {
+gboolean onBoardLayerReady(gpointer userData) {
+  TetrimoneApp *app = static_cast<TetrimoneApp *>(userData);
+  gtk_widget_queue_draw(app->gameArea);
+  return FALSE;
+}
+
+// Redraw at the next effect step; at most one is pending
+static gboolean onEffectStep(gpointer userData) {
+  TetrimoneApp *app = static_cast<TetrimoneApp *>(userData);
+  app->boardLayerStepTimer = 0;
+  return onBoardLayerReady(userData);
+}
+
+void resetBoardLayer(TetrimoneApp *app) {
+  if (app->boardLayerStepTimer > 0) {
+    g_source_remove(app->boardLayerStepTimer);
+    app->boardLayerStepTimer = 0;
+  }
+  app->boardLayerFrame.reset();
+  app->boardLayer.discard();
+}
 
+// Paint background, grid and locked blocks from the render thread's layer.
+// Returns false when they have to be drawn directly this frame.
+static bool drawBoardLayer(cairo_t *cr, TetrimoneApp *app, int width, int height) {
+  Profiler::Scope scope("drawBoardLayer");
   TetrimoneBoard *board = app->board;
+  BoardLayerRenderer &renderer = app->boardLayer;
+  if (!renderer.isRunning()) {
+    return false;
+  }
 
-  // Draw background
-  drawBackground(cr, board, width, height);
+  // Nothing from the previous game's layer carries over
+  BoardLayerFrame &frame = app->boardLayerFrame;
+  if (frame.gameSerial != board->getGameSerial()) {
+    resetBoardLayer(app);
+    frame.gameSerial = board->getGameSerial();
+  }
 
-  // Draw gridlines
-  drawGridLines(cr, board);
+  // Transitions and line clears animate per frame; draw them directly
+  if (board->isInBackgroundTransition() || board->isLineClearActive()) {
+    renderer.discard();
+    return false;
+  }
 
-  // Draw failure line
-  drawFailureLine(cr);
+  // Outside line clears the published grid is the board as it is drawn
+  const PublishedState &state = board->getStatePublisher().latest();
+
+  BoardLayerSnapshot &snapshot = frame.snapshot;
+  double sx = 1.0, sy = 1.0;
+  cairo_user_to_device_distance(cr, &sx, &sy);
+  snapshot.width = width;
+  snapshot.height = height;
+  snapshot.pixelScale = std::round(std::fabs(sx) * 100.0) / 100.0;
+  if (snapshot.pixelScale <= 0.0) snapshot.pixelScale = 1.0;
+  snapshot.blockSize = BLOCK_SIZE;
+  snapshot.gridWidth = GRID_WIDTH;
+  snapshot.gridHeight = GRID_HEIGHT;
+
+  // Cells and colours are only copied when they changed
+  if (!frame.haveCells || frame.cellsSerial != state.serial ||
+      snapshot.cells.size() != (size_t)(GRID_WIDTH * GRID_HEIGHT)) {
+    snapshot.cells.resize(GRID_WIDTH * GRID_HEIGHT);
+    for (int y = 0; y < GRID_HEIGHT; ++y) {
+      for (int x = 0; x < GRID_WIDTH; ++x) {
+        snapshot.cells[y * GRID_WIDTH + x] = state.game.getCell(x, y);
+      }
+    }
+    frame.cellsSerial = state.serial;
+    frame.haveCells = true;
+  }
 
-  // Draw placed blocks with line clearing animation
-  drawPlacedBlocks(cr, board, app);
+  if (snapshot.palette.getVersion() != board->getPalette().getVersion()) {
+    snapshot.palette = board->getPalette();
+  }
+  snapshot.heatLevel = state.game.heatLevel;
+  snapshot.heatEffects = !state.retroMode &&
+                         (snapshot.heatLevel > 0.7f || snapshot.heatLevel < 0.3f);
+  // The effects' clock advances in steps, so draws within a step match
+  // the submitted layer and the worker idles between steps
+  const double step = EffectSprites::ANIMATION_STEP_MS;
+  double now = std::chrono::duration<double, std::milli>(
+      std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+  snapshot.timeMs = std::floor(now / step) * step;
+  snapshot.retro = state.retroMode;
+  snapshot.simple = board->simpleBlocksActive;
+  snapshot.showGridLines = board->isShowingGridLines();
+  snapshot.effectLevel = qualityGovernor.getLevel();
+
+  cairo_surface_t *image = board->getBackgroundImage();
+  bool useImage = (board->isUsingBackgroundImage() || board->isUsingBackgroundZip()) && image &&
+                  qualityGovernor.budget().backgroundImage;
+  if (!useImage) {
+    snapshot.background.reset();
+  } else if (snapshot.background.get() != image) {
+    snapshot.background.reset(cairo_surface_reference(image), cairo_surface_destroy);
+  }
+  snapshot.backgroundOpacity = board->getBackgroundOpacity();
 
-  // Draw splash screen if active
-  if (board->isSplashScreenActive()) {
-    drawSplashScreen(cr, board, app);
-    return FALSE;
+  // Never waits: the worker picks this up while we paint its last layer
+  renderer.submit(snapshot);
+
+  std::vector<int> &newCells = frame.newCells;
+  if (!renderer.paint(cr, snapshot, newCells)) {
+    return false;
   }
 
-  // Draw propaganda messages
-  drawPropagandaMessage(cr, board);
+  // Blocks locked since that layer was rendered
+  if (!newCells.empty()) {
+    blockAtlas.prepare(cr, board);
+    for (int index : newCells) {
+      double drawX = (index % GRID_WIDTH) * BLOCK_SIZE;
+      double drawY = (index / GRID_WIDTH) * BLOCK_SIZE;
+      blockAtlas.draw(cr, BlockAtlas::ROW_PLACED, snapshot.cells[index] - 1, drawX, drawY);
+      if (snapshot.heatEffects) {
+        drawFireyGlow(cr, drawX, drawY, BLOCK_SIZE, snapshot.heatLevel, snapshot.timeMs);
+        drawFreezyEffect(cr, drawX, drawY, BLOCK_SIZE, snapshot.heatLevel, snapshot.timeMs);
+      }
+    }
+  }
 
-  // Draw current piece with smooth movement animation
-  if (board->getCurrentPiece()) {
-    drawCurrentPiece(cr, board);
-  } else {
-    fprintf(stderr, "WARNING: getCurrentPiece() returned null, skipping drawCurrentPiece\n");
+  // While heat effects animate, the next step triggers the next frame
+  if (snapshot.heatEffects && app->boardLayerStepTimer == 0) {
+    guint delay = (guint)std::ceil(snapshot.timeMs + step - now);
+    app->boardLayerStepTimer = g_timeout_add(std::max(1u, delay), onEffectStep, app);
   }
+  return true;
+}
 
-  // Draw ghost piece with interpolated position
-  drawGhostPiece(cr, board);
+void OnDrawGameAreaCairo(cairo_t *cr, TetrimoneApp *app, int width, int height) {
+
+  TetrimoneBoard *board = app->board;
 
-  // Draw enhanced pause menu if paused
-  drawPauseMenu(cr, board);
+  // Blocks, overlays and effects come from one command list, as in the
+  // kiosk and Qt
+  RenderCommandList &commands = app->frameCommands;
+  buildFrameCommands(board, commands);
 
-  // Draw game over text if needed
-  drawGameOver(cr, board);
+  if (!drawBoardLayer(cr, app, width, height)) {
+    // Draw background
+    drawBackground(cr, board, width, height);
 
+    // Draw gridlines
+    drawGridLines(cr, board);
 
-  if (board->isFireworksActive()) {
-    drawFireworks(cr, board, app);
+    // Draw failure line
+    drawFailureLine(cr);
+
+    // Draw placed blocks with line clearing animation
+    executeCommands(cr, commands, RenderCommand::LAYER_BOARD, RenderCommand::LAYER_BOARD);
   }
- 
-  if (board->isTrailsEnabled() && board->isBlockTrailsActive()) {
-    drawBlockTrails(cr, board);
+
+  // Draw splash screen if active
+  if (board->isSplashScreenActive()) {
+    drawSplashScreen(cr, board, app);
+    return;
   }
+
+  // Draw propaganda messages
+  drawPropagandaMessage(cr, board);
+
+  // Falling piece and ghost, pause and game over screens, fireworks and trails.
+  // These still draw on the UI thread; see the TODO in README.md
+  executeCommands(cr, commands, RenderCommand::LAYER_PIECE, RenderCommand::LAYER_TRAILS);
+  frameRecorder.add(commands);
+
+  qualityGovernor.drawIndicator(cr);
+  profiler.drawOverlay(cr, width, height);
 } 
 
 gboolean onDrawGameArea(GtkWidget *widget, cairo_t *cr, gpointer data) {
@@ -268,7 +262,12 @@ gboolean onDrawGameArea(GtkWidget *widget, cairo_t *cr, gpointer data) {
   GtkAllocation allocation;
   gtk_widget_get_allocation(widget, &allocation);
 
-  OnDrawGameAreaCairo(cr, app, allocation.width, allocation.height);
+  {
+    QualityGovernor::Frame frame(qualityGovernor);
+    Profiler::Frame profile;
+    OnDrawGameAreaCairo(cr, app, allocation.width, allocation.height);
+  }
+  app->damage.painted(app->board);
   
   return FALSE;
 }
@@ -286,6 +285,7 @@ void onDrawNextPieceCairo(cairo_t *cr, TetrimoneApp *app, int width, int height)
 
     // Calculate preview block size (half of the normal block size)
     int previewBlockSize = BLOCK_SIZE / 2;
+    const ThemePalette &palette = board->getPalette();
 
     // Draw dividers between sections
     cairo_set_source_rgb(cr, 0.3, 0.3, 0.3);
@@ -309,7 +309,7 @@ void onDrawNextPieceCairo(cairo_t *cr, TetrimoneApp *app, int width, int height)
       if (!piece) continue;  // Skip if piece doesn't exist yet
       
       auto shape = piece->getShape();
-      auto color = piece->getColor();
+      const auto& color = palette.color(piece->getType());
 
       // Calculate the shape dimensions in blocks
       int pieceWidth = 0;
@@ -400,6 +400,7 @@ gboolean onDrawNextPiece(GtkWidget *widget, cairo_t *cr, gpointer data) {
   GtkAllocation allocation;
   gtk_widget_get_allocation(widget, &allocation);
   onDrawNextPieceCairo(cr, app, allocation.width, allocation.height);
+  app->damage.previewPainted(app->board);
 
   return FALSE;
 }
@@ -632,10 +633,33 @@ void onPauseGame(GtkMenuItem *menuItem, gpointer userData) {
 }
 
 void updateDisplay(TetrimoneApp *app) {
+    app->board->publishState();
     gtk_widget_queue_draw(app->gameArea);
     gtk_widget_queue_draw(app->nextPieceArea);
 }
 
+void queueGameAreaDamage(TetrimoneApp *app) {
+    app->board->publishState();
+
+    int width = gtk_widget_get_allocated_width(app->gameArea);
+    if (!app->damage.collect(app->board, width)) {
+        gtk_widget_queue_draw(app->gameArea);
+        return;
+    }
+
+    // GTK clips the draw handler's context to the union of these
+    for (const DamageTracker::Rect &rect : app->damage.getRects()) {
+        gtk_widget_queue_draw_area(app->gameArea, rect.x, rect.y, rect.width, rect.height);
+    }
+}
+
+void updateChangedDisplay(TetrimoneApp *app) {
+    queueGameAreaDamage(app);
+    if (app->damage.previewChanged(app->board)) {
+        gtk_widget_queue_draw(app->nextPieceArea);
+    }
+}
+
 void set_theme_menu(TetrimoneApp *app, int index)
 {
     if (index < 0) {
@@ -1,6 +1,9 @@
 #ifdef GTK3
 #include "tetrimone_gtk.h"
 #include <glib.h>
+#elif defined(KIOSK)
+#include "tetrimone_kiosk.h"
+#include "kiosk_timers.h"
 #else
 #include "tetrimone_qt5.h"
 #include <QObject>
@@ -11,7 +14,7 @@
 #define M_PI 3.14159265358979323846
 #endif
 
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
 void TetrimoneBoard::updateHeat() {
     // Only create timer if it doesn't already exist
     if (heatDecayTimer == 0) {
@@ -341,3 +341,29 @@ void onViewHighScores(void* menuItem, void* userData) {
 }
 
 #endif  // QT5
+
+#ifdef KIOSK
+#include "tetrimone_kiosk.h"
+
+// A kiosk has no keyboard for names, so scores go in unnamed
+bool TetrimoneBoard::checkAndRecordHighScore(TetrimoneApp* app) {
+    std::string difficultyName = getDifficultyName(app->difficulty);
+    
+    if (highScores.isHighScore(score, GRID_WIDTH, GRID_HEIGHT, difficultyName, 
+                               junkLinesPercentage, junkLinesPerLevel)) {
+        Score newScore;
+        newScore.name = "Anonymous";
+        newScore.score = score;
+        newScore.width = GRID_WIDTH;
+        newScore.height = GRID_HEIGHT;
+        newScore.difficulty = difficultyName;
+        newScore.initialJunkPercent = junkLinesPercentage;
+        newScore.junkLinesPerLevel = junkLinesPerLevel;
+        
+        highScores.addScore(newScore);
+        return true;
+    }
+    return false;
+}
+
+#endif  // KIOSK
@@ -67,12 +67,12 @@ static void onJoystickPause(TetrimoneApp* app, bool shouldPause) {
 
 static void onJoystickRotate(TetrimoneApp* app, bool clockwise) {
   app->board->rotatePiece(clockwise);
-  gtk_widget_queue_draw(app->gameArea);
+  updateChangedDisplay(app);
 }
 
 static void onJoystickHardDrop(TetrimoneApp* app) {
   app->board->hardDrop();
-  gtk_widget_queue_draw(app->gameArea);
+  updateChangedDisplay(app);
   updateLabels(app);
 }
 
@@ -115,7 +115,7 @@ gboolean pollJoystick(gpointer data) {
       horizontalControl.moveCount = 0;
       
       app->board->movePiece(moveX, 0);
-      gtk_widget_queue_draw(app->gameArea);
+      updateChangedDisplay(app);
       updateLabels(app);
     } else if (currentTime - horizontalControl.lastMoveTime > horizontalControl.repeatDelay) {
       horizontalControl.moveCount++;
@@ -126,7 +126,7 @@ gboolean pollJoystick(gpointer data) {
         app->board->movePiece(moveX, 0);
       }
       horizontalControl.lastMoveTime = currentTime;
-      gtk_widget_queue_draw(app->gameArea);
+      updateChangedDisplay(app);
       updateLabels(app);
     }
   } else {
@@ -145,7 +145,7 @@ gboolean pollJoystick(gpointer data) {
       if (moveY > 0) {  // Down/drop
         app->board->movePiece(0, 1);
       }
-      gtk_widget_queue_draw(app->gameArea);
+      updateChangedDisplay(app);
       updateLabels(app);
     } else if (currentTime - verticalControl.lastMoveTime > verticalControl.repeatDelay) {
       verticalControl.moveCount++;
@@ -158,7 +158,7 @@ gboolean pollJoystick(gpointer data) {
         }
       }
       verticalControl.lastMoveTime = currentTime;
-      gtk_widget_queue_draw(app->gameArea);
+      updateChangedDisplay(app);
       updateLabels(app);
     }
   } else {
@@ -19,6 +19,10 @@ using namespace GTK3Helpers;
 #include "qt5_dialog_helpers.h"
 #endif
 
+#ifdef KIOSK
+#include "tetrimone_kiosk.h"
+#endif
+
 #ifdef _WIN32
 #include <windows.h>
 #include <commdlg.h>
@@ -100,11 +104,11 @@ void TetrimoneBoard::addJunkLinesFromBottom(int numLines) {
 void TetrimoneBoard::fillJunkRows(int startRow, int endRow) {
   for (int y = startRow; y <= endRow; y++) {
     // Create a list of empty spaces (at least 4 per row)
-    int emptySpaces = 4 + std::rand() % (GRID_WIDTH / 3); // Between 4 and 1/3 of width
+    int emptySpaces = 4 + pieceRng() % (GRID_WIDTH / 3); // Between 4 and 1/3 of width
     std::vector<int> emptyPositions = generateRandomPositions(emptySpaces, GRID_WIDTH);
     
     // Fill the row with blocks, ensuring empty spaces where specified
-    int prevType = 1 + std::rand() % 7; // Random block type (1-7)
+    int prevType = 1 + pieceRng() % 7; // Random block type (1-7)
     int typeCount = 0; // Count of current type (max 3 of each type)
     
     for (int x = 0; x < GRID_WIDTH; x++) {
@@ -139,7 +143,7 @@ void TetrimoneBoard::fillJunkRows(int startRow, int endRow) {
 std::vector<int> TetrimoneBoard::generateRandomPositions(int count, int maxWidth) {
   std::vector<int> positions;
   while ((int)positions.size() < count) {
-    int pos = std::rand() % maxWidth;
+    int pos = pieceRng() % maxWidth;
     if (std::find(positions.begin(), positions.end(), pos) == positions.end()) {
       positions.push_back(pos);
     }
@@ -159,17 +163,17 @@ int TetrimoneBoard::selectNextBlockType(int currentType, int currentTypeCount) {
     // Force a new type if we already have 3 of the current type
     int newType;
     do {
-      newType = 1 + std::rand() % 7;
+      newType = 1 + pieceRng() % 7;
     } while (newType == currentType);
     return newType;
   } else {
     // 70% chance to continue with same type, 30% chance for a new type
-    if (std::rand() % 10 < 7) {
+    if (pieceRng() % 10 < 7) {
       return currentType;
     } else {
       int newType;
       do {
-        newType = 1 + std::rand() % 7;
+        newType = 1 + pieceRng() % 7;
       } while (newType == currentType);
       return newType;
     }
@@ -182,11 +186,9 @@ int TetrimoneBoard::selectNextBlockType(int currentType, int currentTypeCount) {
  * @param numRows Number of rows to shift up
  */
 void TetrimoneBoard::shiftGridContentUp(int numRows) {
-  for (int y = 0; y < GRID_HEIGHT - numRows; y++) {
-    for (int x = 0; x < GRID_WIDTH; x++) {
-      grid[y][x] = grid[y + numRows][x];
-    }
-  }
+  // Rotating the row table is enough; the rows that wrap to the bottom
+  // are overwritten by fillJunkRows() straight afterwards.
+  grid.scrollUp(numRows, GRID_HEIGHT);
 }
 
 /**
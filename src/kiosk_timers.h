@@ -0,0 +1,37 @@
+#ifndef KIOSK_TIMERS_H
+#define KIOSK_TIMERS_H
+
+// ============================================================================
+// GLib timeout calls for the kiosk build
+// ============================================================================
+
+/**
+ * The core schedules its animations with the GLib timeout calls the GTK3
+ * build uses. The kiosk build has no GLib, so tetrimone_kiosk.cpp provides
+ * those calls on top of its own SDL main loop: callbacks run on the UI
+ * thread between events, and returning FALSE removes the timer.
+ *
+ * Only the source files that schedule timers include this, so the GLib
+ * names stay out of the shared headers.
+ */
+typedef int gboolean;
+typedef void* gpointer;
+typedef unsigned int guint;
+typedef gboolean (*GSourceFunc)(gpointer userData);
+
+#ifndef FALSE
+#define FALSE 0
+#endif
+#ifndef TRUE
+#define TRUE 1
+#endif
+#define G_SOURCE_REMOVE FALSE
+#define G_SOURCE_CONTINUE TRUE
+
+/** @return Timer id, never 0 */
+guint g_timeout_add(guint intervalMs, GSourceFunc function, gpointer data);
+
+/** @return FALSE if no timer has that id */
+gboolean g_source_remove(guint id);
+
+#endif // KIOSK_TIMERS_H
@@ -0,0 +1,159 @@
+// ============================================================================
+// Pooled particle and trail storage (Framework-Agnostic)
+// ============================================================================
+
+#include "particles.h"
+#include <cstddef>
+#include <cstring>
+
+// ============================================================================
+// Fireworks
+// ============================================================================
+
+FireworkPool::FireworkPool() : count(0) {
+  // Padding slots are updated too, so start them from harmless values
+  float *arrays[] = {px, py, vx, vy, life, fade, gravity, radius, red, green, blue};
+  for (float *array : arrays) {
+    std::memset(array, 0, sizeof(float) * CAPACITY);
+  }
+}
+
+bool FireworkPool::spawn(float x, float y, float velX, float velY, float size,
+                         float grav, float fadeRate, float r, float g, float b) {
+  if (count >= CAPACITY) return false;
+
+  int i = count++;
+  px[i] = x;
+  py[i] = y;
+  vx[i] = velX;
+  vy[i] = velY;
+  life[i] = 1.0f;
+  fade[i] = fadeRate;
+  gravity[i] = grav;
+  radius[i] = size;
+  red[i] = r;
+  green[i] = g;
+  blue[i] = b;
+  return true;
+}
+
+void FireworkPool::moveParticle(int from, int to) {
+  px[to] = px[from];
+  py[to] = py[from];
+  vx[to] = vx[from];
+  vy[to] = vy[from];
+  life[to] = life[from];
+  fade[to] = fade[from];
+  gravity[to] = gravity[from];
+  radius[to] = radius[from];
+  red[to] = red[from];
+  green[to] = green[from];
+  blue[to] = blue[from];
+}
+
+void FireworkPool::update() {
+  // Run whole vectors: slots past count are scratch, so rounding up is harmless
+  const int n = (count + LANES - 1) & ~(LANES - 1);
+
+  // Physics for every particle in one straight loop, no early-outs
+  for (int i = 0; i < n; ++i) {
+    px[i] += vx[i];
+    py[i] += vy[i];
+    vy[i] += gravity[i];
+    life[i] -= fade[i];
+
+    // Air resistance
+    vx[i] *= DRAG;
+    vy[i] *= DRAG;
+  }
+
+  // Fill each hole with the last particle
+  int i = 0;
+  while (i < count) {
+    if (life[i] <= 0.0f) {
+      moveParticle(--count, i);
+    } else {
+      ++i;
+    }
+  }
+}
+
+// ============================================================================
+// Block trails
+// ============================================================================
+
+uint16_t TrailPool::shapeMask(const std::vector<std::vector<int>> &shape) {
+  uint16_t mask = 0;
+  for (size_t y = 0; y < shape.size() && y < 4; ++y) {
+    for (size_t x = 0; x < shape[y].size() && x < 4; ++x) {
+      if (shape[y][x] == 1) {
+        mask |= (uint16_t)(1u << (y * 4 + x));
+      }
+    }
+  }
+  return mask;
+}
+
+void TrailPool::moveTrail(int from, int to) {
+  px[to] = px[from];
+  py[to] = py[from];
+  life[to] = life[from];
+  maxLife[to] = maxLife[from];
+  alpha[to] = alpha[from];
+  red[to] = red[from];
+  green[to] = green[from];
+  blue[to] = blue[from];
+  cells[to] = cells[from];
+  pieceType[to] = pieceType[from];
+  serial[to] = serial[from];
+}
+
+void TrailPool::evictOldest() {
+  int oldest = 0;
+  for (int i = 1; i < count; ++i) {
+    // Unsigned difference keeps the order right across serial wrap-around
+    if ((int32_t)(serial[i] - serial[oldest]) < 0) {
+      oldest = i;
+    }
+  }
+  moveTrail(--count, oldest);
+}
+
+void TrailPool::spawn(float x, float y, int type, uint16_t mask, float r, float g, float b,
+                      float lifetime, float startAlpha, int limit) {
+  if (limit > CAPACITY) limit = CAPACITY;
+  if (limit < 1) limit = 1;
+  while (count >= limit) {
+    evictOldest();
+  }
+
+  int i = count++;
+  px[i] = x;
+  py[i] = y;
+  life[i] = lifetime;
+  maxLife[i] = lifetime;
+  alpha[i] = startAlpha;
+  red[i] = r;
+  green[i] = g;
+  blue[i] = b;
+  cells[i] = mask;
+  pieceType[i] = (uint8_t)type;
+  serial[i] = nextSerial++;
+}
+
+void TrailPool::update(float deltaTime, float opacity) {
+  const int n = count;
+  for (int i = 0; i < n; ++i) {
+    life[i] -= deltaTime;
+    alpha[i] = (life[i] / maxLife[i]) * opacity;
+  }
+
+  int i = 0;
+  while (i < count) {
+    if (life[i] <= 0.0f || alpha[i] <= 0.05f) {
+      moveTrail(--count, i);
+    } else {
+      ++i;
+    }
+  }
+}
@@ -0,0 +1,129 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Fixed-capacity firework particle storage.
+ *
+ * Fields live in parallel float arrays (structure of arrays) so the
+ * physics step is one branch-free loop the compiler can vectorize. Dead
+ * particles are swap-removed: the last particle moves into the hole, so
+ * removal is O(1) and nothing is ever allocated after construction.
+ * Particle order is not preserved.
+ */
+class FireworkPool {
+public:
+    static const int CAPACITY = 2048;   // Multiple of LANES
+
+    FireworkPool();
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear() { count = 0; }
+
+    /**
+     * Add a particle.
+     * @return false (and nothing added) when the pool is full
+     */
+    bool spawn(float x, float y, float vx, float vy, float size,
+               float gravity, float fade, float r, float g, float b);
+
+    /**
+     * Advance every particle one tick and drop the ones that burned out.
+     */
+    void update();
+
+    float getX(int i) const { return px[i]; }
+    float getY(int i) const { return py[i]; }
+    float getLife(int i) const { return life[i]; }
+    float getSize(int i) const { return radius[i]; }
+    float getRed(int i) const { return red[i]; }
+    float getGreen(int i) const { return green[i]; }
+    float getBlue(int i) const { return blue[i]; }
+
+private:
+    static constexpr float DRAG = 0.98f;
+    static const int LANES = 8;       // update() pads the particle count to this
+
+    alignas(32) float px[CAPACITY];
+    alignas(32) float py[CAPACITY];
+    alignas(32) float vx[CAPACITY];
+    alignas(32) float vy[CAPACITY];
+    alignas(32) float life[CAPACITY];
+    alignas(32) float fade[CAPACITY];
+    alignas(32) float gravity[CAPACITY];
+    alignas(32) float radius[CAPACITY];
+    alignas(32) float red[CAPACITY];
+    alignas(32) float green[CAPACITY];
+    alignas(32) float blue[CAPACITY];
+    int count;
+
+    void moveParticle(int from, int to);
+};
+
+/**
+ * Fixed-capacity block trail storage, same layout rules as FireworkPool.
+ *
+ * A trail keeps its piece's cells as a 4x4 bit mask (bit y*4+x) instead
+ * of a copy of the shape vectors. When the caller's segment limit is
+ * reached the oldest trail is evicted.
+ */
+class TrailPool {
+public:
+    static const int CAPACITY = 16;   // setMaxTrailSegments() clamps to 15
+
+    TrailPool() : count(0), nextSerial(0) {}
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear() { count = 0; }
+
+    /**
+     * Add a trail, evicting the oldest ones beyond the limit.
+     * @param r, g, b Piece colour; a trail keeps it through theme changes
+     * @param limit Maximum number of live trails
+     */
+    void spawn(float x, float y, int pieceType, uint16_t cells, float r, float g, float b,
+               float maxLife, float alpha, int limit);
+
+    /**
+     * Age every trail and drop the faded ones.
+     * @param deltaTime Seconds since the last update
+     * @param opacity Alpha of a fresh trail
+     */
+    void update(float deltaTime, float opacity);
+
+    /** Bit mask of the filled cells of a 4x4 piece shape */
+    static uint16_t shapeMask(const std::vector<std::vector<int>> &shape);
+
+    float getX(int i) const { return px[i]; }
+    float getY(int i) const { return py[i]; }
+    float getAlpha(int i) const { return alpha[i]; }
+    int getPieceType(int i) const { return pieceType[i]; }
+    uint16_t getCells(int i) const { return cells[i]; }
+    float getRed(int i) const { return red[i]; }
+    float getGreen(int i) const { return green[i]; }
+    float getBlue(int i) const { return blue[i]; }
+
+private:
+    float px[CAPACITY];
+    float py[CAPACITY];
+    float life[CAPACITY];
+    float maxLife[CAPACITY];
+    float alpha[CAPACITY];
+    float red[CAPACITY];
+    float green[CAPACITY];
+    float blue[CAPACITY];
+    uint16_t cells[CAPACITY];
+    uint8_t pieceType[CAPACITY];
+    uint32_t serial[CAPACITY];        // Spawn order, for evicting the oldest
+    int count;
+    uint32_t nextSerial;
+
+    void moveTrail(int from, int to);
+    void evictOldest();
+};
+
+#endif // PARTICLES_H
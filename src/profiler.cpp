@@ -0,0 +1,301 @@
+// ============================================================================
+// Frame profiler: stage timings, overlay and trace export (Framework-Agnostic)
+// ============================================================================
+
+#include "profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+Profiler profiler;
+
+// Defined in saveloadsettings.cpp
+std::string getConfigDirectory();
+
+// Weight of the newest frame in the stage averages
+static const double SMOOTHING = 0.05;
+
+// Overlay graph scale: a full-height bar is this many milliseconds
+static const double GRAPH_MAX_MS = 50.0;
+
+// Stage averages listed under the graph
+static const int OVERLAY_STAGES = 8;
+
+uint64_t Profiler::nowUs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+Profiler::Scope::Scope(const char *name)
+    : name(name), start(profiler.recording() ? nowUs() : 0) {}
+
+Profiler::Scope::~Scope() {
+  if (start) {
+    profiler.record(name, start, nowUs(), true);
+  }
+}
+
+Profiler::Tally::Tally(const char *name)
+    : name(name), start(profiler.recording() ? nowUs() : 0) {}
+
+Profiler::Tally::~Tally() {
+  if (start) {
+    profiler.record(name, start, nowUs(), false);
+  }
+}
+
+Profiler::Frame::Frame() : start(0) {
+  if (profiler.recording() && profiler.frameDepth++ == 0) {
+    start = nowUs();
+  }
+}
+
+Profiler::Frame::~Frame() {
+  if (start) {
+    profiler.frameDepth = 0;
+    profiler.endFrame(start, nowUs());
+  } else if (profiler.frameDepth > 0) {
+    --profiler.frameDepth;
+  }
+}
+
+Profiler::Profiler()
+    : enabled(false), overlay(false), stageCount(0), nextEvent(0), eventsWrapped(false),
+      frameCount(0), frameNext(0), frameDepth(0) {
+  std::fill(frameMs, frameMs + HISTORY, 0.0f);
+
+  // For front ends without the command line options
+  const char *path = std::getenv("TETRIMONE_PROFILE");
+  if (path && *path) {
+    tracePath = path;
+    setEnabled(true);
+  }
+  const char *show = std::getenv("TETRIMONE_PROFILE_OVERLAY");
+  if (show && *show && std::strcmp(show, "0") != 0) {
+    setOverlayShown(true);
+  }
+}
+
+Profiler::~Profiler() {
+  if (!tracePath.empty() && exportTrace()) {
+    std::cout << "Profile trace written to " << tracePath << std::endl;
+  }
+}
+
+void Profiler::setEnabled(bool enable) {
+  if (enable && !isEnabled()) {
+    owner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    if (events.empty()) {
+      events.resize(MAX_EVENTS);
+    }
+  }
+  enabled.store(enable, std::memory_order_release);
+  if (!enable) {
+    overlay = false;
+  }
+}
+
+void Profiler::setOverlayShown(bool show) {
+  if (show) {
+    setEnabled(true);
+  }
+  overlay = show;
+}
+
+Profiler::Stage *Profiler::stage(const char *name) {
+  // Literals are usually pooled, so the pointer test nearly always hits
+  for (int i = 0; i < stageCount; ++i) {
+    if (stages[i].name == name) {
+      return &stages[i];
+    }
+  }
+  for (int i = 0; i < stageCount; ++i) {
+    if (std::strcmp(stages[i].name, name) == 0) {
+      return &stages[i];
+    }
+  }
+  if (stageCount == MAX_STAGES) {
+    return nullptr;
+  }
+  stages[stageCount].name = name;
+  return &stages[stageCount++];
+}
+
+void Profiler::addEvent(const char *name, uint64_t start, uint64_t duration, bool counter) {
+  if (events.empty()) {
+    return;
+  }
+  Event &event = events[nextEvent];
+  event.name = name;
+  event.startUs = start;
+  event.durationUs = duration;
+  event.counter = counter;
+  if (++nextEvent == events.size()) {
+    nextEvent = 0;
+    eventsWrapped = true;
+  }
+}
+
+void Profiler::record(const char *name, uint64_t start, uint64_t end, bool trace) {
+  uint64_t duration = end - start;
+  if (trace) {
+    addEvent(name, start, duration, false);
+  }
+  Stage *entry = stage(name);
+  if (entry) {
+    entry->frameUs += duration;
+    entry->tallied = entry->tallied || !trace;
+  }
+}
+
+void Profiler::endFrame(uint64_t start, uint64_t end) {
+  addEvent("frame", start, end - start, false);
+
+  frameMs[frameNext] = (float)((end - start) / 1000.0);
+  frameNext = (frameNext + 1) % HISTORY;
+  if (frameCount < HISTORY) {
+    ++frameCount;
+  }
+
+  for (int i = 0; i < stageCount; ++i) {
+    Stage &entry = stages[i];
+    if (entry.tallied) {
+      addEvent(entry.name, end, entry.frameUs, true);
+    }
+    entry.averageUs += (entry.frameUs - entry.averageUs) * SMOOTHING;
+    entry.frameUs = 0;
+  }
+}
+
+double Profiler::framePercentile(double share) const {
+  if (frameCount == 0) {
+    return 0.0;
+  }
+  float sorted[HISTORY];
+  std::copy(frameMs, frameMs + frameCount, sorted);
+  int index = std::max(0, std::min(frameCount - 1, (int)(share * frameCount)));
+  std::nth_element(sorted, sorted + index, sorted + frameCount);
+  return sorted[index];
+}
+
+std::string Profiler::exportPath() const {
+  if (!tracePath.empty()) {
+    return tracePath;
+  }
+  return getConfigDirectory() +
+#ifdef _WIN32
+         "\\"
+#else
+         "/"
+#endif
+         "tetrimone_trace.json";
+}
+
+bool Profiler::exportTrace(const std::string &path) const {
+  size_t count = eventsWrapped ? events.size() : nextEvent;
+  if (path.empty() || count == 0) {
+    return false;
+  }
+
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    std::cerr << "Failed to open trace file for writing: " << path << std::endl;
+    return false;
+  }
+
+  // Oldest first; stage names are literals, so they need no escaping
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  size_t first = eventsWrapped ? nextEvent : 0;
+  for (size_t i = 0; i < count; ++i) {
+    const Event &event = events[(first + i) % events.size()];
+    file << (i ? ",\n" : "");
+    if (event.counter) {
+      file << "{\"name\":\"" << event.name << "\",\"ph\":\"C\",\"ts\":" << event.startUs
+           << ",\"pid\":1,\"tid\":1,\"args\":{\"ms\":" << event.durationUs / 1000.0 << "}}";
+    } else {
+      file << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"ts\":" << event.startUs
+           << ",\"dur\":" << event.durationUs << ",\"pid\":1,\"tid\":1}";
+    }
+  }
+  file << "\n]}\n";
+  return file.good();
+}
+
+void Profiler::drawOverlay(cairo_t *cr, int width, int height) const {
+  if (!overlay) {
+    return;
+  }
+  (void)width;
+
+  // Largest stages first
+  const Stage *order[MAX_STAGES];
+  for (int i = 0; i < stageCount; ++i) {
+    order[i] = &stages[i];
+  }
+  std::sort(order, order + stageCount,
+            [](const Stage *a, const Stage *b) { return a->averageUs > b->averageUs; });
+  int lines = 1 + std::min(stageCount, OVERLAY_STAGES);
+
+  const double graphHeight = 60.0;
+  const double lineHeight = 13.0;
+  const double boxWidth = HISTORY + 16.0;
+  const double boxHeight = graphHeight + lines * lineHeight + 20.0;
+  const double left = 8.0;
+  const double top = height - boxHeight - 8.0;
+
+  cairo_save(cr);
+  cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.75);
+  cairo_rectangle(cr, left, top, boxWidth, boxHeight);
+  cairo_fill(cr);
+
+  // One bar per frame, oldest on the left; green within 60 fps, red beyond 30
+  double graphLeft = left + 8.0;
+  double baseline = top + 8.0 + graphHeight;
+  for (int i = 0; i < frameCount; ++i) {
+    int index = (frameNext - frameCount + i + HISTORY) % HISTORY;
+    double ms = frameMs[index];
+    double barHeight = std::min(ms / GRAPH_MAX_MS, 1.0) * graphHeight;
+    if (ms <= 1000.0 / 60.0) {
+      cairo_set_source_rgb(cr, 0.3, 0.9, 0.3);
+    } else if (ms <= 1000.0 / 30.0) {
+      cairo_set_source_rgb(cr, 0.95, 0.8, 0.2);
+    } else {
+      cairo_set_source_rgb(cr, 1.0, 0.3, 0.3);
+    }
+    cairo_rectangle(cr, graphLeft + i, baseline - barHeight, 1.0, barHeight);
+    cairo_fill(cr);
+  }
+
+  // 60 fps budget line
+  double budgetY = baseline - (1000.0 / 60.0) / GRAPH_MAX_MS * graphHeight;
+  cairo_set_source_rgba(cr, 1.0, 1.0, 1.0, 0.5);
+  cairo_set_line_width(cr, 1.0);
+  cairo_move_to(cr, graphLeft, budgetY + 0.5);
+  cairo_line_to(cr, graphLeft + HISTORY, budgetY + 0.5);
+  cairo_stroke(cr);
+
+  // Numbers change every frame, so this goes through cairo rather than
+  // the text cache, which would fill up with one-off strings
+  char text[96];
+  cairo_select_font_face(cr, "Monospace", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+  cairo_set_font_size(cr, 11.0);
+  cairo_set_source_rgb(cr, 1.0, 1.0, 1.0);
+  double textY = baseline + 4.0 + lineHeight;
+  snprintf(text, sizeof(text), "frame p50 %5.2f  p99 %5.2f ms", framePercentile(0.5),
+           framePercentile(0.99));
+  cairo_move_to(cr, graphLeft, textY);
+  cairo_show_text(cr, text);
+
+  for (int i = 0; i < lines - 1; ++i) {
+    textY += lineHeight;
+    snprintf(text, sizeof(text), "%-22.22s %6.2f ms", order[i]->name, order[i]->averageUs / 1000.0);
+    cairo_move_to(cr, graphLeft, textY);
+    cairo_show_text(cr, text);
+  }
+  cairo_restore(cr);
+}
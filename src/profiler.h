@@ -0,0 +1,147 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cairo/cairo.h>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Frame and game logic timings, for an on-screen overlay and for Chrome
+ * trace-event export (load the file in chrome://tracing or Perfetto).
+ *
+ * Stages are timed with scoped objects named by string literals:
+ *
+ *     Profiler::Scope scope("drawBackground");
+ *
+ * A Scope records a trace event and adds to its stage's total for the
+ * frame. A Tally only adds to the total; it is meant for code that runs
+ * many times per frame (per-block effects), and its per-frame total is
+ * exported as a counter instead. Frame marks one game area repaint.
+ *
+ * Recording is off until enabled and then only on the thread that
+ * enabled it (the UI thread); scopes elsewhere cost a flag test. The
+ * --profile and --profile-overlay options, or the TETRIMONE_PROFILE and
+ * TETRIMONE_PROFILE_OVERLAY environment variables, turn it on.
+ */
+class Profiler {
+public:
+    static const int MAX_STAGES = 32;
+    static const int HISTORY = 240;             // Frames in the graph and percentiles
+    static const size_t MAX_EVENTS = 200000;    // Trace events kept; the oldest are dropped
+
+    class Scope {
+    public:
+        explicit Scope(const char *name);
+        ~Scope();
+    private:
+        const char *name;
+        uint64_t start;
+    };
+
+    class Tally {
+    public:
+        explicit Tally(const char *name);
+        ~Tally();
+    private:
+        const char *name;
+        uint64_t start;
+    };
+
+    class Frame {
+    public:
+        Frame();
+        ~Frame();
+    private:
+        uint64_t start;
+    };
+
+    Profiler();
+
+    /** Writes the trace if a trace path was set */
+    ~Profiler();
+
+    /** Start or stop recording on the calling thread */
+    void setEnabled(bool enable);
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    /** Show the overlay; showing it also starts recording */
+    void setOverlayShown(bool show);
+    bool isOverlayShown() const { return overlay; }
+
+    /** File the trace is written to on exportTrace() and at exit */
+    void setTracePath(const std::string &path) { tracePath = path; }
+    const std::string &getTracePath() const { return tracePath; }
+
+    /**
+     * Write the recorded events as Chrome trace-event JSON.
+     * @return false if nothing was recorded or the file could not be written
+     */
+    bool exportTrace(const std::string &path) const;
+    bool exportTrace() const { return exportTrace(tracePath); }
+
+    /** Trace path, or tetrimone_trace.json in the config directory if none is set */
+    std::string exportPath() const;
+
+    /**
+     * Frame time below which the given share of recent frames fall.
+     * @param share 0.0 to 1.0, e.g. 0.99 for p99
+     * @return Milliseconds, or 0 before the first frame
+     */
+    double framePercentile(double share) const;
+
+    /** Draw the frame graph and stage averages in the bottom-left corner */
+    void drawOverlay(cairo_t *cr, int width, int height) const;
+
+    /** Microseconds on the profiler clock */
+    static uint64_t nowUs();
+
+private:
+    struct Stage {
+        const char *name = nullptr;
+        uint64_t frameUs = 0;           // Time in the current frame
+        double averageUs = 0.0;         // Per frame, smoothed
+        bool tallied = false;           // Fed by Tally, exported as a counter
+    };
+
+    struct Event {
+        const char *name;
+        uint64_t startUs;
+        uint64_t durationUs;            // Counter value for counter events
+        bool counter;
+    };
+
+    // Read without a lock by scopes on any thread, e.g. the board layer's
+    // worker; owner is stored before enabled is set
+    std::atomic<bool> enabled;
+    bool overlay;
+    std::atomic<std::thread::id> owner;
+    std::string tracePath;
+
+    Stage stages[MAX_STAGES];
+    int stageCount;
+
+    std::vector<Event> events;          // Ring of MAX_EVENTS once full
+    size_t nextEvent;
+    bool eventsWrapped;
+
+    float frameMs[HISTORY];
+    int frameCount;
+    int frameNext;
+    int frameDepth;                     // Nested Frame objects count once
+
+    bool recording() const {
+        return enabled.load(std::memory_order_acquire) &&
+               std::this_thread::get_id() == owner.load(std::memory_order_relaxed);
+    }
+    Stage *stage(const char *name);
+    void addEvent(const char *name, uint64_t start, uint64_t duration, bool counter);
+    void record(const char *name, uint64_t start, uint64_t end, bool trace);
+    void endFrame(uint64_t start, uint64_t end);
+};
+
+extern Profiler profiler;
+
+#endif // PROFILER_H
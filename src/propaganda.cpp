@@ -22,6 +22,10 @@
 #include <QMessageBox>
 #endif
 
+#ifdef KIOSK
+#include "tetrimone_kiosk.h"
+#endif
+
 // ============================================================================
 // Framework-Specific Propaganda Dialogs
 // ============================================================================
@@ -148,3 +152,13 @@ void showIdeologicalFailureDialog(TetrimoneApp* app) {
 }
 
 #endif  // QT5
+
+#ifdef KIOSK
+
+void showIdeologicalFailureDialog(TetrimoneApp* app) {
+    // No dialogs on a kiosk; the message is drawn over the board instead
+    extern const std::vector<std::string> PROPAGANDA_MESSAGES;
+    showKioskMessage(app, PROPAGANDA_MESSAGES, "YOUR BLOCKS HAVE FAILED THE STATE!");
+}
+
+#endif  // KIOSK
@@ -19,7 +19,5 @@
 
     // Optional: Method to clear a specific block or entire grid
     void TetrimoneBoard::clearGrid() {
-        for (auto& row : grid) {
-            std::fill(row.begin(), row.end(), 0);
-        }
+        grid.clear();
     }
@@ -0,0 +1,107 @@
+// ============================================================================
+// Effect quality governor (Framework-Agnostic)
+// ============================================================================
+
+#include "qualitygovernor.h"
+#include "textcache.h"
+#include <algorithm>
+#include <string>
+
+QualityGovernor qualityGovernor;
+
+// Share of the frame budget the game area may take to draw; the rest is
+// left for compositing, the other widgets and the game logic
+static const double DOWN_SHARE = 0.5;
+static const double UP_SHARE = 0.2;
+
+static const double SMOOTHING = 0.1;      // Weight of the newest frame in the average
+static const int SETTLE_FRAMES = 30;      // Frames to wait after a change before judging again
+static const int CALM_FRAMES = 180;       // Frames inside UP_SHARE before stepping up
+static const int MAX_CALM_FRAMES = 180 * 16;
+
+static const QualityGovernor::Budget BUDGETS[QualityGovernor::LEVELS] = {
+  // halo   ring   frost  sparkle fireworks trails  background
+  {false, false, 1, false, 0.25, 1, false, CAIRO_FILTER_FAST},
+  {true, false, 1, false, 0.5, 2, true, CAIRO_FILTER_FAST},
+  {true, true, 2, false, 0.75, 4, true, CAIRO_FILTER_GOOD},
+  {true, true, 3, true, 1.0, 15, true, CAIRO_FILTER_GOOD},
+};
+
+QualityGovernor::Frame::~Frame() {
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  governor.frameDrawn(std::chrono::duration<double, std::milli>(elapsed).count());
+}
+
+QualityGovernor::QualityGovernor()
+    : level(LEVELS - 1), override(AUTO), targetFps(60), showIndicator(false), averageMs(-1.0),
+      framesAtLevel(0), calmFrames(0), calmNeeded(CALM_FRAMES), steppedUp(false) {}
+
+const QualityGovernor::Budget &QualityGovernor::budgetFor(int level) {
+  return BUDGETS[std::max(0, std::min(LEVELS - 1, level))];
+}
+
+void QualityGovernor::changeLevel(int newLevel) {
+  level.store(newLevel, std::memory_order_relaxed);
+  framesAtLevel = 0;
+  calmFrames = 0;
+}
+
+void QualityGovernor::frameDrawn(double drawMs) {
+  averageMs = (averageMs < 0.0) ? drawMs : averageMs + (drawMs - averageMs) * SMOOTHING;
+  ++framesAtLevel;
+  if (override != AUTO || framesAtLevel < SETTLE_FRAMES) {
+    return;
+  }
+
+  double frameMs = 1000.0 / targetFps;
+  int current = getLevel();
+  if (averageMs > frameMs * DOWN_SHARE && current > 0) {
+    // Falling straight back from a step up means that level does not fit;
+    // wait longer before trying it again
+    if (steppedUp) {
+      calmNeeded = std::min(calmNeeded * 2, MAX_CALM_FRAMES);
+    }
+    steppedUp = false;
+    changeLevel(current - 1);
+    return;
+  }
+
+  calmFrames = (averageMs < frameMs * UP_SHARE) ? calmFrames + 1 : 0;
+  if (calmFrames >= calmNeeded && current < LEVELS - 1) {
+    steppedUp = true;
+    changeLevel(current + 1);
+  }
+}
+
+void QualityGovernor::setOverride(int newOverride) {
+  override = (newOverride == AUTO) ? AUTO : std::max(0, std::min(LEVELS - 1, newOverride));
+  calmNeeded = CALM_FRAMES;
+  steppedUp = false;
+  changeLevel(override == AUTO ? LEVELS - 1 : override);
+}
+
+void QualityGovernor::setTargetFps(int fps) {
+  targetFps = std::max(10, std::min(240, fps));
+  calmNeeded = CALM_FRAMES;
+  steppedUp = false;
+  framesAtLevel = 0;
+  calmFrames = 0;
+}
+
+void QualityGovernor::drawIndicator(cairo_t *cr) const {
+  if (!showIndicator) {
+    return;
+  }
+
+  // Only the level is shown, so the text cache sees a handful of strings
+  std::string text = "FX " + std::to_string(getLevel()) + "/" + std::to_string(LEVELS - 1) +
+                     (override == AUTO ? " auto" : " fixed");
+  const TextCache::Entry &entry = textCache.get(cr, text, "Sans", CAIRO_FONT_WEIGHT_BOLD, 11);
+
+  cairo_save(cr);
+  cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.7);
+  TextCache::show(cr, entry, 7, 17);
+  cairo_set_source_rgba(cr, 1.0, 1.0, 0.6, 0.9);
+  TextCache::show(cr, entry, 6, 16);
+  cairo_restore(cr);
+}
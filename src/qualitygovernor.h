@@ -0,0 +1,105 @@
+#ifndef QUALITYGOVERNOR_H
+#define QUALITYGOVERNOR_H
+
+#include <cairo/cairo.h>
+#include <atomic>
+#include <chrono>
+
+/**
+ * Scales effect detail to hold a target frame rate.
+ *
+ * The draw handlers time each frame of the game area. When the average
+ * draw time uses too much of the frame budget the governor drops one
+ * quality level, and when it has stayed well inside the budget for a
+ * while it steps back up. Each level is a fixed effect budget: which
+ * heat effect sprites are drawn, how many frost layers, how many
+ * particles a firework burst spawns, how many trail segments a piece
+ * leaves and how the background image is composited.
+ *
+ * A fixed level can be set instead (settings file or --quality), for
+ * cabinets where the automatic choice is not wanted.
+ */
+class QualityGovernor {
+public:
+    static const int LEVELS = 4;        // 0 = minimal .. LEVELS - 1 = full detail
+    static const int AUTO = -1;         // Override value for automatic control
+
+    struct Budget {
+        bool glowHalo;                  // Halo around hot blocks
+        bool fireRing;                  // Fire particles around very hot blocks
+        int frostLayers;                // Star layers on cold blocks
+        bool coldSparkles;              // Sparkles around very cold blocks
+        double fireworkScale;           // Share of each burst's particles spawned
+        int trailSegments;              // Cap on block trail segments
+        bool backgroundImage;           // Draw the background image at all
+        cairo_filter_t backgroundFilter;
+    };
+
+    /** Times one frame from construction to destruction */
+    class Frame {
+    public:
+        explicit Frame(QualityGovernor &governor)
+            : governor(governor), start(std::chrono::steady_clock::now()) {}
+        ~Frame();
+    private:
+        QualityGovernor &governor;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    QualityGovernor();
+
+    /**
+     * Feed one frame's draw time and adjust the level if needed.
+     * @param drawMs Milliseconds spent drawing the game area
+     */
+    void frameDrawn(double drawMs);
+
+    /** Current level; safe to call from any thread */
+    int getLevel() const { return level.load(std::memory_order_relaxed); }
+
+    /** Budget for the current level; safe to call from any thread */
+    const Budget &budget() const { return budgetFor(getLevel()); }
+
+    /** Budget for a given level (clamped) */
+    static const Budget &budgetFor(int level);
+
+    /**
+     * Fix the level, or hand control back to the governor.
+     * @param level 0 to LEVELS - 1, or AUTO
+     */
+    void setOverride(int level);
+    int getOverride() const { return override; }
+
+    /** @param fps Frame rate to hold, 10 to 240 */
+    void setTargetFps(int fps);
+    int getTargetFps() const { return targetFps; }
+
+    void setShowIndicator(bool show) { showIndicator = show; }
+    bool isIndicatorShown() const { return showIndicator; }
+
+    /** Average draw time of recent frames in milliseconds */
+    double getAverageDrawMs() const { return averageMs; }
+
+    /**
+     * Draw the level indicator in the top-left corner of the game area,
+     * if it is enabled.
+     */
+    void drawIndicator(cairo_t *cr) const;
+
+private:
+    std::atomic<int> level;
+    int override;
+    int targetFps;
+    bool showIndicator;
+    double averageMs;
+    int framesAtLevel;                  // Frames since the level last changed
+    int calmFrames;                     // Consecutive frames well inside the budget
+    int calmNeeded;                     // Calm frames required before stepping up
+    bool steppedUp;                     // The last change was a step up
+
+    void changeLevel(int newLevel);
+};
+
+extern QualityGovernor qualityGovernor;
+
+#endif // QUALITYGOVERNOR_H
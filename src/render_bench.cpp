@@ -0,0 +1,418 @@
+// ============================================================================
+// render_bench: time the game area renderer on canned scenarios
+//
+// Usage: render_bench [--frames N] [--warmup N] [--quality N] [--only NAME]
+//                     [--json FILE] [--png DIR]
+//
+// Draws each scenario into a Cairo image surface, with no window, in the
+// kiosk's game area order: background, grid, then the command list's
+// layers. Reports mean ms/frame per draw stage plus frame percentiles and
+// writes the same numbers as JSON (render_bench.json by default), so
+// renderer changes can be compared run against run. --png saves each
+// scenario's last frame for a visual check.
+//
+// Built from the kiosk sources; see the render-bench target in
+// Makefile.kiosk.
+// ============================================================================
+
+#include "tetrimone_kiosk.h"
+#include "rendercommands.h"
+#include "particles.h"
+#include "qualitygovernor.h"
+#include "profiler.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const int BENCH_SEED = 20250705;
+static const int BENCH_BACKGROUND_WIDTH = 1920;
+static const int BENCH_BACKGROUND_HEIGHT = 1080;
+static const int BENCH_TRAILS = 15;
+static const int BENCH_BURSTS = 5;
+
+struct Scenario {
+    const char *name;
+    int blockSize;
+    int filledRows;         // Locked rows from the bottom
+    float heat;
+    bool fireworks;
+    bool trails;
+    bool themeTransition;
+    bool crossfade;
+};
+
+// The 4K case is the kiosk on a 3840x2160 screen, where the block size
+// hits MAX_BLOCK_SIZE
+static const Scenario SCENARIOS[] = {
+    // name                  block  rows  heat  fire   trails theme  fade
+    {"empty",                  30,    0, 0.5f, false, false, false, false},
+    {"full",                   30,   18, 0.5f, false, false, false, false},
+    {"max-heat",               30,   18, 1.0f, false, false, false, false},
+    {"max-frost",              30,   18, 0.0f, false, false, false, false},
+    {"fireworks",              30,    8, 0.5f, true,  false, false, false},
+    {"trails",                 30,    8, 0.5f, false, true,  false, false},
+    {"theme-transition",       30,    8, 0.5f, false, false, true,  false},
+    {"background-crossfade",   30,    8, 0.5f, false, false, false, true},
+    {"4k-block80",             80,   18, 1.0f, false, false, false, false},
+};
+
+enum Stage { BUILD, BACKGROUND, GRID, BOARD, PIECE, OVERLAY, PARTICLES, TRAILS, STAGE_COUNT };
+
+static const char *STAGE_NAMES[STAGE_COUNT] = {
+    "build", "background", "grid", "board", "piece", "overlay", "particles", "trails"
+};
+
+struct Result {
+    const Scenario *scenario;
+    int width, height;
+    double stageMs[STAGE_COUNT];
+    double meanMs, p50Ms, p95Ms, maxMs;
+    double commands;        // Mean commands per frame
+};
+
+// Stand-in for a background photo: a gradient with soft discs, so the
+// scaled paint and crossfade touch varied pixels
+static cairo_surface_t *createBackground(std::minstd_rand &rng) {
+    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, BENCH_BACKGROUND_WIDTH,
+                                                          BENCH_BACKGROUND_HEIGHT);
+    cairo_t *cr = cairo_create(surface);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    cairo_pattern_t *gradient = cairo_pattern_create_linear(0, 0, BENCH_BACKGROUND_WIDTH,
+                                                            BENCH_BACKGROUND_HEIGHT);
+    cairo_pattern_add_color_stop_rgb(gradient, 0.0, unit(rng), unit(rng), unit(rng));
+    cairo_pattern_add_color_stop_rgb(gradient, 1.0, unit(rng), unit(rng), unit(rng));
+    cairo_set_source(cr, gradient);
+    cairo_paint(cr);
+    cairo_pattern_destroy(gradient);
+
+    for (int i = 0; i < 40; ++i) {
+        cairo_set_source_rgba(cr, unit(rng), unit(rng), unit(rng), 0.4);
+        cairo_arc(cr, unit(rng) * BENCH_BACKGROUND_WIDTH, unit(rng) * BENCH_BACKGROUND_HEIGHT,
+                  20 + unit(rng) * 200, 0, 2 * M_PI);
+        cairo_fill(cr);
+    }
+    cairo_destroy(cr);
+    return surface;
+}
+
+// Replace whatever background.zip gave the board with generated images,
+// so every machine draws the same pixels
+static void setupBackgrounds(TetrimoneBoard &board, std::minstd_rand &rng) {
+    board.cancelBackgroundTransition();
+    board.cleanupBackgroundImages();
+    board.backgroundImages.push_back(createBackground(rng));
+    board.backgroundImages.push_back(createBackground(rng));
+    board.setUseBackgroundImage(true);
+    board.setUseBackgroundZip(true);
+    board.selectRandomBackground();
+}
+
+// Lock filledRows rows of cells under a piece at the top; full rows are
+// fine, nothing clears them outside the game loop
+static bool setupBoard(TetrimoneBoard &board, const Scenario &scenario) {
+    GameSnapshot state = board.snapshot();
+    for (int y = 0; y < GRID_HEIGHT; ++y) {
+        bool filled = y >= GRID_HEIGHT - scenario.filledRows;
+        state.occupancy[y] = 0;
+        state.cells[y] = 0;
+        for (int x = 0; filled && x < GRID_WIDTH; ++x) {
+            state.occupancy[y] |= (uint16_t)(1u << x);
+            state.cells[y] |= (uint64_t)((x + y) % 7 + 1) << (x * 4);
+        }
+    }
+    state.pieceType = 2;
+    state.pieceRotation = 0;
+    state.pieceX = GRID_WIDTH / 2 - 2;
+    state.pieceY = 0;
+    state.heatLevel = scenario.heat;
+    state.gameOver = false;
+    if (!board.restoreSnapshot(state)) {
+        return false;
+    }
+    // buildFrameCommands() draws the published grid, as in the game
+    board.publishState();
+    return true;
+}
+
+// A Tetrimone's worth of bursts, as startFireworksAnimation() spawns them
+static void spawnFireworks(FireworkPool &pool, const TetrimoneBoard &board, std::minstd_rand &rng) {
+    double scale = qualityGovernor.budget().fireworkScale;
+    for (int burst = 0; burst < BENCH_BURSTS; ++burst) {
+        double centerX = (rng() % GRID_WIDTH) * BLOCK_SIZE + BLOCK_SIZE / 2;
+        double centerY = (rng() % 4 + GRID_HEIGHT - 8) * BLOCK_SIZE + BLOCK_SIZE / 2;
+        std::array<double, 3> baseColor = board.getPalette().themeColor(rng() % 7);
+        int count = std::max(1, (int)lround((15 + rng() % 10) * scale));
+
+        for (int i = 0; i < count; ++i) {
+            double angle = (2.0 * M_PI * i) / count + (rng() % 100 - 50) * 0.01;
+            double speed = 2.0 + (rng() % 100) * 0.03;
+            std::array<double, 3> color = baseColor;
+            for (double &channel : color) {
+                channel = std::max(0.0, std::min(1.0, channel + (rng() % 40 - 20) * 0.01));
+            }
+            pool.spawn(centerX, centerY, cos(angle) * speed, sin(angle) * speed,
+                       3.0 + rng() % 3, 0.1 + (rng() % 5) * 0.01, 0.008 + (rng() % 5) * 0.001,
+                       color[0], color[1], color[2]);
+        }
+    }
+}
+
+static double percentile(std::vector<double> sorted, double share) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    size_t index = (size_t)(share * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+static Result runScenario(TetrimoneBoard &board, const Scenario &scenario, int frames, int warmup,
+                          const std::string &pngDir) {
+    BLOCK_SIZE = scenario.blockSize;
+    currentThemeIndex = 0;
+    board.cancelThemeTransition();
+    board.cancelBackgroundTransition();
+
+    std::minstd_rand rng(BENCH_SEED);
+    setupBackgrounds(board, rng);
+    if (!setupBoard(board, scenario)) {
+        std::cerr << "Could not set up the board for " << scenario.name << std::endl;
+    }
+
+    Result result;
+    result.scenario = &scenario;
+    result.width = GRID_WIDTH * BLOCK_SIZE;
+    result.height = GRID_HEIGHT * BLOCK_SIZE;
+    std::fill(result.stageMs, result.stageMs + STAGE_COUNT, 0.0);
+    result.commands = 0.0;
+
+    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, result.width,
+                                                          result.height);
+    cairo_t *cr = cairo_create(surface);
+
+    RenderCommandList list;
+    FireworkPool fireworks;
+    TrailPool trails;
+    int trailLimit = std::min(BENCH_TRAILS, qualityGovernor.budget().trailSegments);
+    uint16_t trailCells[7];
+    for (int type = 0; type < 7; ++type) {
+        trailCells[type] = TrailPool::shapeMask(TetrimoneBlock(type).getShape());
+    }
+
+    std::vector<double> frameMs;
+    frameMs.reserve(frames);
+    int nextTheme = 1;
+
+    for (int frame = 0; frame < warmup + frames; ++frame) {
+        // Advance the animations outside the timed part
+        if (scenario.fireworks) {
+            fireworks.update();
+            if (fireworks.empty()) {
+                spawnFireworks(fireworks, board, rng);
+            }
+        }
+        if (scenario.trails) {
+            trails.update(1.0f / 60.0f, 0.6f);
+            int type = frame % 7;
+            auto color = board.getPalette().themeColor(type);
+            trails.spawn(frame % (GRID_WIDTH - 3), 2 + frame % 6, type, trailCells[type],
+                         color[0], color[1], color[2], 2.0f, 0.6f, trailLimit);
+        }
+        if (scenario.themeTransition) {
+            if (board.isThemeTransitionActive()) {
+                board.updateThemeTransition();
+            } else {
+                board.startThemeTransition(nextTheme);
+                nextTheme = (nextTheme + 1) % (int)NUM_COLOR_THEMES;
+            }
+        }
+        if (scenario.crossfade) {
+            if (board.isInBackgroundTransition()) {
+                board.updateBackgroundTransition();
+            } else {
+                board.startBackgroundTransition();
+            }
+        }
+
+        uint64_t stamps[STAGE_COUNT + 1];
+        stamps[0] = Profiler::nowUs();
+        buildFrameCommands(&board, list);
+        buildFireworkCommands(fireworks, list);
+        buildTrailCommands(trails, list);
+        list.sort();
+        stamps[1] = Profiler::nowUs();
+        drawBackground(cr, &board, result.width, result.height);
+        stamps[2] = Profiler::nowUs();
+        drawGridLines(cr, &board);
+        drawFailureLine(cr);
+        stamps[3] = Profiler::nowUs();
+        for (int layer = RenderCommand::LAYER_BOARD; layer <= RenderCommand::LAYER_TRAILS; ++layer) {
+            executeCommands(cr, list, layer, layer);
+            stamps[BOARD + 1 + layer - RenderCommand::LAYER_BOARD] = Profiler::nowUs();
+        }
+        cairo_surface_flush(surface);
+
+        if (frame < warmup) {
+            continue;   // Atlas and sprite caches fill here
+        }
+        for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+            result.stageMs[stage] += (stamps[stage + 1] - stamps[stage]) / 1000.0;
+        }
+        frameMs.push_back((stamps[STAGE_COUNT] - stamps[0]) / 1000.0);
+        result.commands += list.commands.size();
+    }
+
+    int measured = std::max(1, (int)frameMs.size());
+    for (double &ms : result.stageMs) {
+        ms /= measured;
+    }
+    result.commands /= measured;
+    result.meanMs = 0.0;
+    for (double ms : frameMs) {
+        result.meanMs += ms / measured;
+    }
+    result.p50Ms = percentile(frameMs, 0.50);
+    result.p95Ms = percentile(frameMs, 0.95);
+    result.maxMs = frameMs.empty() ? 0.0 : *std::max_element(frameMs.begin(), frameMs.end());
+
+    if (!pngDir.empty()) {
+        std::string path = pngDir + "/" + scenario.name + ".png";
+        if (cairo_surface_write_to_png(surface, path.c_str()) != CAIRO_STATUS_SUCCESS) {
+            std::cerr << "Failed to write " << path << std::endl;
+        }
+    }
+
+    board.cancelThemeTransition();
+    board.cancelBackgroundTransition();
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+    return result;
+}
+
+static bool writeJson(const std::string &path, const std::vector<Result> &results, int frames,
+                      int warmup, int quality) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open results file for writing: " << path << std::endl;
+        return false;
+    }
+
+    // Scenario and stage names are literals, so they need no escaping
+    file << std::fixed << std::setprecision(4);
+    file << "{\n  \"frames\": " << frames << ",\n  \"warmup\": " << warmup
+         << ",\n  \"quality\": " << quality << ",\n  \"scenarios\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result &r = results[i];
+        file << "    {\"name\": \"" << r.scenario->name << "\", \"width\": " << r.width
+             << ", \"height\": " << r.height << ", \"blockSize\": " << r.scenario->blockSize
+             << ", \"commands\": " << r.commands << ",\n     \"stageMs\": {";
+        for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+            file << (stage ? ", " : "") << "\"" << STAGE_NAMES[stage] << "\": " << r.stageMs[stage];
+        }
+        file << "},\n     \"frameMs\": {\"mean\": " << r.meanMs << ", \"p50\": " << r.p50Ms
+             << ", \"p95\": " << r.p95Ms << ", \"max\": " << r.maxMs << "}}"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    return file.good();
+}
+
+static void printUsage(const char *program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --frames N     Timed frames per scenario (default 300)\n"
+              << "  --warmup N     Untimed frames first (default 10)\n"
+              << "  --quality N    Effect quality level 0-" << QualityGovernor::LEVELS - 1
+              << " (default " << QualityGovernor::LEVELS - 1 << ")\n"
+              << "  --only NAME    Run one scenario\n"
+              << "  --json FILE    Results file (default render_bench.json)\n"
+              << "  --png DIR      Save each scenario's last frame as DIR/NAME.png\n"
+              << "Scenarios:";
+    for (const Scenario &scenario : SCENARIOS) {
+        std::cout << " " << scenario.name;
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    int frames = 300;
+    int warmup = 10;
+    int quality = QualityGovernor::LEVELS - 1;
+    std::string only, jsonPath = "render_bench.json", pngDir;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--frames" && hasValue) {
+            frames = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--warmup" && hasValue) {
+            warmup = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--quality" && hasValue) {
+            quality = std::max(0, std::min(QualityGovernor::LEVELS - 1, std::atoi(argv[++i])));
+        } else if (arg == "--only" && hasValue) {
+            only = argv[++i];
+        } else if (arg == "--json" && hasValue) {
+            jsonPath = argv[++i];
+        } else if (arg == "--png" && hasValue) {
+            pngDir = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    // A fixed level, so a slow scenario does not lower the next one's detail
+    qualityGovernor.setOverride(quality);
+
+    TetrimoneBoard board;
+    board.setApp(nullptr);
+    board.setSplashScreenActive(false);
+    board.showGridLines = true;
+
+    std::vector<Result> results;
+    for (const Scenario &scenario : SCENARIOS) {
+        if (!only.empty() && only != scenario.name) {
+            continue;
+        }
+        results.push_back(runScenario(board, scenario, frames, warmup, pngDir));
+    }
+    if (results.empty()) {
+        std::cerr << "No scenario named " << only << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::cout << "\nFrames: " << frames << " (after " << warmup << " warmup), quality " << quality
+              << ", ms/frame per stage" << std::endl;
+    std::cout << std::left << std::setw(22) << "scenario" << std::right;
+    for (const char *name : STAGE_NAMES) {
+        std::cout << std::setw(11) << name;
+    }
+    std::cout << std::setw(10) << "mean" << std::setw(10) << "p95" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    for (const Result &r : results) {
+        std::cout << std::left << std::setw(22) << r.scenario->name << std::right;
+        for (double ms : r.stageMs) {
+            std::cout << std::setw(11) << ms;
+        }
+        std::cout << std::setw(10) << r.meanMs << std::setw(10) << r.p95Ms << std::endl;
+    }
+
+    if (!writeJson(jsonPath, results, frames, warmup, quality)) {
+        return 1;
+    }
+    std::cout << "Results written to " << jsonPath << std::endl;
+    return 0;
+}
@@ -0,0 +1,950 @@
+// ============================================================================
+// Render Command Lists for the game area (Framework-Agnostic)
+// ============================================================================
+
+#include "tetrimone_core.h"
+#include "rendercommands.h"
+#include "blockatlas.h"
+#include "effectsprites.h"
+#include "textcache.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static_assert(sizeof(RenderCommand) == 28, "RenderCommand must stay free of padding");
+static_assert(std::is_trivially_copyable<ThemePalette>::value,
+              "Recordings store the palette as raw bytes");
+
+static const uint32_t RECORDING_MAGIC = 0x4c435254;  // "TRCL"
+static const uint32_t RECORDING_VERSION = 3;
+
+// Room for sprite outlines and the heat glow around a block
+static const double SPRITE_MARGIN = 2.0;
+
+// ============================================================================
+// Command List
+// ============================================================================
+
+void RenderCommandList::Box::add(double ax0, double ay0, double ax1, double ay1) {
+  if (ax1 <= ax0 || ay1 <= ay0) {
+    return;
+  }
+  if (empty()) {
+    x0 = ax0; y0 = ay0; x1 = ax1; y1 = ay1;
+    return;
+  }
+  x0 = std::min(x0, ax0);
+  y0 = std::min(y0, ay0);
+  x1 = std::max(x1, ax1);
+  y1 = std::max(y1, ay1);
+}
+
+uint32_t RenderCommandList::packColor(double r, double g, double b, double a) {
+  auto channel = [](double v) {
+    return (uint32_t)std::lround(std::max(0.0, std::min(1.0, v)) * 255.0);
+  };
+  return (channel(r) << 24) | (channel(g) << 16) | (channel(b) << 8) | channel(a);
+}
+
+void RenderCommandList::clear() {
+  commands.clear();
+  strings.clear();
+  images.clear();
+}
+
+RenderCommand RenderCommandList::make(int layer, int kind, int style, int type) const {
+  RenderCommand command;
+  std::memset(&command, 0, sizeof(command));
+  command.layer = (uint8_t)layer;
+  command.kind = (uint8_t)kind;
+  command.style = (uint8_t)style;
+  command.type = (uint8_t)type;
+  return command;
+}
+
+void RenderCommandList::clip(double x, double y, double w, double h) {
+  RenderCommand command = make(RenderCommand::LAYER_BACKGROUND, RenderCommand::CLIP, 0, 0);
+  command.x = (float)x;
+  command.y = (float)y;
+  command.w = (float)w;
+  command.h = (float)h;
+  commands.push_back(command);
+}
+
+void RenderCommandList::rect(int layer, double x, double y, double w, double h, uint32_t color) {
+  RenderCommand command = make(layer, RenderCommand::RECT, 0, 0);
+  command.color = color;
+  command.x = (float)x;
+  command.y = (float)y;
+  command.w = (float)w;
+  command.h = (float)h;
+  commands.push_back(command);
+}
+
+void RenderCommandList::sprite(int layer, int row, int type, double x, double y, double scale,
+                               double alpha) {
+  if (alpha <= 0.0 || scale <= 0.0) {
+    return;
+  }
+  RenderCommand command = make(layer, RenderCommand::SPRITE, row, type);
+  command.x = (float)x;
+  command.y = (float)y;
+  command.w = (float)scale;
+  command.h = (float)alpha;
+  commands.push_back(command);
+}
+
+void RenderCommandList::effect(int style, double x, double y, double size) {
+  if (size <= 0.0) {
+    return;
+  }
+  RenderCommand command = make(RenderCommand::LAYER_BOARD, RenderCommand::EFFECT, style, 0);
+  command.x = (float)x;
+  command.y = (float)y;
+  command.w = (float)size;
+  commands.push_back(command);
+}
+
+void RenderCommandList::text(int layer, const std::string &text, double x, double y, double size,
+                             uint32_t color, bool centred) {
+  // A frame holds a handful of strings, so a linear search is enough
+  size_t index = std::find(strings.begin(), strings.end(), text) - strings.begin();
+  if (index == strings.size()) {
+    strings.push_back(text);
+  }
+  RenderCommand command = make(layer, RenderCommand::TEXT,
+                               centred ? RenderCommand::TEXT_CENTRED : RenderCommand::TEXT_LEFT, 0);
+  command.color = color;
+  command.arg = (uint32_t)index;
+  command.x = (float)x;
+  command.y = (float)y;
+  command.w = (float)size;
+  commands.push_back(command);
+}
+
+void RenderCommandList::particle(double x, double y, double radius, double life, uint32_t color) {
+  if (radius * life <= 0.0) {
+    return;
+  }
+  RenderCommand command = make(RenderCommand::LAYER_PARTICLES, RenderCommand::PARTICLE, 0, 0);
+  command.color = color;
+  command.x = (float)x;
+  command.y = (float)y;
+  command.w = (float)radius;
+  command.h = (float)life;
+  commands.push_back(command);
+}
+
+void RenderCommandList::image(cairo_surface_t *surface, double opacity) {
+  cairo_format_t format = cairo_image_surface_get_format(surface);
+  int imageWidth = cairo_image_surface_get_width(surface);
+  int imageHeight = cairo_image_surface_get_height(surface);
+  if (opacity <= 0.0 || imageWidth <= 0 || imageHeight <= 0 ||
+      (format != CAIRO_FORMAT_ARGB32 && format != CAIRO_FORMAT_RGB24)) {
+    return;
+  }
+
+  size_t index = 0;
+  while (index < images.size() && images[index].get() != surface) {
+    ++index;
+  }
+  if (index == images.size()) {
+    images.emplace_back(cairo_surface_reference(surface), cairo_surface_destroy);
+  }
+
+  double scale = std::max((double)width / imageWidth, (double)height / imageHeight);
+  RenderCommand command = make(RenderCommand::LAYER_BACKGROUND, RenderCommand::IMAGE, 0, 0);
+  command.color = packColor(0, 0, 0, opacity);
+  command.arg = (uint32_t)index;
+  command.w = (float)(imageWidth * scale);
+  command.h = (float)(imageHeight * scale);
+  command.x = (float)((width - command.w) / 2);
+  command.y = (float)((height - command.h) / 2);
+  commands.push_back(command);
+}
+
+void RenderCommandList::sort() {
+  std::stable_sort(commands.begin(), commands.end(),
+                   [](const RenderCommand &a, const RenderCommand &b) { return a.key() < b.key(); });
+
+  // Batch by state within each layer; a block's glow still covers the
+  // blocks before it and stays under the neighbours drawn after it
+  std::vector<Box> boxes;
+  boxes.reserve(commands.size());
+  size_t layerStart = 0;
+  for (size_t i = 0; i < commands.size(); ++i) {
+    RenderCommand command = commands[i];
+    Box box = bounds(command);
+    if (i > 0 && commands[i - 1].layer != command.layer) {
+      layerStart = i;
+    }
+    size_t target = i;
+    for (size_t j = i; j-- > layerStart;) {
+      if (commands[j].state() == command.state()) {
+        target = j + 1;
+        break;
+      }
+      if (boxes[j].overlaps(box)) {
+        break;
+      }
+    }
+    if (target != i) {
+      std::move_backward(commands.begin() + target, commands.begin() + i, commands.begin() + i + 1);
+      commands[target] = command;
+      boxes.insert(boxes.begin() + target, box);
+    } else {
+      boxes.push_back(box);
+    }
+  }
+}
+
+static bool hasEffects(const std::vector<RenderCommand> &commands) {
+  for (const RenderCommand &command : commands) {
+    if (command.kind == RenderCommand::EFFECT) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Everything but the commands and the effect clock
+static bool sameSetup(const RenderCommandList &a, const RenderCommandList &b) {
+  return a.width == b.width && a.height == b.height && a.blockSize == b.blockSize &&
+         a.palette.getColorHash() == b.palette.getColorHash() && a.heatLevel == b.heatLevel &&
+         a.retro == b.retro && a.simple == b.simple && a.effectLevel == b.effectLevel &&
+         a.strings == b.strings && a.images == b.images;
+}
+
+bool RenderCommandList::sameAs(const RenderCommandList &other) const {
+  if (!sameSetup(*this, other) || commands.size() != other.commands.size()) {
+    return false;
+  }
+  if (!commands.empty() &&
+      std::memcmp(commands.data(), other.commands.data(), commands.size() * sizeof(RenderCommand)) != 0) {
+    return false;
+  }
+  // Heat effects animate on the clock alone
+  return timeMs == other.timeMs || !hasEffects(commands);
+}
+
+RenderCommandList::Box RenderCommandList::bounds(const RenderCommand &command) const {
+  Box box;
+  switch (command.kind) {
+    case RenderCommand::CLIP:
+    case RenderCommand::RECT:
+    case RenderCommand::IMAGE:
+      box.add(command.x, command.y, command.x + command.w, command.y + command.h);
+      break;
+    case RenderCommand::SPRITE: {
+      double size = blockSize * command.w;
+      box.add(command.x - SPRITE_MARGIN, command.y - SPRITE_MARGIN,
+              command.x + size + SPRITE_MARGIN, command.y + size + SPRITE_MARGIN);
+      break;
+    }
+    case RenderCommand::EFFECT:
+      // Halos and sparkles reach about half a block past the cell
+      box.add(command.x - command.w, command.y - command.w,
+              command.x + 2 * command.w, command.y + 2 * command.w);
+      break;
+    case RenderCommand::PARTICLE: {
+      // The glow mask spans twice the particle radius
+      double reach = 2.0 * command.w * command.h + 1.0;
+      box.add(command.x - reach, command.y - reach, command.x + reach, command.y + reach);
+      break;
+    }
+    default:
+      box.add(0, 0, width, height);
+      break;
+  }
+  return box;
+}
+
+RenderCommandList::Box RenderCommandList::changedArea(const RenderCommandList &previous) const {
+  Box area;
+  if (!sameSetup(*this, previous)) {
+    area.add(0, 0, width, height);
+    area.add(0, 0, previous.width, previous.height);
+    return area;
+  }
+
+  bool clockMoved = timeMs != previous.timeMs;
+  size_t count = std::max(commands.size(), previous.commands.size());
+  for (size_t i = 0; i < count; ++i) {
+    const RenderCommand *now = i < commands.size() ? &commands[i] : nullptr;
+    const RenderCommand *before = i < previous.commands.size() ? &previous.commands[i] : nullptr;
+    bool same = now && before && std::memcmp(now, before, sizeof(RenderCommand)) == 0 &&
+                !(clockMoved && now->kind == RenderCommand::EFFECT);
+    if (same) {
+      continue;
+    }
+    if ((now && now->kind == RenderCommand::TEXT) || (before && before->kind == RenderCommand::TEXT)) {
+      area.add(0, 0, width, height);
+      return area;
+    }
+    if (now) {
+      Box box = bounds(*now);
+      area.add(box.x0, box.y0, box.x1, box.y1);
+    }
+    if (before) {
+      Box box = previous.bounds(*before);
+      area.add(box.x0, box.y0, box.x1, box.y1);
+    }
+  }
+  return area;
+}
+
+// ============================================================================
+// Recording files
+// ============================================================================
+
+template <typename T>
+static void writeValue(std::ostream &out, const T &value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool readValue(std::istream &in, T &value) {
+  return (bool)in.read(reinterpret_cast<char *>(&value), sizeof(T));
+}
+
+// Each image as its number, then its pixels if the recording does not have it yet
+static void writeImages(std::ostream &out, const std::vector<std::shared_ptr<cairo_surface_t>> &images,
+                        std::vector<std::shared_ptr<cairo_surface_t>> &stored) {
+  writeValue(out, (uint32_t)images.size());
+  for (const std::shared_ptr<cairo_surface_t> &image : images) {
+    size_t number = std::find(stored.begin(), stored.end(), image) - stored.begin();
+    bool isNew = number == stored.size();
+    writeValue(out, (uint32_t)number);
+    writeValue(out, (uint8_t)isNew);
+    if (!isNew) {
+      continue;
+    }
+    stored.push_back(image);
+
+    cairo_surface_t *surface = image.get();
+    cairo_surface_flush(surface);
+    int32_t imageWidth = cairo_image_surface_get_width(surface);
+    int32_t imageHeight = cairo_image_surface_get_height(surface);
+    int32_t format = cairo_image_surface_get_format(surface);
+    int stride = cairo_image_surface_get_stride(surface);
+    const unsigned char *data = cairo_image_surface_get_data(surface);
+    writeValue(out, imageWidth);
+    writeValue(out, imageHeight);
+    writeValue(out, format);
+    for (int y = 0; y < imageHeight; ++y) {
+      out.write(reinterpret_cast<const char *>(data + y * stride), imageWidth * 4);
+    }
+  }
+}
+
+static bool readImages(std::istream &in, std::vector<std::shared_ptr<cairo_surface_t>> &images,
+                       std::vector<std::shared_ptr<cairo_surface_t>> &stored) {
+  uint32_t count = 0;
+  if (!readValue(in, count)) {
+    return false;
+  }
+  images.clear();
+  for (uint32_t i = 0; i < count; ++i) {
+    uint32_t number = 0;
+    uint8_t isNew = 0;
+    if (!readValue(in, number) || !readValue(in, isNew)) {
+      return false;
+    }
+    if (!isNew) {
+      if (number >= stored.size()) {
+        return false;
+      }
+      images.push_back(stored[number]);
+      continue;
+    }
+
+    int32_t imageWidth, imageHeight, format;
+    if (number != stored.size() || !readValue(in, imageWidth) || !readValue(in, imageHeight) ||
+        !readValue(in, format) || imageWidth <= 0 || imageHeight <= 0 ||
+        (format != CAIRO_FORMAT_ARGB32 && format != CAIRO_FORMAT_RGB24)) {
+      return false;
+    }
+    std::shared_ptr<cairo_surface_t> image(
+        cairo_image_surface_create((cairo_format_t)format, imageWidth, imageHeight),
+        cairo_surface_destroy);
+    if (cairo_surface_status(image.get()) != CAIRO_STATUS_SUCCESS) {
+      return false;
+    }
+    int stride = cairo_image_surface_get_stride(image.get());
+    unsigned char *data = cairo_image_surface_get_data(image.get());
+    for (int y = 0; y < imageHeight; ++y) {
+      if (!in.read(reinterpret_cast<char *>(data + y * stride), imageWidth * 4)) {
+        return false;
+      }
+    }
+    cairo_surface_mark_dirty(image.get());
+    stored.push_back(image);
+    images.push_back(image);
+  }
+  return true;
+}
+
+void RenderCommandList::write(std::ostream &out, RecordingImages &stored) const {
+  writeValue(out, RECORDING_MAGIC);
+  writeValue(out, RECORDING_VERSION);
+  writeValue(out, (int32_t)width);
+  writeValue(out, (int32_t)height);
+  writeValue(out, (int32_t)blockSize);
+  writeValue(out, heatLevel);
+  writeValue(out, timeMs);
+  writeValue(out, (uint8_t)retro);
+  writeValue(out, (uint8_t)simple);
+  writeValue(out, (int32_t)effectLevel);
+  writeValue(out, palette);
+
+  writeValue(out, (uint32_t)commands.size());
+  out.write(reinterpret_cast<const char *>(commands.data()), commands.size() * sizeof(RenderCommand));
+
+  writeValue(out, (uint32_t)strings.size());
+  for (const std::string &text : strings) {
+    writeValue(out, (uint32_t)text.size());
+    out.write(text.data(), text.size());
+  }
+
+  writeImages(out, images, stored.images);
+}
+
+bool RenderCommandList::read(std::istream &in, RecordingImages &stored) {
+  uint32_t magic = 0, version = 0;
+  if (!readValue(in, magic) || magic != RECORDING_MAGIC ||
+      !readValue(in, version) || version != RECORDING_VERSION) {
+    return false;
+  }
+
+  int32_t w, h, size, level;
+  uint8_t retroFlag, simpleFlag;
+  if (!readValue(in, w) || !readValue(in, h) || !readValue(in, size) ||
+      !readValue(in, heatLevel) || !readValue(in, timeMs) ||
+      !readValue(in, retroFlag) || !readValue(in, simpleFlag) ||
+      !readValue(in, level) || !readValue(in, palette)) {
+    return false;
+  }
+  width = w;
+  height = h;
+  blockSize = size;
+  retro = retroFlag != 0;
+  simple = simpleFlag != 0;
+  effectLevel = level;
+
+  uint32_t count = 0;
+  if (!readValue(in, count)) {
+    return false;
+  }
+  commands.resize(count);
+  if (count && !in.read(reinterpret_cast<char *>(commands.data()), count * sizeof(RenderCommand))) {
+    return false;
+  }
+
+  if (!readValue(in, count)) {
+    return false;
+  }
+  strings.resize(count);
+  for (std::string &text : strings) {
+    uint32_t length = 0;
+    if (!readValue(in, length)) {
+      return false;
+    }
+    text.resize(length);
+    if (length && !in.read(&text[0], length)) {
+      return false;
+    }
+  }
+
+  if (!readImages(in, images, stored.images)) {
+    return false;
+  }
+
+  // A string or image index past its table would read out of bounds when drawn
+  for (const RenderCommand &command : commands) {
+    if ((command.kind == RenderCommand::TEXT && command.arg >= strings.size()) ||
+        (command.kind == RenderCommand::IMAGE && command.arg >= images.size())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ============================================================================
+// Frame recorder
+// ============================================================================
+
+FrameRecorder frameRecorder;
+
+bool FrameRecorder::open(const std::string &recordingPath) {
+  close();
+  file.open(recordingPath, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    std::cerr << "Failed to open recording for writing: " << recordingPath << std::endl;
+    return false;
+  }
+  path = recordingPath;
+  images.clear();
+  haveLast = false;
+  return true;
+}
+
+void FrameRecorder::close() {
+  if (file.is_open()) {
+    file.close();
+    std::cout << "Game recording written to " << path << std::endl;
+  }
+  haveLast = false;
+}
+
+void FrameRecorder::add(const RenderCommandList &list) {
+  if (!file.is_open() || (haveLast && list.sameAs(last))) {
+    return;
+  }
+  list.write(file, images);
+  if (!file.good()) {
+    std::cerr << "Failed to write recording " << path << ", recording stopped" << std::endl;
+    file.close();
+    return;
+  }
+  last = list;
+  haveLast = true;
+}
+
+// ============================================================================
+// Building a frame from the board
+// ============================================================================
+
+// Fill, background image, grid and failure line, as drawBackground(),
+// drawGridLines() and drawFailureLine(). The frontends still draw these
+// with those functions; the layer is here for recordings and executors
+// that have no board.
+static void buildBackground(TetrimoneBoard *board, RenderCommandList &list) {
+  const int layer = RenderCommand::LAYER_BACKGROUND;
+  list.rect(layer, 0, 0, list.width, list.height, RenderCommandList::packColor(0.1, 0.1, 0.1, 1));
+
+  cairo_surface_t *image = (cairo_surface_t *)board->getBackgroundImage();
+  if ((board->isUsingBackgroundImage() || board->isUsingBackgroundZip()) && image &&
+      QualityGovernor::budgetFor(list.effectLevel).backgroundImage) {
+    double opacity = board->getBackgroundOpacity();
+    if (board->isInBackgroundTransition()) {
+      // Fading out shows the old image, fading in the new one
+      opacity = board->getTransitionOpacity();
+      if (board->getTransitionDirection() == -1) {
+        image = (cairo_surface_t *)board->getOldBackground();
+      } else if (board->getTransitionDirection() != 1) {
+        image = nullptr;
+      }
+    }
+    if (image) {
+      list.image(image, opacity);
+    }
+  }
+
+  // One-pixel lines centred on the cell edges, as the strokes are
+  int size = list.blockSize;
+  if (board->isShowingGridLines()) {
+    uint32_t grey = RenderCommandList::packColor(0.3, 0.3, 0.3, 1);
+    for (int x = 1; x < GRID_WIDTH; ++x) {
+      list.rect(layer, x * size - 0.5, 0, 1, GRID_HEIGHT * size, grey);
+    }
+    for (int y = 1; y < GRID_HEIGHT; ++y) {
+      list.rect(layer, 0, y * size - 0.5, GRID_WIDTH * size, 1, grey);
+    }
+  }
+  list.rect(layer, 0, 2 * size - 0.5, GRID_WIDTH * size, 1, RenderCommandList::packColor(1, 0.2, 0.2, 1));
+}
+
+// Locked blocks, moved and faded by a running line clear
+static void buildPlacedBlocks(TetrimoneBoard *board, RenderCommandList &list) {
+  bool heatEffects = !list.retro && (list.heatLevel > 0.7f || list.heatLevel < 0.3f);
+  bool clearing = board->isLineClearActive();
+  double progress = board->getLineClearProgress();
+  int size = list.blockSize;
+
+  // The published grid leaves out rows being cleared, which the
+  // animation still needs from the board
+  const GameSnapshot *settled = clearing ? nullptr : &board->getStatePublisher().latest().game;
+
+  for (int y = 0; y < GRID_HEIGHT; ++y) {
+    bool rowClearing = clearing && board->isLineBeingCleared(y);
+    for (int x = 0; x < GRID_WIDTH; ++x) {
+      int value = settled ? settled->getCell(x, y) : board->getGridValue(x, y);
+      if (value <= 0) {
+        continue;
+      }
+
+      double alpha = 1.0;
+      double scale = 1.0;
+      double offsetX = 0.0;
+      double offsetY = 0.0;
+
+      if (rowClearing) {
+        if (list.retro) {
+          // Soviet-era scan line, CRT collapse, then a chunked wipe
+          if (progress < 0.3) {
+            int scanX = (int)(progress / 0.3 * GRID_WIDTH);
+            alpha = x <= scanX ? 0.3 + 0.4 * sin(progress * 20.0) : 1.0;
+          } else if (progress < 0.7) {
+            double flashProgress = (progress - 0.3) / 0.4;
+            alpha = 1.0 - flashProgress * 0.7;
+            offsetY = flashProgress * size * 0.3;
+          } else {
+            double wipeProgress = (progress - 0.7) / 0.3;
+            double segmentDelay = (x / 3) * 0.2;
+            if (wipeProgress > segmentDelay) {
+              alpha = 0.0;
+              scale = 0.0;
+            } else {
+              alpha = 1.0 - wipeProgress * 0.5;
+            }
+          }
+        } else {
+          LineClearAnimValues animValues =
+              getLineClearAnimationValues(board->getCurrentAnimationType(), progress, x, y);
+          alpha = animValues.alpha;
+          scale = animValues.scale;
+          offsetX = animValues.offsetX;
+          offsetY = animValues.offsetY;
+        }
+      }
+      if (alpha <= 0.0 || scale <= 0.0) {
+        continue;
+      }
+
+      double drawX = x * size + offsetX + (size * (1.0 - scale)) / 2;
+      double drawY = y * size + offsetY + (size * (1.0 - scale)) / 2;
+      list.sprite(RenderCommand::LAYER_BOARD, BlockAtlas::ROW_PLACED, value - 1, drawX, drawY,
+                  scale, alpha);
+
+      if (heatEffects) {
+        list.effect(list.heatLevel > 0.7f ? RenderCommand::GLOW : RenderCommand::FROST,
+                    drawX, drawY, size * scale);
+      }
+    }
+  }
+}
+
+// Falling piece and its ghost, as drawCurrentPiece() and drawGhostPiece()
+static void buildPiece(TetrimoneBoard *board, RenderCommandList &list) {
+  if (board->isGameOver() || board->isPaused() || board->isSplashScreenActive()) {
+    return;
+  }
+  const TetrimoneBlock *piece = board->getCurrentPiece();
+  if (!piece) {
+    return;
+  }
+  const auto &shape = piece->getShape();
+  double pieceX, pieceY;
+  board->getCurrentPieceInterpolatedPosition(pieceX, pieceY);
+  int size = list.blockSize;
+
+  for (size_t y = 0; y < shape.size(); ++y) {
+    for (size_t x = 0; x < shape[y].size(); ++x) {
+      double drawY = (pieceY + y) * size;
+      if (shape[y][x] == 1 && drawY >= -size) {
+        list.sprite(RenderCommand::LAYER_PIECE, BlockAtlas::ROW_PIECE, piece->getType(),
+                    (pieceX + x) * size, drawY, 1.0, 1.0);
+      }
+    }
+  }
+
+  int ghostY = board->getGhostPieceY();
+  if (!board->isGhostPieceEnabled() || ghostY <= (int)pieceY) {
+    return;
+  }
+  for (size_t y = 0; y < shape.size(); ++y) {
+    for (size_t x = 0; x < shape[y].size(); ++x) {
+      double drawY = (ghostY + y) * size;
+      if (shape[y][x] == 1 && drawY >= 0) {
+        list.sprite(RenderCommand::LAYER_PIECE, BlockAtlas::ROW_GHOST, piece->getType(),
+                    (pieceX + x) * size, drawY, 1.0, 1.0);
+      }
+    }
+  }
+}
+
+// Pause menu and game over screen, as drawPauseMenu() and drawGameOver()
+static void buildOverlays(TetrimoneBoard *board, RenderCommandList &list) {
+  const int layer = RenderCommand::LAYER_OVERLAY;
+  double centreX = list.width / 2.0;
+
+  if (board->isPaused() && !board->isGameOver()) {
+    uint32_t white = RenderCommandList::packColor(1, 1, 1, 1);
+    list.rect(layer, 0, 0, list.width, list.height, RenderCommandList::packColor(0, 0, 0, 0.7));
+    list.text(layer, list.retro ? "ПРИОСТАНОВЛЕНО ПО ПРИКАЗУ ПАРТИИ" : "PAUSED",
+              centreX, list.height / 4, 30, white, true);
+
+    const char *menuOptions[3];
+    if (list.retro) {
+      menuOptions[0] = "Продолжить Трудовой Подвиг (P)";
+      menuOptions[1] = "Новая Пятилетка (N)";
+      menuOptions[2] = "Дезертировать с Поля Боя (Q)";
+    } else {
+      menuOptions[0] = "Continue (P)";
+      menuOptions[1] = "New Game (N)";
+      menuOptions[2] = "Quit (Q)";
+    }
+    double y = list.height / 2;
+    for (const char *option : menuOptions) {
+      list.text(layer, option, centreX, y, 20, white, true);
+      y += 40;
+    }
+  }
+
+  if (board->isGameOver()) {
+    uint32_t red = RenderCommandList::packColor(1, 0, 0, 1);
+    list.rect(layer, 0, 0, list.width, list.height, RenderCommandList::packColor(0, 0, 0, 0.7));
+    double y = list.height / 2;
+    list.text(layer, list.retro ? "ИНФОРМАЦИЯ ЗАПРЕЩЕНА" : "GAME OVER", centreX, y, 30, red, true);
+    y += 40;
+    list.text(layer, list.retro ? "ОЖИДАЙТЕ ДОПРОСА. НЕ ДВИГАЙТЕСЬ..." : "Press R to restart",
+              centreX, y, 16, red, true);
+    if (list.retro) {
+      y += 25;
+      list.text(layer, "(AWAIT INTERROGATION. DO NOT MOVE...)", centreX, y, 12, red, true);
+    }
+  }
+}
+
+void buildFireworkCommands(const FireworkPool &particles, RenderCommandList &list) {
+  for (int i = 0; i < particles.size(); ++i) {
+    list.particle(particles.getX(i), particles.getY(i), particles.getSize(i), particles.getLife(i),
+                  RenderCommandList::packColor(particles.getRed(i), particles.getGreen(i),
+                                               particles.getBlue(i), 1.0));
+  }
+}
+
+void buildTrailCommands(const TrailPool &trails, RenderCommandList &list) {
+  int size = list.blockSize;
+  for (int i = 0; i < trails.size(); ++i) {
+    // A trail keeps the colour its piece had. The atlas sprite has the
+    // current theme's, so a trail left over from a theme change is drawn
+    // as flat faces in its own colour instead
+    int type = trails.getPieceType(i);
+    const ThemePalette::Color &spriteColor = list.palette.themeColor(type);
+    uint32_t color = RenderCommandList::packColor(trails.getRed(i), trails.getGreen(i),
+                                                  trails.getBlue(i), trails.getAlpha(i));
+    bool useSprite = (color | 0xff) == RenderCommandList::packColor(spriteColor[0],
+                                                                    spriteColor[1],
+                                                                    spriteColor[2], 1.0);
+    double inset = list.simple ? 0.0 : 1.0;
+
+    uint16_t cells = trails.getCells(i);
+    for (int bit = 0; bit < 16; ++bit) {
+      if (!(cells & (1u << bit))) continue;
+      double drawX = (trails.getX(i) + bit % 4) * size;
+      double drawY = (trails.getY(i) + bit / 4) * size;
+      if (drawY < -size) continue;
+      if (useSprite) {
+        list.sprite(RenderCommand::LAYER_TRAILS, BlockAtlas::ROW_TRAIL, type, drawX, drawY, 1.0,
+                    trails.getAlpha(i));
+      } else {
+        list.rect(RenderCommand::LAYER_TRAILS, drawX + inset, drawY + inset, size - 2 * inset,
+                  size - 2 * inset, color);
+      }
+    }
+  }
+}
+
+static void buildEffects(TetrimoneBoard *board, RenderCommandList &list) {
+  if (board->isFireworksActive()) {
+    buildFireworkCommands(board->getFireworkParticles(), list);
+  }
+  if (board->isTrailsEnabled() && board->isBlockTrailsActive()) {
+    buildTrailCommands(board->getBlockTrails(), list);
+  }
+}
+
+void buildFrameCommands(TetrimoneBoard *board, RenderCommandList &list) {
+  Profiler::Scope scope("buildFrameCommands");
+  list.clear();
+  list.blockSize = BLOCK_SIZE;
+  list.width = GRID_WIDTH * BLOCK_SIZE;
+  list.height = GRID_HEIGHT * BLOCK_SIZE;
+  list.palette = board->getPalette();
+  list.heatLevel = board->getHeatLevel();
+  list.timeMs = std::chrono::duration<double, std::milli>(
+      std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+  list.retro = board->retroModeActive;
+  list.simple = board->simpleBlocksActive;
+  list.effectLevel = qualityGovernor.getLevel();
+
+  list.clip(0, 0, list.width, list.height);
+  buildBackground(board, list);
+  buildPlacedBlocks(board, list);
+  buildPiece(board, list);
+  buildOverlays(board, list);
+  buildEffects(board, list);
+  list.sort();
+}
+
+// ============================================================================
+// Cairo executor
+// ============================================================================
+
+static void setColor(cairo_t *cr, uint32_t color, double alpha = 1.0) {
+  cairo_set_source_rgba(cr, ((color >> 24) & 0xff) / 255.0, ((color >> 16) & 0xff) / 255.0,
+                        ((color >> 8) & 0xff) / 255.0, (color & 0xff) / 255.0 * alpha);
+}
+
+/**
+ * Fireworks, drawn as drawFireworks() does: one masked composite per
+ * particle for the coloured glow, then the white centres batched into
+ * one path per alpha band.
+ */
+static void executeParticles(cairo_t *cr, const RenderCommand *first, const RenderCommand *last,
+                             EffectSprites &sprites) {
+  cairo_pattern_t *mask = sprites.fireworkMask();
+  const double maskCenter = EffectSprites::FIREWORK_CORE * 2;
+  for (const RenderCommand *p = first; mask && p != last; ++p) {
+    double radius = p->w * p->h;
+    double k = EffectSprites::FIREWORK_CORE / radius;
+    cairo_matrix_t matrix;
+    cairo_matrix_init_translate(&matrix, maskCenter, maskCenter);
+    cairo_matrix_scale(&matrix, k, k);
+    cairo_matrix_translate(&matrix, -p->x, -p->y);
+    cairo_pattern_set_matrix(mask, &matrix);
+    setColor(cr, p->color, p->h);
+    cairo_mask(cr, mask);
+  }
+
+  const int ALPHA_BANDS = 16;
+  for (int band = 0; band < ALPHA_BANDS; band++) {
+    bool any = false;
+    cairo_new_path(cr);
+    for (const RenderCommand *p = first; p != last; ++p) {
+      if (std::min(ALPHA_BANDS - 1, (int)(p->h * ALPHA_BANDS)) != band) continue;
+      cairo_new_sub_path(cr);
+      cairo_arc(cr, p->x, p->y, p->w * p->h * 0.3, 0, 2 * M_PI);
+      any = true;
+    }
+    if (any) {
+      cairo_set_source_rgba(cr, 1.0, 1.0, 1.0, (band + 0.5) / ALPHA_BANDS * 0.8);
+      cairo_fill(cr);
+    }
+  }
+}
+
+void executeCommands(cairo_t *cr, const RenderCommandList &list, int firstLayer, int lastLayer) {
+  executeCommands(cr, list, blockAtlas, effectSprites, textCache, firstLayer, lastLayer);
+}
+
+void executeCommands(cairo_t *cr, const RenderCommandList &list, BlockAtlas &atlas,
+                     EffectSprites &sprites, TextCache &text, int firstLayer, int lastLayer) {
+  Profiler::Scope scope("executeCommands");
+  if (list.blockSize <= 0) {
+    return;
+  }
+  cairo_save(cr);
+
+  // Clips apply whatever layers are drawn
+  for (const RenderCommand &command : list.commands) {
+    if (command.kind == RenderCommand::CLIP) {
+      cairo_rectangle(cr, command.x, command.y, command.w, command.h);
+      cairo_clip(cr);
+    }
+  }
+  double clipX0, clipY0, clipX1, clipY1;
+  cairo_clip_extents(cr, &clipX0, &clipY0, &clipX1, &clipY1);
+
+  bool atlasReady = false;
+  const QualityGovernor::Budget &budget = QualityGovernor::budgetFor(list.effectLevel);
+  const RenderCommand *begin = list.commands.data();
+  const RenderCommand *end = begin + list.commands.size();
+
+  for (const RenderCommand *command = begin; command != end; ++command) {
+    if (command->layer < firstLayer || command->layer > lastLayer ||
+        command->kind == RenderCommand::CLIP) {
+      continue;
+    }
+
+    // Runs of particles draw together, like drawFireworks()
+    if (command->kind == RenderCommand::PARTICLE) {
+      const RenderCommand *last = command;
+      while (last != end && last->kind == RenderCommand::PARTICLE && last->layer == command->layer) {
+        ++last;
+      }
+      executeParticles(cr, command, last, sprites);
+      command = last - 1;
+      continue;
+    }
+
+    if (command->kind != RenderCommand::TEXT) {
+      RenderCommandList::Box box = list.bounds(*command);
+      if (box.x1 < clipX0 || box.x0 > clipX1 || box.y1 < clipY0 || box.y0 > clipY1) {
+        continue;
+      }
+    }
+
+    switch (command->kind) {
+      case RenderCommand::RECT:
+        setColor(cr, command->color);
+        cairo_rectangle(cr, command->x, command->y, command->w, command->h);
+        cairo_fill(cr);
+        break;
+
+      case RenderCommand::IMAGE: {
+        cairo_surface_t *image = list.images[command->arg].get();
+        cairo_save(cr);
+        cairo_translate(cr, command->x, command->y);
+        cairo_scale(cr, command->w / cairo_image_surface_get_width(image),
+                    command->h / cairo_image_surface_get_height(image));
+        cairo_set_source_surface(cr, image, 0, 0);
+        cairo_pattern_set_filter(cairo_get_source(cr), budget.backgroundFilter);
+        cairo_paint_with_alpha(cr, (command->color & 0xff) / 255.0);
+        cairo_restore(cr);
+        break;
+      }
+
+      case RenderCommand::SPRITE:
+        if (!atlasReady) {
+          BlockAtlas::Style style;
+          style.palette = &list.palette;
+          style.blockSize = list.blockSize;
+          style.heatLevel = list.heatLevel;
+          style.retro = list.retro;
+          style.simple = list.simple;
+          atlas.prepare(cr, style);
+          atlasReady = true;
+        }
+        if (command->w == 1.0f && command->h == 1.0f) {
+          atlas.draw(cr, (BlockAtlas::Row)command->style, command->type, command->x, command->y);
+        } else {
+          atlas.drawScaled(cr, (BlockAtlas::Row)command->style, command->type, command->x,
+                           command->y, command->w, command->h);
+        }
+        break;
+
+      case RenderCommand::EFFECT:
+        if (command->style == RenderCommand::GLOW) {
+          drawFireyGlow(cr, sprites, list.blockSize, budget, command->x, command->y, command->w,
+                        list.heatLevel, list.timeMs);
+        } else {
+          drawFreezyEffect(cr, sprites, list.blockSize, budget, command->x, command->y, command->w,
+                           list.heatLevel, list.timeMs);
+        }
+        break;
+
+      case RenderCommand::TEXT: {
+        const TextCache::Entry &entry = text.get(cr, list.strings[command->arg], "Sans",
+                                                 CAIRO_FONT_WEIGHT_BOLD, command->w);
+        double x = command->x;
+        if (command->style == RenderCommand::TEXT_CENTRED) {
+          x -= entry.extents.width / 2;
+        }
+        setColor(cr, command->color);
+        TextCache::show(cr, entry, x, command->y);
+        break;
+      }
+    }
+  }
+
+  cairo_restore(cr);
+}
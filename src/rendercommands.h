@@ -0,0 +1,243 @@
+#ifndef RENDERCOMMANDS_H
+#define RENDERCOMMANDS_H
+
+#include <cairo/cairo.h>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "palette.h"
+
+class TetrimoneBoard;
+class BlockAtlas;
+class EffectSprites;
+class TextCache;
+class FireworkPool;
+class TrailPool;
+class RecordingImages;
+
+/**
+ * One drawing operation of a frame, in user units of the game area.
+ *
+ * Commands are plain data with no padding, so frames compare and record
+ * byte for byte. What the fields mean depends on the kind:
+ *
+ *   CLIP      x, y, w, h: area the whole list draws inside
+ *   RECT      x, y, w, h: filled in color
+ *   SPRITE    x, y: top-left of a block sprite (style is the BlockAtlas row)
+ *             w: scale, h: alpha
+ *   EFFECT    x, y, w: block position and size (style is GLOW or FROST)
+ *   TEXT      x, y: origin, or baseline centre if style is TEXT_CENTRED
+ *             w: font size, arg: string index, color
+ *   PARTICLE  x, y: centre, w: radius at full life, h: life, color
+ *   IMAGE     x, y, w, h: where the image is drawn, arg: index into the
+ *             list's images, color: opacity in the alpha byte
+ */
+struct RenderCommand {
+    enum Kind : uint8_t { CLIP, RECT, SPRITE, EFFECT, TEXT, PARTICLE, IMAGE };
+
+    // Painter's order, the same as the game area's draw calls. Within a
+    // layer commands draw in the order they were added, so a block's glow
+    // stays under the blocks drawn after it.
+    enum Layer : uint8_t {
+        LAYER_BACKGROUND,   // Background fill and image, grid and failure lines
+        LAYER_BOARD,        // Locked blocks and their heat effects
+        LAYER_PIECE,        // Falling piece and ghost
+        LAYER_OVERLAY,      // Pause and game over screens
+        LAYER_PARTICLES,    // Fireworks
+        LAYER_TRAILS,       // Block trails
+        LAYER_COUNT
+    };
+
+    enum Style : uint8_t { GLOW = 0, FROST = 1, TEXT_LEFT = 0, TEXT_CENTRED = 1 };
+
+    uint8_t layer;
+    uint8_t kind;
+    uint8_t style;
+    uint8_t type;           // SPRITE: block type
+    uint32_t color;         // 0xRRGGBBAA
+    uint32_t arg;
+    float x, y, w, h;
+
+    /** Sort key: the layer alone, as commands in a layer may overlap */
+    uint32_t key() const { return layer; }
+
+    /** What a command draws with: kind, then effect style or atlas row and block type */
+    uint32_t state() const { return ((uint32_t)kind << 16) | ((uint32_t)style << 8) | type; }
+};
+
+/**
+ * A game area frame as a flat command list.
+ *
+ * buildFrameCommands() walks the board once and describes what the
+ * frame shows; an executor turns the list into pixels. Because the list
+ * is data, it can be sorted into layers with commands that share drawing
+ * state batched together, compared with the previous frame to find what
+ * changed, and written to a file to replay the same frames offline.
+ *
+ * The list carries what the sprites are drawn with (palette, block
+ * size, heat and style), so an executor with its own atlas, e.g. on
+ * another thread, never reads the board.
+ */
+class RenderCommandList {
+public:
+    // Area covered by commands, in user units; empty when x1 <= x0
+    struct Box {
+        double x0 = 0.0, y0 = 0.0, x1 = 0.0, y1 = 0.0;
+        bool empty() const { return x1 <= x0 || y1 <= y0; }
+        bool overlaps(const Box &other) const {
+            return x0 < other.x1 && other.x0 < x1 && y0 < other.y1 && other.y0 < y1;
+        }
+        void add(double ax0, double ay0, double ax1, double ay1);
+    };
+
+    // What the frame is drawn with
+    int width = 0, height = 0;      // Game area size
+    int blockSize = 0;
+    ThemePalette palette;
+    float heatLevel = 0.5f;
+    double timeMs = 0.0;            // Effect animation clock
+    bool retro = false;
+    bool simple = false;
+    int effectLevel = 0;            // QualityGovernor level for the effects
+
+    std::vector<RenderCommand> commands;
+    std::vector<std::string> strings;
+    std::vector<std::shared_ptr<cairo_surface_t>> images;  // Holds a reference to each
+
+    /** Drop the commands, strings and images, keeping their storage */
+    void clear();
+
+    void clip(double x, double y, double w, double h);
+    void rect(int layer, double x, double y, double w, double h, uint32_t color);
+    void sprite(int layer, int row, int type, double x, double y, double scale, double alpha);
+    void effect(int style, double x, double y, double size);
+    void text(int layer, const std::string &text, double x, double y, double size,
+              uint32_t color, bool centred);
+    void particle(double x, double y, double radius, double life, uint32_t color);
+
+    /**
+     * Draw a 32-bit image surface over the whole area, scaled to cover it
+     * and centred, as drawBackground() does
+     */
+    void image(cairo_surface_t *surface, double opacity);
+
+    /**
+     * Stable sort by RenderCommand::key(), then move each command back to
+     * the last one in its layer with the same state() when nothing drawn
+     * in between overlaps it. The pixels are those of painter's order:
+     * only commands that do not overlap change places.
+     */
+    void sort();
+
+    /** True if both lists would draw the same pixels */
+    bool sameAs(const RenderCommandList &other) const;
+
+    /**
+     * Area that differs from previous (both lists sorted). Empty if the
+     * frames match; the whole game area if anything besides the commands
+     * changed or a text command did, as text has no bounds without a font.
+     */
+    Box changedArea(const RenderCommandList &previous) const;
+
+    /** Where a command draws, in user units */
+    Box bounds(const RenderCommand &command) const;
+
+    /**
+     * Append the list to a recording. Recordings are for the build that
+     * wrote them: the palette is stored as it is laid out in memory.
+     * @param stored Images already in the recording; new ones are added
+     */
+    void write(std::ostream &out, RecordingImages &stored) const;
+
+    /**
+     * Read the next list from a recording; false at the end or on a bad file
+     * @param stored Images read so far from the same recording
+     */
+    bool read(std::istream &in, RecordingImages &stored);
+
+    static uint32_t packColor(double r, double g, double b, double a);
+
+private:
+    RenderCommand make(int layer, int kind, int style, int type) const;
+};
+
+/**
+ * The images of one recording. Each image's pixels are stored with the
+ * first list that uses it, and later lists refer to it by number, so a
+ * background costs its pixels once rather than once per frame.
+ */
+class RecordingImages {
+public:
+    void clear() { images.clear(); }
+
+private:
+    friend class RenderCommandList;
+    std::vector<std::shared_ptr<cairo_surface_t>> images;  // By number
+};
+
+/**
+ * Records the game area while it is played, for replay_export to turn
+ * into video. Each frame that would draw differently from the one before
+ * is appended with RenderCommandList::write(); the lists' timeMs say
+ * when each was shown. The GTK and kiosk frontends feed it (--record).
+ */
+class FrameRecorder {
+public:
+    ~FrameRecorder() { close(); }
+
+    /** Start a new recording, replacing the file */
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const { return file.is_open(); }
+
+    /** Append a frame unless it matches the last one; no-op when closed */
+    void add(const RenderCommandList &list);
+
+private:
+    std::ofstream file;
+    std::string path;
+    RecordingImages images;
+    RenderCommandList last;
+    bool haveLast = false;
+};
+
+extern FrameRecorder frameRecorder;
+
+/**
+ * Describe the game area's layers for this frame: background, grid and
+ * failure lines, locked blocks with line clear animations and heat
+ * effects, the falling piece and ghost, pause and game over screens,
+ * fireworks and trails. The splash and propaganda panels are cached
+ * images and stay with their draw functions.
+ * @param board Board to describe
+ * @param list Cleared and refilled, then sorted
+ */
+void buildFrameCommands(TetrimoneBoard *board, RenderCommandList &list);
+
+/**
+ * Append particle commands for a firework pool, or sprite commands for
+ * block trails, to a list whose blockSize is set. buildFrameCommands()
+ * uses these for the board's own pools; the list needs sort() after.
+ */
+void buildFireworkCommands(const FireworkPool &particles, RenderCommandList &list);
+void buildTrailCommands(const TrailPool &trails, RenderCommandList &list);
+
+/**
+ * Draw a list's layers firstLayer to lastLayer with Cairo. Commands
+ * outside the current clip are skipped.
+ */
+void executeCommands(cairo_t *cr, const RenderCommandList &list,
+                     int firstLayer = 0, int lastLayer = RenderCommand::LAYER_COUNT - 1);
+
+/**
+ * Same, with the caller's sprite and text caches, so threads that draw
+ * lists at the same time never share them.
+ */
+void executeCommands(cairo_t *cr, const RenderCommandList &list, BlockAtlas &atlas,
+                     EffectSprites &sprites, TextCache &text, int firstLayer, int lastLayer);
+
+#endif // RENDERCOMMANDS_H
@@ -0,0 +1,335 @@
+// ============================================================================
+// replay_export: render a recorded game to PNG frames or a Y4M stream
+//
+// Usage: replay_export RECORDING (--png DIR | --y4m) [--fps N] [--threads N]
+//                      [--scale F] [--start SEC] [--duration SEC]
+//
+// RECORDING comes from the game's --record option: the game area's
+// command lists, one per frame that changed, each stamped with when it
+// was shown. The exporter samples them at a fixed frame rate and draws
+// the frames on a thread pool, each worker with its own image surface and
+// sprite, effect and text caches. Frames that repeat a recorded frame
+// are drawn once. --png writes DIR/frame_000000.png and on; --y4m writes
+// raw 4:2:0 video to stdout for an encoder:
+//
+//   replay_export game.rec --y4m | ffmpeg -i - -c:v libx264 game.mp4
+//
+// The background image and grid lines are in the recording; the splash
+// and propaganda panels are not, so frames show the board without them.
+// ============================================================================
+
+#include "tetrimone_core.h"
+#include "rendercommands.h"
+#include "blockatlas.h"
+#include "effectsprites.h"
+#include "textcache.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const int SHOTS_PER_WORKER = 4;     // Shots handed to the pool at once, per worker
+static const double HOLD_LAST_MS = 2000.0;  // The final frame (game over) stays this long
+
+// One recorded frame and the run of output frames that show it
+struct Shot {
+    RenderCommandList list;
+    int firstFrame = 0;
+    int frameCount = 0;
+    std::vector<uint8_t> yuv;   // --y4m only
+    bool ok = true;
+};
+
+struct Worker {
+    cairo_surface_t *surface = nullptr;
+    cairo_t *cr = nullptr;
+    BlockAtlas atlas;
+    EffectSprites sprites;
+    TextCache text;
+
+    ~Worker() {
+        if (cr) cairo_destroy(cr);
+        if (surface) cairo_surface_destroy(surface);
+    }
+};
+
+struct ExportOptions {
+    std::string recording, pngDir;
+    bool y4m = false;
+    int fps = 60;
+    int threads = 0;
+    double scale = 1.0;
+    double startSec = 0.0;
+    double durationSec = -1.0;  // Negative: to the end
+};
+
+// Reads a recording one list at a time, holding the list on screen at a
+// given moment
+class RecordingReader {
+public:
+    explicit RecordingReader(const std::string &path) : file(path, std::ios::binary) {
+        havePending = file.is_open() && pending.read(file, images);
+    }
+
+    bool isOpen() const { return file.is_open(); }
+    bool empty() const { return !havePending && !haveCurrent; }
+
+    /** Time of the next list; before the first seek(), the recording's start */
+    double nextMs() const { return pending.timeMs; }
+
+    /**
+     * Move to the list shown at timeMs.
+     * @return true if that is a different list from the last call's
+     */
+    bool seek(double timeMs) {
+        bool moved = false;
+        while (havePending && (!haveCurrent || pending.timeMs <= timeMs)) {
+            std::swap(current, pending);
+            haveCurrent = true;
+            havePending = pending.read(file, images);
+            moved = true;
+        }
+        return moved;
+    }
+
+    /** True once timeMs is HOLD_LAST_MS past the last list */
+    bool finished(double timeMs) const {
+        return !havePending && timeMs > current.timeMs + HOLD_LAST_MS;
+    }
+
+    const RenderCommandList &shown() const { return current; }
+
+private:
+    std::ifstream file;
+    RecordingImages images;
+    RenderCommandList current, pending;
+    bool haveCurrent = false, havePending = false;
+};
+
+static std::string framePath(const std::string &dir, int frame) {
+    char name[32];
+    snprintf(name, sizeof(name), "frame_%06d.png", frame);
+    return dir + "/" + name;
+}
+
+static bool copyFile(const std::string &from, const std::string &to) {
+    std::ifstream in(from, std::ios::binary);
+    std::ofstream out(to, std::ios::binary | std::ios::trunc);
+    out << in.rdbuf();
+    return in.good() && out.good();
+}
+
+// Full-range BT.601, as the C420jpeg tag promises; chroma averages 2x2 pixels
+static void convertToYuv(cairo_surface_t *surface, std::vector<uint8_t> &yuv) {
+    int width = cairo_image_surface_get_width(surface);
+    int height = cairo_image_surface_get_height(surface);
+    int stride = cairo_image_surface_get_stride(surface);
+    const unsigned char *data = cairo_image_surface_get_data(surface);
+
+    yuv.resize((size_t)width * height * 3 / 2);
+    uint8_t *planeY = yuv.data();
+    uint8_t *planeU = planeY + width * height;
+    uint8_t *planeV = planeU + (width / 2) * (height / 2);
+
+    for (int y = 0; y < height; ++y) {
+        const uint32_t *row = reinterpret_cast<const uint32_t *>(data + y * stride);
+        for (int x = 0; x < width; ++x) {
+            int r = (row[x] >> 16) & 0xff, g = (row[x] >> 8) & 0xff, b = row[x] & 0xff;
+            planeY[y * width + x] = (uint8_t)((77 * r + 150 * g + 29 * b + 128) >> 8);
+        }
+    }
+
+    for (int y = 0; y < height / 2; ++y) {
+        const uint32_t *row0 = reinterpret_cast<const uint32_t *>(data + 2 * y * stride);
+        const uint32_t *row1 = reinterpret_cast<const uint32_t *>(data + (2 * y + 1) * stride);
+        for (int x = 0; x < width / 2; ++x) {
+            uint32_t p[4] = {row0[2 * x], row0[2 * x + 1], row1[2 * x], row1[2 * x + 1]};
+            int r = 0, g = 0, b = 0;
+            for (uint32_t pixel : p) {
+                r += (pixel >> 16) & 0xff;
+                g += (pixel >> 8) & 0xff;
+                b += pixel & 0xff;
+            }
+            r = (r + 2) / 4;
+            g = (g + 2) / 4;
+            b = (b + 2) / 4;
+            int u = ((-43 * r - 85 * g + 128 * b + 128) >> 8) + 128;
+            int v = ((128 * r - 107 * g - 21 * b + 128) >> 8) + 128;
+            planeU[y * (width / 2) + x] = (uint8_t)std::max(0, std::min(255, u));
+            planeV[y * (width / 2) + x] = (uint8_t)std::max(0, std::min(255, v));
+        }
+    }
+}
+
+// Draw one shot, then write its PNG frames or convert it for the stream
+static void renderShot(Shot &shot, Worker &worker, const ExportOptions &options) {
+    const RenderCommandList &list = shot.list;
+    cairo_t *cr = worker.cr;
+
+    // The background layer covers the whole frame, so nothing is cleared
+    cairo_save(cr);
+    cairo_scale(cr, options.scale, options.scale);
+    executeCommands(cr, list, worker.atlas, worker.sprites, worker.text, 0,
+                    RenderCommand::LAYER_COUNT - 1);
+    cairo_restore(cr);
+    cairo_surface_flush(worker.surface);
+
+    if (options.y4m) {
+        convertToYuv(worker.surface, shot.yuv);
+        return;
+    }
+
+    // Encode once; repeats of the frame are file copies
+    std::string first = framePath(options.pngDir, shot.firstFrame);
+    shot.ok = cairo_surface_write_to_png(worker.surface, first.c_str()) == CAIRO_STATUS_SUCCESS;
+    for (int i = 1; shot.ok && i < shot.frameCount; ++i) {
+        shot.ok = copyFile(first, framePath(options.pngDir, shot.firstFrame + i));
+    }
+    if (!shot.ok) {
+        std::cerr << "Failed to write frame " << first << std::endl;
+    }
+}
+
+// Render a batch on the pool, then stream it in order
+static bool flushShots(std::vector<Shot> &shots, ThreadPool &pool,
+                       std::vector<std::unique_ptr<Worker>> &workers, const ExportOptions &options) {
+    pool.parallelFor((int)shots.size(), [&](int task, int worker) {
+        renderShot(shots[task], *workers[worker], options);
+    });
+
+    bool ok = true;
+    for (Shot &shot : shots) {
+        ok = ok && shot.ok;
+        for (int i = 0; ok && options.y4m && i < shot.frameCount; ++i) {
+            ok = fputs("FRAME\n", stdout) >= 0 &&
+                 fwrite(shot.yuv.data(), 1, shot.yuv.size(), stdout) == shot.yuv.size();
+        }
+    }
+    if (!ok && options.y4m) {
+        std::cerr << "Failed to write the video stream" << std::endl;
+    }
+    shots.clear();
+    return ok;
+}
+
+static void printUsage(const char *program) {
+    std::cerr << "Usage: " << program << " RECORDING (--png DIR | --y4m) [options]\n"
+              << "  --png DIR        Write DIR/frame_000000.png and on\n"
+              << "  --y4m            Write a Y4M stream to stdout\n"
+              << "  --fps N          Frame rate (default 60)\n"
+              << "  --threads N      Render threads (default: all cores)\n"
+              << "  --scale F        Output size relative to the recorded game area (default 1)\n"
+              << "  --start SEC      Skip the first SEC seconds\n"
+              << "  --duration SEC   Stop after SEC seconds\n"
+              << "Record a game with the GTK or kiosk build's --record FILE option." << std::endl;
+}
+
+static bool parseOptions(int argc, char *argv[], ExportOptions &options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--png" && hasValue) {
+            options.pngDir = argv[++i];
+        } else if (arg == "--y4m") {
+            options.y4m = true;
+        } else if (arg == "--fps" && hasValue) {
+            options.fps = std::max(1, std::min(240, std::atoi(argv[++i])));
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--scale" && hasValue) {
+            options.scale = std::max(0.25, std::min(8.0, std::atof(argv[++i])));
+        } else if (arg == "--start" && hasValue) {
+            options.startSec = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--duration" && hasValue) {
+            options.durationSec = std::atof(argv[++i]);
+        } else if (arg[0] != '-' && options.recording.empty()) {
+            options.recording = arg;
+        } else {
+            return false;
+        }
+    }
+    return !options.recording.empty() && (options.y4m != !options.pngDir.empty());
+}
+
+int main(int argc, char *argv[]) {
+    ExportOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    RecordingReader reader(options.recording);
+    if (!reader.isOpen() || reader.empty()) {
+        std::cerr << "Cannot read a recording from " << options.recording << std::endl;
+        return 1;
+    }
+
+    // The frame size follows the first recorded frame; 4:2:0 needs it even
+    double recordingStartMs = reader.nextMs();
+    reader.seek(recordingStartMs);
+    const RenderCommandList &first = reader.shown();
+    int width = ((int)ceil(first.width * options.scale) + 1) & ~1;
+    int height = ((int)ceil(first.height * options.scale) + 1) & ~1;
+
+    if (options.threads <= 0) {
+        int cores = (int)std::thread::hardware_concurrency();
+        options.threads = cores > 0 ? cores : 1;
+    }
+    ThreadPool pool(options.threads);
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < pool.size(); ++i) {
+        std::unique_ptr<Worker> worker(new Worker());
+        worker->surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, width, height);
+        worker->cr = cairo_create(worker->surface);
+        workers.push_back(std::move(worker));
+    }
+
+    if (options.y4m) {
+        fprintf(stdout, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, options.fps);
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    double originMs = recordingStartMs + options.startSec * 1000.0;
+    double endMs = options.durationSec < 0.0 ? -1.0 : originMs + options.durationSec * 1000.0;
+    size_t batch = (size_t)(pool.size() * SHOTS_PER_WORKER);
+    std::vector<Shot> shots;
+    int frames = 0, unique = 0;
+    bool ok = true;
+
+    for (;;) {
+        double timeMs = originMs + frames * 1000.0 / options.fps;
+        if (reader.finished(timeMs) || (endMs >= 0.0 && timeMs >= endMs)) {
+            break;
+        }
+
+        // A frame that shows the same list as the one before extends its shot
+        if (reader.seek(timeMs) || shots.empty()) {
+            if (shots.size() == batch && !(ok = flushShots(shots, pool, workers, options))) {
+                break;
+            }
+            shots.emplace_back();
+            shots.back().list = reader.shown();
+            shots.back().firstFrame = frames;
+            unique++;
+        }
+        shots.back().frameCount++;
+        frames++;
+    }
+    if (ok && !shots.empty()) {
+        ok = flushShots(shots, pool, workers, options);
+    }
+    fflush(stdout);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::cerr << "Exported " << frames << " frames (" << unique << " drawn) at " << width << "x"
+              << height << " in " << seconds << " s with " << pool.size() << " threads" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -9,6 +9,10 @@
 #include "tetrimone_qt5.h"
 #endif
 
+#ifdef KIOSK
+#include "tetrimone_kiosk.h"
+#endif
+
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -244,6 +248,11 @@ bool saveGameSettings(TetrimoneApp* app) {
         // Visual theme settings
         settings.set("currentThemeIndex", currentThemeIndex);
         
+        // Effect quality settings
+        settings.set("effectQuality", qualityGovernor.getOverride());
+        settings.set("targetFps", qualityGovernor.getTargetFps());
+        settings.set("showQualityIndicator", qualityGovernor.isIndicatorShown());
+        
         // Write to file
         std::string settingsJson = settings.toString();
         std::ofstream file(getSettingsFilePath());
@@ -410,6 +419,7 @@ if (useBackgroundZip && !bgZipPath.empty()) {
         for (int i = 0; i < std::min(5, static_cast<int>(enabledTracks.size())); i++) {
             app->board->enabledTracks[i] = enabledTracks[i];
         }
+        app->board->publishState();
         
         // Apply advanced settings
         app->board->junkLinesPercentage = extractInt("junkLinesPercentage", 0);
@@ -433,6 +443,11 @@ if (useBackgroundZip && !bgZipPath.empty()) {
         // Apply visual theme settings
         currentThemeIndex = extractInt("currentThemeIndex", 0);
         
+        // Apply effect quality settings
+        qualityGovernor.setTargetFps(extractInt("targetFps", 60));
+        qualityGovernor.setOverride(extractInt("effectQuality", QualityGovernor::AUTO));
+        qualityGovernor.setShowIndicator(extractBool("showQualityIndicator", false));
+        
         // Update UI to reflect loaded settings
         updateLabels(app);
         
@@ -482,6 +497,7 @@ void resetGameSettings(TetrimoneApp* app) {
     for (int i = 0; i < 5; i++) {
         app->board->enabledTracks[i] = true;
     }
+    app->board->publishState();
     
     // Advanced settings
     app->board->junkLinesPercentage = 0;
@@ -502,6 +518,11 @@ void resetGameSettings(TetrimoneApp* app) {
     // Visual theme settings
     currentThemeIndex = 0;
     
+    // Effect quality settings
+    qualityGovernor.setTargetFps(60);
+    qualityGovernor.setOverride(QualityGovernor::AUTO);
+    qualityGovernor.setShowIndicator(false);
+    
     // Update UI to reflect reset settings
     updateLabels(app);
     
@@ -575,6 +596,7 @@ void onResetSettings(GtkMenuItem* menuItem, gpointer userData) {
         for (int i = 0; i < 5; i++) {
             app->board->enabledTracks[i] = true;
         }
+        app->board->publishState();
         
         // Advanced settings
         app->board->junkLinesPercentage = 0;
@@ -595,6 +617,11 @@ void onResetSettings(GtkMenuItem* menuItem, gpointer userData) {
         // Visual theme settings
         currentThemeIndex = 0;
         
+        // Effect quality settings
+        qualityGovernor.setTargetFps(60);
+        qualityGovernor.setOverride(QualityGovernor::AUTO);
+        qualityGovernor.setShowIndicator(false);
+        
         // Update UI to reflect reset settings
         
         // Update menu checkboxes to match reset settings
@@ -7,6 +7,10 @@
 #include "tetrimone_qt5.h"
 #endif
 
+#ifdef KIOSK
+#include "tetrimone_kiosk.h"
+#endif
+
 
 #include <algorithm>
 #include <cctype> // Added for std::tolower
@@ -173,12 +177,14 @@ bool TetrimoneBoard::initializeAudio() {
                 << std::endl;
       AudioManager::getInstance().shutdown();
       sound_enabled_ = false;
+      publishState();
       return false;
     }
   } else {
     std::cerr << "Failed to initialize audio system. Sound will be disabled."
               << std::endl;
     sound_enabled_ = false;
+    publishState();
     return false;
   }
 }
@@ -428,6 +434,7 @@ bool TetrimoneBoard::loadSoundFromZip(GameSoundEvent event, const std::string& s
 
 void TetrimoneBoard::playBackgroundMusic() {
   log_to_file("playBackgroundMusic called");
+  publishState();
   
   if (!sound_enabled_) {
     return;
@@ -475,12 +482,15 @@ void TetrimoneBoard::playBackgroundMusic() {
       AudioManager& audioManager = AudioManager::getInstance();
       size_t currentTrackIndex = 0;
 
+      // Settings are read from the published state, never from the board
+      AudioState audio = statePublisher.latestAudio();
+
       // Check if we need to skip the current track because it's disabled
-      while (!enabledTracks[currentTrackIndex]) {
+      while (!audio.trackEnabled(currentTrackIndex)) {
         // If all tracks are disabled, just use the first one
         bool allDisabled = true;
         for (int i = 0; i < 5; i++) {
-          if (enabledTracks[i]) {
+          if (audio.trackEnabled(i)) {
             allDisabled = false;
             break;
           }
@@ -556,19 +566,23 @@ void TetrimoneBoard::playBackgroundMusic() {
         return 120; // Default fallback duration
       };
       
-      while (sound_enabled_ && !musicStopFlag.load()) {
+      while (!musicStopFlag.load()) {
+        audio = statePublisher.latestAudio();
+        if (!audio.soundEnabled) {
+          break;
+        }
         SoundEvent audioEvent;
 
-        if (this->patrioticModeActive) {
+        if (audio.patrioticMusic) {
             audioEvent = backgroundMusicTracksPatriotic[currentTrackIndex];
         } 
-        else if (this->retroModeActive || this->retroMusicActive) {
+        else if (audio.retroMusic) {
             audioEvent = backgroundMusicTracksRetro[currentTrackIndex];
         } 
         else {
             audioEvent = backgroundMusicTracks[currentTrackIndex];
         }
-        if (!audioManager.isMuted() && !musicPaused) {
+        if (!audioManager.isMuted() && !audio.musicPaused) {
           try {
             // Calculate the duration of this track
             int trackDuration = calculateWavDuration(audioEvent);
@@ -579,9 +593,10 @@ void TetrimoneBoard::playBackgroundMusic() {
             
             // Wait for the track to finish or pause to occur
             int elapsedSeconds = 0;
-            while (elapsedSeconds < trackDuration && sound_enabled_ && !musicStopFlag.load() && !musicPaused) {
+            while (elapsedSeconds < trackDuration && audio.soundEnabled && !musicStopFlag.load() && !audio.musicPaused) {
+              audio = statePublisher.latestAudio();
               // Only increment timer if not paused
-              if (!musicPaused) {
+              if (!audio.musicPaused) {
                 std::this_thread::sleep_for(std::chrono::seconds(1));
                 elapsedSeconds++;
               } else {
@@ -591,14 +606,14 @@ void TetrimoneBoard::playBackgroundMusic() {
             }
             
             // Only move to next track if we completed normally
-            if ((elapsedSeconds >= trackDuration || musicPaused) && sound_enabled_ && !musicStopFlag.load()) {
+            if ((elapsedSeconds >= trackDuration || audio.musicPaused) && audio.soundEnabled && !musicStopFlag.load()) {
               // Find the next enabled track
               size_t nextTrackIndex = (currentTrackIndex + 1) % backgroundMusicTracks.size();
               
               // Check if all tracks are disabled
               bool allDisabled = true;
               for (int i = 0; i < 5; i++) {
-                if (enabledTracks[i]) {
+                if (audio.trackEnabled(i)) {
                   allDisabled = false;
                   break;
                 }
@@ -606,7 +621,7 @@ void TetrimoneBoard::playBackgroundMusic() {
               
               if (!allDisabled) {
                 // Skip disabled tracks
-                while (!enabledTracks[nextTrackIndex]) {
+                while (!audio.trackEnabled(nextTrackIndex)) {
                   nextTrackIndex = (nextTrackIndex + 1) % backgroundMusicTracks.size();
                   // If we looped back to the current track, break to avoid infinite loop
                   if (nextTrackIndex == currentTrackIndex) {
@@ -632,21 +647,26 @@ void TetrimoneBoard::playBackgroundMusic() {
       }
       #else
       // Original implementation for non-Windows platforms with track skipping
-      while (sound_enabled_ && !musicStopFlag.load()) {
+      while (!musicStopFlag.load()) {
+        audio = statePublisher.latestAudio();
+        if (!audio.soundEnabled) {
+          break;
+        }
         SoundEvent audioEvent;
-        if (this->patrioticModeActive) {
+        if (audio.patrioticMusic) {
             audioEvent = backgroundMusicTracksPatriotic[currentTrackIndex];
         } 
-        else if (this->retroModeActive || this->retroMusicActive) {
+        else if (audio.retroMusic) {
             audioEvent = backgroundMusicTracksRetro[currentTrackIndex];
         } 
         else {
             audioEvent = backgroundMusicTracks[currentTrackIndex];
         }
-        if (!audioManager.isMuted() && !musicPaused) {
+        if (!audioManager.isMuted() && !audio.musicPaused) {
           try {
             audioManager.playSoundAndWait(audioEvent);
             std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            audio = statePublisher.latestAudio();
             
             // Find the next enabled track
             size_t nextTrackIndex = (currentTrackIndex + 1) % backgroundMusicTracks.size();
@@ -654,7 +674,7 @@ void TetrimoneBoard::playBackgroundMusic() {
             // Check if all tracks are disabled
             bool allDisabled = true;
             for (int i = 0; i < 5; i++) {
-              if (enabledTracks[i]) {
+              if (audio.trackEnabled(i)) {
                 allDisabled = false;
                 break;
               }
@@ -662,7 +682,7 @@ void TetrimoneBoard::playBackgroundMusic() {
             
             if (!allDisabled) {
               // Skip disabled tracks
-              while (!enabledTracks[nextTrackIndex]) {
+              while (!audio.trackEnabled(nextTrackIndex)) {
                 nextTrackIndex = (nextTrackIndex + 1) % backgroundMusicTracks.size();
                 // If we looped back to the current track, break to avoid infinite loop
                 if (nextTrackIndex == currentTrackIndex) {
@@ -697,12 +717,14 @@ void TetrimoneBoard::pauseBackgroundMusic() {
   if (!sound_enabled_) {
     log_to_file("sound not enabled, stopping music thread");
     musicStopFlag = true;
+    publishState();
     AudioManager::getInstance().setMuted(true);
     return;
   }
 
   log_to_file("Setting musicPaused to true and muting audio");
   musicPaused = true;
+  publishState();
   AudioManager::getInstance().setMuted(true);
 }
 
@@ -814,6 +836,7 @@ void TetrimoneBoard::cleanupAudio() {
   log_to_file("Setting musicStopFlag and musicPaused");
   musicStopFlag = true;
   musicPaused = true;
+  publishState();
     
   log_to_file("Waiting for background music thread to exit");
   std::this_thread::sleep_for(std::chrono::milliseconds(200));
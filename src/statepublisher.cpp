@@ -0,0 +1,57 @@
+// ============================================================================
+// Game state publishing for renderer and music threads (Framework-Agnostic)
+// ============================================================================
+
+#include "tetrimone_core.h"
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<PublishedState>::value,
+              "PublishedState must stay trivially copyable");
+
+uint32_t AudioState::pack() const {
+  return (uint32_t)enabledTracks | (soundEnabled ? 1u << 8 : 0) | (musicPaused ? 1u << 9 : 0) |
+         (retroMusic ? 1u << 10 : 0) | (patrioticMusic ? 1u << 11 : 0);
+}
+
+AudioState AudioState::unpack(uint32_t word) {
+  AudioState state;
+  state.enabledTracks = (uint8_t)(word & 0xff);
+  state.soundEnabled = (word >> 8) & 1;
+  state.musicPaused = (word >> 9) & 1;
+  state.retroMusic = (word >> 10) & 1;
+  state.patrioticMusic = (word >> 11) & 1;
+  return state;
+}
+
+GameStatePublisher::GameStatePublisher() : audio(AudioState().pack()), serial(0) {}
+
+void GameStatePublisher::publish(const TetrimoneBoard &board) {
+  PublishedState &out = states.writeSlot();
+  out.serial = ++serial;
+  board.saveSnapshot(out.game);
+  out.ghostY = board.isGhostPieceEnabled() ? (int8_t)board.getGhostPieceY() : -1;
+  out.paused = board.isPaused();
+  out.splash = board.isSplashScreenActive();
+  out.retroMode = board.retroModeActive;
+  out.patrioticMode = board.patrioticModeActive;
+
+  AudioState &sound = out.audio;
+  sound.soundEnabled = board.sound_enabled_;
+  sound.musicPaused = board.musicPaused;
+  sound.retroMusic = board.retroModeActive || board.retroMusicActive;
+  sound.patrioticMusic = board.patrioticModeActive;
+  sound.enabledTracks = 0;
+  for (int i = 0; i < 5; ++i) {
+    if (board.enabledTracks[i]) {
+      sound.enabledTracks |= (uint8_t)(1u << i);
+    }
+  }
+
+  audio.store(sound.pack(), std::memory_order_release);
+  states.publish();
+}
+
+const PublishedState &GameStatePublisher::latest() {
+  states.refresh();
+  return states.read();
+}
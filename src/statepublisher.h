@@ -0,0 +1,76 @@
+#ifndef STATEPUBLISHER_H
+#define STATEPUBLISHER_H
+
+#include <atomic>
+#include <cstdint>
+#include "triplebuffer.h"
+
+// Included from tetrimone_core.h once GameSnapshot is defined
+class TetrimoneBoard;
+
+/**
+ * The settings the music thread plays by, small enough to publish as a
+ * single atomic word.
+ */
+struct AudioState {
+    bool soundEnabled = true;
+    bool musicPaused = false;
+    bool retroMusic = false;            // Retro mode or the retro music option
+    bool patrioticMusic = false;
+    uint8_t enabledTracks = 0x1f;       // Bit i set if track i may play
+
+    bool trackEnabled(size_t track) const { return (enabledTracks >> track) & 1; }
+
+    uint32_t pack() const;
+    static AudioState unpack(uint32_t word);
+};
+
+/**
+ * What a renderer needs beyond the gameplay snapshot. The grid is the
+ * settled board, as saveSnapshot() leaves out rows still being cleared.
+ */
+struct PublishedState {
+    uint32_t serial;                    // Bumped by every publish
+    GameSnapshot game;
+    int8_t ghostY;                      // -1 when the ghost piece is off
+    bool paused, splash;
+    bool retroMode, patrioticMode;
+    AudioState audio;
+};
+
+/**
+ * Publishes the board's state for readers on other threads, so they
+ * never call into the board while the game thread changes it.
+ *
+ * The game thread calls publish() after each tick and each change made
+ * on its behalf (input, settings). The renderer (buildFrameCommands()
+ * and the GTK board layer) takes the latest state through a triple
+ * buffer; music threads take the audio settings from
+ * one atomic word, so an outgoing music thread that overlaps its
+ * replacement is harmless. Nobody waits for anybody.
+ */
+class GameStatePublisher {
+public:
+    GameStatePublisher();
+
+    /** Game thread: capture the board and make it the latest state */
+    void publish(const TetrimoneBoard &board);
+
+    /**
+     * Renderer thread: the latest published state. Only one thread may
+     * read it; the reference stays valid until that thread calls again.
+     */
+    const PublishedState &latest();
+
+    /** Any thread: the latest published audio settings */
+    AudioState latestAudio() const {
+        return AudioState::unpack(audio.load(std::memory_order_acquire));
+    }
+
+private:
+    TripleBuffer<PublishedState> states;
+    std::atomic<uint32_t> audio;
+    uint32_t serial;                    // Game thread only
+};
+
+#endif // STATEPUBLISHER_H
@@ -6,6 +6,11 @@
 #include "tetrimone_qt5.h"
 #endif
 
+#ifdef KIOSK
+#include "tetrimone_kiosk.h"
+#include "kiosk_timers.h"
+#endif
+
 #include "audiomanager.h"
 #include <iostream>
 #include <string>
@@ -120,6 +125,7 @@ TetrimoneBoard::TetrimoneBoard()
       isThemeTransitioning(false), oldThemeIndex(0), newThemeIndex(0),
       themeTransitionProgress(0.0), themeTransitionTimer(0) {
   rng.seed(std::chrono::system_clock::now().time_since_epoch().count());
+  pieceRng.seed(rng());
 
   showPropagandaMessage = false;
   propagandaTimerId = 0;
@@ -139,7 +145,7 @@ TetrimoneBoard::TetrimoneBoard()
   heatLevel = 0.5f;
   heatDecayTimer = 0;
   minBlockSize = 1;
-  grid.resize(MAX_GRID_HEIGHT, std::vector<int>(MAX_GRID_WIDTH, 0));
+  grid.resize(MAX_GRID_HEIGHT, MAX_GRID_WIDTH);
   
   // Initialize currentPiece first to ensure it's never null
   currentPiece = std::make_unique<TetrimoneBlock>(0);
@@ -157,9 +163,11 @@ TetrimoneBoard::TetrimoneBoard()
   for (int i = 0; i < 5; i++) {
     enabledTracks[i] = true;
   }
+  publishState();
 }
 
 void TetrimoneBoard::updateGame() {
+  Profiler::Scope scope("updateGame");
   if (gameOver || paused || splashScreenActive)
     return;
 
@@ -192,12 +200,12 @@ void TetrimoneBoard::hardDrop() {
 }
 
 void TetrimoneBoard::restart() {
+  ++gameSerial;
+
   // Clear the grid
-  for (auto &row : grid) {
-    std::fill(row.begin(), row.end(), 0);
-  }
+  grid.clear();
   heatLevel = 0.5f;
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
   heatDecayTimer = 0;
 #endif
 #ifdef QT5
@@ -225,7 +233,15 @@ void TetrimoneBoard::restart() {
     generateJunkLines(junkLinesPercentage);
   }
 
-  // Generate new pieces
+  consecutiveClears = 0;
+  maxConsecutiveClears = 0;
+  lastClearCount = 0;
+  sequenceActive = false;
+  highScoreAlreadyProcessed = false;
+
+  // Start the undo history from the fresh board; spawning the first piece
+  // records its one undo point
+  undoHistory.clear();
   generateNewPiece();
 
   // Select a random background if using background images from ZIP
@@ -233,12 +249,6 @@ void TetrimoneBoard::restart() {
     // Just select a random background without transitioning at game start
     selectRandomBackground();
   }
-
-  consecutiveClears = 0;
-  maxConsecutiveClears = 0;
-  lastClearCount = 0;
-  sequenceActive = false;
-  highScoreAlreadyProcessed = false;
 }
 
 TetrimoneBoard::~TetrimoneBoard() {
@@ -246,7 +256,7 @@ TetrimoneBoard::~TetrimoneBoard() {
     cancelBackgroundTransition();
 
     // Cancel propaganda message timers
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
     if (propagandaTimerId > 0) {
         g_source_remove(propagandaTimerId);
         propagandaTimerId = 0;
@@ -277,7 +287,7 @@ TetrimoneBoard::~TetrimoneBoard() {
         backgroundImage = nullptr;
     }
 
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
     if (themeTransitionTimer > 0) {
         g_source_remove(themeTransitionTimer);
         themeTransitionTimer = 0;
@@ -341,6 +351,7 @@ TetrimoneBoard::~TetrimoneBoard() {
 }
 
 int TetrimoneBoard::clearLines() {
+  Profiler::Scope scope("clearLines");
   std::vector<int> linesToClear;
   int currentLevel = (this->linesCleared / 10) + initialLevel;
   
@@ -386,7 +397,7 @@ int TetrimoneBoard::clearLines() {
       currentPropagandaMessage = message;
       showPropagandaMessage = true;
       
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
       // Cancel existing timer if any
       if (propagandaTimerId > 0) {
           g_source_remove(propagandaTimerId);
@@ -502,7 +513,7 @@ int TetrimoneBoard::clearLines() {
         currentPropagandaMessage = message;
         showPropagandaMessage = true;
         
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
         // Cancel existing timer if any
         if (propagandaTimerId > 0) {
             g_source_remove(propagandaTimerId);
@@ -694,6 +705,7 @@ bool TetrimoneBoard::movePiece(int dx, int dy) {
 }
 
 void TetrimoneBoard::lockPiece() {
+  Profiler::Scope scope("lockPiece");
   auto shape = currentPiece->getShape();
   int pieceX = currentPiece->getX();
   int pieceY = currentPiece->getY();
@@ -781,7 +793,7 @@ void TetrimoneBoard::generateNewPiece() {
     }
 
     std::uniform_int_distribution<int> dist(0, validPieces.size() - 1);
-    return validPieces[dist(rng)];
+    return validPieces[dist(pieceRng)];
   };
 
   // If queue is empty or cleared, initialize with 20 pieces
@@ -815,10 +827,15 @@ void TetrimoneBoard::generateNewPiece() {
     currentPiece = std::make_unique<TetrimoneBlock>(0);
   }
 
+  pieceSerial++;
+
   // Check if the new piece collides immediately - game over
   if (checkCollision(*currentPiece)) {
     gameOver = true;
   }
+
+  // Practice mode keeps one undo point per spawned piece
+  recordUndoPoint();
 }
 
 bool TetrimoneBoard::checkCollision(const TetrimoneBlock &piece) const {
@@ -865,28 +882,17 @@ void TetrimoneBoard::createBlockTrail() {
     if (timeSinceLastTrail < TRAIL_SPAWN_DELAY) return;
     lastTrailTime = now;
     
-    // Create a new trail segment
-    BlockTrail trail;
-    trail.x = currentPiece->getX();
-    trail.y = currentPiece->getY();
-    trail.rotation = currentPiece->getRotation();
-    trail.pieceType = currentPiece->getType();
-    trail.shape = currentPiece->getShape();
-    trail.color = currentPiece->getColor();
-    trail.maxLife = trailDuration; // Use configurable duration
-    trail.life = trail.maxLife;
-    trail.alpha = trailOpacity; // Use configurable opacity
-    
-    blockTrails.push_back(trail);
-    
-    // Remove old trails if we have too many
-    while (blockTrails.size() > maxTrailSegments) {
-        blockTrails.erase(blockTrails.begin());
-    }
+    // Create a new trail segment; the pool drops the oldest beyond the segment limit,
+    // which the effect budget may lower on slow machines
+    int segments = std::min(maxTrailSegments, qualityGovernor.budget().trailSegments);
+    auto color = currentPiece->getColor();
+    blockTrails.spawn(currentPiece->getX(), currentPiece->getY(), currentPiece->getType(),
+                      TrailPool::shapeMask(currentPiece->getShape()), color[0], color[1], color[2],
+                      trailDuration, trailOpacity, segments);
     
     // Start update timer if not running
     if (trailUpdateTimer == 0) {
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
         trailUpdateTimer = g_timeout_add(TRAIL_UPDATE_INTERVAL,
             [](gpointer userData) -> gboolean {
                 TetrimoneBoard* board = static_cast<TetrimoneBoard*>(userData);
@@ -942,7 +948,7 @@ void TetrimoneBoard::updateBlockTrails() {
     if (!trailsEnabled) {
         blockTrails.clear();
         
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
         // GTK3: Remove g_source timer
         if (trailUpdateTimer != 0) {
             g_source_remove(trailUpdateTimer);
@@ -954,20 +960,10 @@ void TetrimoneBoard::updateBlockTrails() {
     
     double deltaTime = TRAIL_UPDATE_INTERVAL / 1000.0;
     
-    for (auto it = blockTrails.begin(); it != blockTrails.end();) {
-        BlockTrail& trail = *it;
-        trail.life -= deltaTime;
-        trail.alpha = (trail.life / trail.maxLife) * trailOpacity;
-        
-        if (trail.life <= 0.0 || trail.alpha <= 0.05) {
-            it = blockTrails.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    blockTrails.update(deltaTime, trailOpacity);
     
     if (blockTrails.empty() && trailUpdateTimer != 0) {
-#ifdef GTK3
+#if defined(GTK3) || defined(KIOSK)
         // GTK3: Remove timer
         g_source_remove(trailUpdateTimer);
         trailUpdateTimer = 0;
@@ -985,12 +981,16 @@ int TetrimoneBoard::getGridValue(int x, int y) const {
 
 void drawBoard(TetrimoneBoard *board) {
 #ifdef GTK3
-     gtk_widget_queue_draw(board->app->gameArea);
+     queueGameAreaDamage(board->app);
 #endif
 
 #ifdef QT5
     board->app->gameArea->update();
 #endif
+
+#ifdef KIOSK
+    board->app->redrawPending = true;
+#endif
 }
 
 void TetrimoneBoard::setLevel(int newLevel) {
@@ -1157,6 +1157,12 @@ void ui_set_window_title(TetrimoneApp *app, const char *title)
 #ifdef QT5
     app->window->setWindowTitle(QString::fromUtf8(title));
 #endif
+
+#ifdef KIOSK
+    if (app->window) {
+        SDL_SetWindowTitle(app->window, title);
+    }
+#endif
 }
 
 void ui_set_difficulty_label(TetrimoneApp *app, const char *markup)
@@ -1221,6 +1227,10 @@ void drawNextPieceArea(TetrimoneBoard *board) {
 #ifdef QT5
      board->app->nextPieceArea->update();
 #endif
+
+#ifdef KIOSK
+     board->app->redrawPending = true;
+#endif
 }
 
 std::string TetrimoneBoard::getDifficultyText(int difficulty) const {
@@ -1287,6 +1297,9 @@ int ui_run_application(int argc, char *argv[], TetrimoneApp *app, const CommandL
     // Enter Qt event loop
     return qtApp.exec();
 #endif
+#ifdef KIOSK
+    return runKiosk(app, args);
+#endif
 
 }
 
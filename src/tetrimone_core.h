@@ -9,13 +9,14 @@
 #include <memory>
 #include <atomic>
 #include <string>
+#include <cstdint>
 #include "audiomanager.h"
 #include <SDL2/SDL.h>
 #include <cairo/cairo.h>
 
 #ifdef GTK3
     #include <glib.h>
-#else
+#elif defined(QT5)
     class QTimer;
 #endif
 
@@ -23,18 +24,11 @@
 #include "tetrimoneblock.h"
 #include "highscores.h"
 #include "propaganda_messages.h"
-
-struct FireworkParticle {
-    double x, y, vx, vy, life, maxLife, size, gravity, fade;
-    std::array<double, 3> color;
-};
-
-struct BlockTrail {
-    double x, y, life, maxLife, alpha;
-    int rotation, pieceType;
-    std::array<double, 3> color;
-    std::vector<std::vector<int>> shape;
-};
+#include "gridrows.h"
+#include "particles.h"
+#include "palette.h"
+#include "qualitygovernor.h"
+#include "profiler.h"
 
 struct LineClearAnimValues {
     double alpha, scale, offsetX, offsetY;
@@ -62,6 +56,37 @@ class TetrimoneBlock;
 class TetrimoneBoard;
 struct TetrimoneApp;
 
+// ============================================================================
+// Game state snapshot
+// ============================================================================
+/**
+ * Compact, trivially copyable copy of everything that decides how a game
+ * plays out from a given moment: locked cells, the falling piece, the
+ * preview queue, scoring and the piece RNG. Animations, timers and
+ * surfaces are deliberately left out, so taking or restoring one is a
+ * few hundred bytes of copying.
+ */
+struct GameSnapshot {
+    static const int QUEUE_LENGTH = 20;
+
+    uint16_t occupancy[MAX_GRID_HEIGHT];  // Bit x set when cell (x, y) is filled
+    uint64_t cells[MAX_GRID_HEIGHT];      // 4 bits per cell: piece type + 1, 0 = empty
+    std::minstd_rand pieceRng;
+    int32_t score, level, linesCleared;
+    int32_t consecutiveClears, maxConsecutiveClears, lastClearCount;
+    float heatLevel;
+    int8_t gridWidth, gridHeight;
+    int8_t pieceType, pieceRotation, pieceX, pieceY;
+    int8_t queueLength;
+    int8_t nextTypes[QUEUE_LENGTH];
+    bool gameOver, sequenceActive;
+
+    int getCell(int x, int y) const { return (int)((cells[y] >> (x * 4)) & 0xF); }
+    bool isFilled(int x, int y) const { return (occupancy[y] >> x) & 1; }
+};
+
+#include "statepublisher.h"
+
 class TetrimoneBlock {
 private:
     int type, rotation, x, y;
@@ -76,6 +101,7 @@ public:
     int getX() const { return x; }
     int getY() const { return y; }
     void setPosition(int newX, int newY);
+    void setRotation(int newRotation) { rotation = newRotation & 3; }
     bool isValid() const { 
         return type >= 0 && type < 14 && rotation >= 0 && rotation < 4; 
     }
@@ -89,18 +115,22 @@ private:
         QTimer* heatDecayTimer = nullptr;
     #endif
     
-    #ifdef GTK3
+    #if defined(GTK3) || defined(KIOSK)
         unsigned int heatDecayTimer;
     #endif
-    std::vector<std::vector<int>> grid;
+    GridRows grid;
     std::unique_ptr<TetrimoneBlock> currentPiece;
     std::deque<std::unique_ptr<TetrimoneBlock>> nextPieces;
+    int pieceSerial = 0;  // Bumped whenever the current piece is replaced
+    int gameSerial = 0;   // Bumped by every restart()
     int score, level, linesCleared;
     bool gameOver, paused;
     bool gameOverSoundPlayed = false;  // Ensures game over sound plays only once
     std::mt19937 rng;
+    std::minstd_rand pieceRng;  // Gameplay randomness only, so snapshots can capture it
     bool splashScreenActive;
     std::atomic<bool> musicStopFlag{false};
+    GameStatePublisher statePublisher;
     int minBlockSize = 4;
     int gridWidth = GRID_WIDTH, gridHeight = GRID_HEIGHT;
     bool ghostPieceEnabled;
@@ -113,6 +143,7 @@ private:
     bool isThemeTransitioning;
     double themeTransitionProgress;
     int oldThemeIndex, newThemeIndex;
+    mutable ThemePalette palette;   // Refreshed lazily by getPalette()
     static const int THEME_TRANSITION_DURATION = 3000;
 
     // Line clear animation
@@ -131,28 +162,34 @@ private:
 
     // Fireworks
     bool fireworksActive;
-    std::vector<FireworkParticle> fireworkParticles;
+    FireworkPool fireworkParticles;
     std::chrono::high_resolution_clock::time_point fireworksStartTime;
     static const int FIREWORKS_DURATION = 2000;
     int fireworksType;
 
     // Block trails
     bool trailsEnabled;
-    std::vector<BlockTrail> blockTrails;
+    TrailPool blockTrails;
     std::chrono::high_resolution_clock::time_point lastTrailTime;
     int maxTrailSegments;
     double trailOpacity, trailDuration;
     static const int TRAIL_UPDATE_INTERVAL = 16;
     static constexpr double TRAIL_SPAWN_DELAY = 120.0;
 
+    // Practice mode undo history (oldest first)
+    bool practiceMode = false;
+    std::deque<GameSnapshot> undoHistory;
+    static const int MAX_UNDO_STEPS = 100;
+
     // Background transition
     bool isTransitioning;
     double transitionOpacity;
     int transitionDirection;
     void* oldBackground;
 
-    // Platform-specific timer members (declared in tetrimone_gtk.h or tetrimone_qt5.h)
-    #ifdef GTK3
+    // Platform-specific timer members (declared in tetrimone_gtk.h or tetrimone_qt5.h;
+    // the kiosk build uses GTK3-style ids from its own main loop)
+    #if defined(GTK3) || defined(KIOSK)
         unsigned int smoothMovementTimer = 0;
         unsigned int lineClearAnimationTimer = 0;
         unsigned int themeTransitionTimer = 0;
@@ -250,12 +287,25 @@ public:
 
     // Grid/State
     int getGridValue(int x, int y) const;
-    const std::vector<std::vector<int>>& getGrid() const { return grid; }
+    const GridRows& getGrid() const { return grid; }
     void dismissSplashScreen();
     void togglePause() { paused = !paused; }
     void generateJunkLines(int percentage);
     void addJunkLinesFromBottom(int count);
 
+    // Snapshots, undo and save state
+    void saveSnapshot(GameSnapshot& out) const;
+    GameSnapshot snapshot() const { GameSnapshot s; saveSnapshot(s); return s; }
+    bool restoreSnapshot(const GameSnapshot& state);
+    void recordUndoPoint();
+    bool undoLastPiece();
+    bool canUndo() const { return practiceMode && undoHistory.size() > 1; }
+    bool isPracticeMode() const { return practiceMode; }
+    void setPracticeMode(bool enabled);
+    bool saveGameState(const std::string& path) const;
+    bool loadGameState(const std::string& path);
+    static std::string getSaveStatePath();
+
     // Score/Status
     int getScore() const { return score; }
     int getLevel() const { return level; }
@@ -265,6 +315,10 @@ public:
     void setPaused(bool p) { paused = p; }
     void setGameOver(bool g) { gameOver = g; }
 
+    /** Publish the current state for the renderer and music threads */
+    void publishState() { statePublisher.publish(*this); }
+    GameStatePublisher& getStatePublisher() { return statePublisher; }
+
     // Pieces
     const TetrimoneBlock* getCurrentPiece() const { 
       if (!currentPiece) {
@@ -301,6 +355,9 @@ public:
       return nextPieces.size();
     }
 
+    int getPieceSerial() const { return pieceSerial; }
+    int getGameSerial() const { return gameSerial; }
+
     // Heat
     float getHeatLevel();
     void setHeatLevel(float level);
@@ -349,6 +406,7 @@ public:
     int getOldThemeIndex() const { return oldThemeIndex; }
     int getNewThemeIndex() const { return newThemeIndex; }
     std::array<double, 3> getInterpolatedColor(int blockType, double progress) const;
+    const ThemePalette& getPalette() const;
     int getCurrentAnimationType() const { return currentAnimationType; }
 
     // Background management
@@ -387,6 +445,7 @@ public:
     void getCurrentPieceInterpolatedPosition(double &x, double &y) const;
     void startLineClearAnimation(const std::vector<int> &clearedLines);
     void updateLineClearAnimation();
+    void cancelLineClearAnimation();
 
     // Movement animation
     void startSmoothMovement(int newX, int newY);
@@ -397,7 +456,7 @@ public:
     void updateFireworksAnimation();
     void createFireworkBurst(double centerX, double centerY, const std::array<double, 3>& baseColor, int particleCount);
     bool isFireworksActive() const { return fireworksActive; }
-    const std::vector<FireworkParticle>& getFireworkParticles() const { return fireworkParticles; }
+    const FireworkPool& getFireworkParticles() const { return fireworkParticles; }
 
     // Block trails
     void setTrailsEnabled(bool enabled) { trailsEnabled = enabled; }
@@ -411,7 +470,7 @@ public:
     void updateBlockTrails();
     void createBlockTrail();
     bool isBlockTrailsActive() const { return !blockTrails.empty(); }
-    const std::vector<BlockTrail>& getBlockTrails() const { return blockTrails; }
+    const TrailPool& getBlockTrails() const { return blockTrails; }
 
     // Background transition
     void startBackgroundTransition();
@@ -474,6 +533,7 @@ bool saveGameSettings(TetrimoneApp* app);
 bool loadGameSettings(TetrimoneApp* app);
 void resetGameSettings(TetrimoneApp* app);
 void adjustDropSpeed(TetrimoneApp* app);
+void restartDropTimer(TetrimoneApp* app);
 void calculateBlockSize(TetrimoneApp* app);
 
 
@@ -492,15 +552,9 @@ void ui_set_mediumMenuItem_enabled(TetrimoneApp *app, bool enabled);
 void app_set_track_items_active(TetrimoneApp* app, int count, bool active);
 
 // Drawing functions - Cairo version (implementation of platform-agnostic interface)
-void drawGameOver(cairo_t *cr, TetrimoneBoard *board);
-void drawBlockTrails(cairo_t *cr, TetrimoneBoard *board);
-void drawFireworks(cairo_t *cr, TetrimoneBoard *board, TetrimoneApp *app);
-void drawPauseMenu(cairo_t *cr, TetrimoneBoard *board);
 void drawGridLines(cairo_t *cr, TetrimoneBoard *board);
 void drawFailureLine(cairo_t *cr);
 void drawSplashScreen(cairo_t *cr, TetrimoneBoard *board, TetrimoneApp *app);
-void drawGhostPiece(cairo_t *cr, TetrimoneBoard *board);
-void drawCurrentPiece(cairo_t *cr, TetrimoneBoard *board);
 void drawPropagandaMessage(cairo_t *cr, TetrimoneBoard *board);
 
 // GTK JPEG image loading utilities
@@ -511,6 +565,16 @@ cairo_surface_t* cairo_image_surface_create_from_memory(const void* data, size_t
 void drawFreezyEffect(cairo_t* cr, double x, double y, double size, float heatLevel, double time);
 void drawFireyGlow(cairo_t* cr, double x, double y, double size, float heatLevel, double time);
 
+// Same effects from a caller-owned sprite cache, block size and effect
+// budget (render thread)
+class EffectSprites;
+void drawFreezyEffect(cairo_t* cr, EffectSprites &sprites, int blockSize,
+                      const QualityGovernor::Budget &budget, double x, double y,
+                      double size, float heatLevel, double time);
+void drawFireyGlow(cairo_t* cr, EffectSprites &sprites, int blockSize,
+                   const QualityGovernor::Budget &budget, double x, double y,
+                   double size, float heatLevel, double time);
+
 
 // Helper function
 LineClearAnimValues getLineClearAnimationValues(int animationType, double progress, int x, int y);
@@ -6,6 +6,11 @@
 #include <SDL2/SDL.h>
 #include "audiomanager.h"
 #include "tetrimone_core.h"
+#include "damage.h"
+#include "boardlayer.h"
+#include "rendercommands.h"
+
+class AutoPlayer;
 
 // ============================================================================
 // GTK3-specific callback data structures
@@ -67,6 +72,22 @@ struct TetrimoneApp {
     RenderingMode renderingMode;
     GtkWidget* renderModeMenuItems[2];  // Radio menu items for Cairo and OpenGL
 
+    // Built-in bot and attract mode
+    AutoPlayer* autoPlayer = nullptr;
+    guint autoplayTimerId = 0;
+    bool autoPlayActive = false;
+    bool demoMode = false;
+    std::chrono::steady_clock::time_point lastInputTime;
+
+    // What the game area and preview last painted, for partial redraws
+    DamageTracker damage;
+
+    // Background and locked blocks, rasterized off the UI thread
+    BoardLayerRenderer boardLayer;
+    BoardLayerFrame boardLayerFrame;        // Main thread side of boardLayer
+    guint boardLayerStepTimer = 0;          // Redraw at the next effect step, if pending
+    RenderCommandList frameCommands;        // Game area layers, rebuilt each frame
+
 };
 
 // ============================================================================
@@ -76,9 +97,15 @@ struct TetrimoneApp {
 // Cairo drawing (legacy support)
 gboolean onDrawGameArea(GtkWidget* widget, cairo_t* cr, gpointer data);
 gboolean onDrawNextPiece(GtkWidget* widget, cairo_t* cr, gpointer data);
+gboolean onBoardLayerReady(gpointer userData);
+void resetBoardLayer(TetrimoneApp* app);
 
 void drawBackground(cairo_t *cr, TetrimoneBoard *board, int width, int height);
 
+// Redraw only what changed since the last paint (gameplay updates)
+void queueGameAreaDamage(TetrimoneApp *app);
+void updateChangedDisplay(TetrimoneApp *app);
+
 // Input and event handling (GTK3-specific)
 gboolean onKeyPress(GtkWidget* widget, GdkEventKey* event, gpointer data);
 gboolean onKeyDownTick(gpointer userData);
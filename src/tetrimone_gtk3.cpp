@@ -18,6 +18,7 @@
 #include "propaganda_messages.h"
 #include "freedom_messages.h"
 #include "commandline.h"
+#include "autoplay.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -67,7 +68,7 @@ gboolean onKeyDownTick(gpointer userData) {
     keyDownTimer = g_timeout_add(keyDownDelay, onKeyDownTick, app);
     
     // Update the display
-    updateDisplay(app);
+    updateChangedDisplay(app);
     updateLabels(app);
     
     // Stop this timer instance (we created a new one above)
@@ -102,7 +103,7 @@ gboolean onKeyLeftTick(gpointer userData) {
     keyLeftTimer = g_timeout_add(keyLeftDelay, onKeyLeftTick, app);
     
     // Update the display
-    updateDisplay(app);
+    updateChangedDisplay(app);
     updateLabels(app);
     
     // Stop this timer instance
@@ -136,7 +137,7 @@ gboolean onKeyRightTick(gpointer userData) {
     keyRightTimer = g_timeout_add(keyRightDelay, onKeyRightTick, app);
     
     // Update the display
-    updateDisplay(app);
+    updateChangedDisplay(app);
     updateLabels(app);
     
     // Stop this timer instance
@@ -162,7 +163,7 @@ void TetrimoneBoard::startFireworksAnimation(int linesCleared) {
         
         // Use theme colors for fireworks
         int colorIndex = rng() % 7; // Use tetrimone block colors
-        std::array<double, 3> color = TETRIMONEBLOCK_COLOR_THEMES[currentThemeIndex][colorIndex];
+        std::array<double, 3> color = getPalette().themeColor(colorIndex);
         
         createFireworkBurst(x, y, color, 15 + rng() % 10);
     }
@@ -184,31 +185,29 @@ void TetrimoneBoard::startFireworksAnimation(int linesCleared) {
 void TetrimoneBoard::createFireworkBurst(double centerX, double centerY, 
                                         const std::array<double, 3>& baseColor, 
                                         int particleCount) {
+    // Slow machines get smaller bursts
+    particleCount = std::max(1, (int)lround(particleCount * qualityGovernor.budget().fireworkScale));
     for (int i = 0; i < particleCount; i++) {
-        FireworkParticle particle;
-        
         // Random angle and speed
         double angle = (2.0 * M_PI * i) / particleCount + (rng() % 100 - 50) * 0.01;
         double speed = 2.0 + (rng() % 100) * 0.03;
         
-        particle.x = centerX;
-        particle.y = centerY;
-        particle.vx = cos(angle) * speed;
-        particle.vy = sin(angle) * speed;
-        particle.life = 1.0;
-        particle.maxLife = 1.0 + (rng() % 100) * 0.01; // Slight variation
-        particle.size = 3.0 + (rng() % 3);
-        particle.gravity = 0.1 + (rng() % 5) * 0.01;
-        particle.fade = 0.008 + (rng() % 5) * 0.001;
+        double size = 3.0 + (rng() % 3);
+        double gravity = 0.1 + (rng() % 5) * 0.01;
+        double fade = 0.008 + (rng() % 5) * 0.001;
         
         // Color variation
-        particle.color = baseColor;
+        std::array<double, 3> color = baseColor;
         for (int c = 0; c < 3; c++) {
-            particle.color[c] += (rng() % 40 - 20) * 0.01;
-            particle.color[c] = std::max(0.0, std::min(1.0, particle.color[c]));
+            color[c] += (rng() % 40 - 20) * 0.01;
+            color[c] = std::max(0.0, std::min(1.0, color[c]));
         }
         
-        fireworkParticles.push_back(particle);
+        // A full pool just means a smaller burst
+        if (!fireworkParticles.spawn(centerX, centerY, cos(angle) * speed, sin(angle) * speed,
+                                     size, gravity, fade, color[0], color[1], color[2])) {
+            break;
+        }
     }
 }
 
@@ -222,32 +221,13 @@ void TetrimoneBoard::updateFireworksAnimation() {
         double y = (rng() % 6 + GRID_HEIGHT - 10) * BLOCK_SIZE + BLOCK_SIZE / 2;
         
         int colorIndex = rng() % 7;
-        std::array<double, 3> color = TETRIMONEBLOCK_COLOR_THEMES[currentThemeIndex][colorIndex];
+        std::array<double, 3> color = getPalette().themeColor(colorIndex);
         
         createFireworkBurst(x, y, color, 12 + rng() % 8);
     }
     
-    // Update existing particles
-    for (auto it = fireworkParticles.begin(); it != fireworkParticles.end();) {
-        FireworkParticle& p = *it;
-        
-        // Update physics
-        p.x += p.vx;
-        p.y += p.vy;
-        p.vy += p.gravity; // Apply gravity
-        p.life -= p.fade;
-        
-        // Add some air resistance
-        p.vx *= 0.98;
-        p.vy *= 0.98;
-        
-        // Remove dead particles
-        if (p.life <= 0.0) {
-            it = fireworkParticles.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    // Update existing particles (physics, then drop the dead ones)
+    fireworkParticles.update();
     
     // FORCE REDRAW - This is crucial!
     if (app) {
@@ -271,6 +251,11 @@ gboolean onKeyPress(GtkWidget *widget, GdkEventKey *event, gpointer data) {
   
   // Handle key press events
   if (event->type == GDK_KEY_PRESS) {
+    // Any key ends a demo game and returns to the splash screen
+    if (autoPlayHandleInput(app)) {
+      return true;
+    }
+
     // Handle space to dismiss splash screen first
     if (event->keyval == GDK_KEY_space && board->isSplashScreenActive()) {
       board->dismissSplashScreen();
@@ -397,6 +382,63 @@ gboolean onKeyPress(GtkWidget *widget, GdkEventKey *event, gpointer data) {
       }
       break;
 
+    case GDK_KEY_b:
+    case GDK_KEY_B:
+      // Toggle the built-in bot
+      if (!board->isSplashScreenActive() && !board->isGameOver()) {
+        if (isAutoPlayActive(app)) {
+          stopAutoPlay(app);
+        } else {
+          startAutoPlay(app);
+        }
+      }
+      break;
+
+    case GDK_KEY_u:
+    case GDK_KEY_U:
+      // Practice mode: take back the last placed piece
+      if (board->isPracticeMode() && !board->isSplashScreenActive()) {
+        if (board->undoLastPiece()) {
+          restartDropTimer(app);
+        }
+      }
+      break;
+
+    case GDK_KEY_F3:
+      // Frame time overlay
+      profiler.setOverlayShown(!profiler.isOverlayShown());
+      gtk_widget_queue_draw(app->gameArea);
+      break;
+
+    case GDK_KEY_F4:
+      // Write the profile trace recorded so far
+      if (profiler.isEnabled()) {
+        std::string path = profiler.exportPath();
+        if (profiler.exportTrace(path)) {
+          std::cout << "Profile trace written to " << path << std::endl;
+        }
+      }
+      break;
+
+    case GDK_KEY_F5:
+      // Quick save
+      if (!board->isSplashScreenActive() && !board->isGameOver()) {
+        if (board->saveGameState(TetrimoneBoard::getSaveStatePath())) {
+          std::cout << "Game state saved" << std::endl;
+        }
+      }
+      break;
+
+    case GDK_KEY_F9:
+      // Quick resume
+      if (!board->isSplashScreenActive()) {
+        if (board->loadGameState(TetrimoneBoard::getSaveStatePath())) {
+          std::cout << "Game state restored" << std::endl;
+          restartDropTimer(app);
+        }
+      }
+      break;
+
     case GDK_KEY_Escape:
       // Emergency unpause if somehow stuck
       if (board->isPaused() && !board->isGameOver()) {
@@ -648,8 +690,7 @@ case GDK_KEY_comma:
   }
 
   // Always redraw and update after any key press
-  gtk_widget_queue_draw(app->gameArea);
-  gtk_widget_queue_draw(app->nextPieceArea);
+  updateChangedDisplay(app);
   updateLabels(app);
 
   return true; // Always claim we handled the key event
@@ -667,6 +708,11 @@ if (!board->isPaused() && !board->isSplashScreenActive() && !board->retroModeAct
   if (!board->isPaused()) {
     board->updateGame();
 
+    // Bot games never go on the high score table
+    if (board->isGameOver() && isAutoPlayActive(app)) {
+      board->highScoreAlreadyProcessed = true;
+    }
+
     // If the game just ended after this update, check for high score
     if (board->isGameOver()) {
       if (!board->highScoreAlreadyProcessed) {
@@ -697,8 +743,7 @@ if (!board->isPaused() && !board->isSplashScreenActive() && !board->retroModeAct
 
          }
     }
-    gtk_widget_queue_draw(app->gameArea);
-    gtk_widget_queue_draw(app->nextPieceArea);
+    updateChangedDisplay(app);
     updateLabels(app);
   }
 
@@ -902,6 +947,21 @@ void cleanupApp(gpointer data) {
     app->joystickEnabled = false;
   }
 
+  if (app->autoplayTimerId > 0) {
+    g_source_remove(app->autoplayTimerId);
+    app->autoplayTimerId = 0;
+  }
+
+  // Join the render thread and drop repaints it already scheduled
+  app->boardLayer.stop();
+  while (g_idle_remove_by_data(app)) {
+  }
+  resetBoardLayer(app);
+  frameRecorder.close();
+
+  delete app->autoPlayer;
+  app->autoPlayer = NULL;
+
   // Delete board after all timers are stopped
   delete app->board;
   app->board = NULL;
@@ -995,6 +1055,12 @@ void onAppActivate(GtkApplication *app, gpointer userData) {
                               GRID_HEIGHT * BLOCK_SIZE);
   g_signal_connect(G_OBJECT(tetrimoneApp->gameArea), "draw",
                    G_CALLBACK(onDrawGameArea), tetrimoneApp);
+
+  // Locked blocks and background are rasterized on a worker thread;
+  // each finished layer schedules a repaint back on the main loop
+  tetrimoneApp->boardLayer.start([tetrimoneApp]() {
+    g_idle_add(onBoardLayerReady, tetrimoneApp);
+  });
   gtk_box_pack_start(GTK_BOX(tetrimoneApp->mainBox), tetrimoneApp->gameArea,
                      FALSE, FALSE, 0);
 
@@ -1657,6 +1723,7 @@ void onSimpleBlocksToggled(GtkCheckMenuItem* menuItem, gpointer userData) {
 void onRetroMusicToggled(GtkCheckMenuItem* menuItem, gpointer userData) {
     TetrimoneApp* app = static_cast<TetrimoneApp*>(userData);
     app->board->retroMusicActive = gtk_check_menu_item_get_active(menuItem);
+    app->board->publishState();
     
     // If music is playing, restart it to apply the change
     if (app->backgroundMusicPlaying && app->board->sound_enabled_) {
@@ -1892,6 +1959,7 @@ void onSoundToggled(GtkCheckMenuItem *menuItem, gpointer userData) {
   bool isSoundEnabled = gtk_check_menu_item_get_active(menuItem);
 
   app->board->sound_enabled_ = isSoundEnabled;
+  app->board->publishState();
 
   if (isSoundEnabled) {
     // If sound is being turned on, we need to initialize the audio system
@@ -2068,6 +2136,16 @@ void adjustDropSpeed(TetrimoneApp *app) {
   }
 }
 
+// After undo or a quick resume the level, and so the speed, may differ
+void restartDropTimer(TetrimoneApp *app) {
+  adjustDropSpeed(app);
+  // A paused game has no timer; resuming starts one at the new speed
+  if (app->timerId > 0) {
+    g_source_remove(app->timerId);
+    app->timerId = g_timeout_add(app->dropSpeed, onTimerTick, app);
+  }
+}
+
 
 
 // Add to startGame function
@@ -2405,6 +2483,9 @@ void onTrackToggled(GtkCheckMenuItem *menuItem, gpointer userData) {
     app->board->enabledTracks[trackIndex] = true;
     gtk_check_menu_item_set_active(menuItem, true);
   }
+
+  // The music thread picks the next track from the published state
+  app->board->publishState();
 }
 
 void updateWidthValueLabel(GtkAdjustment *adj, gpointer data) {
@@ -0,0 +1,1327 @@
+// ============================================================================
+// Standalone SDL2 kiosk front end (no GTK or Qt)
+// ============================================================================
+
+#include "tetrimone_kiosk.h"
+#include "kiosk_timers.h"
+#include "audiomanager.h"
+#include "autoplay.h"
+#include "blockatlas.h"
+#include "commandline.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Key repeat state shared with the core (defined in tetrimone.cpp)
+extern bool keyDownPressed;
+extern bool keyLeftPressed;
+extern bool keyRightPressed;
+extern int keyDownTimer;
+extern int keyLeftTimer;
+extern int keyRightTimer;
+extern int keyDownDelay;
+extern int keyLeftDelay;
+extern int keyRightDelay;
+extern int keyDownCount;
+extern int keyLeftCount;
+extern int keyRightCount;
+
+// Side panel width in blocks; the preview needs two blocks per piece
+static const int PANEL_BLOCKS = 6;
+
+// Stick travel (of 32767) before it counts as a direction
+static const int STICK_DEAD_ZONE = 12000;
+
+// ============================================================================
+// Main Loop Timers
+// ============================================================================
+
+// Backs the g_timeout_add() calls declared in kiosk_timers.h
+class KioskTimers {
+public:
+    KioskTimers() : nextId(1) {}
+
+    /** @return Timer id, never 0 */
+    guint add(guint intervalMs, GSourceFunc function, gpointer data);
+
+    /** @return false if no timer has that id */
+    bool remove(guint id);
+
+    /** Run every timer that is due */
+    void dispatch();
+
+    /** Milliseconds until the next timer is due, or -1 if none is set */
+    int msUntilNext() const;
+
+private:
+    struct Timer {
+        guint id;
+        guint intervalMs;
+        uint64_t dueMs;
+        GSourceFunc function;
+        gpointer data;
+    };
+
+    std::vector<Timer> timers;
+    guint nextId;
+
+    static uint64_t nowMs();
+};
+
+static KioskTimers kioskTimers;
+
+guint g_timeout_add(guint intervalMs, GSourceFunc function, gpointer data) {
+    return kioskTimers.add(intervalMs, function, data);
+}
+
+gboolean g_source_remove(guint id) {
+    return kioskTimers.remove(id) ? TRUE : FALSE;
+}
+
+uint64_t KioskTimers::nowMs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+guint KioskTimers::add(guint intervalMs, GSourceFunc function, gpointer data) {
+    guint id = nextId++;
+    if (nextId == 0) {
+        nextId = 1;
+    }
+    timers.push_back(Timer{id, intervalMs, nowMs() + intervalMs, function, data});
+    return id;
+}
+
+bool KioskTimers::remove(guint id) {
+    for (auto it = timers.begin(); it != timers.end(); ++it) {
+        if (it->id == id) {
+            timers.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void KioskTimers::dispatch() {
+    uint64_t now = nowMs();
+
+    // Callbacks add and remove timers, so work from ids rather than iterators
+    std::vector<guint> due;
+    for (const Timer &timer : timers) {
+        if (timer.dueMs <= now) {
+            due.push_back(timer.id);
+        }
+    }
+
+    for (guint id : due) {
+        auto find = [this, id]() {
+            return std::find_if(timers.begin(), timers.end(),
+                                [id](const Timer &timer) { return timer.id == id; });
+        };
+        auto it = find();
+        if (it == timers.end()) {
+            continue; // Removed by an earlier callback
+        }
+
+        gboolean keep = it->function(it->data);
+
+        it = find();
+        if (it == timers.end()) {
+            continue; // Removed itself
+        }
+        if (keep) {
+            // Like GLib, the next interval starts after the callback
+            it->dueMs = nowMs() + it->intervalMs;
+        } else {
+            timers.erase(it);
+        }
+    }
+}
+
+int KioskTimers::msUntilNext() const {
+    if (timers.empty()) {
+        return -1;
+    }
+    uint64_t next = timers.front().dueMs;
+    for (const Timer &timer : timers) {
+        next = std::min(next, timer.dueMs);
+    }
+    uint64_t now = nowMs();
+    return next <= now ? 0 : (int)(next - now);
+}
+
+// ============================================================================
+// Board Drawing
+// ============================================================================
+
+// Same layers, in the same order, as the GTK game area. Blocks, overlays
+// and effects come from one command list; commands outside the damaged
+// area are skipped
+static void drawGameArea(cairo_t *cr, TetrimoneApp *app, int width, int height) {
+    TetrimoneBoard *board = app->board;
+    RenderCommandList &commands = app->frameCommands;
+    buildFrameCommands(board, commands);
+
+    drawBackground(cr, board, width, height);
+    drawGridLines(cr, board);
+    drawFailureLine(cr);
+    executeCommands(cr, commands, RenderCommand::LAYER_BOARD, RenderCommand::LAYER_BOARD);
+
+    // Keep the heat effects animating; one redraw request covers every block
+    if (!board->retroModeActive && (commands.heatLevel > 0.7f || commands.heatLevel < 0.3f)) {
+        updateDisplay(app);
+    }
+
+    if (board->isSplashScreenActive()) {
+        drawSplashScreen(cr, board, app);
+        return;
+    }
+
+    drawPropagandaMessage(cr, board);
+    executeCommands(cr, commands, RenderCommand::LAYER_PIECE, RenderCommand::LAYER_TRAILS);
+    frameRecorder.add(commands);
+
+    qualityGovernor.drawIndicator(cr);
+    profiler.drawOverlay(cr, width, height);
+}
+
+// ============================================================================
+// Side Panel
+// ============================================================================
+
+// The core's label text carries Pango markup; the panel draws plain text
+static std::string stripMarkup(const std::string &markup) {
+    std::string text;
+    bool inTag = false;
+    for (char c : markup) {
+        if (c == '<') {
+            inTag = true;
+        } else if (c == '>') {
+            inTag = false;
+        } else if (!inTag) {
+            text += c;
+        }
+    }
+    return text;
+}
+
+static std::vector<std::string> panelLines(TetrimoneApp *app) {
+    TetrimoneBoard *board = app->board;
+    bool retro = board->retroModeActive;
+    std::vector<std::string> lines;
+
+    lines.push_back(retro ? "Партийная Лояльность: " + std::to_string(board->getScore()) + "%"
+                          : "Score: " + std::to_string(board->getScore()));
+    lines.push_back((retro ? "Пятилетка: " : "Level: ") + std::to_string(board->getLevel()));
+    lines.push_back((retro ? "Уничтожено врагов народа: " : "Lines: ") +
+                    std::to_string(board->getLinesCleared()));
+    lines.push_back((retro ? "Коллективная эффективность: " : "Sequence: ") +
+                    std::to_string(board->getConsecutiveClears()) + (retro ? " (Рекорд: " : " (Max: ") +
+                    std::to_string(board->getMaxConsecutiveClears()) + ")");
+    lines.push_back(stripMarkup(board->getDifficultyText(app->difficulty)));
+    if (isAutoPlayActive(app)) {
+        lines.push_back(app->demoMode ? "Demo - press any key" : "Bot playing (B)");
+    }
+    return lines;
+}
+
+static void drawNextPieces(cairo_t *cr, TetrimoneApp *app, int width, int height) {
+    TetrimoneBoard *board = app->board;
+    cairo_set_source_rgb(cr, 0.1, 0.1, 0.1);
+    cairo_rectangle(cr, 0, 0, width, height);
+    cairo_fill(cr);
+
+    if (board->isGameOver()) {
+        return;
+    }
+
+    int sectionWidth = width / 3;
+    double previewScale = 0.5;
+    double previewBlockSize = BLOCK_SIZE * previewScale;
+
+    cairo_set_source_rgb(cr, 0.3, 0.3, 0.3);
+    cairo_set_line_width(cr, 2);
+    cairo_move_to(cr, sectionWidth, 0);
+    cairo_line_to(cr, sectionWidth, height);
+    cairo_move_to(cr, sectionWidth * 2, 0);
+    cairo_line_to(cr, sectionWidth * 2, height);
+    cairo_stroke(cr);
+
+    blockAtlas.prepare(cr, board);
+    for (int pieceIndex = 0; pieceIndex < 3; pieceIndex++) {
+        const TetrimoneBlock *piece = board->getNextPiece(pieceIndex);
+        if (!piece) {
+            continue;
+        }
+
+        auto shape = piece->getShape();
+        int pieceWidth = 0;
+        for (const auto &row : shape) {
+            pieceWidth = std::max(pieceWidth, (int)row.size());
+        }
+        int pieceHeight = shape.size();
+        double offsetX = pieceIndex * sectionWidth + (sectionWidth - pieceWidth * previewBlockSize) / 2;
+        double offsetY = (height - pieceHeight * previewBlockSize) / 2;
+
+        for (size_t y = 0; y < shape.size(); ++y) {
+            for (size_t x = 0; x < shape[y].size(); ++x) {
+                if (shape[y][x] == 1) {
+                    blockAtlas.drawScaled(cr, BlockAtlas::ROW_PIECE, piece->getType(),
+                                          offsetX + x * previewBlockSize,
+                                          offsetY + y * previewBlockSize, previewScale, 1.0);
+                }
+            }
+        }
+    }
+}
+
+static void drawPanel(cairo_t *cr, TetrimoneApp *app, const std::vector<std::string> &lines) {
+    cairo_save(cr);
+    cairo_translate(cr, app->panelX, app->panelY);
+
+    cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+    cairo_rectangle(cr, 0, 0, app->panelWidth, app->panelHeight);
+    cairo_fill(cr);
+
+    int previewHeight = BLOCK_SIZE * 5 / 2;
+    drawNextPieces(cr, app, app->panelWidth, previewHeight);
+
+    // Counters change every piece, so they go through cairo rather than
+    // the text cache, which would fill up with one-off strings
+    double fontSize = std::max(12.0, BLOCK_SIZE * 0.4);
+    cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    cairo_set_font_size(cr, fontSize);
+    cairo_set_source_rgb(cr, 0.9, 0.9, 0.9);
+    double y = previewHeight + fontSize * 2;
+    for (const std::string &line : lines) {
+        cairo_move_to(cr, 0, y);
+        cairo_show_text(cr, line.c_str());
+        y += fontSize * 1.6;
+    }
+
+    cairo_set_font_size(cr, fontSize * 0.75);
+    cairo_set_source_rgb(cr, 0.6, 0.6, 0.6);
+    y = app->panelHeight - fontSize;
+    const char *help[] = {"P / Start: pause", "Space / Y: hard drop", "Up, A / B: rotate",
+                          "Arrows, stick: move"};
+    for (const char *line : help) {
+        cairo_move_to(cr, 0, y);
+        cairo_show_text(cr, line);
+        y -= fontSize * 1.2;
+    }
+    cairo_restore(cr);
+}
+
+// ============================================================================
+// Frame Output
+// ============================================================================
+
+static void layoutScreen(TetrimoneApp *app) {
+    int boardWidth = GRID_WIDTH * BLOCK_SIZE;
+    int boardHeight = GRID_HEIGHT * BLOCK_SIZE;
+    int gap = BLOCK_SIZE / 2;
+
+    app->panelWidth = PANEL_BLOCKS * BLOCK_SIZE;
+    app->panelHeight = boardHeight;
+    app->boardX = std::max(0, (app->screenWidth - boardWidth - gap - app->panelWidth) / 2);
+    app->boardY = std::max(0, (app->screenHeight - boardHeight) / 2);
+    app->panelX = app->boardX + boardWidth + gap;
+    app->panelY = app->boardY;
+}
+
+static void releaseFrame(TetrimoneApp *app) {
+    if (app->cairoContext) {
+        cairo_destroy(app->cairoContext);
+        app->cairoContext = nullptr;
+    }
+    if (app->surface) {
+        cairo_surface_destroy(app->surface);
+        app->surface = nullptr;
+    }
+    if (app->texture) {
+        SDL_DestroyTexture(app->texture);
+        app->texture = nullptr;
+    }
+}
+
+// Size the Cairo surface and texture to the output; both persist between frames
+static bool createFrame(TetrimoneApp *app) {
+    releaseFrame(app);
+
+    if (SDL_GetRendererOutputSize(app->renderer, &app->screenWidth, &app->screenHeight) != 0) {
+        std::cerr << "Failed to query renderer size: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    // Cairo's ARGB32 is native-endian 32-bit, which SDL calls ARGB8888
+    app->texture = SDL_CreateTexture(app->renderer, SDL_PIXELFORMAT_ARGB8888,
+                                     SDL_TEXTUREACCESS_STREAMING, app->screenWidth,
+                                     app->screenHeight);
+    if (!app->texture) {
+        std::cerr << "Failed to create SDL texture: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    app->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, app->screenWidth, app->screenHeight);
+    if (cairo_surface_status(app->surface) != CAIRO_STATUS_SUCCESS) {
+        std::cerr << "Failed to create cairo surface" << std::endl;
+        releaseFrame(app);
+        return false;
+    }
+    app->cairoContext = cairo_create(app->surface);
+
+    layoutScreen(app);
+    app->redrawAll = true;
+    app->redrawPending = true;
+    return true;
+}
+
+static void renderFrame(TetrimoneApp *app) {
+    TetrimoneBoard *board = app->board;
+    cairo_t *cr = app->cairoContext;
+    app->redrawPending = false;
+    if (!cr) {
+        return;
+    }
+
+    int boardWidth = GRID_WIDTH * BLOCK_SIZE;
+    int boardHeight = GRID_HEIGHT * BLOCK_SIZE;
+    std::vector<SDL_Rect> dirty;
+
+    {
+        QualityGovernor::Frame frame(qualityGovernor);
+        Profiler::Frame profile;
+        board->publishState();
+
+        if (app->redrawAll) {
+            cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+            cairo_paint(cr);
+        }
+
+        // The overlays redraw over the whole board every frame
+        bool wholeBoard = !app->damage.collect(board, boardWidth) || app->redrawAll ||
+                          profiler.isOverlayShown() || qualityGovernor.isIndicatorShown();
+        if (wholeBoard || !app->damage.getRects().empty()) {
+            cairo_save(cr);
+            cairo_translate(cr, app->boardX, app->boardY);
+            if (wholeBoard) {
+                cairo_rectangle(cr, 0, 0, boardWidth, boardHeight);
+                dirty.push_back(SDL_Rect{app->boardX, app->boardY, boardWidth, boardHeight});
+            } else {
+                for (const DamageTracker::Rect &rect : app->damage.getRects()) {
+                    int x0 = std::max(0, rect.x), y0 = std::max(0, rect.y);
+                    int x1 = std::min(boardWidth, rect.x + rect.width);
+                    int y1 = std::min(boardHeight, rect.y + rect.height);
+                    if (x1 > x0 && y1 > y0) {
+                        cairo_rectangle(cr, x0, y0, x1 - x0, y1 - y0);
+                        dirty.push_back(SDL_Rect{app->boardX + x0, app->boardY + y0, x1 - x0, y1 - y0});
+                    }
+                }
+            }
+            // Cairo clips to the union of the rectangles
+            cairo_clip(cr);
+            drawGameArea(cr, app, boardWidth, boardHeight);
+            cairo_restore(cr);
+        }
+        app->damage.painted(board);
+
+        std::vector<std::string> lines = panelLines(app);
+        std::string text;
+        for (const std::string &line : lines) {
+            text += line + "\n";
+        }
+        if (app->redrawAll || text != app->panelText || app->damage.previewChanged(board)) {
+            drawPanel(cr, app, lines);
+            app->damage.previewPainted(board);
+            app->panelText = text;
+            dirty.push_back(SDL_Rect{app->panelX, app->panelY, app->panelWidth, app->panelHeight});
+        }
+    }
+
+    if (app->redrawAll) {
+        dirty.assign(1, SDL_Rect{0, 0, app->screenWidth, app->screenHeight});
+        app->redrawAll = false;
+    }
+    if (dirty.empty()) {
+        return;
+    }
+
+    {
+        Profiler::Scope scope("uploadFrame");
+        cairo_surface_flush(app->surface);
+        const unsigned char *pixels = cairo_image_surface_get_data(app->surface);
+        int stride = cairo_image_surface_get_stride(app->surface);
+        for (const SDL_Rect &rect : dirty) {
+            SDL_Rect clipped = rect;
+            clipped.w = std::min(clipped.w, app->screenWidth - clipped.x);
+            clipped.h = std::min(clipped.h, app->screenHeight - clipped.y);
+            if (clipped.w > 0 && clipped.h > 0) {
+                SDL_UpdateTexture(app->texture, &clipped, pixels + clipped.y * stride + clipped.x * 4,
+                                  stride);
+            }
+        }
+    }
+
+    // Vsync paces presentation, so animation timers never outrun the display
+    SDL_RenderClear(app->renderer);
+    SDL_RenderCopy(app->renderer, app->texture, nullptr, nullptr);
+    SDL_RenderPresent(app->renderer);
+}
+
+// ============================================================================
+// Game Flow
+// ============================================================================
+
+gboolean onTimerTick(gpointer data);
+
+void updateDisplay(TetrimoneApp *app) {
+    app->board->publishState();
+    app->redrawPending = true;
+}
+
+void updateLabels(TetrimoneApp *app) {
+    // The panel compares its text with what it last drew
+    app->redrawPending = true;
+}
+
+void resetUI(TetrimoneApp *app) {
+    app->redrawAll = true;
+    app->redrawPending = true;
+}
+
+void rebuildGameUI(TetrimoneApp *app) {
+    // Block or grid size changed; the screen keeps its size
+    layoutScreen(app);
+    app->damage = DamageTracker();
+    app->redrawAll = true;
+    app->redrawPending = true;
+}
+
+void adjustDropSpeed(TetrimoneApp *app) {
+    // Base speed based on level
+    int baseSpeed = INITIAL_SPEED - (app->board->getLevel() - 1) * 50;
+
+    switch (app->difficulty) {
+    case 0: // Zen
+        app->dropSpeed = 1000;
+        break;
+    case 1: // Easy
+        app->dropSpeed = baseSpeed * 1.5;
+        break;
+    case 3: // Hard
+        app->dropSpeed = baseSpeed * 0.7;
+        break;
+    case 4: // Extreme
+        app->dropSpeed = baseSpeed * 0.3;
+        break;
+    case 5: // Insane
+        app->dropSpeed = baseSpeed * 0.1;
+        break;
+    default: // Medium
+        app->dropSpeed = baseSpeed;
+    }
+
+    // Enforce minimum speed
+    if (app->dropSpeed < 10) {
+        app->dropSpeed = 10;
+    }
+}
+
+// After undo or a quick resume the level, and so the speed, may differ
+void restartDropTimer(TetrimoneApp *app) {
+    adjustDropSpeed(app);
+    // A paused game has no timer; resuming starts one at the new speed
+    if (app->timerId > 0) {
+        g_source_remove(app->timerId);
+        app->timerId = g_timeout_add(app->dropSpeed, onTimerTick, app);
+    }
+}
+
+void calculateBlockSize(TetrimoneApp *app) {
+    int width = app->screenWidth, height = app->screenHeight;
+    if (width <= 0 || height <= 0) {
+        SDL_DisplayMode mode;
+        if (SDL_GetDesktopDisplayMode(0, &mode) != 0) {
+            return;
+        }
+        width = mode.w;
+        height = mode.h;
+    }
+
+    // The board fills the height; the side panel and a margin share the width
+    int heightBasedSize = (height * 9 / 10) / GRID_HEIGHT;
+    int widthBasedSize = (width * 9 / 10) / (GRID_WIDTH + PANEL_BLOCKS + 1);
+
+    BLOCK_SIZE = std::min(heightBasedSize, widthBasedSize);
+    BLOCK_SIZE = std::max(BLOCK_SIZE, MIN_BLOCK_SIZE);
+    BLOCK_SIZE = std::min(BLOCK_SIZE, MAX_BLOCK_SIZE);
+}
+
+void startGame(TetrimoneApp *app) {
+    if (app->timerId > 0) {
+        g_source_remove(app->timerId);
+        app->timerId = 0;
+    }
+
+    if (!app->backgroundMusicPlaying && app->board->sound_enabled_) {
+        app->board->resumeBackgroundMusic();
+        app->backgroundMusicPlaying = true;
+    }
+
+    adjustDropSpeed(app);
+    app->timerId = g_timeout_add(app->dropSpeed, onTimerTick, app);
+}
+
+void pauseGame(TetrimoneApp *app) {
+    if (app->timerId > 0) {
+        g_source_remove(app->timerId);
+        app->timerId = 0;
+    }
+
+    if (app->backgroundMusicPlaying && app->board->sound_enabled_) {
+        app->board->pauseBackgroundMusic();
+        app->backgroundMusicPlaying = false;
+    }
+}
+
+static void onPauseGame(TetrimoneApp *app) {
+    if (app->board->isGameOver()) {
+        return;
+    }
+    app->board->togglePause();
+    if (app->board->isPaused()) {
+        pauseGame(app);
+    } else {
+        startGame(app);
+    }
+    updateDisplay(app);
+}
+
+void onRestartGame(TetrimoneApp *app) {
+    TetrimoneBoard *board = app->board;
+    board->restart();
+    if (board->isPaused()) {
+        board->togglePause();
+    }
+
+    if (board->junkLinesPercentage > 0) {
+        board->generateJunkLines(board->junkLinesPercentage);
+    }
+    if (board->junkLinesPerLevel > 0) {
+        board->addJunkLinesFromBottom(board->junkLinesPerLevel);
+    }
+
+    startGame(app);
+    resetUI(app);
+}
+
+void cleanupApp(TetrimoneApp *app) {
+    // Timers first, so no callback sees a half torn down app
+    if (app->timerId > 0) {
+        g_source_remove(app->timerId);
+        app->timerId = 0;
+    }
+    if (app->autoplayTimerId > 0) {
+        g_source_remove(app->autoplayTimerId);
+        app->autoplayTimerId = 0;
+    }
+
+    if (app->controller) {
+        SDL_GameControllerClose(app->controller);
+        app->controller = nullptr;
+    }
+
+    frameRecorder.close();
+    delete app->autoPlayer;
+    app->autoPlayer = nullptr;
+    delete app->board;
+    app->board = nullptr;
+
+    releaseFrame(app);
+    if (app->renderer) {
+        SDL_DestroyRenderer(app->renderer);
+        app->renderer = nullptr;
+    }
+    if (app->window) {
+        SDL_DestroyWindow(app->window);
+        app->window = nullptr;
+    }
+}
+
+void showKioskMessage(TetrimoneApp* app, const std::vector<std::string>& messages,
+                      const char* fallback) {
+    if (!app || !app->board) return;
+
+    std::string message;
+    if (messages.empty()) {
+        message = fallback;
+    } else {
+        static std::mt19937 rng(std::chrono::system_clock::now().time_since_epoch().count());
+        std::uniform_int_distribution<int> dist(0, messages.size() - 1);
+        message = messages[dist(rng)];
+    }
+
+    app->board->currentPropagandaMessage = message;
+    app->board->showPropagandaMessage = true;
+    updateDisplay(app);
+
+    // Clear the message after 2 seconds
+    g_timeout_add(2000, [](gpointer userData) -> gboolean {
+        TetrimoneApp *app = static_cast<TetrimoneApp *>(userData);
+        app->board->showPropagandaMessage = false;
+        updateDisplay(app);
+        return G_SOURCE_REMOVE;
+    }, app);
+}
+
+// Inspections pause play for a moment; a kiosk shows them on the board
+static void showInspection(TetrimoneApp *app, const std::string &message, guint durationMs) {
+    app->board->setPaused(true);
+    app->board->currentPropagandaMessage = message;
+    app->board->showPropagandaMessage = true;
+    updateDisplay(app);
+
+    g_timeout_add(durationMs, [](gpointer userData) -> gboolean {
+        TetrimoneApp *app = static_cast<TetrimoneApp *>(userData);
+        app->board->showPropagandaMessage = false;
+        app->board->setPaused(false);
+        updateDisplay(app);
+        return G_SOURCE_REMOVE;
+    }, app);
+}
+
+gboolean onTimerTick(gpointer data) {
+    TetrimoneApp *app = static_cast<TetrimoneApp *>(data);
+    TetrimoneBoard *board = app->board;
+
+    if (!board->isPaused() && !board->isSplashScreenActive() && !board->retroModeActive) {
+        board->coolDown();
+    }
+
+    if (!board->isPaused()) {
+        board->updateGame();
+
+        // Bot games never go on the high score table
+        if (board->isGameOver() && isAutoPlayActive(app)) {
+            board->highScoreAlreadyProcessed = true;
+        }
+
+        if (board->isGameOver() && !board->highScoreAlreadyProcessed) {
+            board->highScoreAlreadyProcessed = true;
+            if (board->checkAndRecordHighScore(app)) {
+                board->playSound(GameSoundEvent::Excellent);
+            }
+
+            // Delay slightly for dramatic effect
+            if (board->retroModeActive) {
+                g_timeout_add(1500, [](gpointer userData) -> gboolean {
+                    showIdeologicalFailureDialog(static_cast<TetrimoneApp *>(userData));
+                    return FALSE;
+                }, app);
+            }
+            if (board->patrioticModeActive) {
+                g_timeout_add(1500, [](gpointer userData) -> gboolean {
+                    showPatrioticPerformanceDialog(static_cast<TetrimoneApp *>(userData));
+                    return FALSE;
+                }, app);
+            }
+        }
+        updateDisplay(app);
+        updateLabels(app);
+    }
+
+    if (board->retroModeActive) {
+        board->setHeatLevel(0.5);
+    }
+
+    static std::mt19937 rng(std::chrono::system_clock::now().time_since_epoch().count());
+    if (!board->isPaused() && !board->isGameOver() && board->retroModeActive) {
+        // 1 in 1000 chance of KGB inspection
+        std::uniform_int_distribution<int> dist(1, 1000);
+        if (dist(rng) == 1) {
+            showInspection(app, "КГБ ИНСПЕКЦИЯ В ПРОЦЕССЕ...", 2000);
+        }
+    } else if (!board->isPaused() && !board->isGameOver() && board->patrioticModeActive) {
+        // 1 in 1776 chance of Freedom Inspection
+        std::uniform_int_distribution<int> dist(1, 1776);
+        if (dist(rng) == 1) {
+            showInspection(app, "FREEDOM INSPECTION IN PROGRESS!", 2500);
+        }
+    }
+    return TRUE;
+}
+
+// ============================================================================
+// Input
+// ============================================================================
+
+// One auto-repeat step; delays shorten the longer the direction is held
+static gboolean repeatMove(TetrimoneApp *app, int dx, int dy, bool pressed, int &timer, int &delay,
+                           int &count, GSourceFunc self) {
+    TetrimoneBoard *board = app->board;
+    if (board->isPaused() || board->isGameOver() || board->isSplashScreenActive() || !pressed) {
+        timer = 0;
+        return FALSE;
+    }
+
+    board->movePiece(dx, dy);
+    count++;
+
+    // Soft drop speeds up harder than sideways movement
+    if (count > 6) {
+        delay = dy ? 20 : 30;
+    } else if (count > 4) {
+        delay = dy ? 30 : 50;
+    } else if (count > 2) {
+        delay = dy ? 60 : 100;
+    }
+    timer = g_timeout_add(delay, self, app);
+    updateDisplay(app);
+    return FALSE;
+}
+
+static gboolean onKeyDownTick(gpointer userData) {
+    return repeatMove(static_cast<TetrimoneApp *>(userData), 0, 1, keyDownPressed, keyDownTimer,
+                      keyDownDelay, keyDownCount, onKeyDownTick);
+}
+
+static gboolean onKeyLeftTick(gpointer userData) {
+    return repeatMove(static_cast<TetrimoneApp *>(userData), -1, 0, keyLeftPressed, keyLeftTimer,
+                      keyLeftDelay, keyLeftCount, onKeyLeftTick);
+}
+
+static gboolean onKeyRightTick(gpointer userData) {
+    return repeatMove(static_cast<TetrimoneApp *>(userData), 1, 0, keyRightPressed, keyRightTimer,
+                      keyRightDelay, keyRightCount, onKeyRightTick);
+}
+
+static void pressDirection(TetrimoneApp *app, int dx, int dy) {
+    TetrimoneBoard *board = app->board;
+    if (board->isPaused() || board->isGameOver() || board->isSplashScreenActive()) {
+        return;
+    }
+
+    bool *pressed = dy ? &keyDownPressed : dx < 0 ? &keyLeftPressed : &keyRightPressed;
+    int *timer = dy ? &keyDownTimer : dx < 0 ? &keyLeftTimer : &keyRightTimer;
+    int *delay = dy ? &keyDownDelay : dx < 0 ? &keyLeftDelay : &keyRightDelay;
+    int *count = dy ? &keyDownCount : dx < 0 ? &keyLeftCount : &keyRightCount;
+    GSourceFunc tick = dy ? onKeyDownTick : dx < 0 ? onKeyLeftTick : onKeyRightTick;
+
+    if (*pressed) {
+        return;
+    }
+    *pressed = true;
+    *count = 0;
+    *delay = 150;
+    board->movePiece(dx, dy);
+    if (*timer == 0) {
+        *timer = g_timeout_add(*delay, tick, app);
+    }
+}
+
+static void releaseDirection(int dx, int dy) {
+    bool *pressed = dy ? &keyDownPressed : dx < 0 ? &keyLeftPressed : &keyRightPressed;
+    int *timer = dy ? &keyDownTimer : dx < 0 ? &keyLeftTimer : &keyRightTimer;
+    *pressed = false;
+    if (*timer > 0) {
+        g_source_remove(*timer);
+        *timer = 0;
+    }
+}
+
+static void toggleRetroMode(TetrimoneApp *app) {
+    static int savedThemeIndex = 0;
+    TetrimoneBoard *board = app->board;
+    board->retroModeActive = !board->retroModeActive;
+    board->patrioticModeActive = false;
+
+    if (board->retroModeActive) {
+        savedThemeIndex = currentThemeIndex;
+        currentThemeIndex = NUM_COLOR_THEMES - 1;
+        ui_set_window_title(app, "БЛОЧНАЯ РЕВОЛЮЦИЯ");
+        board->setUseBackgroundImage(false);
+        board->setUseBackgroundZip(false);
+        board->playSound(GameSoundEvent::Select);
+    } else {
+        currentThemeIndex = savedThemeIndex;
+        ui_set_window_title(app, "Tetrimone");
+        if (board->getBackgroundImage() != nullptr) {
+            board->setUseBackgroundImage(true);
+            if (!board->backgroundZipPath.empty()) {
+                board->setUseBackgroundZip(true);
+                board->startBackgroundTransition();
+            }
+        }
+    }
+
+    board->pauseBackgroundMusic();
+    board->resumeBackgroundMusic();
+    resetUI(app);
+}
+
+static void togglePatrioticMode(TetrimoneApp *app) {
+    static int savedThemeIndex = 0;
+    TetrimoneBoard *board = app->board;
+    board->retroModeActive = false;
+    board->patrioticModeActive = !board->patrioticModeActive;
+
+    if (board->patrioticModeActive) {
+        savedThemeIndex = currentThemeIndex;
+        currentThemeIndex = NUM_COLOR_THEMES - 2;
+        ui_set_window_title(app, "FREEDOM BLOCKS - GOD BLESS AMERICA");
+        board->playSound(GameSoundEvent::Select);
+    } else {
+        currentThemeIndex = savedThemeIndex;
+        ui_set_window_title(app, "Tetrimone");
+    }
+
+    if (board->getBackgroundImage() != nullptr) {
+        board->setUseBackgroundImage(true);
+        if (!board->backgroundZipPath.empty()) {
+            board->setUseBackgroundZip(true);
+        }
+    }
+    board->startBackgroundTransition();
+
+    board->pauseBackgroundMusic();
+    board->resumeBackgroundMusic();
+    resetUI(app);
+}
+
+// Start / pause / restart, for the one button a cabinet has for it
+static void onStartButton(TetrimoneApp *app) {
+    TetrimoneBoard *board = app->board;
+    if (board->isSplashScreenActive()) {
+        board->dismissSplashScreen();
+        resetUI(app);
+    } else if (board->isGameOver()) {
+        onRestartGame(app);
+    } else {
+        onPauseGame(app);
+    }
+}
+
+static void onKeyPress(TetrimoneApp *app, SDL_Keycode key) {
+    TetrimoneBoard *board = app->board;
+
+    // Any key ends a demo game and returns to the splash screen
+    if (autoPlayHandleInput(app)) {
+        return;
+    }
+
+    if (key == SDLK_SPACE && board->isSplashScreenActive()) {
+        board->dismissSplashScreen();
+        resetUI(app);
+        return;
+    }
+
+    // Game control keys only while a game is running
+    if (!board->isPaused() && !board->isGameOver() && !board->isSplashScreenActive()) {
+        switch (key) {
+        case SDLK_LEFT:
+        case SDLK_a:
+            pressDirection(app, -1, 0);
+            break;
+        case SDLK_RIGHT:
+        case SDLK_d:
+            pressDirection(app, 1, 0);
+            break;
+        case SDLK_DOWN:
+        case SDLK_s:
+            pressDirection(app, 0, 1);
+            break;
+        case SDLK_UP:
+        case SDLK_w:
+            board->rotatePiece(true);
+            break;
+        case SDLK_z:
+            board->rotatePiece(false);
+            break;
+        case SDLK_SPACE:
+            board->hardDrop();
+            break;
+        }
+    }
+
+    // Global keys regardless of game state
+    switch (key) {
+    case SDLK_p:
+        if (!board->isSplashScreenActive()) {
+            onPauseGame(app);
+        }
+        break;
+    case SDLK_m:
+        if (board->musicPaused) {
+            board->resumeBackgroundMusic();
+        } else {
+            board->pauseBackgroundMusic();
+        }
+        break;
+    case SDLK_n:
+        if (board->isPaused()) {
+            onRestartGame(app);
+        }
+        break;
+    case SDLK_q:
+        if (board->isPaused()) {
+            app->running = false;
+        }
+        break;
+    case SDLK_r:
+        if (board->isGameOver()) {
+            onRestartGame(app);
+        }
+        break;
+    case SDLK_b:
+        // Toggle the built-in bot
+        if (!board->isSplashScreenActive() && !board->isGameOver()) {
+            if (isAutoPlayActive(app)) {
+                stopAutoPlay(app);
+            } else {
+                startAutoPlay(app);
+            }
+        }
+        break;
+    case SDLK_u:
+        // Practice mode: take back the last placed piece
+        if (board->isPracticeMode() && !board->isSplashScreenActive()) {
+            if (board->undoLastPiece()) {
+                restartDropTimer(app);
+            }
+        }
+        break;
+    case SDLK_F3:
+        profiler.setOverlayShown(!profiler.isOverlayShown());
+        break;
+    case SDLK_F4:
+        if (profiler.isEnabled()) {
+            std::string path = profiler.exportPath();
+            if (profiler.exportTrace(path)) {
+                std::cout << "Profile trace written to " << path << std::endl;
+            }
+        }
+        break;
+    case SDLK_F5:
+        if (!board->isSplashScreenActive() && !board->isGameOver()) {
+            if (board->saveGameState(TetrimoneBoard::getSaveStatePath())) {
+                std::cout << "Game state saved" << std::endl;
+            }
+        }
+        break;
+    case SDLK_F9:
+        if (!board->isSplashScreenActive()) {
+            if (board->loadGameState(TetrimoneBoard::getSaveStatePath())) {
+                std::cout << "Game state restored" << std::endl;
+                restartDropTimer(app);
+            }
+        }
+        break;
+    case SDLK_ESCAPE:
+        // Emergency unpause if somehow stuck
+        if (board->isPaused() && !board->isGameOver()) {
+            onPauseGame(app);
+        }
+        break;
+    case SDLK_PERIOD:
+        toggleRetroMode(app);
+        break;
+    case SDLK_COMMA:
+        togglePatrioticMode(app);
+        break;
+    }
+
+    updateDisplay(app);
+}
+
+static void onKeyRelease(SDL_Keycode key) {
+    switch (key) {
+    case SDLK_DOWN:
+    case SDLK_s:
+        releaseDirection(0, 1);
+        break;
+    case SDLK_LEFT:
+    case SDLK_a:
+        releaseDirection(-1, 0);
+        break;
+    case SDLK_RIGHT:
+    case SDLK_d:
+        releaseDirection(1, 0);
+        break;
+    }
+}
+
+static void openController(TetrimoneApp *app, int deviceIndex) {
+    if (app->controller || !app->joystickEnabled || !SDL_IsGameController(deviceIndex)) {
+        return;
+    }
+    app->controller = SDL_GameControllerOpen(deviceIndex);
+    if (!app->controller) {
+        std::cerr << "Failed to open game controller: " << SDL_GetError() << std::endl;
+        return;
+    }
+    app->controllerId = SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(app->controller));
+    app->axisX = app->axisY = 0;
+    std::cout << "Game controller: " << SDL_GameControllerName(app->controller) << std::endl;
+}
+
+static void onControllerButton(TetrimoneApp *app, Uint8 button, bool down) {
+    TetrimoneBoard *board = app->board;
+
+    if (!down) {
+        switch (button) {
+        case SDL_CONTROLLER_BUTTON_DPAD_LEFT:
+            releaseDirection(-1, 0);
+            break;
+        case SDL_CONTROLLER_BUTTON_DPAD_RIGHT:
+            releaseDirection(1, 0);
+            break;
+        case SDL_CONTROLLER_BUTTON_DPAD_DOWN:
+            releaseDirection(0, 1);
+            break;
+        }
+        return;
+    }
+
+    if (autoPlayHandleInput(app)) {
+        return;
+    }
+
+    bool playing = !board->isPaused() && !board->isGameOver() && !board->isSplashScreenActive();
+    switch (button) {
+    case SDL_CONTROLLER_BUTTON_START:
+        onStartButton(app);
+        break;
+    case SDL_CONTROLLER_BUTTON_BACK:
+        if (board->isPaused()) {
+            onRestartGame(app);
+        }
+        break;
+    case SDL_CONTROLLER_BUTTON_DPAD_LEFT:
+        pressDirection(app, -1, 0);
+        break;
+    case SDL_CONTROLLER_BUTTON_DPAD_RIGHT:
+        pressDirection(app, 1, 0);
+        break;
+    case SDL_CONTROLLER_BUTTON_DPAD_DOWN:
+        pressDirection(app, 0, 1);
+        break;
+    case SDL_CONTROLLER_BUTTON_DPAD_UP:
+    case SDL_CONTROLLER_BUTTON_A:
+        if (playing) {
+            board->rotatePiece(true);
+        } else if (board->isSplashScreenActive() || board->isGameOver()) {
+            onStartButton(app);
+        }
+        break;
+    case SDL_CONTROLLER_BUTTON_B:
+        if (playing) {
+            board->rotatePiece(false);
+        }
+        break;
+    case SDL_CONTROLLER_BUTTON_Y:
+        if (playing) {
+            board->hardDrop();
+        }
+        break;
+    }
+    updateDisplay(app);
+}
+
+// The left stick acts like the d-pad once it leaves the dead zone
+static void onControllerAxis(TetrimoneApp *app, Uint8 axis, Sint16 value) {
+    int direction = value < -STICK_DEAD_ZONE ? -1 : value > STICK_DEAD_ZONE ? 1 : 0;
+
+    if (axis == SDL_CONTROLLER_AXIS_LEFTX && direction != app->axisX) {
+        if (app->axisX != 0) {
+            releaseDirection(app->axisX, 0);
+        }
+        app->axisX = direction;
+        if (direction != 0 && !autoPlayHandleInput(app)) {
+            pressDirection(app, direction, 0);
+        }
+    } else if (axis == SDL_CONTROLLER_AXIS_LEFTY && (direction > 0) != (app->axisY > 0)) {
+        // Only down means anything; up is rotate on the d-pad
+        if (app->axisY > 0) {
+            releaseDirection(0, 1);
+        }
+        app->axisY = direction;
+        if (direction > 0 && !autoPlayHandleInput(app)) {
+            pressDirection(app, 0, 1);
+        }
+    } else {
+        return;
+    }
+    updateDisplay(app);
+}
+
+static void onWindowEvent(TetrimoneApp *app, const SDL_WindowEvent &event) {
+    TetrimoneBoard *board = app->board;
+    switch (event.event) {
+    case SDL_WINDOWEVENT_FOCUS_LOST:
+        if (!board->isPaused() && !board->isGameOver() && !board->isSplashScreenActive()) {
+            app->pausedByFocusLoss = true;
+            onPauseGame(app);
+        }
+        break;
+    case SDL_WINDOWEVENT_FOCUS_GAINED:
+        if (app->pausedByFocusLoss) {
+            app->pausedByFocusLoss = false;
+            if (board->isPaused()) {
+                onPauseGame(app);
+            }
+        }
+        break;
+    case SDL_WINDOWEVENT_SIZE_CHANGED:
+        createFrame(app);
+        break;
+    case SDL_WINDOWEVENT_EXPOSED:
+        app->redrawAll = true;
+        app->redrawPending = true;
+        break;
+    }
+}
+
+static void handleEvent(TetrimoneApp *app, const SDL_Event &event) {
+    switch (event.type) {
+    case SDL_QUIT:
+        app->running = false;
+        break;
+    case SDL_KEYDOWN:
+        if (!event.key.repeat) {
+            onKeyPress(app, event.key.keysym.sym);
+        }
+        break;
+    case SDL_KEYUP:
+        onKeyRelease(event.key.keysym.sym);
+        break;
+    case SDL_CONTROLLERDEVICEADDED:
+        openController(app, event.cdevice.which);
+        updateDisplay(app);
+        break;
+    case SDL_CONTROLLERDEVICEREMOVED:
+        if (app->controller && event.cdevice.which == app->controllerId) {
+            SDL_GameControllerClose(app->controller);
+            app->controller = nullptr;
+            app->controllerId = -1;
+            for (int i = 0; i < SDL_NumJoysticks() && !app->controller; ++i) {
+                openController(app, i);
+            }
+        }
+        break;
+    case SDL_CONTROLLERBUTTONDOWN:
+    case SDL_CONTROLLERBUTTONUP:
+        if (event.cbutton.which == app->controllerId) {
+            onControllerButton(app, event.cbutton.button, event.type == SDL_CONTROLLERBUTTONDOWN);
+        }
+        break;
+    case SDL_CONTROLLERAXISMOTION:
+        if (event.caxis.which == app->controllerId) {
+            onControllerAxis(app, event.caxis.axis, event.caxis.value);
+        }
+        break;
+    case SDL_WINDOWEVENT:
+        onWindowEvent(app, event.window);
+        break;
+    }
+}
+
+// ============================================================================
+// Application Lifecycle
+// ============================================================================
+
+int runKiosk(TetrimoneApp *app, const CommandLineArgs *args) {
+    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER) != 0) {
+        std::cerr << "SDL init failed: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    app->window = SDL_CreateWindow("Tetrimone", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 0, 0,
+                                   SDL_WINDOW_FULLSCREEN_DESKTOP | SDL_WINDOW_ALLOW_HIGHDPI);
+    if (!app->window) {
+        std::cerr << "Failed to create SDL window: " << SDL_GetError() << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+
+    app->renderer = SDL_CreateRenderer(app->window, -1,
+                                       SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    if (!app->renderer) {
+        std::cerr << "No accelerated renderer (" << SDL_GetError() << "), using software" << std::endl;
+        app->renderer = SDL_CreateRenderer(app->window, -1, SDL_RENDERER_SOFTWARE);
+    }
+    if (!app->renderer) {
+        std::cerr << "Failed to create SDL renderer: " << SDL_GetError() << std::endl;
+        cleanupApp(app);
+        SDL_Quit();
+        return 1;
+    }
+    SDL_ShowCursor(SDL_DISABLE);
+    if (SDL_GetRendererOutputSize(app->renderer, &app->screenWidth, &app->screenHeight) != 0) {
+        app->screenWidth = app->screenHeight = 0;
+    }
+
+    // Grid size first, then a block size that fits it on this screen
+    if (args && args->gridWidth != -1) {
+        GRID_WIDTH = args->gridWidth;
+    }
+    if (args && args->gridHeight != -1) {
+        GRID_HEIGHT = args->gridHeight;
+    }
+    if (!args || args->blockSize == -1) {
+        calculateBlockSize(app);
+    }
+
+    app->cmdlineArgs = const_cast<CommandLineArgs *>(args);
+    app->board = new TetrimoneBoard();
+    app->board->setApp(app);
+    app->dropSpeed = INITIAL_SPEED;
+
+    if (app->board->initializeAudio()) {
+        app->board->playBackgroundMusic();
+        app->backgroundMusicPlaying = true;
+    } else {
+        std::cerr << "Music failed to initialize" << std::endl;
+    }
+
+    if (args) {
+        applyCommandLineArgs(app, *args);
+    }
+
+    if (!createFrame(app)) {
+        cleanupApp(app);
+        SDL_Quit();
+        return 1;
+    }
+
+    // Controllers already plugged in also arrive as device added events
+    app->board->setSplashScreenActive(true);
+    onRestartGame(app);
+    app->running = true;
+
+    while (app->running) {
+        // Sleep until input, a timer or a frame request needs attention
+        int timeout = app->redrawPending ? 0 : kioskTimers.msUntilNext();
+        SDL_Event event;
+        if (SDL_WaitEventTimeout(&event, timeout)) {
+            handleEvent(app, event);
+            while (app->running && SDL_PollEvent(&event)) {
+                handleEvent(app, event);
+            }
+        }
+
+        kioskTimers.dispatch();
+
+        if (app->redrawPending) {
+            renderFrame(app);
+        }
+    }
+
+    cleanupApp(app);
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,90 @@
+#ifndef TETRIMONE_KIOSK_H
+#define TETRIMONE_KIOSK_H
+
+#include <SDL2/SDL.h>
+#include <cairo/cairo.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "audiomanager.h"
+#include "tetrimone_core.h"
+#include "damage.h"
+#include "rendercommands.h"
+
+// Forward declarations
+struct TetrimoneApp;
+struct CommandLineArgs;
+class AutoPlayer;
+
+// ============================================================================
+// Kiosk-specific TetrimoneApp structure
+// ============================================================================
+
+struct TetrimoneApp {
+    // Fullscreen window presented through an SDL renderer with vsync
+    SDL_Window* window = nullptr;
+    SDL_Renderer* renderer = nullptr;
+    SDL_Texture* texture = nullptr;         // Streaming copy of the frame
+    cairo_surface_t* surface = nullptr;     // Frame drawn by Cairo, kept between frames
+    cairo_t* cairoContext = nullptr;
+    int screenWidth = 0, screenHeight = 0;  // Output pixels
+
+    // Where the board and the side panel sit on the screen
+    int boardX = 0, boardY = 0;
+    int panelX = 0, panelY = 0, panelWidth = 0, panelHeight = 0;
+
+    bool running = false;
+    bool redrawAll = true;                  // Next frame repaints the whole screen
+    bool redrawPending = false;             // Something asked for a new frame
+
+    bool backgroundMusicPlaying = false;
+    TetrimoneBoard* board = nullptr;
+    CommandLineArgs* cmdlineArgs = nullptr;
+
+    unsigned int timerId = 0;
+    int dropSpeed = 500;
+    int difficulty = 2; // 0=Zen, 1=Easy, 2=Medium, 3=Hard, 4=Extreme, 5=Insane
+    bool pausedByFocusLoss = false;
+
+    // First game controller; hotplugged controllers replace a missing one
+    SDL_GameController* controller = nullptr;
+    SDL_JoystickID controllerId = -1;
+    bool joystickEnabled = true;            // Controller input allowed (saved setting)
+    JoystickMapping joystickMapping;        // Kept so saved settings round-trip; the
+                                            // game controller API maps buttons itself
+    int axisX = 0, axisY = 0;               // Left stick, -1, 0 or 1 past the dead zone
+
+    // Built-in bot and attract mode
+    AutoPlayer* autoPlayer = nullptr;
+    unsigned int autoplayTimerId = 0;
+    bool autoPlayActive = false;
+    bool demoMode = false;
+    std::chrono::steady_clock::time_point lastInputTime;
+
+    // What the board and preview last painted, for partial redraws
+    DamageTracker damage;
+    std::string panelText;                  // Side panel labels as last painted
+    RenderCommandList frameCommands;        // Game area layers, rebuilt each frame
+};
+
+// ============================================================================
+// Kiosk-specific drawing and event functions
+// ============================================================================
+
+void drawBackground(cairo_t *cr, TetrimoneBoard *board, int width, int height);
+
+// Game flow
+void onRestartGame(TetrimoneApp* app);
+
+/**
+ * Draw one of the messages over the board for two seconds; the kiosk
+ * shows these in place of the GTK and Qt dialogs
+ */
+void showKioskMessage(TetrimoneApp* app, const std::vector<std::string>& messages,
+                      const char* fallback);
+
+/** Open the fullscreen window and run the SDL event loop until quit */
+int runKiosk(TetrimoneApp* app, const CommandLineArgs* args);
+
+#endif // TETRIMONE_KIOSK_H
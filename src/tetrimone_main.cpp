@@ -9,7 +9,13 @@
 #include "tetrimone_qt5.h"
 #endif
 
+#ifdef KIOSK
+#include "tetrimone_kiosk.h"
+#endif
+
 #include "commandline.h"
+#include "autoplay.h"
+#include "rendercommands.h"
 
 void printHelp(const char* programName) {
     std::cout << "Tetrimone - A block falling puzzle game\n\n";
@@ -32,7 +38,13 @@ void printHelp(const char* programName) {
     std::cout << "  --background-opacity VAL   Set background opacity (0.0-1.0)\n";
     std::cout << "  --grid-lines               Show grid lines\n";
     std::cout << "  --simple-blocks            Use simple blocks (no 3D effect)\n";
-    std::cout << "  --no-ghost                 Disable ghost piece\n\n";
+    std::cout << "  --no-ghost                 Disable ghost piece\n";
+    std::cout << "  --quality LEVEL            Effect quality (auto, or 0=minimal to 3=full)\n";
+    std::cout << "  --target-fps FPS           Frame rate automatic quality aims for (10-240)\n";
+    std::cout << "  --show-quality             Show the effect quality level on the board\n";
+    std::cout << "  --profile FILE             Record frame timings and write a trace file at exit\n";
+    std::cout << "  --profile-overlay          Show the frame time graph (F3 toggles, F4 writes the trace)\n";
+    std::cout << "  --record FILE              Record the game area for replay_export (GTK, kiosk)\n\n";
     
     std::cout << "Audio Options:\n";
     std::cout << "  --no-sound                 Disable all sound effects\n";
@@ -41,7 +53,9 @@ void printHelp(const char* programName) {
     std::cout << "  --sound-zip ZIP            Set sound effects ZIP file\n\n";
     
     std::cout << "Special Modes:\n";
-    std::cout << "  --retro                    Enable Soviet retro mode\n\n";
+    std::cout << "  --retro                    Enable Soviet retro mode\n";
+    std::cout << "  --practice                 Practice mode (U: undo last piece)\n";
+    std::cout << "  --demo                     Attract mode: the bot plays while idle (B toggles bot)\n\n";
     
     std::cout << "Information:\n";
     std::cout << "  --help                     Show this help message\n";
@@ -91,6 +105,14 @@ ArgType getArgType(const std::string& arg) {
     if (arg == "--retro") {printf("Retro\n"); return ArgType::RETRO;}
     if (arg == "--simple-blocks") return ArgType::SIMPLE_BLOCKS;
     if (arg == "--retro-music") return ArgType::RETRO_MUSIC;
+    if (arg == "--practice") return ArgType::PRACTICE;
+    if (arg == "--demo") return ArgType::DEMO;
+    if (arg == "--quality") return ArgType::QUALITY;
+    if (arg == "--target-fps") return ArgType::TARGET_FPS;
+    if (arg == "--show-quality") return ArgType::SHOW_QUALITY;
+    if (arg == "--profile") return ArgType::PROFILE;
+    if (arg == "--profile-overlay") return ArgType::PROFILE_OVERLAY;
+    if (arg == "--record") return ArgType::RECORD;
     return ArgType::UNKNOWN;
 }
 
@@ -297,6 +319,67 @@ CommandLineArgs parseCommandLine(int argc, char* argv[]) {
             case ArgType::RETRO_MUSIC:
                 args.retroMusic = true;
                 break;
+
+            case ArgType::PRACTICE:
+                args.practiceMode = true;
+                break;
+
+            case ArgType::DEMO:
+                args.demoMode = true;
+                break;
+
+            case ArgType::QUALITY:
+                if (i + 1 < argc) {
+                    std::string value = argv[++i];
+                    if (value == "auto") {
+                        args.effectQuality = -1;
+                    } else {
+                        args.effectQuality = std::atoi(value.c_str());
+                        if (args.effectQuality < 0 || args.effectQuality > 3) {
+                            std::cerr << "Error: Quality must be auto or 0-3\n";
+                            args.effectQuality = -2;
+                        }
+                    }
+                } else {
+                    std::cerr << "Error: --quality requires a value\n";
+                }
+                break;
+
+            case ArgType::TARGET_FPS:
+                if (i + 1 < argc) {
+                    args.targetFps = std::atoi(argv[++i]);
+                    if (args.targetFps < 10 || args.targetFps > 240) {
+                        std::cerr << "Error: Target FPS must be between 10-240\n";
+                        args.targetFps = -1;
+                    }
+                } else {
+                    std::cerr << "Error: --target-fps requires a value\n";
+                }
+                break;
+
+            case ArgType::SHOW_QUALITY:
+                args.showQuality = true;
+                break;
+
+            case ArgType::PROFILE:
+                if (i + 1 < argc) {
+                    args.profileTrace = argv[++i];
+                } else {
+                    std::cerr << "Error: --profile requires a file name\n";
+                }
+                break;
+
+            case ArgType::PROFILE_OVERLAY:
+                args.profileOverlay = true;
+                break;
+
+            case ArgType::RECORD:
+                if (i + 1 < argc) {
+                    args.recordFrames = argv[++i];
+                } else {
+                    std::cerr << "Error: --record requires a file name\n";
+                }
+                break;
                 
     case ArgType::UNKNOWN:
     default:
@@ -409,6 +492,18 @@ void applyCommandLineArgs(TetrimoneApp* app, const CommandLineArgs& args) {
         ui_set_background_enabled(app, false);
     }
     
+    app->board->publishState();
+
+    if (args.practiceMode) {
+        printf("DEBUG: Enabling practice mode\n");
+        app->board->setPracticeMode(true);
+    }
+
+    if (args.demoMode) {
+        printf("DEBUG: Enabling demo mode\n");
+        enableDemoMode(app);
+    }
+    
     // Apply background settings
     if (!args.backgroundImage.empty()) {
         printf("DEBUG: Loading background image: %s\n", args.backgroundImage.c_str());
@@ -437,6 +532,37 @@ void applyCommandLineArgs(TetrimoneApp* app, const CommandLineArgs& args) {
         app->board->setBackgroundOpacity(args.backgroundOpacity);
     }
     
+    // Apply effect quality
+    if (args.targetFps != -1) {
+        printf("DEBUG: Setting target FPS to %d\n", args.targetFps);
+        qualityGovernor.setTargetFps(args.targetFps);
+    }
+    
+    if (args.effectQuality != -2) {
+        printf("DEBUG: Setting effect quality to %d\n", args.effectQuality);
+        qualityGovernor.setOverride(args.effectQuality);
+    }
+    
+    if (args.showQuality) {
+        qualityGovernor.setShowIndicator(true);
+    }
+    
+    // Apply profiling
+    if (!args.profileTrace.empty()) {
+        printf("DEBUG: Writing profile trace to %s\n", args.profileTrace.c_str());
+        profiler.setTracePath(args.profileTrace);
+        profiler.setEnabled(true);
+    }
+    
+    if (args.profileOverlay) {
+        profiler.setOverlayShown(true);
+    }
+
+    if (!args.recordFrames.empty()) {
+        printf("DEBUG: Recording the game area to %s\n", args.recordFrames.c_str());
+        frameRecorder.open(args.recordFrames);
+    }
+    
     if (!args.soundZip.empty()) {
         printf("DEBUG: Setting sound ZIP path: %s\n", args.soundZip.c_str());
         app->board->setSoundsZipPath(args.soundZip);
@@ -455,6 +581,8 @@ void applyCommandLineArgs(TetrimoneApp* app, const CommandLineArgs& args) {
     printf("DEBUG: Command line args application complete\n");
 }
 
+// Offline tools (render_bench, replay_export) link the front end and bring their own main
+#ifndef OFFLINE_TOOL
 int main(int argc, char *argv[])
 {
     CommandLineArgs args = parseCommandLine(argc, argv);
@@ -477,6 +605,8 @@ int main(int argc, char *argv[])
     std::cout << "retroMode: " << args.retroMode << "\n";
     std::cout << "simpleBlocks: " << args.simpleBlocks << "\n";
     std::cout << "retroMusic: " << args.retroMusic << "\n";
+    std::cout << "practiceMode: " << args.practiceMode << "\n";
+    std::cout << "demoMode: " << args.demoMode << "\n";
     std::cout << "fullscreen: " << args.fullscreen << "\n";
     std::cout << "help: " << args.help << "\n";
     std::cout << "version: " << args.version << "\n";
@@ -484,6 +614,12 @@ int main(int argc, char *argv[])
     std::cout << "backgroundZip: " << (args.backgroundZip.empty() ? "(empty)" : args.backgroundZip) << "\n";
     std::cout << "soundZip: " << (args.soundZip.empty() ? "(empty)" : args.soundZip) << "\n";
     std::cout << "backgroundOpacity: " << args.backgroundOpacity << "\n";
+    std::cout << "effectQuality: " << args.effectQuality << "\n";
+    std::cout << "targetFps: " << args.targetFps << "\n";
+    std::cout << "showQuality: " << args.showQuality << "\n";
+    std::cout << "profileTrace: " << (args.profileTrace.empty() ? "(empty)" : args.profileTrace) << "\n";
+    std::cout << "profileOverlay: " << args.profileOverlay << "\n";
+    std::cout << "recordFrames: " << (args.recordFrames.empty() ? "(empty)" : args.recordFrames) << "\n";
     std::cout << "====================================\n\n";
 
     if (args.help) {
@@ -533,6 +669,10 @@ int main(int argc, char *argv[])
                 case ArgType::BACKGROUND_ZIP:
                 case ArgType::BACKGROUND_OPACITY:
                 case ArgType::SOUND_ZIP:
+                case ArgType::QUALITY:
+                case ArgType::TARGET_FPS:
+                case ArgType::PROFILE:
+                case ArgType::RECORD:
                     if (i + 1 < argc) {
                         i++; // Skip the value
                     }
@@ -548,6 +688,8 @@ int main(int argc, char *argv[])
                 case ArgType::RETRO:
                 case ArgType::SIMPLE_BLOCKS:
                 case ArgType::RETRO_MUSIC:
+                case ArgType::SHOW_QUALITY:
+                case ArgType::PROFILE_OVERLAY:
                 case ArgType::HELP:
                 case ArgType::VERSION:
                     break; // Just skip this argument
@@ -570,3 +712,4 @@ int main(int argc, char *argv[])
     delete[] newArgv;
     return result;
 }
+#endif // OFFLINE_TOOL
@@ -11,6 +11,9 @@
 #include "propaganda_messages.h"
 #include "freedom_messages.h"
 #include "commandline.h"
+#include "autoplay.h"
+#include "blockatlas.h"
+#include "rendercommands.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
@@ -52,7 +55,7 @@ SDLCairoRenderer::SDLCairoRenderer(int w, int h)
     : window(nullptr), sdlRenderer(nullptr), texture(nullptr),
       cairoSurface(nullptr), cairoContext(nullptr),
       width(w), height(h), pixelFormat(SDL_PIXELFORMAT_ARGB8888),
-      pitch(0), pixelBuffer(nullptr) {}
+      pitch(0), pixelBuffer(nullptr), frameOwner(nullptr) {}
 
 bool SDLCairoRenderer::init(const char* title, Uint32 flags) {
     if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0) {
@@ -160,6 +163,21 @@ void SDLCairoRenderer::syncSurfaceToTexture() {
     SDL_UpdateTexture(texture, nullptr, pixelBuffer, pitch);
 }
 
+void SDLCairoRenderer::syncSurfaceToTexture(const std::vector<SDL_Rect>& rects) {
+    if (!texture || !pixelBuffer) return;
+    cairo_surface_flush(cairoSurface);
+    for (const SDL_Rect& rect : rects) {
+        const unsigned char* first = (const unsigned char*)pixelBuffer + rect.y * pitch + rect.x * 4;
+        SDL_UpdateTexture(texture, &rect, first, pitch);
+    }
+}
+
+bool SDLCairoRenderer::beginFrame(const void* owner) {
+    bool kept = (owner == frameOwner);
+    frameOwner = owner;
+    return kept;
+}
+
 void SDLCairoRenderer::present() {
     if (!sdlRenderer) return;
     SDL_SetRenderDrawColor(sdlRenderer, 0, 0, 0, 255);
@@ -187,6 +205,7 @@ bool SDLCairoRenderer::resize(int newWidth, int newHeight) {
         SDL_DestroyTexture(texture);
         texture = nullptr;
     }
+    frameOwner = nullptr;
 
     width = newWidth;
     height = newHeight;
@@ -278,6 +297,54 @@ SDLCairoRenderer::~SDLCairoRenderer() {
     cleanup();
 }
 
+// ============================================================================
+// CairoFrameBuffer Implementation
+// ============================================================================
+
+bool CairoFrameBuffer::ensure(int w, int h) {
+    if (context && image.width() == w && image.height() == h) {
+        return false;
+    }
+    release();
+
+    image = QImage(w, h, QImage::Format_ARGB32_Premultiplied);
+    if (image.isNull()) {
+        std::cerr << "Failed to allocate " << w << "x" << h << " frame buffer" << std::endl;
+        return true;
+    }
+
+    surface = cairo_image_surface_create_for_data(
+        image.bits(),
+        CAIRO_FORMAT_ARGB32,
+        w, h,
+        image.bytesPerLine()
+    );
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+        std::cerr << "Failed to create cairo surface for frame buffer" << std::endl;
+        release();
+        return true;
+    }
+
+    context = cairo_create(surface);
+    if (cairo_status(context) != CAIRO_STATUS_SUCCESS) {
+        std::cerr << "Failed to create cairo context for frame buffer" << std::endl;
+        release();
+    }
+    return true;
+}
+
+void CairoFrameBuffer::release() {
+    if (context) {
+        cairo_destroy(context);
+        context = nullptr;
+    }
+    if (surface) {
+        cairo_surface_destroy(surface);
+        surface = nullptr;
+    }
+    image = QImage();
+}
+
 // ============================================================================
 // Global variables for key repeat handling
 // ============================================================================
@@ -322,110 +389,24 @@ LineClearAnimValues getLineClearAnimationValues(int animationType, double progre
 std::array<double, 3> getHeatModifiedColor(const std::array<double, 3>& baseColor, float heatLevel);
 
 // ============================================================================
-// Implementation of drawPlacedBlocks (locked/placed blocks with animations)
+// Game area layers from the shared frame builder
 // ============================================================================
 
-void drawPlacedBlocks(cairo_t *cr, TetrimoneBoard *board, TetrimoneApp *app) {
-  for (int y = 0; y < GRID_HEIGHT; ++y) {
-    for (int x = 0; x < GRID_WIDTH; ++x) {
-      int value = board->getGridValue(x, y);
-      if (value > 0) {
-        double alpha = 1.0;
-        double scale = 1.0;
-        double offsetX = 0.0;
-        double offsetY = 0.0;
-        
-        if (board->isLineClearActive() && board->isLineBeingCleared(y)) {
-          double progress = board->getLineClearProgress();
-          
-          if (board->retroModeActive) {
-            if (progress < 0.3) {
-              double scanProgress = progress / 0.3;
-              int scanX = (int)(scanProgress * GRID_WIDTH);
-              if (x <= scanX) {
-                alpha = 0.3 + 0.4 * sin(progress * 20.0);
-              } else {
-                alpha = 1.0;
-              }
-              scale = 1.0;
-            } else if (progress < 0.7) {
-              double flashProgress = (progress - 0.3) / 0.4;
-              alpha = 1.0 - flashProgress * 0.7;
-              scale = 1.0;
-              offsetY = flashProgress * BLOCK_SIZE * 0.3;
-            } else {
-              double wipeProgress = (progress - 0.7) / 0.3;
-              int segment = x / 3;
-              double segmentDelay = segment * 0.2;
-              
-              if (wipeProgress > segmentDelay) {
-                alpha = 0.0;
-                scale = 0.0;
-              } else {
-                alpha = 1.0 - wipeProgress * 0.5;
-                scale = 1.0;
-              }
-            }
-          } else {
-            int animationType = board->getCurrentAnimationType();
-            LineClearAnimValues animValues = getLineClearAnimationValues(animationType, progress, x, y);
-            alpha = animValues.alpha;
-            scale = animValues.scale;
-            offsetX = animValues.offsetX;
-            offsetY = animValues.offsetY;
-          }
-        }
-
-        auto baseColor = board->isInThemeTransition() ? 
-        board->getInterpolatedColor(value - 1, board->getThemeTransitionProgress()) :
-        TETRIMONEBLOCK_COLOR_THEMES[currentThemeIndex][value - 1];
-        auto color = getHeatModifiedColor(baseColor, board->getHeatLevel());
-
-        cairo_set_source_rgba(cr, color[0], color[1], color[2], alpha);
-
-        double drawX = x * BLOCK_SIZE + offsetX + (BLOCK_SIZE * (1.0 - scale)) / 2;
-        double drawY = y * BLOCK_SIZE + offsetY + (BLOCK_SIZE * (1.0 - scale)) / 2;
-        double drawSize = BLOCK_SIZE * scale;
-
-        if (board->retroModeActive || board->simpleBlocksActive) {
-          cairo_rectangle(cr, drawX, drawY, drawSize, drawSize);
-          cairo_fill(cr);
-        } else {
-          cairo_rectangle(cr, drawX + 1, drawY + 1, drawSize - 2, drawSize - 2);
-          cairo_fill(cr);
-
-          cairo_set_source_rgba(cr, 1, 1, 1, 0.3 * alpha);
-          cairo_move_to(cr, drawX + 1, drawY + 1);
-          cairo_line_to(cr, drawX + drawSize - 1, drawY + 1);
-          cairo_line_to(cr, drawX + 1, drawY + drawSize - 1);
-          cairo_close_path(cr);
-          cairo_fill(cr);
-
-          cairo_set_source_rgba(cr, 0, 0, 0, 0.3 * alpha);
-          cairo_move_to(cr, drawX + drawSize - 1, drawY + 1);
-          cairo_line_to(cr, drawX + drawSize - 1, drawY + drawSize - 1);
-          cairo_line_to(cr, drawX + 1, drawY + drawSize - 1);
-          cairo_close_path(cr);
-          cairo_fill(cr);
-        }
-        
-        if (!board->retroModeActive) {
-          float heatLevel = board->getHeatLevel();
-          auto now = std::chrono::high_resolution_clock::now();
-          auto timeMs = std::chrono::duration<double, std::milli>(
-              now.time_since_epoch()).count();
-          
-          if (heatLevel > 0.7f) {
-            drawFireyGlow(cr, drawX, drawY, drawSize, heatLevel, timeMs);
-          }
-          
-          if (heatLevel < 0.3f) {
-            drawFreezyEffect(cr, drawX, drawY, drawSize, heatLevel, timeMs);
-          }
-        }   
-      }
-    }
+// Blocks, overlays and effects come from one command list, in the same
+// order as the GTK game area and the kiosk
+static void drawGameLayers(cairo_t *cr, TetrimoneApp *app) {
+  TetrimoneBoard *board = app->board;
+  RenderCommandList &commands = app->frameCommands;
+  buildFrameCommands(board, commands);
+
+  drawGridLines(cr, board);
+  executeCommands(cr, commands, RenderCommand::LAYER_BOARD, RenderCommand::LAYER_BOARD);
+  if (board->isSplashScreenActive()) {
+    drawSplashScreen(cr, board, app);
+    return;
   }
+  drawPropagandaMessage(cr, board);
+  executeCommands(cr, commands, RenderCommand::LAYER_PIECE, RenderCommand::LAYER_TRAILS);
 }
 
 // ============================================================================
@@ -459,6 +440,9 @@ protected:
         
         if (w <= 0 || h <= 0) return;
         
+        QualityGovernor::Frame frame(qualityGovernor);
+        Profiler::Frame profile;
+        
         // Calculate scaling factor - make blocks fill the HEIGHT (22 blocks)
         int blockSize = h / 22;  // Fill the full height with 22 blocks
         
@@ -466,116 +450,108 @@ protected:
         
         // Use GPU renderer if available
         if (app->sdlCairoRenderer) {
-            cairo_t* cr = app->sdlCairoRenderer->getCairoContext();
+            SDLCairoRenderer* renderer = app->sdlCairoRenderer;
+            cairo_t* cr = renderer->getCairoContext();
+            if (!cr) return;
             
-            // Draw background image with transition support
-            if (board->useBackgroundImage && board->getBackgroundImage() != nullptr) {
-                cairo_surface_t* bgImage = (cairo_surface_t*)board->getBackgroundImage();
-                
-                // Draw old background during transition (fade out)
-                if (board->isInBackgroundTransition() && board->getOldBackground() != nullptr) {
-                    cairo_surface_t* oldBg = (cairo_surface_t*)board->getOldBackground();
-                    cairo_set_source_surface(cr, oldBg, 0, 0);
-                    cairo_paint_with_alpha(cr, board->getTransitionOpacity());
-                    
-                    // Draw new background on top (fade in)
-                    cairo_set_source_surface(cr, bgImage, 0, 0);
-                    cairo_paint_with_alpha(cr, 1.0 - board->getTransitionOpacity());
-                } else {
-                    // Normal drawing without transition
-                    cairo_set_source_surface(cr, bgImage, 0, 0);
-                    cairo_paint(cr);
-                }
-            } else {
-                // Fallback to black background
-                app->sdlCairoRenderer->clearCairoSurface(0, 0, 0, 1.0);
-            }
-            
-            if (cr) {
-                cairo_scale(cr, scale, scale);
-                
-                drawGridLines(cr, board);
-                drawPlacedBlocks(cr, board, app);
-                drawCurrentPiece(cr, board);
-                drawGhostPiece(cr, board);
-                drawBlockTrails(cr, board);
-                drawGameOver(cr, board);
-                drawPauseMenu(cr, board);
-                if (board->isSplashScreenActive()) {
-                    drawSplashScreen(cr, board, app);
-                }
-                drawFireworks(cr, board, app);
-                drawPropagandaMessage(cr, board);
-                
-                app->sdlCairoRenderer->syncSurfaceToTexture();
-                app->sdlCairoRenderer->present();
+            // The next piece preview draws into the same surface
+            bool kept = renderer->beginFrame(this);
+            bool partial = collectDamage(kept, scale, renderer->getWidth(), renderer->getHeight());
+            if (!partial) {
+                drawFrame(cr, false, scale, w, h);
+                renderer->syncSurfaceToTexture();
+            } else if (!damageRects.empty()) {
+                drawFrame(cr, true, scale, w, h);
+                renderer->syncSurfaceToTexture(damageRects);
             }
+            renderer->present();
         } else {
-            // Fallback: CPU rendering with Qt
-            SDL_Surface* surface = SDL_CreateRGBSurface(0, w, h, 32,
-                0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+            // Fallback: CPU rendering into a buffer Qt can paint directly
+            bool kept = !frameBuffer.ensure(w, h);
+            if (!frameBuffer.isValid()) return;
             
-            if (!surface) return;
-            
-            cairo_surface_t* cairo_surface = cairo_image_surface_create_for_data(
-                (unsigned char*)surface->pixels,
-                CAIRO_FORMAT_ARGB32,
-                w, h,
-                surface->pitch
-            );
+            bool partial = collectDamage(kept, scale, w, h);
+            if (!partial || !damageRects.empty()) {
+                drawFrame(frameBuffer.getContext(), partial, scale, w, h);
+                cairo_surface_flush(cairo_get_target(frameBuffer.getContext()));
+            }
             
-            cairo_t* cr = cairo_create(cairo_surface);
+            QPainter painter(this);
+            painter.drawImage(0, 0, frameBuffer.getImage());
+        }
+        
+        app->damage.painted(board);
+        paintedScale = scale;
+        
+        (void)event;
+    }
+
+    // Fill damageRects with the surface pixels that changed since the last
+    // paint. Returns false when the whole frame has to be drawn.
+    bool collectDamage(bool kept, double scale, int surfaceWidth, int surfaceHeight) {
+        damageRects.clear();
+        if (!kept || scale != paintedScale) {
+            return false;
+        }
+        if (!app->damage.collect(board, (int)std::ceil(surfaceWidth / scale))) {
+            return false;
+        }
+        
+        for (const DamageTracker::Rect& rect : app->damage.getRects()) {
+            int x0 = std::max(0, (int)std::floor(rect.x * scale));
+            int y0 = std::max(0, (int)std::floor(rect.y * scale));
+            int x1 = std::min(surfaceWidth, (int)std::ceil((rect.x + rect.width) * scale));
+            int y1 = std::min(surfaceHeight, (int)std::ceil((rect.y + rect.height) * scale));
+            if (x1 > x0 && y1 > y0) {
+                damageRects.push_back({x0, y0, x1 - x0, y1 - y0});
+            }
+        }
+        return true;
+    }
+
+    // Draw the game area; with partial set, only inside damageRects
+    void drawFrame(cairo_t* cr, bool partial, double scale, int w, int h) {
+        cairo_save(cr);
+        if (partial) {
+            for (const SDL_Rect& rect : damageRects) {
+                cairo_rectangle(cr, rect.x, rect.y, rect.w, rect.h);
+            }
+            cairo_clip(cr);
+        }
+        
+        // Draw background image with transition support
+        if (board->useBackgroundImage && board->getBackgroundImage() != nullptr &&
+            qualityGovernor.budget().backgroundImage) {
+            cairo_surface_t* bgImage = (cairo_surface_t*)board->getBackgroundImage();
             
-            // Draw background image with transition support
-            if (board->useBackgroundImage && board->getBackgroundImage() != nullptr) {
-                cairo_surface_t* bgImage = (cairo_surface_t*)board->getBackgroundImage();
+            // Draw old background during transition (fade out)
+            if (board->isInBackgroundTransition() && board->getOldBackground() != nullptr) {
+                cairo_surface_t* oldBg = (cairo_surface_t*)board->getOldBackground();
+                cairo_set_source_surface(cr, oldBg, 0, 0);
+                cairo_paint_with_alpha(cr, board->getTransitionOpacity());
                 
-                // Draw old background during transition (fade out)
-                if (board->isInBackgroundTransition() && board->getOldBackground() != nullptr) {
-                    cairo_surface_t* oldBg = (cairo_surface_t*)board->getOldBackground();
-                    cairo_set_source_surface(cr, oldBg, 0, 0);
-                    cairo_paint_with_alpha(cr, board->getTransitionOpacity());
-                    
-                    // Draw new background on top (fade in)
-                    cairo_set_source_surface(cr, bgImage, 0, 0);
-                    cairo_paint_with_alpha(cr, 1.0 - board->getTransitionOpacity());
-                } else {
-                    // Normal drawing without transition
-                    cairo_set_source_surface(cr, bgImage, 0, 0);
-                    cairo_paint(cr);
-                }
+                // Draw new background on top (fade in)
+                cairo_set_source_surface(cr, bgImage, 0, 0);
+                cairo_paint_with_alpha(cr, 1.0 - board->getTransitionOpacity());
             } else {
-                // Fallback to black background
-                cairo_set_source_rgb(cr, 0, 0, 0);
-                cairo_rectangle(cr, 0, 0, w, h);
-                cairo_fill(cr);
+                // Normal drawing without transition
+                cairo_set_source_surface(cr, bgImage, 0, 0);
+                cairo_paint(cr);
             }
-            
-            cairo_scale(cr, scale, scale);
-            
-            drawGridLines(cr, board);
-            drawPlacedBlocks(cr, board, app);
-            drawCurrentPiece(cr, board);
-            drawGhostPiece(cr, board);
-            drawBlockTrails(cr, board);
-            drawGameOver(cr, board);
-            drawPauseMenu(cr, board);
-            if (board->isSplashScreenActive()) {
-                drawSplashScreen(cr, board, app);
-            }
-            drawFireworks(cr, board, app);
-            drawPropagandaMessage(cr, board);
-            
-            QImage img((uchar*)surface->pixels, w, h, surface->pitch, QImage::Format_ARGB32);
-            QPainter painter(this);
-            painter.drawImage(0, 0, img);
-            
-            cairo_destroy(cr);
-            cairo_surface_destroy(cairo_surface);
-            SDL_FreeSurface(surface);
+        } else {
+            // Fallback to black background
+            cairo_set_source_rgb(cr, 0, 0, 0);
+            cairo_paint(cr);
         }
         
-        (void)event;
+        cairo_scale(cr, scale, scale);
+        
+        drawGameLayers(cr, app);
+        
+        cairo_identity_matrix(cr);
+        qualityGovernor.drawIndicator(cr);
+        profiler.drawOverlay(cr, w, h);
+        cairo_restore(cr);
     }
 
     void resizeEvent(QResizeEvent* event) override {
@@ -589,6 +565,11 @@ protected:
             return;
         }
         
+        // Any key ends a demo game and returns to the splash screen
+        if (autoPlayHandleInput(app)) {
+            return;
+        }
+        
         int key = event->key();
         
         if (key == Qt::Key_Down || key == Qt::Key_S) {
@@ -671,6 +652,48 @@ protected:
                 app->window->setWindowTitle("Tetrimone");
             }
             updateDisplay(app);
+        } else if (key == Qt::Key_B) {
+            // Toggle the built-in bot
+            if (!board->isSplashScreenActive() && !board->isGameOver()) {
+                if (isAutoPlayActive(app)) {
+                    stopAutoPlay(app);
+                } else {
+                    startAutoPlay(app);
+                }
+            }
+        } else if (key == Qt::Key_U) {
+            // Practice mode: take back the last placed piece
+            if (board->isPracticeMode() && !board->isSplashScreenActive()) {
+                board->undoLastPiece();
+            }
+            updateDisplay(app);
+        } else if (key == Qt::Key_F3) {
+            // Frame time overlay
+            profiler.setOverlayShown(!profiler.isOverlayShown());
+            updateDisplay(app);
+        } else if (key == Qt::Key_F4) {
+            // Write the profile trace recorded so far
+            if (profiler.isEnabled()) {
+                std::string path = profiler.exportPath();
+                if (profiler.exportTrace(path)) {
+                    std::cout << "Profile trace written to " << path << std::endl;
+                }
+            }
+        } else if (key == Qt::Key_F5) {
+            // Quick save
+            if (!board->isSplashScreenActive() && !board->isGameOver()) {
+                if (board->saveGameState(TetrimoneBoard::getSaveStatePath())) {
+                    std::cout << "Game state saved" << std::endl;
+                }
+            }
+        } else if (key == Qt::Key_F9) {
+            // Quick resume
+            if (!board->isSplashScreenActive()) {
+                if (board->loadGameState(TetrimoneBoard::getSaveStatePath())) {
+                    std::cout << "Game state restored" << std::endl;
+                }
+            }
+            updateDisplay(app);
         } else if (key == Qt::Key_Escape) {
             if (board->isSplashScreenActive()) {
                 board->setSplashScreenActive(false);
@@ -713,6 +736,9 @@ private:
     TetrimoneBoard* board;
     TetrimoneApp* app;
     QPixmap* backgroundPixmap;
+    CairoFrameBuffer frameBuffer;       // CPU rendering target, reused while the size holds
+    std::vector<SDL_Rect> damageRects;  // Surface pixels to redraw this frame
+    double paintedScale = 0.0;          // Scale of the frame the buffers hold
 };
 
 // ============================================================================
@@ -736,6 +762,7 @@ protected:
         
         // Use GPU renderer if available
         if (app && app->sdlCairoRenderer) {
+            app->sdlCairoRenderer->beginFrame(this);
             app->sdlCairoRenderer->clearCairoSurface(0.15, 0.15, 0.2, 1.0);
             cairo_t* cr = app->sdlCairoRenderer->getCairoContext();
             
@@ -751,6 +778,7 @@ protected:
             int blockSize = 15;
             int previewX = 25;
             
+            const ThemePalette& palette = board->getPalette();
             int validPieceCount = 0;
             for (int pieceIndex = 0; pieceIndex < 3; pieceIndex++) {
                 const TetrimoneBlock* nextBlock = board->getNextPiece(pieceIndex);
@@ -777,7 +805,7 @@ protected:
                             int px = previewX + col * blockSize;
                             int py = previewY + row * blockSize;
                             
-                            std::array<double, 3> color = getTetrimineColor(nextType);
+                            const ThemePalette::Color& color = palette.color(nextType);
                             
                             // Main block
                             cairo_set_source_rgb(cr, color[0], color[1], color[2]);
@@ -785,7 +813,7 @@ protected:
                             cairo_fill(cr);
                             
                             // 3D highlight
-                            cairo_set_source_rgba(cr, 1, 1, 1, 0.3);
+                            cairo_set_source_rgb(cr, palette.highlight(nextType)[0], palette.highlight(nextType)[1], palette.highlight(nextType)[2]);
                             cairo_move_to(cr, px + 1, py + 1);
                             cairo_line_to(cr, px + blockSize - 1, py + 1);
                             cairo_line_to(cr, px + 1, py + blockSize - 1);
@@ -793,7 +821,7 @@ protected:
                             cairo_fill(cr);
                             
                             // 3D shadow
-                            cairo_set_source_rgba(cr, 0, 0, 0, 0.3);
+                            cairo_set_source_rgb(cr, palette.shadow(nextType)[0], palette.shadow(nextType)[1], palette.shadow(nextType)[2]);
                             cairo_move_to(cr, px + blockSize - 1, py + 1);
                             cairo_line_to(cr, px + blockSize - 1, py + blockSize - 1);
                             cairo_line_to(cr, px + 1, py + blockSize - 1);
@@ -809,19 +837,10 @@ protected:
             app->sdlCairoRenderer->present();
         } else {
             // Fallback: Qt rendering
-            SDL_Surface* surface = SDL_CreateRGBSurface(0, w, h, 32,
-                0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
-            
-            if (!surface) return;
-            
-            cairo_surface_t* cairo_surface = cairo_image_surface_create_for_data(
-                (unsigned char*)surface->pixels,
-                CAIRO_FORMAT_ARGB32,
-                w, h,
-                surface->pitch
-            );
+            frameBuffer.ensure(w, h);
+            if (!frameBuffer.isValid()) return;
             
-            cairo_t* cr = cairo_create(cairo_surface);
+            cairo_t* cr = frameBuffer.getContext();
             
             cairo_set_source_rgb(cr, 0.15, 0.15, 0.2);
             cairo_rectangle(cr, 0, 0, w, h);
@@ -838,6 +857,7 @@ protected:
             int blockSize = 15;
             int previewX = 25;
             
+            const ThemePalette& palette = board->getPalette();
             int validPieceCount = 0;
             for (int pieceIndex = 0; pieceIndex < 3; pieceIndex++) {
                 const TetrimoneBlock* nextBlock = board->getNextPiece(pieceIndex);
@@ -862,20 +882,20 @@ protected:
                             int px = previewX + col * blockSize;
                             int py = previewY + row * blockSize;
                             
-                            std::array<double, 3> color = getTetrimineColor(nextType);
+                            const ThemePalette::Color& color = palette.color(nextType);
                             
                             cairo_set_source_rgb(cr, color[0], color[1], color[2]);
                             cairo_rectangle(cr, px + 1, py + 1, blockSize - 2, blockSize - 2);
                             cairo_fill(cr);
                             
-                            cairo_set_source_rgba(cr, 1, 1, 1, 0.3);
+                            cairo_set_source_rgb(cr, palette.highlight(nextType)[0], palette.highlight(nextType)[1], palette.highlight(nextType)[2]);
                             cairo_move_to(cr, px + 1, py + 1);
                             cairo_line_to(cr, px + blockSize - 1, py + 1);
                             cairo_line_to(cr, px + 1, py + blockSize - 1);
                             cairo_close_path(cr);
                             cairo_fill(cr);
                             
-                            cairo_set_source_rgba(cr, 0, 0, 0, 0.3);
+                            cairo_set_source_rgb(cr, palette.shadow(nextType)[0], palette.shadow(nextType)[1], palette.shadow(nextType)[2]);
                             cairo_move_to(cr, px + blockSize - 1, py + 1);
                             cairo_line_to(cr, px + blockSize - 1, py + blockSize - 1);
                             cairo_line_to(cr, px + 1, py + blockSize - 1);
@@ -887,13 +907,9 @@ protected:
                 validPieceCount++;
             }
             
-            QImage img((uchar*)surface->pixels, w, h, surface->pitch, QImage::Format_ARGB32);
+            cairo_surface_flush(cairo_get_target(cr));
             QPainter painter(this);
-            painter.drawImage(0, 0, img);
-            
-            cairo_destroy(cr);
-            cairo_surface_destroy(cairo_surface);
-            SDL_FreeSurface(surface);
+            painter.drawImage(0, 0, frameBuffer.getImage());
         }
         
         (void)event;
@@ -902,19 +918,7 @@ protected:
 private:
     TetrimoneBoard* board;
     TetrimoneApp* app;
-
-    std::array<double, 3> getTetrimineColor(int type) {
-        const std::array<double, 3> colors[] = {
-            {0.0, 1.0, 1.0},
-            {1.0, 1.0, 0.0},
-            {1.0, 0.0, 1.0},
-            {0.0, 1.0, 0.0},
-            {1.0, 0.0, 0.0},
-            {0.0, 0.0, 1.0},
-            {1.0, 0.5, 0.0}
-        };
-        return colors[std::min(type - 1, 6)];
-    }
+    CairoFrameBuffer frameBuffer;
 };
 
 // ============================================================================
@@ -1282,6 +1286,9 @@ void updateLabels(TetrimoneApp* app) {
 }
 
 void updateDisplay(TetrimoneApp* app) {
+    if (app && app->board) {
+        app->board->publishState();
+    }
     if (app && app->gameArea) {
         app->gameArea->update();
     }
@@ -1372,6 +1379,7 @@ void onQuitGameAction(TetrimoneApp* app) {
 void onSoundToggleAction(TetrimoneApp* app, bool enabled) {
     if (app->board) {
         app->board->setSoundEnabled(enabled);
+        app->board->publishState();
         std::cout << (enabled ? "✓ Sound enabled" : "✓ Sound disabled") << std::endl;
     }
 }
@@ -1455,20 +1463,11 @@ void shutdownGPURenderer(TetrimoneApp* app) {
 void renderFrameGPU(TetrimoneApp* app) {
     if (!app || !app->sdlCairoRenderer || !app->board) return;
     
+    app->sdlCairoRenderer->beginFrame(app);
     app->sdlCairoRenderer->clearCairoSurface(0, 0, 0, 1.0);
     cairo_t* cr = app->sdlCairoRenderer->getCairoContext();
     
-    drawGridLines(cr, app->board);
-    drawPlacedBlocks(cr, app->board, app);
-    drawCurrentPiece(cr, app->board);
-    drawGhostPiece(cr, app->board);
-    drawBlockTrails(cr, app->board);
-    drawGameOver(cr, app->board);
-    drawPauseMenu(cr, app->board);
-    if (app->board->isSplashScreenActive()) {
-        drawSplashScreen(cr, app->board, app);
-    }
-    drawFireworks(cr, app->board, app);
+    drawGameLayers(cr, app);
     
     app->sdlCairoRenderer->syncSurfaceToTexture();
     app->sdlCairoRenderer->present();
@@ -2141,6 +2140,7 @@ void onSimpleBlocksToggled(TetrimoneApp* app, bool enabled) {
 void onRetroMusicToggled(TetrimoneApp* app, bool enabled) {
     if (app->board) {
         app->board->retroMusicActive = enabled;
+        app->board->publishState();
     }
 }
 
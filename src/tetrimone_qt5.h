@@ -9,13 +9,18 @@
 #include <QAction>
 #include <QActionGroup>
 #include <QTimer>
+#include <QImage>
 #include <SDL2/SDL.h>
 #include <cairo/cairo.h>
+#include <vector>
 #include "audiomanager.h"
 #include "tetrimone_core.h"
+#include "damage.h"
+#include "rendercommands.h"
 
 // Forward declarations
 struct TetrimoneApp;
+class AutoPlayer;
 class GameAreaWidget;
 class NextPieceWidget;
 
@@ -34,6 +39,7 @@ private:
     Uint32 pixelFormat;
     int pitch;
     void* pixelBuffer;
+    const void* frameOwner;     // Widget whose frame the surface and texture hold
 
 public:
     SDLCairoRenderer(int w, int h);
@@ -44,6 +50,18 @@ public:
     cairo_surface_t* getCairoSurface() { return cairoSurface; }
     void clearCairoSurface(double r, double g, double b, double a = 1.0);
     void syncSurfaceToTexture();
+    
+    /** Upload only the given rectangles of the surface to the texture */
+    void syncSurfaceToTexture(const std::vector<SDL_Rect>& rects);
+    
+    /**
+     * Start a frame for one of the widgets sharing the renderer.
+     * @param owner Widget drawing the frame
+     * @return true if the surface and texture still hold that widget's
+     *         last frame, so only its damaged areas need drawing
+     */
+    bool beginFrame(const void* owner);
+    
     void present();
     bool resize(int newWidth, int newHeight);
     int getWidth() const { return width; }
@@ -55,6 +73,41 @@ public:
     void cleanup();
 };
 
+// ============================================================================
+// Reusable Cairo Frame Buffer for CPU Rendering
+// ============================================================================
+
+/**
+ * A Cairo surface drawn straight into a QImage's pixels, kept from frame
+ * to frame. Cairo's ARGB32 is premultiplied native-endian 32-bit, the same
+ * layout as QImage::Format_ARGB32_Premultiplied, so QPainter takes the
+ * image as it is without a conversion or copy.
+ */
+class CairoFrameBuffer {
+public:
+    CairoFrameBuffer() : surface(nullptr), context(nullptr) {}
+    ~CairoFrameBuffer() { release(); }
+    
+    /**
+     * Match the buffer to the widget size.
+     * @return true if it was (re)created and no longer holds the last frame
+     */
+    bool ensure(int w, int h);
+    void release();
+    
+    bool isValid() const { return context != nullptr; }
+    cairo_t* getContext() { return context; }
+    const QImage& getImage() const { return image; }
+
+private:
+    QImage image;
+    cairo_surface_t* surface;
+    cairo_t* context;
+    
+    CairoFrameBuffer(const CairoFrameBuffer&) = delete;
+    CairoFrameBuffer& operator=(const CairoFrameBuffer&) = delete;
+};
+
 // ============================================================================
 // Qt5-specific TetrimoneApp structure
 // ============================================================================
@@ -144,6 +197,17 @@ struct TetrimoneApp {
     // GPU-accelerated SDL/Cairo renderer
     SDLCairoRenderer* sdlCairoRenderer = nullptr;
     bool useGPUAcceleration = true;
+
+    // Parts of the game area changed since it was last painted
+    DamageTracker damage;
+    RenderCommandList frameCommands;        // Game area layers, rebuilt each frame
+
+    // Built-in bot and attract mode
+    AutoPlayer*   autoPlayer = nullptr;
+    QTimer*       autoplayTimer = nullptr;
+    bool          autoPlayActive = false;
+    bool          demoMode = false;
+    std::chrono::steady_clock::time_point lastInputTime;
 };
 
 // ============================================================================
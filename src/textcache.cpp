@@ -0,0 +1,86 @@
+// ============================================================================
+// Overlay Text Cache for the Cairo renderer (Framework-Agnostic)
+// ============================================================================
+
+#include "textcache.h"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+TextCache textCache;
+
+void TextCache::clear() {
+  for (auto &item : entries) {
+    if (item.second.mask) {
+      cairo_surface_destroy(item.second.mask);
+    }
+  }
+  entries.clear();
+}
+
+const TextCache::Entry &TextCache::get(cairo_t *cr, const std::string &text, const char *family,
+                                       cairo_font_weight_t weight, double size) {
+  double sx = 1.0, sy = 1.0;
+  cairo_user_to_device_distance(cr, &sx, &sy);
+  double pixelScale = std::round(std::fabs(sx) * 100.0) / 100.0;
+  if (pixelScale <= 0.0) pixelScale = 1.0;
+
+  char params[64];
+  snprintf(params, sizeof(params), "|%d|%.2f|%.2f", (int)weight, size, pixelScale);
+  std::string key = text + "|" + family + params;
+
+  auto found = entries.find(key);
+  if (found != entries.end()) {
+    return found->second;
+  }
+
+  if (entries.size() >= MAX_ENTRIES) {
+    clear();
+  }
+
+  Entry &entry = entries[key];
+
+  // Measure with a scratch context so the caller's state is left alone
+  cairo_surface_t *scratch = cairo_image_surface_create(CAIRO_FORMAT_A8, 1, 1);
+  cairo_t *measure = cairo_create(scratch);
+  cairo_select_font_face(measure, family, CAIRO_FONT_SLANT_NORMAL, weight);
+  cairo_set_font_size(measure, size);
+  cairo_text_extents(measure, text.c_str(), &entry.extents);
+  cairo_destroy(measure);
+  cairo_surface_destroy(scratch);
+
+  entry.maskX = std::floor(entry.extents.x_bearing) - PAD;
+  entry.maskY = std::floor(entry.extents.y_bearing) - PAD;
+  double width = std::ceil(entry.extents.x_bearing + entry.extents.width) + PAD - entry.maskX;
+  double height = std::ceil(entry.extents.y_bearing + entry.extents.height) + PAD - entry.maskY;
+  if (text.empty() || width <= 0 || height <= 0) {
+    return entry;
+  }
+
+  entry.mask = cairo_image_surface_create(CAIRO_FORMAT_A8,
+                                          (int)std::ceil(width * pixelScale),
+                                          (int)std::ceil(height * pixelScale));
+  if (cairo_surface_status(entry.mask) != CAIRO_STATUS_SUCCESS) {
+    std::cerr << "Failed to create text cache surface" << std::endl;
+    cairo_surface_destroy(entry.mask);
+    entry.mask = nullptr;
+    return entry;
+  }
+  cairo_surface_set_device_scale(entry.mask, pixelScale, pixelScale);
+
+  cairo_t *textCr = cairo_create(entry.mask);
+  cairo_select_font_face(textCr, family, CAIRO_FONT_SLANT_NORMAL, weight);
+  cairo_set_font_size(textCr, size);
+  cairo_set_source_rgba(textCr, 0, 0, 0, 1);
+  cairo_move_to(textCr, -entry.maskX, -entry.maskY);
+  cairo_show_text(textCr, text.c_str());
+  cairo_destroy(textCr);
+  cairo_surface_flush(entry.mask);
+
+  return entry;
+}
+
+void TextCache::show(cairo_t *cr, const Entry &entry, double x, double y) {
+  if (!entry.mask) return;
+  cairo_mask_surface(cr, entry.mask, x + entry.maskX, y + entry.maskY);
+}
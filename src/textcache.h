@@ -0,0 +1,57 @@
+#ifndef TEXTCACHE_H
+#define TEXTCACHE_H
+
+#include <cairo/cairo.h>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Pre-rasterized overlay text for the Cairo renderer.
+ *
+ * Each string is measured and rasterized once per font, size and device
+ * scale into an alpha mask. Drawing it is then a single mask composite
+ * in the current source colour, with no font selection, shaping or
+ * extents query on the frame.
+ */
+class TextCache {
+public:
+    struct Entry {
+        cairo_surface_t *mask = nullptr;
+        cairo_text_extents_t extents;    // Same values cairo_text_extents() reports
+        double maskX = 0.0, maskY = 0.0; // Mask top-left relative to the text origin
+    };
+
+    TextCache() {}
+    ~TextCache() { clear(); }
+
+    /**
+     * Look up (or rasterize) a string. The entry stays valid until the
+     * next get(), which may flush the cache, so draw it before asking for
+     * another string.
+     * @param cr Context the text will be drawn to (used for its device scale)
+     * @param text UTF-8 string
+     * @param family Font family, e.g. "Sans"
+     * @param weight Font weight
+     * @param size Font size in user units
+     */
+    const Entry &get(cairo_t *cr, const std::string &text, const char *family,
+                     cairo_font_weight_t weight, double size);
+
+    /**
+     * Draw cached text with its origin (baseline start) at (x, y) in the
+     * current source colour, like cairo_move_to() plus cairo_show_text().
+     */
+    static void show(cairo_t *cr, const Entry &entry, double x, double y);
+
+    void clear();
+
+private:
+    static const size_t MAX_ENTRIES = 128;   // Flushed wholesale when exceeded
+    static const int PAD = 2;                // Antialiasing room around the ink
+
+    std::unordered_map<std::string, Entry> entries;
+};
+
+extern TextCache textCache;
+
+#endif // TEXTCACHE_H
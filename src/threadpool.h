@@ -0,0 +1,116 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Small persistent worker pool for fork/join loops.
+ *
+ * parallelFor() hands out task indices from a shared counter; the calling
+ * thread works as worker 0 alongside the pool threads and returns once
+ * every task has run. Threads are created once and sleep between calls,
+ * so a per-frame job does not pay for thread start-up.
+ */
+class ThreadPool {
+public:
+    typedef std::function<void(int task, int worker)> Job;
+
+    /**
+     * @param threadCount Total workers including the caller; values below 1 mean 1
+     */
+    explicit ThreadPool(int threadCount) {
+        for (int i = 1; i < threadCount; ++i) {
+            threads.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return (int)threads.size() + 1; }
+
+    /**
+     * Run job(task, worker) for every task in [0, count).
+     * worker is in [0, size()) and is stable for the duration of one task,
+     * so it can index per-worker scratch space.
+     */
+    void parallelFor(int count, const Job& fn) {
+        if (count <= 0) return;
+        if (threads.empty() || count == 1) {
+            for (int t = 0; t < count; ++t) fn(t, 0);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            taskCount = count;
+            nextTask.store(0, std::memory_order_relaxed);
+            busy = (int)threads.size();
+            generation++;
+        }
+        wake.notify_all();
+
+        runTasks(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return busy == 0; });
+        job = nullptr;
+    }
+
+private:
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    const Job* job = nullptr;
+    int taskCount = 0;
+    std::atomic<int> nextTask{0};
+    int busy = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+
+    void runTasks(int worker) {
+        int t;
+        while ((t = nextTask.fetch_add(1, std::memory_order_relaxed)) < taskCount) {
+            (*job)(t, worker);
+        }
+    }
+
+    void workerLoop(int worker) {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]() { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+
+            runTasks(worker);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busy == 0) {
+                done.notify_one();
+            }
+        }
+    }
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,61 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Hands the latest value from one writer thread to one reader thread
+ * without locks. Neither side ever waits for the other.
+ *
+ * There are three slots: the writer fills its back slot and publish()
+ * swaps it with the middle one; the reader's refresh() swaps its front
+ * slot with the middle one if something new was published since. A
+ * value the reader never picked up is simply overwritten, so the reader
+ * always sees the newest complete value and never a half-written one.
+ *
+ * Slots are reused, so the writer must set every field it cares about
+ * before each publish().
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle(1), back(2), front(0) {}
+
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+    /** Writer: the slot to fill before the next publish() */
+    T &writeSlot() { return slots[back]; }
+
+    /** Writer: make the filled slot the latest value */
+    void publish() {
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    /**
+     * Reader: move to the latest published value, if there is a new one.
+     * @return true if read() now returns a newer value
+     */
+    bool refresh() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    /** Reader: the value picked up by the last refresh() */
+    const T &read() const { return slots[front]; }
+
+private:
+    static const uint8_t INDEX = 3;     // Slot number bits of middle
+    static const uint8_t FRESH = 4;     // Set by publish(), cleared by refresh()
+
+    T slots[3];
+    std::atomic<uint8_t> middle;
+    uint8_t back;                       // Writer only
+    uint8_t front;                      // Reader only
+};
+
+#endif // TRIPLEBUFFER_H
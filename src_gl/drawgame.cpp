@@ -247,30 +247,14 @@ void TetrimoneBoard::cancelThemeTransition() {
     themeTransitionProgress = 0.0;
 }
 
+const ThemePalette& TetrimoneBoard::getPalette() const {
+    // Cheap when neither the theme nor the transition step changed
+    palette.update(currentThemeIndex, isThemeTransitioning, oldThemeIndex, newThemeIndex,
+                   themeTransitionProgress);
+    return palette;
+}
+
 std::array<double, 3> TetrimoneBoard::getInterpolatedColor(int blockType, double progress) const {
-    if (!isThemeTransitioning) {
-        return TETRIMONEBLOCK_COLOR_THEMES[currentThemeIndex][blockType];
-    }
-    
-    // Get colors from old and new themes
-    auto oldColor = TETRIMONEBLOCK_COLOR_THEMES[oldThemeIndex][blockType];
-    auto newColor = TETRIMONEBLOCK_COLOR_THEMES[newThemeIndex][blockType];
-    
-    // Use a more gentle easing function for the longer transition
-    // Cubic ease-in-out for smoother, more noticeable transitions
-    double t = themeTransitionProgress;
-    if (t < 0.5) {
-        t = 4 * t * t * t; // Ease-in cubic
-    } else {
-        t = 1 - pow(-2 * t + 2, 3) / 2; // Ease-out cubic
-    }
-    
-    // Interpolate between colors
-    std::array<double, 3> interpolatedColor;
-    for (int i = 0; i < 3; i++) {
-        interpolatedColor[i] = oldColor[i] + (newColor[i] - oldColor[i]) * t;
-    }
-    
-    return interpolatedColor;
+    return getPalette().color(blockType);
 }
 
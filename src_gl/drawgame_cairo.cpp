@@ -555,6 +555,8 @@ void drawGameOver(cairo_t *cr, TetrimoneBoard *board) {
 }
 
 void drawPlacedBlocks(cairo_t *cr, TetrimoneBoard *board, TetrimoneApp *app) {
+  const ThemePalette &palette = board->getPalette();
+
   for (int y = 0; y < GRID_HEIGHT; ++y) {
     for (int x = 0; x < GRID_WIDTH; ++x) {
       int value = board->getGridValue(x, y);
@@ -618,10 +620,8 @@ void drawPlacedBlocks(cairo_t *cr, TetrimoneBoard *board, TetrimoneApp *app) {
           }
         }
 
-        // Get color from tetrimoneblock colors
-        auto baseColor = board->isInThemeTransition() ? 
-        board->getInterpolatedColor(value - 1, board->getThemeTransitionProgress()) :
-        TETRIMONEBLOCK_COLOR_THEMES[currentThemeIndex][value - 1];
+        // Get color from the frame's palette (blended during transitions)
+        const auto& baseColor = palette.color(value - 1);
         auto color = getHeatModifiedColor(baseColor, board->getHeatLevel());
 
         cairo_set_source_rgba(cr, color[0], color[1], color[2], alpha);
@@ -993,9 +993,7 @@ void drawCurrentPiece(cairo_t *cr, TetrimoneBoard *board) {
   if (!board->isGameOver() && !board->isPaused() && !board->isSplashScreenActive()) {
     const TetrimoneBlock &piece = board->getCurrentPiece();
     auto shape = piece.getShape();
-    auto color = board->isInThemeTransition() ? 
-    board->getInterpolatedColor(piece.getType(), board->getThemeTransitionProgress()) :
-    piece.getColor();
+    const auto& color = board->getPalette().color(piece.getType());
     
     double pieceX, pieceY;
     board->getCurrentPieceInterpolatedPosition(pieceX, pieceY);
@@ -1048,7 +1046,7 @@ void drawGhostPiece(cairo_t *cr, TetrimoneBoard *board) {
     
     const TetrimoneBlock &piece = board->getCurrentPiece();
     auto shape = piece.getShape();
-    auto color = piece.getColor();
+    const auto& color = board->getPalette().themeColor(piece.getType());
     
     double currentPieceX, currentPieceY;
     board->getCurrentPieceInterpolatedPosition(currentPieceX, currentPieceY);
@@ -1223,7 +1221,7 @@ gboolean onDrawNextPiece(GtkWidget *widget, cairo_t *cr, gpointer data) {
       // Get the piece information
       const TetrimoneBlock &piece = board->getNextPiece(pieceIndex);
       auto shape = piece.getShape();
-      auto color = piece.getColor();
+      const auto& color = board->getPalette().color(piece.getType());
 
       // Calculate the shape dimensions in blocks
       int pieceWidth = 0;
@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <chrono>
 #include <vector>
+#include <unordered_map>
 #ifdef _WIN32
 #include <windows.h>
 #include <commdlg.h>
@@ -60,12 +61,125 @@ typedef struct {
     GLuint program;
     GLuint vao;
     GLuint vbo;
+    int vbo_capacity;       // Vertices the buffer holds; doubled when a draw needs more
+    int vbo_peak;           // Most vertices a single draw has needed
     Mat4 projection;
     float color[4];
 } GLRenderState;
 
+// Enough for every primitive the overlays draw; circles are the largest
+static const int GL_VERTEX_BUFFER_INITIAL = 256;
+
 static GLRenderState gl_state = {0};
 
+// One block sprite per instance; positions are in pixels so the trails and
+// the preview, which are not on the board grid, share the format
+typedef struct {
+    float x, y;
+    float size;
+    float alpha;
+    float type;     // Atlas column
+    float row;      // Atlas row (block style)
+} BlockInstance;
+
+// Atlas rows: every block type in each style, bevels baked in
+enum {
+    ATLAS_ROW_PLACED = 0,   // Placed blocks, 30% highlight and shadow
+    ATLAS_ROW_FLAT,         // Retro and simple blocks
+    ATLAS_ROW_PIECE,        // Falling piece, brighter highlight
+    ATLAS_ROW_GHOST,        // Outline in the unblended theme colour
+    ATLAS_ROW_TRAIL,        // Flat, unblended theme colour
+    ATLAS_ROW_PREVIEW,      // Next piece preview, highlight only
+    ATLAS_ROWS
+};
+
+static const int ATLAS_SPRITE = 32;                     // Texels per sprite side
+static const int ATLAS_COLUMNS = ThemePalette::MAX_TYPES;
+
+typedef struct {
+    GLuint program;
+    GLuint vao;
+    GLuint quad_vbo;        // Unit quad shared by every instance
+    GLuint instance_vbo;
+    GLuint atlas;
+    bool atlas_valid;
+    unsigned int atlas_version;  // Palette version the atlas was baked from
+    std::vector<BlockInstance> instances;
+} GLBlockState;
+
+static GLBlockState gl_blocks;
+
+// Board shader mode: the locked board is one quad shaded from a texture
+// holding the grid cells, so its cost no longer depends on the block count
+typedef struct {
+    GLuint program;
+    GLuint vao;
+    GLuint vbo;
+    GLuint grid_texture;
+    int grid_width, grid_height;        // Size the texture was allocated at
+    std::vector<unsigned char> cells;   // What the texture holds
+    bool palette_valid;
+    unsigned int palette_version;       // Palette version in the colour uniforms
+} GLBoardShaderState;
+
+static GLBoardShaderState gl_board;
+
+// Set by TETRIMONE_GL_BOARD_SHADER for front ends without a toggle
+static bool board_shader_enabled = getenv("TETRIMONE_GL_BOARD_SHADER") != NULL;
+
+// A background image on the GPU, attached to its Cairo surface so it is
+// uploaded once and lives exactly as long as the surface
+typedef struct {
+    GLuint texture;
+    GLuint pbo;         // Staging buffer until the upload lands
+    GLsync fence;       // Signals when the texture data is on the GPU
+    bool ready;         // Uploaded and mipmapped
+    bool opaque;        // CAIRO_FORMAT_RGB24: the alpha byte is undefined
+} BackgroundTexture;
+
+typedef struct {
+    GLuint program;
+    GLuint vao;
+    std::vector<BackgroundTexture*> released;  // Surfaces destroyed; freed with a context current
+} GLBackgroundState;
+
+static GLBackgroundState gl_background;
+static cairo_user_data_key_t background_texture_key;
+
+// Overlay text: Cairo rasterizes each glyph once into a single-channel
+// atlas and every string becomes textured quads in one batched draw
+typedef struct {
+    float x, y;
+    float u, v;
+    float r, g, b, a;
+} TextVertex;
+
+typedef struct {
+    float u0, v0, u1, v1;       // Atlas rectangle
+    float x_offset, y_offset;   // Rectangle corner from the pen, in atlas texels
+    float width, height;        // Rectangle size; zero for whitespace
+    float advance;
+} Glyph;
+
+static const int TEXT_ATLAS_SIZE = 1024;
+static const double TEXT_BAKE_SIZE = 40.0;  // Font size the glyphs are rasterized at
+static const int TEXT_GLYPH_PAD = 4;        // Empty texels around a glyph, so mipmaps do not bleed
+
+typedef struct {
+    GLuint program;
+    GLuint vao;
+    GLuint vbo;
+    GLuint atlas;                   // Created once the initial glyphs are drawn
+    cairo_surface_t *surface;       // CPU copy of the atlas; new glyphs are drawn into it
+    cairo_t *cr;
+    int pen_x, pen_y, row_height;   // Shelf packing position
+    bool full;
+    std::unordered_map<uint32_t, Glyph> glyphs;
+    std::vector<TextVertex> vertices;
+} GLTextState;
+
+static GLTextState gl_text;
+
 // Shader sources for OpenGL 3.3+
 static const char *vertex_shader = 
     "#version 330 core\n"
@@ -86,6 +200,150 @@ static const char *fragment_shader =
     "    FragColor = vertexColor;\n"
     "}\n";
 
+// Block sprites: a unit quad per vertex, placement and sprite per instance
+static const char *block_vertex_shader =
+    "#version 330 core\n"
+    "layout(location = 0) in vec2 corner;\n"
+    "layout(location = 1) in vec4 placement;\n"
+    "layout(location = 2) in vec2 sprite;\n"
+    "uniform mat4 projection;\n"
+    "uniform vec2 atlasGrid;\n"
+    "out vec2 texCoord;\n"
+    "out float blockAlpha;\n"
+    "void main() {\n"
+    "    vec2 position = placement.xy + corner * placement.z;\n"
+    "    gl_Position = projection * vec4(position, 0.0, 1.0);\n"
+    "    texCoord = (sprite + corner) / atlasGrid;\n"
+    "    blockAlpha = placement.w;\n"
+    "}\n";
+
+static const char *block_fragment_shader =
+    "#version 330 core\n"
+    "in vec2 texCoord;\n"
+    "in float blockAlpha;\n"
+    "uniform sampler2D atlas;\n"
+    "out vec4 FragColor;\n"
+    "void main() {\n"
+    "    vec4 texel = texture(atlas, texCoord);\n"
+    "    FragColor = vec4(texel.rgb, texel.a * blockAlpha);\n"
+    "}\n";
+
+// Whole-board shader: cell values come from an integer texture, with the
+// top bit set on rows being cleared; fill, bevel, grid lines, line clear
+// fade and heat tint are worked out per pixel
+static const char *board_vertex_shader =
+    "#version 330 core\n"
+    "layout(location = 0) in vec2 corner;\n"
+    "uniform mat4 projection;\n"
+    "uniform vec2 boardSize;\n"
+    "out vec2 boardPos;\n"
+    "void main() {\n"
+    "    boardPos = corner * boardSize;\n"
+    "    gl_Position = projection * vec4(boardPos, 0.0, 1.0);\n"
+    "}\n";
+
+static const char *board_fragment_shader =
+    "#version 330 core\n"
+    "in vec2 boardPos;\n"
+    "uniform usampler2D grid;\n"
+    "uniform vec3 blockColors[16];\n"
+    "uniform float cellSize;\n"
+    "uniform float clearProgress;\n"
+    "uniform float heatLevel;\n"
+    "uniform int bevel;\n"
+    "uniform int gridLines;\n"
+    "out vec4 FragColor;\n"
+    "void main() {\n"
+    "    ivec2 cell = ivec2(floor(boardPos / cellSize));\n"
+    "    vec2 local = boardPos - vec2(cell) * cellSize;\n"
+    "    uint value = texelFetch(grid, cell, 0).r;\n"
+    "    uint type = value & 0x7Fu;\n"
+    "    vec4 under = vec4(0.0);\n"
+    "    if (gridLines != 0 && ((cell.x > 0 && local.x < 1.0) || (cell.y > 0 && local.y < 1.0))) {\n"
+    "        under = vec4(0.3, 0.3, 0.3, 1.0);\n"
+    "    }\n"
+    "    if (type == 0u) {\n"
+    "        FragColor = under;\n"
+    "        return;\n"
+    "    }\n"
+    "    float alpha = 1.0;\n"
+    "    float scale = 1.0;\n"
+    "    if ((value & 0x80u) != 0u) {\n"
+    "        alpha = max(1.0 - clearProgress * 2.0, 0.0);\n"
+    "        scale = 1.0 + min(clearProgress, 0.5) * 0.3;\n"
+    "    }\n"
+    "    vec2 p = (local - 0.5 * cellSize) / scale + 0.5 * cellSize;\n"
+    "    if (p.x < 1.0 || p.y < 1.0 || p.x > cellSize - 1.0 || p.y > cellSize - 1.0) {\n"
+    "        FragColor = under;\n"
+    "        return;\n"
+    "    }\n"
+    "    float heat = heatLevel < 0.5 ? 1.0 - (0.5 - heatLevel) * 1.2 : 1.0 + (heatLevel - 0.5);\n"
+    "    vec3 rgb = min(blockColors[type - 1u] * heat, vec3(1.0));\n"
+    "    if (bevel != 0) {\n"
+    "        rgb = (p.x + p.y < cellSize) ? mix(rgb, vec3(1.0), 0.3) : rgb * 0.7;\n"
+    "    }\n"
+    "    float outAlpha = alpha + under.a * (1.0 - alpha);\n"
+    "    vec3 outRgb = outAlpha > 0.0 ? (rgb * alpha + under.rgb * under.a * (1.0 - alpha)) / outAlpha : rgb;\n"
+    "    FragColor = vec4(outRgb, outAlpha);\n"
+    "}\n";
+
+// Background image: scaled to cover the board, faded by the opacity uniform.
+// Cairo's ARGB32 is premultiplied, so colour is divided back out
+static const char *background_vertex_shader =
+    "#version 330 core\n"
+    "layout(location = 0) in vec2 corner;\n"
+    "uniform mat4 projection;\n"
+    "uniform vec2 areaSize;\n"
+    "uniform vec4 imageRect;\n"
+    "out vec2 texCoord;\n"
+    "void main() {\n"
+    "    vec2 position = corner * areaSize;\n"
+    "    gl_Position = projection * vec4(position, 0.0, 1.0);\n"
+    "    texCoord = (position - imageRect.xy) / imageRect.zw;\n"
+    "}\n";
+
+static const char *background_fragment_shader =
+    "#version 330 core\n"
+    "in vec2 texCoord;\n"
+    "uniform sampler2D image;\n"
+    "uniform float opacity;\n"
+    "uniform int opaque;\n"
+    "out vec4 FragColor;\n"
+    "void main() {\n"
+    "    vec4 texel = texture(image, texCoord);\n"
+    "    if (opaque != 0) {\n"
+    "        FragColor = vec4(texel.rgb, opacity);\n"
+    "    } else {\n"
+    "        vec3 rgb = texel.a > 0.0 ? texel.rgb / texel.a : vec3(0.0);\n"
+    "        FragColor = vec4(rgb, texel.a * opacity);\n"
+    "    }\n"
+    "}\n";
+
+// Text: the atlas holds coverage only, colour comes with each vertex
+static const char *text_vertex_shader =
+    "#version 330 core\n"
+    "layout(location = 0) in vec2 position;\n"
+    "layout(location = 1) in vec2 uv;\n"
+    "layout(location = 2) in vec4 color;\n"
+    "uniform mat4 projection;\n"
+    "out vec2 texCoord;\n"
+    "out vec4 vertexColor;\n"
+    "void main() {\n"
+    "    gl_Position = projection * vec4(position, 0.0, 1.0);\n"
+    "    texCoord = uv;\n"
+    "    vertexColor = color;\n"
+    "}\n";
+
+static const char *text_fragment_shader =
+    "#version 330 core\n"
+    "in vec2 texCoord;\n"
+    "in vec4 vertexColor;\n"
+    "uniform sampler2D atlas;\n"
+    "out vec4 FragColor;\n"
+    "void main() {\n"
+    "    FragColor = vec4(vertexColor.rgb, vertexColor.a * texture(atlas, texCoord).r);\n"
+    "}\n";
+
 // ============================================================================
 // SHADER COMPILATION AND PROGRAM CREATION
 // ============================================================================
@@ -126,7 +384,9 @@ static GLuint create_program(const char *vs_src, const char *fs_src) {
     return prog;
 }
 
-static void gl_init(void) {
+static void init_text_atlas(void);
+
+void gl_init(void) {
     if (gl_state.program) return;
     
     fprintf(stderr, "[GL] Initializing modern GL 3.3+ renderer for Tetrimone\n");
@@ -138,7 +398,8 @@ static void gl_init(void) {
     
     glBindVertexArray(gl_state.vao);
     glBindBuffer(GL_ARRAY_BUFFER, gl_state.vbo);
-    glBufferData(GL_ARRAY_BUFFER, 1000000 * sizeof(Vertex), NULL, GL_DYNAMIC_DRAW);
+    gl_state.vbo_capacity = GL_VERTEX_BUFFER_INITIAL;
+    glBufferData(GL_ARRAY_BUFFER, gl_state.vbo_capacity * sizeof(Vertex), NULL, GL_DYNAMIC_DRAW);
     
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, x));
     glEnableVertexAttribArray(0);
@@ -153,7 +414,89 @@ static void gl_init(void) {
     gl_state.color[1] = 1.0f;
     gl_state.color[2] = 1.0f;
     gl_state.color[3] = 1.0f;
-    
+
+    // Instanced block sprites
+    gl_blocks.program = create_program(block_vertex_shader, block_fragment_shader);
+
+    static const float quad[12] = {
+        0.0f, 0.0f,  1.0f, 0.0f,  1.0f, 1.0f,
+        0.0f, 0.0f,  1.0f, 1.0f,  0.0f, 1.0f
+    };
+
+    glGenVertexArrays(1, &gl_blocks.vao);
+    glGenBuffers(1, &gl_blocks.quad_vbo);
+    glGenBuffers(1, &gl_blocks.instance_vbo);
+
+    glBindVertexArray(gl_blocks.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, gl_blocks.quad_vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, gl_blocks.instance_vbo);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(BlockInstance), (void*)offsetof(BlockInstance, x));
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(BlockInstance), (void*)offsetof(BlockInstance, type));
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    glGenTextures(1, &gl_blocks.atlas);
+    glBindTexture(GL_TEXTURE_2D, gl_blocks.atlas);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, ATLAS_COLUMNS * ATLAS_SPRITE, ATLAS_ROWS * ATLAS_SPRITE,
+                 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    gl_blocks.atlas_valid = false;
+
+    // Whole-board shader; the grid texture is sized on first use
+    gl_board.program = create_program(board_vertex_shader, board_fragment_shader);
+    glGenVertexArrays(1, &gl_board.vao);
+    glGenBuffers(1, &gl_board.vbo);
+    glBindVertexArray(gl_board.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, gl_board.vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glGenTextures(1, &gl_board.grid_texture);
+    gl_board.grid_width = 0;
+    gl_board.grid_height = 0;
+    gl_board.palette_valid = false;
+
+    // Background images share the unit quad with the block sprites
+    gl_background.program = create_program(background_vertex_shader, background_fragment_shader);
+    glGenVertexArrays(1, &gl_background.vao);
+    glBindVertexArray(gl_background.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, gl_blocks.quad_vbo);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    // Overlay text
+    gl_text.program = create_program(text_vertex_shader, text_fragment_shader);
+    glGenVertexArrays(1, &gl_text.vao);
+    glGenBuffers(1, &gl_text.vbo);
+    glBindVertexArray(gl_text.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, gl_text.vbo);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, x));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, u));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, r));
+    glEnableVertexAttribArray(2);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    init_text_atlas();
+
     fprintf(stderr, "[GL] GL 3.3+ renderer initialized successfully\n");
 }
 
@@ -164,12 +507,409 @@ static void draw_vertices(Vertex *verts, int count, GLenum mode) {
     glUniformMatrix4fv(proj_loc, 1, GL_FALSE, gl_state.projection.m);
     
     glBindBuffer(GL_ARRAY_BUFFER, gl_state.vbo);
+    gl_state.vbo_peak = std::max(gl_state.vbo_peak, count);
+    if (count > gl_state.vbo_capacity) {
+        while (gl_state.vbo_capacity < count) {
+            gl_state.vbo_capacity *= 2;
+        }
+        glBufferData(GL_ARRAY_BUFFER, gl_state.vbo_capacity * sizeof(Vertex), NULL, GL_DYNAMIC_DRAW);
+    }
     glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(Vertex), verts);
     
     glBindVertexArray(gl_state.vao);
     glDrawArrays(mode, 0, count);
 }
 
+// ============================================================================
+// INSTANCED BLOCK SPRITES
+// ============================================================================
+
+/**
+ * Paint one sprite into the atlas pixels. The sprite covers a whole cell
+ * with a one texel transparent margin, matching the 1px inset of the
+ * rectangle renderer. The top-left half is lightened by highlight and the
+ * bottom-right half darkened by shadow, the same split as the bevel
+ * triangles. Transparent texels keep the sprite colour so filtering does
+ * not pull dark fringes in from the margin.
+ */
+static void bake_block_sprite(std::vector<unsigned char> &pixels, int column, int row,
+                              const ThemePalette::Color &color, double highlight, double shadow,
+                              bool outline) {
+    int stride = ATLAS_COLUMNS * ATLAS_SPRITE * 4;
+    for (int v = 0; v < ATLAS_SPRITE; ++v) {
+        for (int u = 0; u < ATLAS_SPRITE; ++u) {
+            bool inside = u >= 1 && u < ATLAS_SPRITE - 1 && v >= 1 && v < ATLAS_SPRITE - 1;
+            bool edge = u == 1 || u == ATLAS_SPRITE - 2 || v == 1 || v == ATLAS_SPRITE - 2;
+
+            double rgb[3] = {color[0], color[1], color[2]};
+            double alpha = inside && (!outline || edge) ? 1.0 : 0.0;
+            if (inside && !outline) {
+                bool lit = (u + 0.5) + (v + 0.5) < ATLAS_SPRITE;
+                for (int c = 0; c < 3; ++c) {
+                    rgb[c] = lit ? rgb[c] + (1.0 - rgb[c]) * highlight : rgb[c] * (1.0 - shadow);
+                }
+            }
+
+            unsigned char *texel = &pixels[(row * ATLAS_SPRITE + v) * stride +
+                                           (column * ATLAS_SPRITE + u) * 4];
+            for (int c = 0; c < 3; ++c) {
+                texel[c] = (unsigned char)(std::min(1.0, std::max(0.0, rgb[c])) * 255.0 + 0.5);
+            }
+            texel[3] = (unsigned char)(alpha * 255.0);
+        }
+    }
+}
+
+// Rebake the atlas when the theme colours change (themes, crossfades)
+static void update_block_atlas(const ThemePalette &palette) {
+    if (gl_blocks.atlas_valid && gl_blocks.atlas_version == palette.getVersion()) {
+        return;
+    }
+    Profiler::Scope scope("update_block_atlas");
+
+    std::vector<unsigned char> pixels(ATLAS_COLUMNS * ATLAS_SPRITE * ATLAS_ROWS * ATLAS_SPRITE * 4, 0);
+    for (int type = 0; type < palette.size() && type < ATLAS_COLUMNS; ++type) {
+        const ThemePalette::Color &color = palette.color(type);
+        const ThemePalette::Color &themeColor = palette.themeColor(type);
+        bake_block_sprite(pixels, type, ATLAS_ROW_PLACED, color, 0.3, 0.3, false);
+        bake_block_sprite(pixels, type, ATLAS_ROW_FLAT, color, 0.0, 0.0, false);
+        bake_block_sprite(pixels, type, ATLAS_ROW_PIECE, color, 0.4, 0.3, false);
+        bake_block_sprite(pixels, type, ATLAS_ROW_GHOST, themeColor, 0.0, 0.0, true);
+        bake_block_sprite(pixels, type, ATLAS_ROW_TRAIL, themeColor, 0.0, 0.0, false);
+        bake_block_sprite(pixels, type, ATLAS_ROW_PREVIEW, color, 0.3, 0.0, false);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, gl_blocks.atlas);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, ATLAS_COLUMNS * ATLAS_SPRITE, ATLAS_ROWS * ATLAS_SPRITE,
+                    GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    gl_blocks.atlas_valid = true;
+    gl_blocks.atlas_version = palette.getVersion();
+}
+
+// Add one block to the batch drawn by gl_flush_blocks()
+static void gl_queue_block(float x, float y, float size, int type, int row, float alpha) {
+    if (alpha <= 0.0f || size <= 0.0f) {
+        return;
+    }
+    BlockInstance instance = {x, y, size, alpha, (float)type, (float)row};
+    gl_blocks.instances.push_back(instance);
+}
+
+void gl_flush_blocks(TetrimoneBoard *board) {
+    if (gl_blocks.instances.empty()) {
+        return;
+    }
+    Profiler::Scope scope("gl_flush_blocks");
+    update_block_atlas(board->getPalette());
+
+    glUseProgram(gl_blocks.program);
+    glUniformMatrix4fv(glGetUniformLocation(gl_blocks.program, "projection"), 1, GL_FALSE,
+                       gl_state.projection.m);
+    glUniform2f(glGetUniformLocation(gl_blocks.program, "atlasGrid"), (float)ATLAS_COLUMNS,
+                (float)ATLAS_ROWS);
+    glUniform1i(glGetUniformLocation(gl_blocks.program, "atlas"), 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, gl_blocks.atlas);
+
+    // Orphan the buffer each frame so the driver never waits on the last draw
+    glBindBuffer(GL_ARRAY_BUFFER, gl_blocks.instance_vbo);
+    glBufferData(GL_ARRAY_BUFFER, gl_blocks.instances.size() * sizeof(BlockInstance),
+                 gl_blocks.instances.data(), GL_STREAM_DRAW);
+
+    glBindVertexArray(gl_blocks.vao);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)gl_blocks.instances.size());
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    gl_blocks.instances.clear();
+}
+
+// ============================================================================
+// GLYPH ATLAS TEXT
+// ============================================================================
+
+// Decode one UTF-8 character and step past it; malformed bytes read as '?'
+static uint32_t next_codepoint(const char *&text) {
+    const unsigned char *s = (const unsigned char *)text;
+    uint32_t codepoint;
+    int extra;
+    if (s[0] < 0x80) {
+        codepoint = s[0];
+        extra = 0;
+    } else if ((s[0] & 0xE0) == 0xC0) {
+        codepoint = s[0] & 0x1F;
+        extra = 1;
+    } else if ((s[0] & 0xF0) == 0xE0) {
+        codepoint = s[0] & 0x0F;
+        extra = 2;
+    } else if ((s[0] & 0xF8) == 0xF0) {
+        codepoint = s[0] & 0x07;
+        extra = 3;
+    } else {
+        text += 1;
+        return '?';
+    }
+    for (int i = 1; i <= extra; ++i) {
+        if ((s[i] & 0xC0) != 0x80) {
+            text += i;
+            return '?';
+        }
+        codepoint = (codepoint << 6) | (s[i] & 0x3F);
+    }
+    text += extra + 1;
+    return codepoint;
+}
+
+static void encode_codepoint(uint32_t codepoint, char *utf8) {
+    if (codepoint < 0x80) {
+        *utf8++ = (char)codepoint;
+    } else if (codepoint < 0x800) {
+        *utf8++ = (char)(0xC0 | (codepoint >> 6));
+        *utf8++ = (char)(0x80 | (codepoint & 0x3F));
+    } else if (codepoint < 0x10000) {
+        *utf8++ = (char)(0xE0 | (codepoint >> 12));
+        *utf8++ = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        *utf8++ = (char)(0x80 | (codepoint & 0x3F));
+    } else {
+        *utf8++ = (char)(0xF0 | (codepoint >> 18));
+        *utf8++ = (char)(0x80 | ((codepoint >> 12) & 0x3F));
+        *utf8++ = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        *utf8++ = (char)(0x80 | (codepoint & 0x3F));
+    }
+    *utf8 = '\0';
+}
+
+/**
+ * Draw one glyph into the atlas surface and record where it went. Glyphs
+ * are packed left to right in shelves. Once the texture exists only the
+ * new glyph's rectangle is uploaded, so characters outside the preloaded
+ * set cost one small upload the first time they appear.
+ * @return NULL if the atlas has no room left
+ */
+static const Glyph *rasterize_glyph(uint32_t codepoint) {
+    char utf8[5];
+    encode_codepoint(codepoint, utf8);
+
+    cairo_text_extents_t extents;
+    cairo_text_extents(gl_text.cr, utf8, &extents);
+
+    Glyph glyph = {0};
+    glyph.advance = (float)extents.x_advance;
+    if (extents.width <= 0.0 || extents.height <= 0.0) {
+        // Whitespace only moves the pen
+        return &(gl_text.glyphs[codepoint] = glyph);
+    }
+
+    int width = (int)ceil(extents.width) + 1 + 2 * TEXT_GLYPH_PAD;
+    int height = (int)ceil(extents.height) + 1 + 2 * TEXT_GLYPH_PAD;
+    if (gl_text.pen_x + width > TEXT_ATLAS_SIZE) {
+        gl_text.pen_x = 0;
+        gl_text.pen_y += gl_text.row_height;
+        gl_text.row_height = 0;
+    }
+    if (gl_text.pen_y + height > TEXT_ATLAS_SIZE) {
+        if (!gl_text.full) {
+            fprintf(stderr, "[GL] Glyph atlas full, unknown characters draw as '?'\n");
+            gl_text.full = true;
+        }
+        return NULL;
+    }
+
+    int x = gl_text.pen_x;
+    int y = gl_text.pen_y;
+    gl_text.pen_x += width;
+    gl_text.row_height = std::max(gl_text.row_height, height);
+
+    cairo_move_to(gl_text.cr, x + TEXT_GLYPH_PAD - extents.x_bearing, y + TEXT_GLYPH_PAD - extents.y_bearing);
+    cairo_show_text(gl_text.cr, utf8);
+
+    glyph.u0 = (float)x / TEXT_ATLAS_SIZE;
+    glyph.v0 = (float)y / TEXT_ATLAS_SIZE;
+    glyph.u1 = (float)(x + width) / TEXT_ATLAS_SIZE;
+    glyph.v1 = (float)(y + height) / TEXT_ATLAS_SIZE;
+    glyph.x_offset = (float)extents.x_bearing - TEXT_GLYPH_PAD;
+    glyph.y_offset = (float)extents.y_bearing - TEXT_GLYPH_PAD;
+    glyph.width = (float)width;
+    glyph.height = (float)height;
+
+    if (gl_text.atlas) {
+        cairo_surface_flush(gl_text.surface);
+        int stride = cairo_image_surface_get_stride(gl_text.surface);
+        const unsigned char *pixels = cairo_image_surface_get_data(gl_text.surface);
+
+        glBindTexture(GL_TEXTURE_2D, gl_text.atlas);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, stride);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RED, GL_UNSIGNED_BYTE,
+                        pixels + y * stride + x);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    return &(gl_text.glyphs[codepoint] = glyph);
+}
+
+static const Glyph *find_glyph(uint32_t codepoint) {
+    std::unordered_map<uint32_t, Glyph>::const_iterator it = gl_text.glyphs.find(codepoint);
+    if (it != gl_text.glyphs.end()) {
+        return &it->second;
+    }
+    const Glyph *glyph = rasterize_glyph(codepoint);
+    if (!glyph && codepoint != '?') {
+        // Remember the fallback so a full atlas is not retried every frame
+        const Glyph *fallback = find_glyph('?');
+        if (fallback) {
+            glyph = &(gl_text.glyphs[codepoint] = *fallback);
+        }
+    }
+    return glyph;
+}
+
+/**
+ * Rasterize the font once with Cairo, the same bold Sans the Cairo
+ * overlays use. ASCII and the Cyrillic block cover every built-in
+ * overlay string, including retro mode; anything else is added on first
+ * use. Glyphs are drawn at TEXT_BAKE_SIZE and scaled, with mipmaps for
+ * the small sizes.
+ */
+static void init_text_atlas(void) {
+    Profiler::Scope scope("init_text_atlas");
+
+    gl_text.surface = cairo_image_surface_create(CAIRO_FORMAT_A8, TEXT_ATLAS_SIZE, TEXT_ATLAS_SIZE);
+    gl_text.cr = cairo_create(gl_text.surface);
+    cairo_select_font_face(gl_text.cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    cairo_set_font_size(gl_text.cr, TEXT_BAKE_SIZE);
+
+    // Unhinted outlines and metrics, since glyphs are scaled when drawn
+    cairo_font_options_t *options = cairo_font_options_create();
+    cairo_font_options_set_antialias(options, CAIRO_ANTIALIAS_GRAY);
+    cairo_font_options_set_hint_style(options, CAIRO_HINT_STYLE_NONE);
+    cairo_font_options_set_hint_metrics(options, CAIRO_HINT_METRICS_OFF);
+    cairo_set_font_options(gl_text.cr, options);
+    cairo_font_options_destroy(options);
+    cairo_set_source_rgba(gl_text.cr, 1.0, 1.0, 1.0, 1.0);
+
+    gl_text.atlas = 0;
+    gl_text.pen_x = 0;
+    gl_text.pen_y = 0;
+    gl_text.row_height = 0;
+    gl_text.full = false;
+
+    for (uint32_t codepoint = 0x20; codepoint < 0x7F; ++codepoint) {
+        rasterize_glyph(codepoint);
+    }
+    for (uint32_t codepoint = 0x400; codepoint < 0x460; ++codepoint) {
+        rasterize_glyph(codepoint);
+    }
+    cairo_surface_flush(gl_text.surface);
+
+    glGenTextures(1, &gl_text.atlas);
+    glBindTexture(GL_TEXTURE_2D, gl_text.atlas);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, cairo_image_surface_get_stride(gl_text.surface));
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, TEXT_ATLAS_SIZE, TEXT_ATLAS_SIZE, 0, GL_RED, GL_UNSIGNED_BYTE,
+                 cairo_image_surface_get_data(gl_text.surface));
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    fprintf(stderr, "[GL] Glyph atlas: %zu glyphs\n", gl_text.glyphs.size());
+}
+
+float gl_text_width(const char *text, float size) {
+    if (!gl_text.cr) {
+        return 0.0f;
+    }
+    float width = 0.0f;
+    while (*text) {
+        const Glyph *glyph = find_glyph(next_codepoint(text));
+        if (glyph) {
+            width += glyph->advance;
+        }
+    }
+    return width * size / (float)TEXT_BAKE_SIZE;
+}
+
+void gl_draw_text(const char *text, float x, float y, float size) {
+    if (!gl_text.cr) {
+        return;
+    }
+    float scale = size / (float)TEXT_BAKE_SIZE;
+    const float *c = gl_state.color;
+    float pen = x;
+    while (*text) {
+        const Glyph *glyph = find_glyph(next_codepoint(text));
+        if (!glyph) {
+            continue;
+        }
+        if (glyph->width > 0.0f) {
+            float x0 = pen + glyph->x_offset * scale;
+            float y0 = y + glyph->y_offset * scale;
+            float x1 = x0 + glyph->width * scale;
+            float y1 = y0 + glyph->height * scale;
+            TextVertex quad[6] = {
+                {x0, y0, glyph->u0, glyph->v0, c[0], c[1], c[2], c[3]},
+                {x1, y0, glyph->u1, glyph->v0, c[0], c[1], c[2], c[3]},
+                {x1, y1, glyph->u1, glyph->v1, c[0], c[1], c[2], c[3]},
+                {x0, y0, glyph->u0, glyph->v0, c[0], c[1], c[2], c[3]},
+                {x1, y1, glyph->u1, glyph->v1, c[0], c[1], c[2], c[3]},
+                {x0, y1, glyph->u0, glyph->v1, c[0], c[1], c[2], c[3]}
+            };
+            gl_text.vertices.insert(gl_text.vertices.end(), quad, quad + 6);
+        }
+        pen += glyph->advance * scale;
+    }
+}
+
+void gl_draw_text_centered(const char *text, float cx, float y, float size) {
+    gl_draw_text(text, cx - gl_text_width(text, size) / 2.0f, y, size);
+}
+
+void gl_flush_text(void) {
+    if (gl_text.vertices.empty()) {
+        return;
+    }
+    Profiler::Scope scope("gl_flush_text");
+
+    glUseProgram(gl_text.program);
+    glUniformMatrix4fv(glGetUniformLocation(gl_text.program, "projection"), 1, GL_FALSE,
+                       gl_state.projection.m);
+    glUniform1i(glGetUniformLocation(gl_text.program, "atlas"), 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, gl_text.atlas);
+
+    // Orphaned like the block instances
+    glBindBuffer(GL_ARRAY_BUFFER, gl_text.vbo);
+    glBufferData(GL_ARRAY_BUFFER, gl_text.vertices.size() * sizeof(TextVertex),
+                 gl_text.vertices.data(), GL_STREAM_DRAW);
+
+    glBindVertexArray(gl_text.vao);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)gl_text.vertices.size());
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    gl_text.vertices.clear();
+}
+
+// Largest size up to size at which text fits in max_width
+static float fit_text_size(const char *text, float size, float max_width) {
+    float width = gl_text_width(text, size);
+    if (width > max_width && width > 0.0f) {
+        return size * max_width / width;
+    }
+    return size;
+}
+
 // ============================================================================
 // HIGH-LEVEL DRAWING API
 // ============================================================================
@@ -180,6 +920,11 @@ void gl_setup_2d_projection(int width, int height) {
     gl_state.projection = mat4_ortho(0, width, height, 0, -1, 1);
 }
 
+void gl_vertex_buffer_stats(int *capacity, int *peak) {
+    *capacity = gl_state.vbo_capacity;
+    *peak = gl_state.vbo_peak;
+}
+
 void gl_set_color(float r, float g, float b) {
     gl_state.color[0] = r;
     gl_state.color[1] = g;
@@ -274,11 +1019,170 @@ void gl_draw_triangle(float x1, float y1, float x2, float y2, float x3, float y3
 // TETRIMONE GAME DRAWING FUNCTIONS
 // ============================================================================
 
+// Cairo destroys surfaces without a GL context, so textures are only queued here
+static void release_background_texture(void *data) {
+    gl_background.released.push_back((BackgroundTexture*)data);
+}
+
+static void free_released_backgrounds() {
+    for (BackgroundTexture *background : gl_background.released) {
+        if (background->fence) {
+            glDeleteSync(background->fence);
+        }
+        if (background->pbo) {
+            glDeleteBuffers(1, &background->pbo);
+        }
+        glDeleteTextures(1, &background->texture);
+        delete background;
+    }
+    gl_background.released.clear();
+}
+
+/**
+ * Start uploading a surface: copy its pixels into a pixel buffer object
+ * and point glTexImage2D at it, which returns without waiting for the
+ * transfer. A fence marks when the data has landed.
+ */
+static BackgroundTexture *start_background_upload(cairo_surface_t *surface) {
+    cairo_format_t format = cairo_image_surface_get_format(surface);
+    if (format != CAIRO_FORMAT_ARGB32 && format != CAIRO_FORMAT_RGB24) {
+        return NULL;
+    }
+    cairo_surface_flush(surface);
+    const unsigned char *data = cairo_image_surface_get_data(surface);
+    int width = cairo_image_surface_get_width(surface);
+    int height = cairo_image_surface_get_height(surface);
+    int stride = cairo_image_surface_get_stride(surface);
+    if (!data || width <= 0 || height <= 0) {
+        return NULL;
+    }
+    Profiler::Scope scope("start_background_upload");
+
+    BackgroundTexture *background = new BackgroundTexture();
+    background->opaque = format == CAIRO_FORMAT_RGB24;
+
+    glGenBuffers(1, &background->pbo);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, background->pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)stride * height, NULL, GL_STREAM_DRAW);
+    void *staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)stride * height,
+                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (staging) {
+        memcpy(staging, data, (size_t)stride * height);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    } else {
+        // No staging buffer; upload straight from the surface instead
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glDeleteBuffers(1, &background->pbo);
+        background->pbo = 0;
+    }
+
+    glGenTextures(1, &background->texture);
+    glBindTexture(GL_TEXTURE_2D, background->texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // Cairo's native-endian ARGB32 is BGRA in memory on little-endian
+    // machines; the _REV packed type reads it right on either
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, stride / 4);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_BGRA,
+                 GL_UNSIGNED_INT_8_8_8_8_REV, staging ? (void*)0 : data);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    background->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+
+    cairo_surface_set_user_data(surface, &background_texture_key, background, release_background_texture);
+    return background;
+}
+
+// The surface's texture once it is usable; NULL while the upload is in flight
+static BackgroundTexture *get_background_texture(cairo_surface_t *surface) {
+    BackgroundTexture *background =
+        (BackgroundTexture*)cairo_surface_get_user_data(surface, &background_texture_key);
+    if (!background) {
+        background = start_background_upload(surface);
+        if (!background) {
+            return NULL;
+        }
+    }
+
+    if (!background->ready) {
+        GLenum status = glClientWaitSync(background->fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            return NULL;
+        }
+        glDeleteSync(background->fence);
+        background->fence = 0;
+        glDeleteBuffers(1, &background->pbo);
+        background->pbo = 0;
+
+        glBindTexture(GL_TEXTURE_2D, background->texture);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        background->ready = true;
+    }
+    return background;
+}
+
+static void draw_background_image_gl(cairo_surface_t *surface, double opacity, int width, int height) {
+    if (opacity <= 0.0) {
+        return;
+    }
+    BackgroundTexture *background = get_background_texture(surface);
+    if (!background) {
+        return;
+    }
+
+    // Scale to fill the game area while maintaining aspect ratio, centred
+    int imgWidth = cairo_image_surface_get_width(surface);
+    int imgHeight = cairo_image_surface_get_height(surface);
+    double scale = std::max((double)width / imgWidth, (double)height / imgHeight);
+    double x = (width - imgWidth * scale) / 2;
+    double y = (height - imgHeight * scale) / 2;
+
+    glUseProgram(gl_background.program);
+    glUniformMatrix4fv(glGetUniformLocation(gl_background.program, "projection"), 1, GL_FALSE,
+                       gl_state.projection.m);
+    glUniform2f(glGetUniformLocation(gl_background.program, "areaSize"), (float)width, (float)height);
+    glUniform4f(glGetUniformLocation(gl_background.program, "imageRect"), (float)x, (float)y,
+                (float)(imgWidth * scale), (float)(imgHeight * scale));
+    glUniform1f(glGetUniformLocation(gl_background.program, "opacity"), (float)opacity);
+    glUniform1i(glGetUniformLocation(gl_background.program, "opaque"), background->opaque ? 1 : 0);
+    glUniform1i(glGetUniformLocation(gl_background.program, "image"), 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, background->texture);
+    glBindVertexArray(gl_background.vao);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
 void drawBackground_gl(TetrimoneBoard *board, int width, int height) {
+    Profiler::Scope scope("drawBackground_gl");
+    free_released_backgrounds();
+    
     // Draw main game area background
     gl_set_color(0.1f, 0.1f, 0.1f);
     gl_draw_rect_filled(0, 0, width, height);
     
+    // Draw background image if enabled, fading like the Cairo renderer
+    if ((board->isUsingBackgroundImage() || board->isUsingBackgroundZip()) &&
+        board->getBackgroundImage() != nullptr) {
+        if (!board->isInBackgroundTransition()) {
+            draw_background_image_gl(board->getBackgroundImage(), board->getBackgroundOpacity(), width, height);
+        } else if (board->getTransitionDirection() == 1 ||
+                   (board->getTransitionDirection() == -1 && board->getOldBackground() != nullptr)) {
+            // Fading out, the old background is a copy of the still current
+            // image, so the texture already on the GPU serves both halves
+            draw_background_image_gl(board->getBackgroundImage(), board->getTransitionOpacity(), width, height);
+        }
+    }
+    
     // Draw a subtle border around the game area
     gl_set_color(0.3f, 0.3f, 0.3f);
     gl_draw_rect_outline(0, 0, width, height, 2.0f);
@@ -326,6 +1230,12 @@ void drawSplashScreen_gl(TetrimoneBoard *board, TetrimoneApp *app) {
     gl_set_color(1.0f, 1.0f, 1.0f);
     gl_draw_rect_outline(title_x, title_y, title_width, title_height, 2.0f);
     
+    // Title, centred in its box
+    float centerX = (GRID_WIDTH * BLOCK_SIZE) / 2.0f;
+    const char *title = board->retroModeActive ? "БЛОЧНАЯ РЕВОЛЮЦИЯ" : "TETRIMONE";
+    float titleSize = fit_text_size(title, 40.0f * BLOCK_SIZE / 47, title_width - 20);
+    gl_draw_text_centered(title, centerX, title_y + title_height / 2 + titleSize * 0.35f, titleSize);
+    
     // Draw colored blocks for decoration
     int startX = (GRID_WIDTH * BLOCK_SIZE - 4 * BLOCK_SIZE) / 2;
     int startY = title_y + title_height + 20;
@@ -348,6 +1258,22 @@ void drawSplashScreen_gl(TetrimoneBoard *board, TetrimoneApp *app) {
     int promptY = (GRID_HEIGHT * BLOCK_SIZE) * 3 / 4;
     gl_set_color(1.0f, 1.0f, 0.0f);
     gl_draw_rect_outline(100, promptY - 30, GRID_WIDTH * BLOCK_SIZE - 200, 60, 2.0f);
+    
+    const char *startText = board->retroModeActive ? 
+        "Нажмите ПРОБЕЛ для начала" : "Press SPACE to Start";
+    float startSize = fit_text_size(startText, 20.0f * BLOCK_SIZE / 47, GRID_WIDTH * BLOCK_SIZE - 220);
+    gl_draw_text_centered(startText, centerX, promptY + startSize * 0.35f, startSize);
+    
+    // Joystick hint under the prompt box
+    if (app && app->joystickEnabled) {
+        const char *joystickText = board->retroModeActive ? 
+            "или Нажмите СТАРТ на контроллере" : 
+            "or Press START on Controller";
+        float joystickSize = fit_text_size(joystickText, 16.0f * BLOCK_SIZE / 47, GRID_WIDTH * BLOCK_SIZE - 40);
+        gl_set_color(1.0f, 1.0f, 1.0f);
+        gl_draw_text_centered(joystickText, centerX, promptY + 30 + joystickSize * 1.5f, joystickSize);
+    }
+    gl_flush_text();
 }
 
 // Animation value struct
@@ -375,6 +1301,9 @@ static LineClearAnimValues getLineClearAnimationValues(int type, double progress
 }
 
 void drawPlacedBlocks_gl(TetrimoneBoard *board, TetrimoneApp *app) {
+    Profiler::Scope scope("drawPlacedBlocks_gl");
+    int row = (board->retroModeActive || board->simpleBlocksActive) ? ATLAS_ROW_FLAT : ATLAS_ROW_PLACED;
+    
     for (int y = 0; y < GRID_HEIGHT; ++y) {
         for (int x = 0; x < GRID_WIDTH; ++x) {
             int value = board->getGridValue(x, y);
@@ -394,37 +1323,13 @@ void drawPlacedBlocks_gl(TetrimoneBoard *board, TetrimoneApp *app) {
                     offsetY = animValues.offsetY;
                 }
                 
-                // Get color from theme
-                auto baseColor = board->isInThemeTransition() ? 
-                    board->getInterpolatedColor(value - 1, board->getThemeTransitionProgress()) :
-                    TETRIMONEBLOCK_COLOR_THEMES[currentThemeIndex][value - 1];
-                
-                gl_set_color_alpha(baseColor[0], baseColor[1], baseColor[2], alpha);
-                
                 // Calculate position with animation
                 double drawX = x * BLOCK_SIZE + offsetX + (BLOCK_SIZE * (1.0 - scale)) / 2;
                 double drawY = y * BLOCK_SIZE + offsetY + (BLOCK_SIZE * (1.0 - scale)) / 2;
                 double drawSize = BLOCK_SIZE * scale;
                 
-                // Draw main block
-                gl_draw_rect_filled(drawX + 1, drawY + 1, drawSize - 2, drawSize - 2);
-                
-                // Draw 3D highlight if not in retro mode
-                if (!board->retroModeActive && !board->simpleBlocksActive) {
-                    gl_set_color_alpha(1.0f, 1.0f, 1.0f, 0.3f * alpha);
-                    gl_draw_triangle(
-                        drawX + 1, drawY + 1,
-                        drawX + drawSize - 1, drawY + 1,
-                        drawX + 1, drawY + drawSize - 1
-                    );
-                    
-                    gl_set_color_alpha(0.0f, 0.0f, 0.0f, 0.3f * alpha);
-                    gl_draw_triangle(
-                        drawX + drawSize - 1, drawY + 1,
-                        drawX + drawSize - 1, drawY + drawSize - 1,
-                        drawX + 1, drawY + drawSize - 1
-                    );
-                }
+                // Theme colour and bevel come from the atlas sprite
+                gl_queue_block(drawX, drawY, drawSize, value - 1, row, alpha);
             }
         }
     }
@@ -433,12 +1338,11 @@ void drawPlacedBlocks_gl(TetrimoneBoard *board, TetrimoneApp *app) {
 void drawCurrentPiece_gl(TetrimoneBoard *board) {
     auto piece = board->getCurrentPiece();
     auto shape = piece.getShape();
-    auto color = piece.getColor();
     
     int pieceX = piece.getX();
     int pieceY = piece.getY();
     
-    // Draw each block in the piece
+    // Queue each block in the piece
     for (size_t row = 0; row < shape.size(); ++row) {
         for (size_t col = 0; col < shape[row].size(); ++col) {
             if (shape[row][col]) {
@@ -446,25 +1350,8 @@ void drawCurrentPiece_gl(TetrimoneBoard *board) {
                 int gridY = pieceY + row;
                 
                 if (gridX >= 0 && gridX < GRID_WIDTH && gridY >= 0 && gridY < GRID_HEIGHT) {
-                    gl_set_color((float)color[0], (float)color[1], (float)color[2]);
-                    gl_draw_rect_filled(gridX * BLOCK_SIZE + 1, gridY * BLOCK_SIZE + 1, 
-                                       BLOCK_SIZE - 2, BLOCK_SIZE - 2);
-                    
-                    // Draw 3D effect with highlight
-                    gl_set_color_alpha(1.0f, 1.0f, 1.0f, 0.4f);
-                    gl_draw_triangle(
-                        gridX * BLOCK_SIZE + 1, gridY * BLOCK_SIZE + 1,
-                        gridX * BLOCK_SIZE + BLOCK_SIZE - 1, gridY * BLOCK_SIZE + 1,
-                        gridX * BLOCK_SIZE + 1, gridY * BLOCK_SIZE + BLOCK_SIZE - 1
-                    );
-                    
-                    // Draw shadow
-                    gl_set_color_alpha(0.0f, 0.0f, 0.0f, 0.3f);
-                    gl_draw_triangle(
-                        gridX * BLOCK_SIZE + BLOCK_SIZE - 1, gridY * BLOCK_SIZE + 1,
-                        gridX * BLOCK_SIZE + BLOCK_SIZE - 1, gridY * BLOCK_SIZE + BLOCK_SIZE - 1,
-                        gridX * BLOCK_SIZE + 1, gridY * BLOCK_SIZE + BLOCK_SIZE - 1
-                    );
+                    gl_queue_block(gridX * BLOCK_SIZE, gridY * BLOCK_SIZE, BLOCK_SIZE,
+                                   piece.getType(), ATLAS_ROW_PIECE, 1.0f);
                 }
             }
         }
@@ -474,15 +1361,12 @@ void drawCurrentPiece_gl(TetrimoneBoard *board) {
 void drawGhostPiece_gl(TetrimoneBoard *board) {
     auto piece = board->getCurrentPiece();
     auto shape = piece.getShape();
-    auto color = piece.getColor();
     
     // Get current piece position
     int pieceX = piece.getX();
     int ghostY = board->getGhostPieceY();
     
-    gl_set_color_alpha((float)color[0], (float)color[1], (float)color[2], 0.3f);
-    
-    // Draw ghost piece with transparency
+    // Queue ghost piece outlines with transparency
     for (size_t row = 0; row < shape.size(); ++row) {
         for (size_t col = 0; col < shape[row].size(); ++col) {
             if (shape[row][col]) {
@@ -490,14 +1374,108 @@ void drawGhostPiece_gl(TetrimoneBoard *board) {
                 int gridY = ghostY + row;
                 
                 if (gridX >= 0 && gridX < GRID_WIDTH && gridY >= 0 && gridY < GRID_HEIGHT) {
-                    gl_draw_rect_outline(gridX * BLOCK_SIZE + 1, gridY * BLOCK_SIZE + 1,
-                                        BLOCK_SIZE - 2, BLOCK_SIZE - 2, 1.0f);
+                    gl_queue_block(gridX * BLOCK_SIZE, gridY * BLOCK_SIZE, BLOCK_SIZE,
+                                   piece.getType(), ATLAS_ROW_GHOST, 0.3f);
                 }
             }
         }
     }
 }
 
+void gl_set_board_shader(bool enable) {
+    board_shader_enabled = enable;
+}
+
+bool gl_is_board_shader() {
+    return board_shader_enabled;
+}
+
+// Copy the grid into the cell texture; uploads only when a cell changed
+static void update_grid_texture(TetrimoneBoard *board) {
+    bool resized = gl_board.grid_width != GRID_WIDTH || gl_board.grid_height != GRID_HEIGHT;
+    bool changed = resized;
+    bool clearing = board->isLineClearActive();
+
+    gl_board.cells.resize(GRID_WIDTH * GRID_HEIGHT);
+    for (int y = 0; y < GRID_HEIGHT; ++y) {
+        unsigned char rowFlag = (clearing && board->isLineBeingCleared(y)) ? 0x80 : 0;
+        for (int x = 0; x < GRID_WIDTH; ++x) {
+            int value = board->getGridValue(x, y);
+            unsigned char cell = (unsigned char)((value > 0 ? std::min(value, 0x7F) : 0) | rowFlag);
+            unsigned char &stored = gl_board.cells[y * GRID_WIDTH + x];
+            if (stored != cell) {
+                stored = cell;
+                changed = true;
+            }
+        }
+    }
+    if (!changed) {
+        return;
+    }
+
+    Profiler::Scope scope("update_grid_texture");
+    glBindTexture(GL_TEXTURE_2D, gl_board.grid_texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (resized) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, GRID_WIDTH, GRID_HEIGHT, 0, GL_RED_INTEGER,
+                     GL_UNSIGNED_BYTE, gl_board.cells.data());
+        gl_board.grid_width = GRID_WIDTH;
+        gl_board.grid_height = GRID_HEIGHT;
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, GRID_WIDTH, GRID_HEIGHT, GL_RED_INTEGER,
+                        GL_UNSIGNED_BYTE, gl_board.cells.data());
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void drawBoardShader_gl(TetrimoneBoard *board) {
+    Profiler::Scope scope("drawBoardShader_gl");
+    update_grid_texture(board);
+
+    glUseProgram(gl_board.program);
+
+    // Theme colours only change with the palette
+    const ThemePalette &palette = board->getPalette();
+    if (!gl_board.palette_valid || gl_board.palette_version != palette.getVersion()) {
+        float colors[ThemePalette::MAX_TYPES * 3] = {0};
+        for (int type = 0; type < palette.size() && type < ThemePalette::MAX_TYPES; ++type) {
+            const ThemePalette::Color &color = palette.color(type);
+            colors[type * 3] = (float)color[0];
+            colors[type * 3 + 1] = (float)color[1];
+            colors[type * 3 + 2] = (float)color[2];
+        }
+        glUniform3fv(glGetUniformLocation(gl_board.program, "blockColors"), ThemePalette::MAX_TYPES, colors);
+        gl_board.palette_valid = true;
+        gl_board.palette_version = palette.getVersion();
+    }
+
+    bool flat = board->retroModeActive || board->simpleBlocksActive;
+    glUniformMatrix4fv(glGetUniformLocation(gl_board.program, "projection"), 1, GL_FALSE,
+                       gl_state.projection.m);
+    glUniform2f(glGetUniformLocation(gl_board.program, "boardSize"), (float)(GRID_WIDTH * BLOCK_SIZE),
+                (float)(GRID_HEIGHT * BLOCK_SIZE));
+    glUniform1f(glGetUniformLocation(gl_board.program, "cellSize"), (float)BLOCK_SIZE);
+    glUniform1f(glGetUniformLocation(gl_board.program, "clearProgress"),
+                board->isLineClearActive() ? (float)board->getLineClearProgress() : 0.0f);
+    glUniform1f(glGetUniformLocation(gl_board.program, "heatLevel"),
+                board->retroModeActive ? 0.5f : board->getHeatLevel());
+    glUniform1i(glGetUniformLocation(gl_board.program, "bevel"), flat ? 0 : 1);
+    glUniform1i(glGetUniformLocation(gl_board.program, "gridLines"), board->isShowingGridLines() ? 1 : 0);
+    glUniform1i(glGetUniformLocation(gl_board.program, "grid"), 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, gl_board.grid_texture);
+    glBindVertexArray(gl_board.vao);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
 void drawGameOver_gl(TetrimoneBoard *board) {
     if (board->isGameOver()) {
         // Semi-transparent overlay
@@ -520,6 +1498,28 @@ void drawGameOver_gl(TetrimoneBoard *board) {
             gl_draw_circle(100 + (i * boxWidth / 3), textY - 50, 10, 16);
             gl_draw_circle(100 + (i * boxWidth / 3), textY + 50, 10, 16);
         }
+        
+        // Text goes in the box, the restart hint below it
+        float centerX = (GRID_WIDTH * BLOCK_SIZE) / 2.0f;
+        const char *text = board->retroModeActive ? "ИНФОРМАЦИЯ ЗАПРЕЩЕНА" : "GAME OVER";
+        float textSize = fit_text_size(text, 30.0f, boxWidth - 40);
+        gl_set_color(1.0f, 1.0f, 1.0f);
+        gl_draw_text_centered(text, centerX, textY + textSize * 0.35f, textSize);
+        
+        const char *restartText = board->retroModeActive ? 
+                                  "ОЖИДАЙТЕ ДОПРОСА. НЕ ДВИГАЙТЕСЬ..." : 
+                                  "Press R to restart";
+        float restartY = textY + 80;
+        gl_draw_text_centered(restartText, centerX, restartY,
+                              fit_text_size(restartText, 16.0f, GRID_WIDTH * BLOCK_SIZE - 40));
+        
+        // Translation for non-Russian speakers
+        if (board->retroModeActive) {
+            const char *translationText = "(AWAIT INTERROGATION. DO NOT MOVE...)";
+            gl_draw_text_centered(translationText, centerX, restartY + 25,
+                                  fit_text_size(translationText, 12.0f, GRID_WIDTH * BLOCK_SIZE - 40));
+        }
+        gl_flush_text();
     }
 }
 
@@ -538,10 +1538,39 @@ void drawPauseMenu_gl(TetrimoneBoard *board) {
         // Draw border
         gl_set_color(0.0f, 0.0f, 0.0f);
         gl_draw_rect_outline(100, textY - 40, boxWidth, 80, 2.0f);
+        
+        // Title in the box, menu below it
+        float centerX = (GRID_WIDTH * BLOCK_SIZE) / 2.0f;
+        const char *text = board->retroModeActive ? "ПРИОСТАНОВЛЕНО ПО ПРИКАЗУ ПАРТИИ" : "PAUSED";
+        float textSize = fit_text_size(text, 30.0f, boxWidth - 40);
+        gl_draw_text_centered(text, centerX, textY + textSize * 0.35f, textSize);
+        
+        const int numOptions = 3;
+        const char *menuOptions[numOptions];
+        
+        if (board->retroModeActive) {
+            menuOptions[0] = "Продолжить Трудовой Подвиг (P)";
+            menuOptions[1] = "Новая Пятилетка (N)";
+            menuOptions[2] = "Дезертировать с Поля Боя (Q)";
+        } else {
+            menuOptions[0] = "Continue (P)";
+            menuOptions[1] = "New Game (N)";
+            menuOptions[2] = "Quit (Q)";
+        }
+        
+        gl_set_color(1.0f, 1.0f, 1.0f);
+        float optionY = textY + 90;
+        for (int i = 0; i < numOptions; i++) {
+            gl_draw_text_centered(menuOptions[i], centerX, optionY,
+                                  fit_text_size(menuOptions[i], 20.0f, GRID_WIDTH * BLOCK_SIZE - 40));
+            optionY += 40;
+        }
+        gl_flush_text();
     }
 }
 
 void drawPropagandaMessage_gl(TetrimoneBoard *board) {
+    Profiler::Scope scope("drawPropagandaMessage_gl");
     if (board->isShowingPropagandaMessage()) {
         // Draw retro-style message box
         gl_set_color(0.8f, 0.2f, 0.2f);
@@ -551,10 +1580,19 @@ void drawPropagandaMessage_gl(TetrimoneBoard *board) {
         // Add border
         gl_set_color(1.0f, 1.0f, 1.0f);
         gl_draw_rect_outline(0, 0, GRID_WIDTH * BLOCK_SIZE, messageHeight, 2.0f);
+        
+        // One line, shrunk to fit the bar
+        const std::string &message = board->getCurrentPropagandaMessage();
+        float screenWidth = GRID_WIDTH * BLOCK_SIZE;
+        float fontSize = std::max(14.0f, std::min(26.0f, screenWidth / 25.0f));
+        fontSize = fit_text_size(message.c_str(), fontSize, screenWidth - 20);
+        gl_draw_text_centered(message.c_str(), screenWidth / 2.0f, messageHeight / 2 + fontSize * 0.35f, fontSize);
+        gl_flush_text();
     }
 }
 
 void drawFireworks_gl(TetrimoneBoard *board) {
+    Profiler::Scope scope("drawFireworks_gl");
     const auto& particles = board->getFireworkParticles();
     
     for (const auto& particle : particles) {
@@ -569,23 +1607,22 @@ void drawFireworks_gl(TetrimoneBoard *board) {
 }
 
 void drawBlockTrails_gl(TetrimoneBoard *board) {
+    Profiler::Scope scope("drawBlockTrails_gl");
     const auto& trails = board->getBlockTrails();
     
     for (const auto& trail : trails) {
         // Draw trail as a semi-transparent piece at its position
         double alpha = trail.alpha * trail.life;  // Fade over time
         
-        gl_set_color_alpha(trail.color[0], trail.color[1], trail.color[2], (float)alpha);
-        
-        // Draw the piece blocks at the trail position
+        // Queue the piece blocks at the trail position
         for (size_t row = 0; row < trail.shape.size(); ++row) {
             for (size_t col = 0; col < trail.shape[row].size(); ++col) {
                 if (trail.shape[row][col]) {
-                    // Draw a small block at trail position
+                    // A small block at the trail position
                     double blockSize = BLOCK_SIZE * 0.7;  // Slightly smaller
                     double drawX = trail.x + col * blockSize;
                     double drawY = trail.y + row * blockSize;
-                    gl_draw_rect_filled(drawX + 1, drawY + 1, blockSize - 2, blockSize - 2);
+                    gl_queue_block(drawX, drawY, blockSize, trail.pieceType, ATLAS_ROW_TRAIL, (float)alpha);
                 }
             }
         }
@@ -630,7 +1667,6 @@ void drawNextPiecePreview_gl(TetrimoneBoard *board, int previewIndex, int screen
     
     const auto& piece = board->getNextPiece(previewIndex);
     const auto& shape = piece.getShape();
-    const auto& color = piece.getColor();
     
     // Draw background
     gl_set_color(0.15f, 0.15f, 0.15f);
@@ -645,27 +1681,12 @@ void drawNextPiecePreview_gl(TetrimoneBoard *board, int previewIndex, int screen
     int centerX = screenX + (previewSize - shapeWidth * blockSize) / 2;
     int centerY = screenY + (previewSize - shapeHeight * blockSize) / 2;
     
-    // Draw piece blocks
-    gl_set_color((float)color[0], (float)color[1], (float)color[2]);
+    // Queue piece blocks; the caller flushes all previews together
     for (size_t row = 0; row < shape.size(); ++row) {
         for (size_t col = 0; col < shape[row].size(); ++col) {
             if (shape[row][col]) {
-                gl_draw_rect_filled(
-                    centerX + col * blockSize + 1,
-                    centerY + row * blockSize + 1,
-                    blockSize - 2,
-                    blockSize - 2
-                );
-                
-                // Draw 3D effect on preview
-                gl_set_color_alpha(1.0f, 1.0f, 1.0f, 0.3f);
-                gl_draw_triangle(
-                    centerX + col * blockSize + 1, centerY + row * blockSize + 1,
-                    centerX + col * blockSize + blockSize - 1, centerY + row * blockSize + 1,
-                    centerX + col * blockSize + 1, centerY + row * blockSize + blockSize - 1
-                );
-                
-                gl_set_color((float)color[0], (float)color[1], (float)color[2]);
+                gl_queue_block(centerX + col * blockSize, centerY + row * blockSize, blockSize,
+                               piece.getType(), ATLAS_ROW_PREVIEW, 1.0f);
             }
         }
     }
@@ -675,6 +1696,61 @@ void drawNextPiecePreview_gl(TetrimoneBoard *board, int previewIndex, int screen
 // GTK CALLBACKS
 // ============================================================================
 
+// The game area owns the GL context; the preview draws with the same one,
+// so shaders, buffers and textures exist once
+typedef struct {
+    GtkGLArea *game_area;
+    GtkGLArea *preview_area;
+    int preview_shown[6];           // Type and rotation of each piece last shown
+    int preview_count;
+    unsigned int preview_palette;
+    bool preview_valid;
+} GLViewState;
+
+static GLViewState gl_views = {0};
+
+static GdkGLContext *on_create_context_preview(GtkGLArea *area, gpointer data) {
+    (void)area;
+    (void)data;
+    if (!gl_views.game_area) {
+        return NULL;
+    }
+    gtk_widget_realize(GTK_WIDGET(gl_views.game_area));
+    GdkGLContext *context = gtk_gl_area_get_context(gl_views.game_area);
+    if (!context) {
+        // NULL lets GtkGLArea create a context of its own
+        fprintf(stderr, "[GL] Game area has no context, preview cannot share it\n");
+        return NULL;
+    }
+    return GDK_GL_CONTEXT(g_object_ref(context));
+}
+
+// The preview only changes with the next pieces or the colours, so the game
+// area's redraw loop asks for it rather than it redrawing every frame
+static void queue_preview_if_changed(TetrimoneBoard *board) {
+    if (!gl_views.preview_area) {
+        return;
+    }
+    int shown[6];
+    int count = 0;
+    for (int i = 0; i < 3 && i < (int)board->getNextPieces().size(); ++i) {
+        const auto& piece = board->getNextPiece(i);
+        shown[count++] = piece.getType();
+        shown[count++] = piece.getRotation();
+    }
+    unsigned int palette = board->getPalette().getVersion();
+    if (gl_views.preview_valid && count == gl_views.preview_count &&
+        palette == gl_views.preview_palette &&
+        memcmp(shown, gl_views.preview_shown, count * sizeof(int)) == 0) {
+        return;
+    }
+    memcpy(gl_views.preview_shown, shown, count * sizeof(int));
+    gl_views.preview_count = count;
+    gl_views.preview_palette = palette;
+    gl_views.preview_valid = true;
+    gtk_widget_queue_draw(GTK_WIDGET(gl_views.preview_area));
+}
+
 gboolean on_realize_gl(GtkGLArea *area, gpointer data) {
     (void)data;
     gtk_gl_area_make_current(area);
@@ -721,6 +1797,9 @@ gboolean on_render_gl(GtkGLArea *area, GdkGLContext *context, gpointer data) {
     int board_width = GRID_WIDTH * BLOCK_SIZE;
     int board_height = GRID_HEIGHT * BLOCK_SIZE;
     
+    Profiler::Frame profile;
+    Profiler::Scope scope("on_render_gl");
+    
     glViewport(0, 0, window_width, window_height);
     gl_setup_2d_projection(board_width, board_height);
     
@@ -730,25 +1809,45 @@ gboolean on_render_gl(GtkGLArea *area, GdkGLContext *context, gpointer data) {
     
     // Draw all game elements in correct order
     drawBackground_gl(board, board_width, board_height);
-    drawGridLines_gl(board);
+    if (!gl_is_board_shader()) {
+        drawGridLines_gl(board);
+    }
     drawFailureLine_gl();
-    drawPlacedBlocks_gl(board, app);
     
     if (board->isSplashScreenActive()) {
+        if (gl_is_board_shader()) {
+            drawBoardShader_gl(board);
+        } else {
+            drawPlacedBlocks_gl(board, app);
+            gl_flush_blocks(board);
+        }
         drawSplashScreen_gl(board, app);
         glFlush();
         gtk_widget_queue_draw(GTK_WIDGET(area));
         return TRUE;
     }
     
-    // Draw game elements
+    // The message bar goes under the blocks so it never hides the piece
     drawPropagandaMessage_gl(board);
+    
+    // Every block on the board is one instanced draw, or in shader mode
+    // the locked board is one quad and the batch holds the moving blocks
+    if (gl_is_board_shader()) {
+        drawBoardShader_gl(board);
+    } else {
+        drawPlacedBlocks_gl(board, app);
+    }
     drawCurrentPiece_gl(board);
     
     if (board->getMinBlockSize() > 1) {
         drawGhostPiece_gl(board);
     }
     
+    if (board->isTrailsEnabled() && board->isBlockTrailsActive()) {
+        drawBlockTrails_gl(board);
+    }
+    gl_flush_blocks(board);
+    
     drawPauseMenu_gl(board);
     drawGameOver_gl(board);
     
@@ -757,11 +1856,8 @@ gboolean on_render_gl(GtkGLArea *area, GdkGLContext *context, gpointer data) {
         drawFireworks_gl(board);
     }
     
-    if (board->isTrailsEnabled() && board->isBlockTrailsActive()) {
-        drawBlockTrails_gl(board);
-    }
-    
     glFlush();
+    queue_preview_if_changed(board);
     gtk_widget_queue_draw(GTK_WIDGET(area));
     
     return TRUE;
@@ -780,11 +1876,15 @@ gboolean on_render_gl_next_piece(GtkGLArea *area, GdkGLContext *context, gpointe
     
     gtk_gl_area_make_current(area);
     
+    // A preview that could not share the game context has none of its objects
+    if (gl_views.game_area && gtk_gl_area_get_context(area) != gtk_gl_area_get_context(gl_views.game_area)) {
+        return FALSE;
+    }
+    
     int window_width = gtk_widget_get_allocated_width(GTK_WIDGET(area));
     int window_height = gtk_widget_get_allocated_height(GTK_WIDGET(area));
     
     if (window_width < 10 || window_height < 10) {
-        gtk_widget_queue_draw(GTK_WIDGET(area));
         return TRUE;
     }
     
@@ -807,9 +1907,14 @@ gboolean on_render_gl_next_piece(GtkGLArea *area, GdkGLContext *context, gpointe
         drawNextPiecePreview_gl(board, i, 10, yOffset, previewSize);
         yOffset += previewSize + 10;
     }
+    gl_flush_blocks(board);
     
     glFlush();
-    gtk_widget_queue_draw(GTK_WIDGET(area));
+    
+    // Without a game area nothing else schedules the preview
+    if (!gl_views.game_area) {
+        gtk_widget_queue_draw(GTK_WIDGET(area));
+    }
     
     return TRUE;
 }
@@ -819,11 +1924,15 @@ gboolean on_render_gl_next_piece(GtkGLArea *area, GdkGLContext *context, gpointe
 // ============================================================================
 
 void tetrimone_gl_init(GtkGLArea *gl_area) {
+    gl_views.game_area = gl_area;
     g_signal_connect(gl_area, "realize", G_CALLBACK(on_realize_gl), NULL);
     g_signal_connect(gl_area, "render", G_CALLBACK(on_render_gl), NULL);
 }
 
 void tetrimone_gl_next_piece_init(GtkGLArea *gl_area) {
+    gl_views.preview_area = gl_area;
+    gl_views.preview_valid = false;
+    g_signal_connect(gl_area, "create-context", G_CALLBACK(on_create_context_preview), NULL);
     g_signal_connect(gl_area, "realize", G_CALLBACK(on_realize_gl), NULL);
     g_signal_connect(gl_area, "render", G_CALLBACK(on_render_gl_next_piece), NULL);
 }
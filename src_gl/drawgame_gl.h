@@ -9,6 +9,12 @@
 // CORE OPENGL SETUP AND PROJECTION
 // ============================================================================
 
+/**
+ * Create every shader, buffer and texture the renderer draws with
+ * Call once with the context current, after glewInit(); later calls do nothing
+ */
+void gl_init(void);
+
 /**
  * Set up 2D orthographic projection for Tetrimone rendering
  * Uses glMatrixMode(), glOrtho() equivalent via matrix math
@@ -108,13 +114,80 @@ void gl_draw_circle_outline(float cx, float cy, float radius, float line_width,
  */
 void gl_draw_triangle(float x1, float y1, float x2, float y2, float x3, float y3);
 
+/**
+ * Draw every queued block sprite
+ * The block drawing functions below queue instances (position, size, type,
+ * style, alpha) instead of drawing; this uploads them and issues a single
+ * glDrawArraysInstanced against the block atlas texture, rebaking the atlas
+ * first if the theme colours changed
+ * @param board The board whose palette colours the atlas
+ */
+void gl_flush_blocks(TetrimoneBoard *board);
+
+/**
+ * Choose how the locked board is drawn
+ * Off: one block sprite per cell through gl_flush_blocks()
+ * On: drawBoardShader_gl() shades the whole board from a grid texture
+ * Starts on when TETRIMONE_GL_BOARD_SHADER is set
+ * @param enable True to use the board shader
+ */
+void gl_set_board_shader(bool enable);
+
+/**
+ * @return True if the locked board is drawn by the board shader
+ */
+bool gl_is_board_shader();
+
+/**
+ * Report how large the line/rect vertex buffer has grown
+ * @param capacity Receives the vertices the buffer holds
+ * @param peak Receives the most vertices a single draw has needed
+ */
+void gl_vertex_buffer_stats(int *capacity, int *peak);
+
+/**
+ * Measure UTF-8 text drawn with gl_draw_text()
+ * @param text UTF-8 string
+ * @param size Font size in pixels
+ * @return Advance width in pixels
+ */
+float gl_text_width(const char *text, float size);
+
+/**
+ * Queue UTF-8 text in the current colour
+ * Glyphs come from an atlas Cairo rasterizes once at startup (bold Sans,
+ * ASCII and Cyrillic preloaded, other characters added on first use);
+ * each glyph is one textured quad drawn by gl_flush_text()
+ * @param text UTF-8 string
+ * @param x Left edge of the text
+ * @param y Baseline
+ * @param size Font size in pixels
+ */
+void gl_draw_text(const char *text, float x, float y, float size);
+
+/**
+ * Queue UTF-8 text centred horizontally on cx
+ * @param text UTF-8 string
+ * @param cx Horizontal centre
+ * @param y Baseline
+ * @param size Font size in pixels
+ */
+void gl_draw_text_centered(const char *text, float cx, float y, float size);
+
+/**
+ * Draw all queued text with a single glDrawArrays(GL_TRIANGLES)
+ */
+void gl_flush_text(void);
+
 // ============================================================================
 // TETRIMONE GAME DRAWING FUNCTIONS
 // ============================================================================
 
 /**
  * Draw the background of the game board
- * Includes main area fill and border
+ * Includes main area fill, the background image and border
+ * Images are uploaded once per Cairo surface through a pixel buffer object
+ * and mipmapped; opacity and transition fades are applied in the shader
  * Uses glDrawArrays(GL_TRIANGLES) and GL_LINE_STRIP
  */
 void drawBackground_gl(TetrimoneBoard *board, int width, int height);
@@ -135,50 +208,60 @@ void drawFailureLine_gl();
 
 /**
  * Draw the splash/title screen
- * Semi-transparent overlay with tetris blocks decoration
- * Uses multiple glDrawArrays calls (GL_TRIANGLES, GL_LINE_STRIP)
+ * Semi-transparent overlay with tetris blocks decoration, title and start prompt
+ * Uses multiple glDrawArrays calls (GL_TRIANGLES, GL_LINE_STRIP) and one text batch
  */
 void drawSplashScreen_gl(TetrimoneBoard *board, TetrimoneApp *app);
 
 /**
  * Draw all placed blocks on the board
  * Includes animations for line clears
- * Uses glDrawArrays(GL_TRIANGLES) for each block and 3D effects
+ * Queues one bevelled atlas sprite per block for gl_flush_blocks()
  */
 void drawPlacedBlocks_gl(TetrimoneBoard *board, TetrimoneApp *app);
 
+/**
+ * Draw grid lines and all placed blocks as a single quad
+ * The grid cells live in a GRID_WIDTH x GRID_HEIGHT integer texture that
+ * is re-uploaded only when a cell changes; the fragment shader computes
+ * fill, bevel, grid lines, the line clear fade and the heat tint per pixel
+ * Uses glDrawArrays(GL_TRIANGLES) with 6 vertices
+ */
+void drawBoardShader_gl(TetrimoneBoard *board);
+
 /**
  * Draw the currently falling tetrimone piece
  * Includes 3D highlight and shadow effects
- * Uses glDrawArrays(GL_TRIANGLES) for blocks and highlights
+ * Queues atlas sprites for gl_flush_blocks()
  */
 void drawCurrentPiece_gl(TetrimoneBoard *board);
 
 /**
  * Draw the ghost/preview of where the current piece will land
  * Semi-transparent outline
- * Uses glDrawArrays(GL_LINE_STRIP) for outlines
+ * Queues outline sprites for gl_flush_blocks()
  */
 void drawGhostPiece_gl(TetrimoneBoard *board);
 
 /**
  * Draw the GAME OVER screen
- * Semi-transparent overlay with decorative elements
+ * Semi-transparent overlay with decorative elements and the restart hint
  * Uses glDrawArrays(GL_TRIANGLES, GL_LINE_STRIP) for overlay, box, and circles
+ * and one text batch
  */
 void drawGameOver_gl(TetrimoneBoard *board);
 
 /**
  * Draw the PAUSED overlay
- * Semi-transparent background with pause indication
- * Uses glDrawArrays(GL_TRIANGLES, GL_LINE_STRIP)
+ * Semi-transparent background with pause indication and menu keys
+ * Uses glDrawArrays(GL_TRIANGLES, GL_LINE_STRIP) and one text batch
  */
 void drawPauseMenu_gl(TetrimoneBoard *board);
 
 /**
  * Draw propaganda/status message if active
- * Retro-style message box
- * Uses glDrawArrays(GL_TRIANGLES, GL_LINE_STRIP)
+ * Retro-style message bar with the message shrunk to fit on one line
+ * Uses glDrawArrays(GL_TRIANGLES, GL_LINE_STRIP) and one text batch
  */
 void drawPropagandaMessage_gl(TetrimoneBoard *board);
 
@@ -190,8 +273,8 @@ void drawFireworks_gl(TetrimoneBoard *board);
 
 /**
  * Draw block movement trail effects
- * Semi-transparent fading lines
- * Uses glDrawArrays(GL_LINES) for trail segments
+ * Semi-transparent fading blocks
+ * Queues flat sprites for gl_flush_blocks()
  */
 void drawBlockTrails_gl(TetrimoneBoard *board);
 
@@ -212,7 +295,8 @@ void drawFreezyEffect_gl(double x, double y, double size, float heatLevel, doubl
 /**
  * Draw next piece preview box
  * Shows a single upcoming piece
- * Uses glDrawArrays(GL_TRIANGLES, GL_LINE_STRIP)
+ * Uses glDrawArrays(GL_TRIANGLES, GL_LINE_STRIP) for the box and queues
+ * the piece for gl_flush_blocks()
  */
 void drawNextPiecePreview_gl(TetrimoneBoard *board, int previewIndex, int screenX, int screenY, int previewSize);
 
@@ -223,13 +307,17 @@ void drawNextPiecePreview_gl(TetrimoneBoard *board, int previewIndex, int screen
 /**
  * Initialize the main game rendering callback
  * Connects to the GTK realize and render signals
+ * The area's GL context holds every shader, buffer and texture, and its
+ * render loop also schedules the preview whenever the next pieces change
  * @param gl_area The GtkGLArea widget
  */
 void tetrimone_gl_init(GtkGLArea *gl_area);
 
 /**
  * Initialize the next piece preview rendering callback
- * Connects to the GTK realize and render signals
+ * Connects to the GTK create-context, realize and render signals
+ * Call after tetrimone_gl_init(): the preview uses the game area's GL
+ * context instead of creating its own, and redraws only when asked
  * @param gl_area The GtkGLArea widget for next piece display
  */
 void tetrimone_gl_next_piece_init(GtkGLArea *gl_area);
@@ -0,0 +1,433 @@
+// ============================================================================
+// gl_check: draw with the OpenGL renderer offscreen and check the pixels
+//
+// Usage: gl_check
+//
+// Makes a GL 3.3 core context on a surfaceless EGL display, so it needs
+// no window or X server (Mesa's llvmpipe is enough), and draws into a
+// framebuffer object through the same drawgame_gl.cpp functions the game
+// uses. Each check compares what it reads back with what the renderer
+// promises and reports PASS or FAIL; the exit status is the number of
+// failed checks.
+//
+// Built from the GL sources; see the gl-check target in Makefile.gl.
+// ============================================================================
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/glew.h>
+#include <GL/gl.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "tetrimone.h"
+
+static const int CHECK_WIDTH = 300;     // GRID_WIDTH * BLOCK_SIZE
+static const int CHECK_HEIGHT = 660;    // GRID_HEIGHT * BLOCK_SIZE
+static const int CHECK_TOLERANCE = 3;   // Per channel, out of 255
+
+struct Pixel {
+    int r, g, b, a;
+};
+
+static GLuint framebuffer = 0;
+static int failures = 0;
+
+static bool createContext() {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    EGLDisplay display = EGL_NO_DISPLAY;
+    if (getPlatformDisplay) {
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    }
+    if (display == EGL_NO_DISPLAY) {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+        fprintf(stderr, "gl_check: no EGL display\n");
+        return false;
+    }
+    eglBindAPI(EGL_OPENGL_API);
+
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config = NULL;
+    EGLint configs = 0;
+    eglChooseConfig(display, configAttribs, &config, 1, &configs);
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, configs ? config : (EGLConfig)0, EGL_NO_CONTEXT,
+                                          contextAttribs);
+    if (context == EGL_NO_CONTEXT ||
+        !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        fprintf(stderr, "gl_check: no GL 3.3 core context (EGL error 0x%x)\n", eglGetError());
+        return false;
+    }
+
+    glewExperimental = GL_TRUE;
+    GLenum status = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // GLX-only GLEW builds load the GL entry points, then fail looking for X
+    if (status == GLEW_ERROR_NO_GLX_DISPLAY) {
+        status = GLEW_OK;
+    }
+#endif
+    if (status != GLEW_OK) {
+        fprintf(stderr, "gl_check: glewInit failed: %s\n", glewGetErrorString(status));
+        return false;
+    }
+
+    printf("%s, OpenGL %s\n", glGetString(GL_RENDERER), glGetString(GL_VERSION));
+    return true;
+}
+
+// Surfaceless contexts have no default framebuffer; everything draws here
+static void createFramebuffer() {
+    GLuint color;
+    glGenRenderbuffers(1, &color);
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, CHECK_WIDTH, CHECK_HEIGHT);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+}
+
+// Same state the game sets before drawing a frame
+static void beginFrame() {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, CHECK_WIDTH, CHECK_HEIGHT);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gl_setup_2d_projection(CHECK_WIDTH, CHECK_HEIGHT);
+}
+
+// The whole frame, top row first like the renderer's coordinates
+static std::vector<unsigned char> readFrame() {
+    std::vector<unsigned char> pixels(CHECK_WIDTH * CHECK_HEIGHT * 4);
+    glFinish();
+    glReadPixels(0, 0, CHECK_WIDTH, CHECK_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    std::vector<unsigned char> flipped(pixels.size());
+    int stride = CHECK_WIDTH * 4;
+    for (int y = 0; y < CHECK_HEIGHT; ++y) {
+        std::copy(pixels.begin() + (CHECK_HEIGHT - 1 - y) * stride,
+                  pixels.begin() + (CHECK_HEIGHT - y) * stride, flipped.begin() + y * stride);
+    }
+    return flipped;
+}
+
+static Pixel pixelAt(const std::vector<unsigned char> &frame, int x, int y) {
+    const unsigned char *p = &frame[(y * CHECK_WIDTH + x) * 4];
+    Pixel pixel = {p[0], p[1], p[2], p[3]};
+    return pixel;
+}
+
+static bool samePixel(const Pixel &a, const Pixel &b) {
+    return abs(a.r - b.r) <= CHECK_TOLERANCE && abs(a.g - b.g) <= CHECK_TOLERANCE &&
+           abs(a.b - b.b) <= CHECK_TOLERANCE && abs(a.a - b.a) <= CHECK_TOLERANCE;
+}
+
+static void report(const char *name, bool passed, const char *detail) {
+    printf("%s %s: %s\n", passed ? "PASS" : "FAIL", name, detail);
+    if (!passed) {
+        ++failures;
+    }
+}
+
+static bool noGLError(const char *name) {
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        char detail[64];
+        snprintf(detail, sizeof(detail), "GL error 0x%04x", error);
+        report(name, false, detail);
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// CHECKS
+// ============================================================================
+
+/**
+ * The board shader has to draw the locked board the way the block sprites
+ * do: each filled cell is sampled in its lit and its shaded half and each
+ * empty cell in its centre, in both modes. Another piece is then locked so
+ * the grid texture is re-uploaded, and the comparison runs again.
+ */
+static void checkBoardShader(TetrimoneBoard *board) {
+    const char *name = "board shader";
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < (pass == 0 ? 6 : 1); ++i) {
+            board->hardDrop();
+        }
+        board->setHeatLevel(0.5f);
+
+        beginFrame();
+        drawPlacedBlocks_gl(board, NULL);
+        gl_flush_blocks(board);
+        std::vector<unsigned char> sprites = readFrame();
+
+        beginFrame();
+        drawBoardShader_gl(board);
+        std::vector<unsigned char> shaded = readFrame();
+        if (!noGLError(name)) {
+            return;
+        }
+
+        int filled = 0;
+        int samples[2][2] = {{BLOCK_SIZE / 4, BLOCK_SIZE / 4}, {BLOCK_SIZE * 3 / 4, BLOCK_SIZE * 3 / 4}};
+        for (int y = 0; y < GRID_HEIGHT; ++y) {
+            if (board->isLineClearActive() && board->isLineBeingCleared(y)) {
+                continue;
+            }
+            for (int x = 0; x < GRID_WIDTH; ++x) {
+                bool empty = board->getGridValue(x, y) == 0;
+                filled += empty ? 0 : 1;
+                for (int s = 0; s < (empty ? 1 : 2); ++s) {
+                    int px = x * BLOCK_SIZE + (empty ? BLOCK_SIZE / 2 : samples[s][0]);
+                    int py = y * BLOCK_SIZE + (empty ? BLOCK_SIZE / 2 : samples[s][1]);
+                    Pixel a = pixelAt(sprites, px, py);
+                    Pixel b = pixelAt(shaded, px, py);
+                    if (!samePixel(a, b)) {
+                        char detail[160];
+                        snprintf(detail, sizeof(detail),
+                                 "cell (%d,%d) sprite %d,%d,%d,%d shader %d,%d,%d,%d", x, y,
+                                 a.r, a.g, a.b, a.a, b.r, b.g, b.b, b.a);
+                        report(name, false, detail);
+                        return;
+                    }
+                }
+            }
+        }
+        if (filled == 0) {
+            report(name, false, "no locked cells to compare");
+            return;
+        }
+        char detail[96];
+        snprintf(detail, sizeof(detail), "%d locked cells match the block sprites%s", filled,
+                 pass == 0 ? "" : " after a re-upload");
+        report(name, true, detail);
+    }
+}
+
+// A Cairo image surface of one colour, in Cairo's native-endian 0xAARRGGBB
+static cairo_surface_t *solidSurface(cairo_format_t format, int r, int g, int b) {
+    cairo_surface_t *surface = cairo_image_surface_create(format, 64, 32);
+    unsigned char *data = cairo_image_surface_get_data(surface);
+    int stride = cairo_image_surface_get_stride(surface);
+    uint32_t argb = 0xFF000000u | ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
+    for (int y = 0; y < 32; ++y) {
+        uint32_t *row = (uint32_t *)(data + y * stride);
+        std::fill(row, row + 64, argb);
+    }
+    cairo_surface_mark_dirty(surface);
+    return surface;
+}
+
+// Draw the background until the image shows; the upload lands asynchronously
+static Pixel drawBackgroundUntil(TetrimoneBoard *board, const Pixel &expected, int *frames) {
+    Pixel centre = {0, 0, 0, 0};
+    for (*frames = 1; *frames <= 30; ++*frames) {
+        beginFrame();
+        drawBackground_gl(board, CHECK_WIDTH, CHECK_HEIGHT);
+        centre = pixelAt(readFrame(), CHECK_WIDTH / 2, CHECK_HEIGHT / 2);
+        centre.a = expected.a;
+        if (samePixel(centre, expected)) {
+            break;
+        }
+    }
+    return centre;
+}
+
+/**
+ * Background images go up through a pixel buffer object and a fence, so
+ * the first frames may show only the fill. An opaque ARGB32 image at full
+ * opacity has to come back unchanged once it lands. Replacing it with an
+ * RGB24 image at half opacity releases the first texture and has to blend
+ * the new image over the 0.1 grey fill.
+ */
+static void checkBackground(TetrimoneBoard *board) {
+    const char *name = "background upload";
+    board->setUseBackgroundImage(true);
+    board->setBackgroundOpacity(1.0);
+    board->backgroundImage = solidSurface(CAIRO_FORMAT_ARGB32, 200, 100, 50);
+
+    int frames = 0;
+    Pixel expected = {200, 100, 50, 255};
+    Pixel centre = drawBackgroundUntil(board, expected, &frames);
+    if (!noGLError(name)) {
+        return;
+    }
+    char detail[128];
+    bool passed = samePixel(centre, expected);
+    snprintf(detail, sizeof(detail), "ARGB32 image %s after %d frame%s (centre %d,%d,%d)",
+             passed ? "drawn" : "not drawn", frames, frames == 1 ? "" : "s", centre.r, centre.g, centre.b);
+    report(name, passed, detail);
+
+    cairo_surface_destroy(board->backgroundImage);
+    board->backgroundImage = solidSurface(CAIRO_FORMAT_RGB24, 40, 220, 120);
+    board->setBackgroundOpacity(0.5);
+    int fill = 26;  // 0.1 grey
+    Pixel blended = {(40 + fill) / 2, (220 + fill) / 2, (120 + fill) / 2, 255};
+    centre = drawBackgroundUntil(board, blended, &frames);
+    if (!noGLError(name)) {
+        return;
+    }
+    passed = samePixel(centre, blended);
+    snprintf(detail, sizeof(detail), "RGB24 image at half opacity %s after %d frame%s (centre %d,%d,%d)",
+             passed ? "blended" : "not blended", frames, frames == 1 ? "" : "s", centre.r, centre.g, centre.b);
+    report(name, passed, detail);
+
+    board->setUseBackgroundImage(false);
+}
+
+// Pixels of the text colour's red channel above half in a rectangle
+static int litPixels(const std::vector<unsigned char> &frame, int x0, int y0, int x1, int y1) {
+    int lit = 0;
+    for (int y = std::max(y0, 0); y < std::min(y1, CHECK_HEIGHT); ++y) {
+        for (int x = std::max(x0, 0); x < std::min(x1, CHECK_WIDTH); ++x) {
+            lit += pixelAt(frame, x, y).r > 128 ? 1 : 0;
+        }
+    }
+    return lit;
+}
+
+/**
+ * Text is drawn from the glyph atlas: one preloaded ASCII letter, one
+ * preloaded Cyrillic letter and a full block, which is not preloaded and
+ * has to be added to the atlas on first use. Each glyph has to cover
+ * part of its own advance, the full block has to be solid in its middle,
+ * and nothing may be drawn above the line.
+ */
+static void checkGlyphAtlas() {
+    const char *name = "glyph atlas";
+    const char *glyphs[] = {"H", "\xD0\x96", "\xE2\x96\x88"};  // H, Cyrillic Zhe, full block
+    const float size = 40.0f;
+    const float left = 20.0f;
+    const float baseline = 100.0f;
+
+    beginFrame();
+    gl_set_color(1.0f, 1.0f, 1.0f);
+    std::string line;
+    for (const char *glyph : glyphs) {
+        line += glyph;
+    }
+    gl_draw_text(line.c_str(), left, baseline, size);
+    gl_flush_text();
+    std::vector<unsigned char> frame = readFrame();
+    if (!noGLError(name)) {
+        return;
+    }
+
+    char detail[128];
+    float pen = left;
+    for (const char *glyph : glyphs) {
+        float advance = gl_text_width(glyph, size);
+        int lit = litPixels(frame, (int)pen, (int)(baseline - size), (int)(pen + advance),
+                            (int)(baseline + size / 4));
+        snprintf(detail, sizeof(detail), "'%s' covers %d pixels of its %.0f px advance", glyph, lit, advance);
+        report(name, lit > 0, detail);
+        pen += advance;
+    }
+
+    // The last glyph is the full block, added after the atlas was created
+    float blockAdvance = gl_text_width(glyphs[2], size);
+    Pixel middle = pixelAt(frame, (int)(pen - blockAdvance / 2), (int)(baseline - size / 4));
+    middle.a = 255;
+    Pixel white = {255, 255, 255, 255};
+    snprintf(detail, sizeof(detail), "first-use glyph middle is %d,%d,%d", middle.r, middle.g, middle.b);
+    report(name, samePixel(middle, white), detail);
+
+    int stray = litPixels(frame, 0, 0, CHECK_WIDTH, (int)(baseline - size * 1.5f));
+    snprintf(detail, sizeof(detail), "%d stray pixels above the line", stray);
+    report(name, stray == 0, detail);
+}
+
+/**
+ * The line/rect vertex buffer starts small and doubles when a draw needs
+ * more, so after the game's own frames (playing in both board modes,
+ * paused, fireworks, game over) it has to hold the largest draw and be
+ * less than twice its size, unless that draw fits the initial size. This
+ * check ends the game, so it runs last.
+ */
+static void checkVertexBuffer(TetrimoneBoard *board) {
+    const char *name = "vertex buffer";
+    bool boardShader = gl_is_board_shader();
+    for (int mode = 0; mode < 2; ++mode) {
+        gl_set_board_shader(mode == 1);
+        beginFrame();
+        drawGameFrame_gl(board, CHECK_WIDTH, CHECK_HEIGHT);
+    }
+    gl_set_board_shader(boardShader);
+
+    board->setPaused(true);
+    beginFrame();
+    drawGameFrame_gl(board, CHECK_WIDTH, CHECK_HEIGHT);
+    board->setPaused(false);
+
+    board->startFireworksAnimation(4);
+    beginFrame();
+    drawGameFrame_gl(board, CHECK_WIDTH, CHECK_HEIGHT);
+
+    for (int i = 0; i < 200 && !board->isGameOver(); ++i) {
+        board->hardDrop();
+    }
+    beginFrame();
+    drawGameFrame_gl(board, CHECK_WIDTH, CHECK_HEIGHT);
+    glFinish();
+    if (!noGLError(name)) {
+        return;
+    }
+
+    int capacity = 0;
+    int peak = 0;
+    gl_vertex_buffer_stats(&capacity, &peak);
+    const int initial = 256;
+    bool passed = board->isGameOver() && capacity >= peak && (capacity <= initial || capacity < 2 * peak);
+    char detail[128];
+    snprintf(detail, sizeof(detail), "%d vertices (%zu bytes) for a largest draw of %d vertices%s",
+             capacity, capacity * 6 * sizeof(float), peak, board->isGameOver() ? "" : ", game not over");
+    report(name, passed, detail);
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    if (!createContext()) {
+        return 1;
+    }
+    createFramebuffer();
+    gl_init();
+    if (!noGLError("gl_init")) {
+        return 1;
+    }
+
+    BLOCK_SIZE = CHECK_WIDTH / GRID_WIDTH;
+    TetrimoneBoard *board = new TetrimoneBoard();
+
+    checkBoardShader(board);
+    checkBackground(board);
+    checkGlyphAtlas();
+    checkVertexBuffer(board);
+
+    delete board;
+    printf("%d check%s failed\n", failures, failures == 1 ? "" : "s");
+    return failures;
+}
@@ -0,0 +1,77 @@
+// ============================================================================
+// Per-frame block colour palette (Framework-Agnostic)
+// ============================================================================
+
+#include <vector>
+#include <array>
+#include <cmath>
+#include <algorithm>
+#include "themes.h"
+#include "palette.h"
+
+ThemePalette::ThemePalette()
+    : typeCount(1), valid(false), keyTheme(-1), keyFrom(-1), keyTo(-1), keyStep(-1),
+      version(0) {
+  colors[0] = highlights[0] = shadows[0] = themeColors[0] = {1.0, 1.0, 1.0};
+}
+
+ThemePalette::Color ThemePalette::highlightOf(const Color &c) {
+  return {c[0] * 0.7 + 0.3, c[1] * 0.7 + 0.3, c[2] * 0.7 + 0.3};
+}
+
+ThemePalette::Color ThemePalette::shadowOf(const Color &c) {
+  return {c[0] * 0.7, c[1] * 0.7, c[2] * 0.7};
+}
+
+// Out-of-range theme indices fall back to the last theme, as getColor() did
+static int validTheme(int index) {
+  int themes = (int)TETRIMONEBLOCK_COLOR_THEMES.size();
+  return (index < 0 || index >= themes) ? themes - 1 : index;
+}
+
+bool ThemePalette::update(int themeIndex, bool transitioning, int fromTheme, int toTheme,
+                          double progress) {
+  themeIndex = validTheme(themeIndex);
+  fromTheme = transitioning ? validTheme(fromTheme) : themeIndex;
+  toTheme = transitioning ? validTheme(toTheme) : themeIndex;
+
+  int step = 0;
+  if (transitioning) {
+    double clamped = std::max(0.0, std::min(1.0, progress));
+    step = (int)std::lround(clamped * TRANSITION_STEPS);
+  }
+
+  if (valid && keyTheme == themeIndex && keyFrom == fromTheme && keyTo == toTheme &&
+      keyStep == step) {
+    return false;
+  }
+  valid = true;
+  keyTheme = themeIndex;
+  keyFrom = fromTheme;
+  keyTo = toTheme;
+  keyStep = step;
+  ++version;
+
+  // Cubic ease-in-out for smoother, more noticeable transitions
+  double t = (double)step / TRANSITION_STEPS;
+  if (t < 0.5) {
+    t = 4 * t * t * t;
+  } else {
+    t = 1 - pow(-2 * t + 2, 3) / 2;
+  }
+
+  const auto &current = TETRIMONEBLOCK_COLOR_THEMES[themeIndex];
+  const auto &from = TETRIMONEBLOCK_COLOR_THEMES[fromTheme];
+  const auto &to = TETRIMONEBLOCK_COLOR_THEMES[toTheme];
+  typeCount = std::min((int)current.size(), (int)MAX_TYPES);
+
+  for (int type = 0; type < typeCount; ++type) {
+    for (int i = 0; i < 3; ++i) {
+      colors[type][i] = from[type][i] + (to[type][i] - from[type][i]) * t;
+    }
+    highlights[type] = highlightOf(colors[type]);
+    shadows[type] = shadowOf(colors[type]);
+    themeColors[type] = current[type];
+  }
+  return true;
+}
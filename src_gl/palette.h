@@ -0,0 +1,69 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <array>
+
+/**
+ * Block colours for the current frame.
+ *
+ * Holds the theme colour of every block type, already blended for a
+ * theme transition, plus the lighter and darker shades used for bevels.
+ * update() only recomputes when the theme or the (quantized) transition
+ * step changes, so renderers can index it per cell for free.
+ */
+class ThemePalette {
+public:
+    typedef std::array<double, 3> Color;
+
+    static const int MAX_TYPES = 16;
+    static const int TRANSITION_STEPS = 64;  // Colour steps across a theme crossfade
+
+    ThemePalette();
+
+    /**
+     * Bring the colours up to date with the board's theme state.
+     * @param themeIndex Current theme (the old one while transitioning)
+     * @param transitioning True while a theme crossfade runs
+     * @param fromTheme Theme being faded out
+     * @param toTheme Theme being faded in
+     * @param progress Linear transition progress, 0.0 to 1.0
+     * @return true if the colours changed
+     */
+    bool update(int themeIndex, bool transitioning, int fromTheme, int toTheme, double progress);
+
+    /** Number of block types in the themes */
+    int size() const { return typeCount; }
+
+    /** Colour of a block type, blended while transitioning */
+    const Color &color(int type) const { return colors[clampType(type)]; }
+    const Color &highlight(int type) const { return highlights[clampType(type)]; }
+    const Color &shadow(int type) const { return shadows[clampType(type)]; }
+
+    /** Unblended colour of the current theme (ghost piece, trails) */
+    const Color &themeColor(int type) const { return themeColors[clampType(type)]; }
+
+    /** Changes whenever any colour does; a cheap cache key for sprites */
+    unsigned int getVersion() const { return version; }
+
+    /** Bevel shades: the colour under a 30% white or 30% black overlay */
+    static Color highlightOf(const Color &c);
+    static Color shadowOf(const Color &c);
+
+private:
+    Color colors[MAX_TYPES];
+    Color highlights[MAX_TYPES];
+    Color shadows[MAX_TYPES];
+    Color themeColors[MAX_TYPES];
+    int typeCount;
+
+    // What the colours were computed for
+    bool valid;
+    int keyTheme, keyFrom, keyTo, keyStep;
+    unsigned int version;
+
+    int clampType(int type) const {
+        return type < 0 ? 0 : (type >= typeCount ? typeCount - 1 : type);
+    }
+};
+
+#endif // PALETTE_H
@@ -563,6 +563,7 @@ bool TetrimoneBoard::checkCollision(const TetrimoneBlock &piece) const {
 }
 
 void TetrimoneBoard::lockPiece() {
+  Profiler::Scope scope("lockPiece");
   auto shape = currentPiece->getShape();
   int pieceX = currentPiece->getX();
   int pieceY = currentPiece->getY();
@@ -588,6 +589,7 @@ void TetrimoneBoard::lockPiece() {
 }
 
 int TetrimoneBoard::clearLines() {
+  Profiler::Scope scope("clearLines");
   std::vector<int> linesToClear;
   int currentlevel = (this->linesCleared / 10) + initialLevel;
   
@@ -1007,6 +1009,7 @@ void TetrimoneBoard::generateNewPiece() {
 }
 
 void TetrimoneBoard::updateGame() {
+  Profiler::Scope scope("updateGame");
   if (gameOver || paused || splashScreenActive)
     return;
 
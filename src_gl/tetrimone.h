@@ -15,6 +15,8 @@
 #include "tetrimoneblock.h"
 #include "highscores.h"
 #include "propaganda_messages.h"
+#include "palette.h"
+#include "../src/profiler.h"  // Shared with the Cairo frontends
 
 enum class GameSoundEvent {
   BackgroundMusic,
@@ -191,6 +193,7 @@ private:
     int oldThemeIndex;
     int newThemeIndex;
     double themeTransitionProgress;
+    mutable ThemePalette palette;   // Refreshed lazily by getPalette()
     guint themeTransitionTimer;
     static const int THEME_TRANSITION_DURATION = 3000; // milliseconds
 
@@ -271,6 +274,7 @@ public:
     double getThemeTransitionProgress() const { return themeTransitionProgress; }
     int getOldThemeIndex() const { return oldThemeIndex; }
     std::array<double, 3> getInterpolatedColor(int blockType, double progress) const;
+    const ThemePalette& getPalette() const;
 
     int getCurrentAnimationType() const { return currentAnimationType; }
 
@@ -442,6 +446,7 @@ void tetrimone_gl_init(GtkGLArea *gl_area);
 void tetrimone_gl_next_piece_init(GtkGLArea *gl_area);
 
 // OpenGL primitive drawing functions
+void gl_init(void);
 void gl_setup_2d_projection(int width, int height);
 void gl_set_color(float r, float g, float b);
 void gl_set_color_alpha(float r, float g, float b, float a);
@@ -451,6 +456,14 @@ void gl_draw_line(float x1, float y1, float x2, float y2, float width);
 void gl_draw_circle(float cx, float cy, float radius, int segments);
 void gl_draw_circle_outline(float cx, float cy, float radius, float line_width, int segments);
 void gl_draw_triangle(float x1, float y1, float x2, float y2, float x3, float y3);
+void gl_flush_blocks(TetrimoneBoard *board);
+void gl_vertex_buffer_stats(int *capacity, int *peak);
+void gl_set_board_shader(bool enable);
+bool gl_is_board_shader();
+float gl_text_width(const char *text, float size);
+void gl_draw_text(const char *text, float x, float y, float size);
+void gl_draw_text_centered(const char *text, float cx, float y, float size);
+void gl_flush_text(void);
 
 // OpenGL game rendering functions
 void drawBackground_gl(TetrimoneBoard *board, int width, int height);
@@ -458,6 +471,7 @@ void drawGridLines_gl(TetrimoneBoard *board);
 void drawFailureLine_gl();
 void drawSplashScreen_gl(TetrimoneBoard *board, TetrimoneApp *app);
 void drawPlacedBlocks_gl(TetrimoneBoard *board, TetrimoneApp *app);
+void drawBoardShader_gl(TetrimoneBoard *board);
 void drawCurrentPiece_gl(TetrimoneBoard *board);
 void drawGhostPiece_gl(TetrimoneBoard *board);
 void drawGameOver_gl(TetrimoneBoard *board);
@@ -468,6 +482,7 @@ void drawBlockTrails_gl(TetrimoneBoard *board);
 void drawFireyGlow_gl(double x, double y, double size, float heatLevel, double time);
 void drawFreezyEffect_gl(double x, double y, double size, float heatLevel, double time);
 void drawNextPiecePreview_gl(TetrimoneBoard *board, int previewIndex, int screenX, int screenY, int previewSize);
+void drawGameFrame_gl(TetrimoneBoard *board, int width, int height);
 
 // Input and event handling
 gboolean onKeyPress(GtkWidget* widget, GdkEventKey* event, gpointer data);
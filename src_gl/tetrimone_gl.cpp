@@ -462,6 +462,7 @@ bool TetrimoneBoard::checkCollision(const TetrimoneBlock &piece) const {
 }
 
 void TetrimoneBoard::lockPiece() {
+  Profiler::Scope scope("lockPiece");
   auto shape = currentPiece->getShape();
   int pieceX = currentPiece->getX();
   int pieceY = currentPiece->getY();
@@ -487,6 +488,7 @@ void TetrimoneBoard::lockPiece() {
 }
 
 int TetrimoneBoard::clearLines() {
+  Profiler::Scope scope("clearLines");
   std::vector<int> linesToClear;
   int currentlevel = (this->linesCleared / 10) + initialLevel;
   
@@ -906,6 +908,7 @@ void TetrimoneBoard::generateNewPiece() {
 }
 
 void TetrimoneBoard::updateGame() {
+  Profiler::Scope scope("updateGame");
   if (gameOver || paused || splashScreenActive)
     return;
 
@@ -1060,6 +1063,8 @@ bool initSDLGL() {
 
     std::cout << "OpenGL " << glGetString(GL_VERSION) << std::endl;
 
+    gl_init();
+
     return true;
 }
 
@@ -1125,6 +1130,40 @@ void shutdown() {
     shutdownSDL();
 }
 
+// ============================================================================
+// FRONTEND HOOKS
+// ============================================================================
+
+// The shared modules call these; the SDL window has no labels or menus,
+// so the HUD is redrawn every frame and the layout follows the window
+
+void updateLabels([[maybe_unused]] TetrimoneApp* app) {
+}
+
+void calculateBlockSize([[maybe_unused]] TetrimoneApp* app) {
+    int width = WINDOW_WIDTH, height = WINDOW_HEIGHT;
+    if (g_window) {
+        SDL_GetWindowSize(g_window, &width, &height);
+    }
+
+    int heightBasedSize = (height * 9 / 10) / GRID_HEIGHT;
+    int widthBasedSize = (width * 6 / 10) / GRID_WIDTH;
+
+    BLOCK_SIZE = std::min(heightBasedSize, widthBasedSize);
+    BLOCK_SIZE = std::max(BLOCK_SIZE, MIN_BLOCK_SIZE);
+    BLOCK_SIZE = std::min(BLOCK_SIZE, MAX_BLOCK_SIZE);
+}
+
+void rebuildGameUI(TetrimoneApp* app) {
+    calculateBlockSize(app);
+}
+
+void onPauseGame([[maybe_unused]] GtkMenuItem* menuItem, [[maybe_unused]] gpointer userData) {
+    if (!g_board->isGameOver()) {
+        g_paused = !g_paused;
+    }
+}
+
 // ============================================================================
 // INPUT HANDLING
 // ============================================================================
@@ -1175,6 +1214,10 @@ void handleKeyPress(SDL_KeyboardEvent& key) {
             //     // Resume audio if available
             // }
             break;
+        case SDLK_F6:
+            // Switch the locked board between block sprites and the grid shader
+            gl_set_board_shader(!gl_is_board_shader());
+            break;
         case SDLK_ESCAPE:
             g_quit = true;
             break;
@@ -1251,45 +1294,52 @@ void update() {
     }
 }
 
-void render() {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    int window_width, window_height;
-    SDL_GetWindowSize(g_window, &window_width, &window_height);
-
-    // Draw game - use your existing OpenGL rendering functions
-    // These should be in your drawgame_gl.cpp
-    
-    // Set up projection
-    gl_setup_2d_projection(window_width, window_height);
+// Everything the window shows, drawn with the current context and
+// framebuffer; gl_check draws the same frame offscreen
+void drawGameFrame_gl(TetrimoneBoard *board, int width, int height) {
+    gl_setup_2d_projection(width, height);
     
     // Draw game components
-    drawBackground_gl(g_board.get(), window_width, window_height);
-    drawGridLines_gl(g_board.get());
-    drawPlacedBlocks_gl(g_board.get(), nullptr);
-    drawCurrentPiece_gl(g_board.get());
-    drawGhostPiece_gl(g_board.get());
+    drawBackground_gl(board, width, height);
+    if (gl_is_board_shader()) {
+        drawBoardShader_gl(board);
+    } else {
+        drawGridLines_gl(board);
+        drawPlacedBlocks_gl(board, nullptr);
+    }
+    drawCurrentPiece_gl(board);
+    drawGhostPiece_gl(board);
+    if (board->isBlockTrailsActive()) {
+        drawBlockTrails_gl(board);
+    }
+    gl_flush_blocks(board);
     
     // Optional effects
-    if (g_board->isFireworksActive()) {
-        drawFireworks_gl(g_board.get());
-    }
-    if (g_board->isBlockTrailsActive()) {
-        drawBlockTrails_gl(g_board.get());
+    if (board->isFireworksActive()) {
+        drawFireworks_gl(board);
     }
 
     // Draw UI overlays
-    if (g_board->isPaused()) {
-        drawPauseMenu_gl(g_board.get());
+    if (board->isPaused()) {
+        drawPauseMenu_gl(board);
     }
 
-    if (g_board->isGameOver()) {
-        drawGameOver_gl(g_board.get());
+    if (board->isGameOver()) {
+        drawGameOver_gl(board);
     }
 
-    if (g_board->isShowingPropagandaMessage()) {
-        drawPropagandaMessage_gl(g_board.get());
+    if (board->isShowingPropagandaMessage()) {
+        drawPropagandaMessage_gl(board);
     }
+}
+
+void render() {
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    int window_width, window_height;
+    SDL_GetWindowSize(g_window, &window_width, &window_height);
+
+    drawGameFrame_gl(g_board.get(), window_width, window_height);
 
     SDL_GL_SwapWindow(g_window);
 }
@@ -1298,6 +1348,8 @@ void render() {
 // MAIN
 // ============================================================================
 
+// Offline tools bring their own main()
+#ifndef OFFLINE_TOOL
 int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
     // Initialize SDL and OpenGL
     TetrimoneApp* app;
@@ -1376,6 +1428,7 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
     shutdown();
     return 0;
 }
+#endif // OFFLINE_TOOL
 
 bool TetrimoneBoard::isGameOver() const {
   // If this is the first time checking game over status since it became true,